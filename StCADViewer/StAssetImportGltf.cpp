@@ -13,13 +13,12 @@
 #include "StImageOcct.h"
 
 #include <StStrings/StLogger.h>
-#include <StTemplates/StArrayStreamBuffer.h>
+#include <StThreads/StAtomicOp.h>
 
 #include <Graphic3d_Mat4d.hxx>
 #include <Graphic3d_Vec.hxx>
 #include <gp_Quaternion.hxx>
 #include <NCollection_Buffer.hxx>
-#include <OSD_OpenFile.hxx>
 #include <Precision.hxx>
 
 namespace
@@ -30,6 +29,11 @@ namespace
     const char THE_KHR_materials_common[] = "KHR_materials_common";
     const char THE_KHR_binary_glTF[]      = "KHR_binary_glTF";
 
+    //! Maximum size of images decoded in advance.
+    //! Prefetched image is released only when texture is uploaded,
+    //! so that textures which are never displayed should not hold unbounded amount of memory.
+    static const int32_t THE_PREFETCH_LIMIT_KIB = 256 * 1024;
+
     //! Look-up table for decoding base64 stream.
     static const stUByte_t THE_BASE64_FROM[128] = {
         255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
@@ -104,6 +108,57 @@ namespace
              : NULL;
     }
 
+    /**
+     * Check that the buffer contains specified number of elements.
+     */
+    static bool isValidRange(const GltfAccessorData& theData,
+                             const size_t theElemSize,
+                             const size_t theStride,
+                             const size_t theNbElems) {
+        return theStride >= theElemSize
+            && theNbElems > 0
+            && int64_t(theStride) * int64_t(theNbElems - 1) + int64_t(theElemSize) <= theData.Size;
+    }
+
+    /**
+     * Copy array of elements with specified stride.
+     * Destination array should be already resized.
+     */
+    template<typename Elem_t>
+    static void copyStrided(std::vector<Elem_t>& theDst,
+                            const stUByte_t*     theSrc,
+                            const size_t         theStride) {
+        if(theStride == sizeof(Elem_t)) {
+            // tightly packed array
+            std::memcpy(&theDst[0], theSrc, theDst.size() * sizeof(Elem_t));
+            return;
+        }
+
+        for(size_t anElemIter = 0; anElemIter < theDst.size(); ++anElemIter) {
+            std::memcpy(&theDst[anElemIter], theSrc + anElemIter * theStride, sizeof(Elem_t));
+        }
+    }
+
+    /**
+     * Copy array of indices with specified stride and validate them.
+     * Destination array should be already resized.
+     */
+    template<typename Index_t>
+    static bool copyIndices(std::vector<GLuint>& theDst,
+                            const stUByte_t*     theSrc,
+                            const size_t         theStride,
+                            const size_t         theNbNodes) {
+        for(size_t anElemIter = 0; anElemIter < theDst.size(); ++anElemIter) {
+            Index_t anIndex = 0;
+            std::memcpy(&anIndex, theSrc + anElemIter * theStride, sizeof(Index_t));
+            if(size_t(anIndex) >= theNbNodes) {
+                return false;
+            }
+            theDst[anElemIter] = GLuint(anIndex);
+        }
+        return true;
+    }
+
 }
 
 /**
@@ -117,9 +172,12 @@ class StGltfBinTexture : public StAssetTexture {
 
     /**
      * Constructor.
+     * The file is referenced only when it is memory-mapped,
+     * otherwise image bytes are copied so that the file buffer could be released after import.
      */
     StGltfBinTexture(const StString& theUri,
                      const StString& theMime,
+                     const StHandle<StRawFile>& theFile,
                      const int64_t theStart,
                      const int theLen)
     : StAssetTexture(theUri),
@@ -130,6 +188,26 @@ class StGltfBinTexture : public StAssetTexture {
             const StString anId = StString("texture://") + theUri + "@offset=" + StString(theStart) + "@len=" + StString(theLen);
             myTexId = anId.toCString();
         }
+
+        if(theFile.isNull()) {
+            return;
+        } else if(theFile->isMapped()) {
+            myFile = theFile;
+            return;
+        } else if(theFile->getBuffer() == NULL
+               || theStart < 0
+               || theStart + int64_t(theLen) > int64_t(theFile->getSize())) {
+            ST_ERROR_LOG(StString() + "Texture refers to non-existing location within '" + theUri + "'");
+            return;
+        }
+
+        myBuffer = new NCollection_Buffer(NCollection_BaseAllocator::CommonBaseAllocator());
+        if(!myBuffer->Allocate(theLen)) {
+            myBuffer.Nullify();
+            return;
+        }
+        std::memcpy(myBuffer->ChangeData(), theFile->getBuffer() + theStart, theLen);
+        myStart = 0;
     }
 
     /**
@@ -149,44 +227,49 @@ class StGltfBinTexture : public StAssetTexture {
         }
     }
 
+    /**
+     * Compare with another texture.
+     */
+    virtual bool isEqual(const StAssetTexture& theOther) const {
+        return myTexId == theOther.GetId();
+    }
+
     /**
      * Image getter.
+     * Releases the reference to the file (or copied data) once the image has been decoded for upload.
      */
     virtual Handle(Image_PixMap) GetImage() const Standard_OVERRIDE {
+        Handle(Image_PixMap) anImage = StAssetTexture::GetImage();
+        if(!anImage.IsNull()) {
+            myFile.nullify();
+            myBuffer.Nullify();
+        }
+        return anImage;
+    }
+
+        protected:
+
+    /**
+     * Decode the image.
+     */
+    virtual Handle(Image_PixMap) loadImage() const Standard_OVERRIDE {
         Handle(Image_PixMap) anImage;
         if(!myBuffer.IsNull()) {
             Handle(StImageOcct) anStImage = new StImageOcct();
             if(anStImage->Load(myImageUri, StMIME(myMime, StString(), StString()), myBuffer->ChangeData(), (int )myBuffer->Size())) {
                 anImage = anStImage;
             }
-        } else {
-            std::ifstream aFile;
-            OSD_OpenStream(aFile, myImageUri.toCString(), std::ios::in | std::ios::binary);
-            if(!aFile.is_open() || !aFile.good()) {
-                ST_ERROR_LOG(StString() + "Texture points to non existing file '" + myImageUri.toCString() + "'");
-                return false;
-            }
-
-            aFile.seekg(myStart, std::ios_base::beg);
-            if(!aFile.good()) {
-                aFile.close();
-                ST_ERROR_LOG(StString() + "Texture refers to non-existing location");
-                return false;
-            }
-
-            Handle(NCollection_Buffer) aData = new NCollection_Buffer(NCollection_BaseAllocator::CommonBaseAllocator());
-            if(!aData->Allocate(myLen)) {
-                ST_ERROR_LOG("Fail to allocate memory.");
-                return false;
-            }
-
-            if(!aFile.read((char* )aData->ChangeData(), myLen)) {
-                ST_ERROR_LOG(StString() + "Texture refers to non-existing location");
-                return false;
+        } else if(!myFile.isNull()) {
+            // read directly from already mapped file
+            if(myFile->getBuffer() == NULL
+            || myStart < 0
+            || myStart + int64_t(myLen) > int64_t(myFile->getSize())) {
+                ST_ERROR_LOG(StString() + "Texture refers to non-existing location within '" + myImageUri + "'");
+                return Handle(Image_PixMap)();
             }
 
             Handle(StImageOcct) anStImage = new StImageOcct();
-            if(anStImage->Load(myImageUri, StMIME(myMime, StString(), StString()), aData->ChangeData(), myLen)) {
+            if(anStImage->Load(myImageUri, StMIME(myMime, StString(), StString()), (uint8_t* )myFile->getBuffer() + myStart, myLen)) {
                 anImage = anStImage;
             }
         }
@@ -197,19 +280,13 @@ class StGltfBinTexture : public StAssetTexture {
         return anImage;
     }
 
-    /**
-     * Compare with another texture.
-     */
-    virtual bool isEqual(const StAssetTexture& theOther) const {
-        return myTexId == theOther.GetId();
-    }
-
         private:
 
-    int64_t myStart;
-    int     myLen;
-    Handle(NCollection_Buffer) myBuffer;
-    StString myMime;
+    mutable StHandle<StRawFile>        myFile;   //!< memory-mapped file, released after upload
+    int64_t                            myStart;
+    int                                myLen;
+    mutable Handle(NCollection_Buffer) myBuffer; //!< image data, released after upload
+    StString                           myMime;
 
 };
 
@@ -262,7 +339,9 @@ bool StAssetImportGltf::probeFormatFromExtension(const StString& theExt) {
 }
 
 StAssetImportGltf::StAssetImportGltf()
-: myBinBodyOffset(0),
+: myNbJobsTaken(0),
+  myPrefetchedKiB(0),
+  myBinBodyOffset(0),
   myBinBodyLen(0),
   myIsBinary(false) {
     //
@@ -277,32 +356,32 @@ bool StAssetImportGltf::load(const Handle(StDocNode)& theParentNode,
         myFolder += SYS_FS_SPLITTER;
     }
 
-    std::ifstream aFile;
-    OSD_OpenStream(aFile, theFile.toCString(), std::ios::in | std::ios::binary);
-    if(!aFile.is_open() || !aFile.good()) {
+    // map the whole file, so that buffers can be decoded in-place
+    myRawFile = new StRawFile();
+    if(!myRawFile->mapFile(theFile)) {
         signals.onError(formatSyntaxError(myFileName, StString("File '") + theFile + "' is not found!"));
         return false;
     }
 
-    char aGlbHeader[12] = {};
-    aFile.read(aGlbHeader, sizeof(aGlbHeader));
+    const char*   aFileData = (const char* )myRawFile->getBuffer();
+    const int64_t aFileLen  = (int64_t )myRawFile->getSize();
     int64_t aJsonBodyOffset = 0;
-    int64_t aJsonBodyLen    = 0;
-    if(::strncmp(aGlbHeader, "glTF", 4) == 0) {
-        myIsBinary = true;
-        const uint32_t* aVer = (const uint32_t* )(aGlbHeader + 4);
-        const uint32_t* aLen = (const uint32_t* )(aGlbHeader + 8);
+    int64_t aJsonBodyLen    = aFileLen;
+    if(aFileLen >= 12
+    && ::strncmp(aFileData, "glTF", 4) == 0) {
+        myIsBinary   = true;
+        aJsonBodyLen = 0;
+        const uint32_t* aVer = (const uint32_t* )(aFileData + 4);
+        const uint32_t* aLen = (const uint32_t* )(aFileData + 8);
         if(*aVer == 1) {
-            if(*aLen < 20) {
+            if(*aLen < 20
+            || aFileLen < 20) {
                 signals.onError(formatSyntaxError(myFileName, StString("File '") + theFile + "' has broken glTF format!"));
                 return false;
             }
 
-            char aHeader1[8] = {};
-            aFile.read(aHeader1, sizeof(aHeader1));
-
-            const uint32_t* aSceneLen    = (const uint32_t* )(aHeader1 + 0);
-            const uint32_t* aSceneFormat = (const uint32_t* )(aHeader1 + 4);
+            const uint32_t* aSceneLen    = (const uint32_t* )(aFileData + 12);
+            const uint32_t* aSceneFormat = (const uint32_t* )(aFileData + 16);
             aJsonBodyOffset = 20;
             aJsonBodyLen    = int64_t(*aSceneLen);
 
@@ -317,44 +396,41 @@ bool StAssetImportGltf::load(const Handle(StDocNode)& theParentNode,
                 //signals.onError(formatSyntaxError(myFileName, StString("File '") + theFile + "' is written using unknown version " + int(*aVer) + "!"));
             }
 
-            for(int aChunkIter = 0; !aFile.eof() && aChunkIter < 2; ++aChunkIter) {
-                char aChunkHeader2[8] = {};
-                if(int64_t(aFile.tellg()) + int64_t(sizeof(aChunkHeader2)) > int64_t(aLen)) {
+            const int64_t aTotalLen = stMin(int64_t(*aLen), aFileLen);
+            int64_t aChunkOffset = 12;
+            for(int aChunkIter = 0; aChunkIter < 2; ++aChunkIter) {
+                if(aChunkOffset + 8 > aTotalLen) {
                     break;
                 }
 
-                aFile.read(aChunkHeader2, sizeof(aChunkHeader2));
-                if(!aFile.good()) {
-                    signals.onError(formatSyntaxError(myFileName, StString("File '") + theFile + "' is written using unsupported format!"));
-                    return false;
-                }
-
-                const uint32_t* aChunkLen  = (const uint32_t* )(aChunkHeader2 + 0);
-                const uint32_t* aChunkType = (const uint32_t* )(aChunkHeader2 + 4);
+                const uint32_t* aChunkLen  = (const uint32_t* )(aFileData + aChunkOffset + 0);
+                const uint32_t* aChunkType = (const uint32_t* )(aFileData + aChunkOffset + 4);
+                aChunkOffset += 8;
                 if(*aChunkType == 0x4E4F534A) {
-                    aJsonBodyOffset = int64_t(aFile.tellg());
+                    aJsonBodyOffset = aChunkOffset;
                     aJsonBodyLen    = int64_t(*aChunkLen);
                 } else if(*aChunkType == 0x004E4942) {
-                    myBinBodyOffset = int64_t(aFile.tellg());
+                    myBinBodyOffset = aChunkOffset;
                     myBinBodyLen    = int64_t(*aChunkLen);
                 }
-                if(*aChunkLen != 0) {
-                    aFile.seekg(*aChunkLen, std::ios_base::cur);
-                }
+                aChunkOffset += int64_t(*aChunkLen);
             }
+        }
 
-            aFile.seekg(aJsonBodyOffset, std::ios_base::beg);
+        if(aJsonBodyOffset + aJsonBodyLen > aFileLen
+        || myBinBodyOffset + myBinBodyLen > aFileLen
+        || myBinBodyLen < 0) {
+            signals.onError(formatSyntaxError(myFileName, StString("File '") + theFile + "' has broken glTF format!"));
+            return false;
         }
-    } else {
-        aFile.seekg(0, std::ios_base::beg);
     }
 
-    rapidjson::IStreamWrapper aFileStream(aFile);
+    rapidjson::MemoryStream aJsonStream(aFileData + aJsonBodyOffset, size_t(aJsonBodyLen));
     rapidjson::ParseResult aRes;
     if(myIsBinary) {
-        aRes = ParseStream<rapidjson::kParseStopWhenDoneFlag, rapidjson::UTF8<>, rapidjson::IStreamWrapper>(aFileStream);
+        aRes = ParseStream<rapidjson::kParseStopWhenDoneFlag, rapidjson::UTF8<>, rapidjson::MemoryStream>(aJsonStream);
     } else {
-        aRes = ParseStream(aFileStream);
+        aRes = ParseStream<rapidjson::kParseDefaultFlags, rapidjson::UTF8<>, rapidjson::MemoryStream>(aJsonStream);
     }
 
     if(aRes.IsError()) {
@@ -439,6 +515,9 @@ void StAssetImportGltf::gltfParseMaterials() {
                 aMat->Name = aMatId.GetString();
             }
             myMaterials.Bind(aMatId.GetString(), aMat);
+            if(!aMat->Texture.IsNull()) {
+                myTextures.push_back(aMat->Texture);
+            }
         }
     } else if(aMatList->IsArray()) {
         // glTF 2.0
@@ -459,6 +538,9 @@ void StAssetImportGltf::gltfParseMaterials() {
                 aMat->Name = StString("mat_") + aMatIndex;
             }
             myMaterials.Bind(TCollection_AsciiString(aMatIndex), aMat);
+            if(!aMat->Texture.IsNull()) {
+                myTextures.push_back(aMat->Texture);
+            }
         }
     }
 }
@@ -719,7 +801,7 @@ bool StAssetImportGltf::gltfParseTexture(StGLMaterial& theMat,
             if(aMimeTypeVal != NULL && aMimeTypeVal->IsString()) {
                 aMime = aMimeTypeVal->GetString();
             }
-            theMat.Texture = new StGltfBinTexture(myFileName, aMime, anOffset, (int )aBuffView.ByteLength);
+            theMat.Texture = new StGltfBinTexture(myFileName, aMime, myRawFile, anOffset, (int )aBuffView.ByteLength);
             return true;
         }
     }
@@ -738,6 +820,10 @@ bool StAssetImportGltf::gltfParseTexture(StGLMaterial& theMat,
                 const int aBase64Len = int(aBase64End - aBase64Data);
                 const StString aMime(aDataStart, aDataIter - aDataStart);
                 Handle(NCollection_Buffer) aData = decodeBase64((const stUByte_t* )aBase64Data, aBase64Len);
+                if(aData.IsNull()) {
+                    signals.onError(formatSyntaxError(myFileName, StString("Image '") + aSrcVal->GetString() + "' defines invalid base64 data."));
+                    return false;
+                }
                 theMat.Texture = new StGltfBinTexture(myFileName + "@" + aSrcVal->GetString(), aMime, aData);
                 return true;
             }
@@ -1027,6 +1113,10 @@ bool StAssetImportGltf::gltfParsePrimArray(const Handle(StDocMeshNode)& theMeshN
         myMaterials.Find(getKeyString(*aMaterial), aPrimArray->Material);
     }
 
+    myPrimArrays.push_back(GltfPrimArrayData());
+    GltfPrimArrayData& aPrimData = myPrimArrays.back();
+    aPrimData.PrimArray = aPrimArray;
+
     bool hasPositions = false;
     for(rapidjson::Value::ConstMemberIterator anAttribIter = anAttribs->MemberBegin(); anAttribIter != anAttribs->MemberEnd(); ++anAttribIter) {
         const TCollection_AsciiString anAttribId = getKeyString(anAttribIter->value);
@@ -1047,7 +1137,7 @@ bool StAssetImportGltf::gltfParsePrimArray(const Handle(StDocMeshNode)& theMeshN
             signals.onError(formatSyntaxError(myFileName, StString("Primitive array attribute accessor key '") + anAttribId.ToCString()
                                                                  + "' points to non-existing object."));
             return false;
-        } else if(!gltfParseAccessor(aPrimArray, anAttribId, *anAccessor, aType, aMode)) {
+        } else if(!gltfParseAccessor(aPrimData, anAttribId, *anAccessor, aType, aMode)) {
             return false;
         } else if(aType == GltfArrayType_Position) {
             hasPositions = true;
@@ -1072,7 +1162,7 @@ bool StAssetImportGltf::gltfParsePrimArray(const Handle(StDocMeshNode)& theMeshN
             signals.onError(formatSyntaxError(myFileName, StString("Primitive array indices accessor key '") + anIndicesId.ToCString()
                                                                 + "' points to non-existing object."));
             return false;
-        } else if(!gltfParseAccessor(aPrimArray, anIndicesId, *anAccessor, GltfArrayType_Indices, aMode)) {
+        } else if(!gltfParseAccessor(aPrimData, anIndicesId, *anAccessor, GltfArrayType_Indices, aMode)) {
             return false;
         }
     }
@@ -1080,7 +1170,7 @@ bool StAssetImportGltf::gltfParsePrimArray(const Handle(StDocMeshNode)& theMeshN
     return true;
 }
 
-bool StAssetImportGltf::gltfParseAccessor(const Handle(StPrimArray)& thePrimArray,
+bool StAssetImportGltf::gltfParseAccessor(GltfPrimArrayData& thePrimData,
                                           const TCollection_AsciiString& theName,
                                           const GenericValue&     theAccessor,
                                           const GltfArrayType     theType,
@@ -1156,10 +1246,10 @@ bool StAssetImportGltf::gltfParseAccessor(const Handle(StPrimArray)& thePrimArra
         return false;
     }
 
-    return gltfParseBufferView(thePrimArray, getKeyString(*aBufferViewName), *aBufferView, aStruct, theType, theMode);
+    return gltfParseBufferView(thePrimData, getKeyString(*aBufferViewName), *aBufferView, aStruct, theType, theMode);
 }
 
-bool StAssetImportGltf::gltfParseBufferView(const Handle(StPrimArray)& thePrimArray,
+bool StAssetImportGltf::gltfParseBufferView(GltfPrimArrayData& thePrimData,
                                             const TCollection_AsciiString& theName,
                                             const GenericValue&     theBufferView,
                                             const GltfAccessor&     theAccessor,
@@ -1205,21 +1295,54 @@ bool StAssetImportGltf::gltfParseBufferView(const Handle(StPrimArray)& thePrimAr
         return false;
     }
 
-    return gltfParseBuffer(thePrimArray, getKeyString(*aBufferName), *aBuffer, theAccessor, aBuffView, theType, theMode);
+    return gltfParseBuffer(thePrimData, getKeyString(*aBufferName), *aBuffer, theAccessor, aBuffView, theType, theMode);
 }
 
-bool StAssetImportGltf::gltfParseBuffer(const Handle(StPrimArray)& thePrimArray,
+bool StAssetImportGltf::gltfParseBuffer(GltfPrimArrayData& thePrimData,
                                         const TCollection_AsciiString& theName,
                                         const GenericValue&     theBuffer,
                                         const GltfAccessor&     theAccessor,
                                         const GltfBufferView&   theView,
                                         const GltfArrayType     theType,
                                         const GltfPrimitiveMode theMode) {
+    if(theMode != GltfPrimitiveMode_Triangles) {
+        ST_DEBUG_LOG("Buffer '" + theName.ToCString() + "' skipped unsupported primitive array.");
+        return true;
+    }
+
+    if(!myBuffers.IsBound(theName)) {
+        GltfBufferData aBufferData;
+        if(!gltfLoadBuffer(aBufferData, theName, theBuffer)) {
+            return false;
+        }
+        myBuffers.Bind(theName, aBufferData);
+    }
+
+    const GltfBufferData& aBufferData = myBuffers.Find(theName);
+    const int64_t anOffset = theView.ByteOffset + theAccessor.ByteOffset;
+    if(anOffset >= aBufferData.Size) {
+        signals.onError(formatSyntaxError(myFileName, StString("Buffer '") + theName.ToCString() + "' refers to invalid location."));
+        return false;
+    }
+
+    // actual decoding is postponed to gltfDecodeData()
+    GltfAccessorData anAccessorData;
+    anAccessorData.Name     = theName;
+    anAccessorData.Accessor = theAccessor;
+    anAccessorData.Type     = theType;
+    anAccessorData.Data     = aBufferData.Data + anOffset;
+    anAccessorData.Size     = aBufferData.Size - anOffset;
+    thePrimData.Accessors.push_back(anAccessorData);
+    return true;
+}
+
+bool StAssetImportGltf::gltfLoadBuffer(GltfBufferData& theData,
+                                       const TCollection_AsciiString& theName,
+                                       const GenericValue& theBuffer) {
     //const GenericValue* aType       = findObjectMember(theBuffer, "type");
     //const GenericValue* aByteLength = findObjectMember(theBuffer, "byteLength");
     const GenericValue* anUriVal      = findObjectMember(theBuffer, "uri");
 
-    int64_t anOffset = theView.ByteOffset + theAccessor.ByteOffset;
     bool isBinary = false;
     if(myIsBinary) {
         isBinary = theName.IsEqual("binary_glTF") // glTF 1.0
@@ -1227,22 +1350,10 @@ bool StAssetImportGltf::gltfParseBuffer(const Handle(StPrimArray)& thePrimArray,
     }
 
     if(isBinary) {
-        std::ifstream aFile;
-        OSD_OpenStream(aFile, myFileName.toCString(), std::ios::in | std::ios::binary);
-        if(!aFile.is_open() || !aFile.good()) {
-            signals.onError(formatSyntaxError(myFileName, StString("Buffer '") + theName.ToCString() + "' refers to non-existing file '" + myFileName + "'."));
-            return false;
-        }
-
-        anOffset += myBinBodyOffset;
-        aFile.seekg(anOffset, std::ios_base::beg);
-        if(!aFile.good()) {
-            aFile.close();
-            signals.onError(formatSyntaxError(myFileName, StString("Buffer '") + theName.ToCString() + "' refers to non-existing location."));
-            return false;
-        }
-
-        return gltfReadBuffer(thePrimArray, theName, theAccessor, aFile, theType, theMode);
+        // binary body within already mapped file
+        theData.Data = myRawFile->getBuffer() + myBinBodyOffset;
+        theData.Size = myBinBodyLen;
+        return true;
     }
 
     if(anUriVal == NULL || !anUriVal->IsString()) {
@@ -1252,203 +1363,183 @@ bool StAssetImportGltf::gltfParseBuffer(const Handle(StPrimArray)& thePrimArray,
 
     const char* anUriData = anUriVal->GetString();
     if(::strncmp(anUriData, "data:application/octet-stream;base64,", 37) == 0) {
-        Handle(NCollection_Buffer) aData = decodeBase64((const stUByte_t* )anUriData + 37, anUriVal->GetStringLength() - 37);
-        StArrayStreamBuffer aStreamBuffer((const char* )aData->Data(), aData->Size());
-        std::istream aStream(&aStreamBuffer);
-        aStream.seekg(anOffset, std::ios_base::beg);
-        return gltfReadBuffer(thePrimArray, theName, theAccessor, aStream, theType, theMode);
-    } else {
-        StString anUri = anUriData;
-        if(anUri.isEmpty()) {
-            signals.onError(formatSyntaxError(myFileName, StString("Buffer '") + theName.ToCString() + "' does not define uri."));
+        theData.Decoded = decodeBase64((const stUByte_t* )anUriData + 37, anUriVal->GetStringLength() - 37);
+        if(theData.Decoded.IsNull()) {
+            signals.onError(formatSyntaxError(myFileName, StString("Buffer '") + theName.ToCString() + "' defines invalid base64 data."));
             return false;
         }
 
-        std::ifstream aFile;
-        StString aPath = myFolder + anUri;
-        OSD_OpenStream(aFile, aPath.toCString(), std::ios::in | std::ios::binary);
-        if(!aFile.is_open() || !aFile.good()) {
-            signals.onError(formatSyntaxError(myFileName, StString("Buffer '") + theName.ToCString() + "' refers to non-existing file '" + anUri + "'."));
-            return false;
-        }
+        theData.Data = theData.Decoded->Data();
+        theData.Size = (int64_t )theData.Decoded->Size();
+        return true;
+    }
 
-        aFile.seekg(anOffset, std::ios_base::beg);
-        if(!aFile.good()) {
-            aFile.close();
-            signals.onError(formatSyntaxError(myFileName, StString("Buffer '") + theName.ToCString() + "' refers to invalid location."));
-            return false;
+    const StString anUri = anUriData;
+    if(anUri.isEmpty()) {
+        signals.onError(formatSyntaxError(myFileName, StString("Buffer '") + theName.ToCString() + "' does not define uri."));
+        return false;
+    }
+
+    theData.File = new StRawFile();
+    if(!theData.File->mapFile(myFolder + anUri)) {
+        signals.onError(formatSyntaxError(myFileName, StString("Buffer '") + theName.ToCString() + "' refers to non-existing file '" + anUri + "'."));
+        return false;
+    }
+
+    theData.Data = theData.File->getBuffer();
+    theData.Size = (int64_t )theData.File->getSize();
+    return true;
+}
+
+SV_THREAD_FUNCTION StAssetImportGltf::decodeThread(void* theImporter) {
+    ((StAssetImportGltf* )theImporter)->decodeLoop();
+    return SV_THREAD_RETURN 0;
+}
+
+void StAssetImportGltf::decodeLoop() {
+    const int32_t aNbTextures = int32_t(myTextures.size());
+    const int32_t aNbJobs     = aNbTextures + int32_t(myPrimArrays.size());
+    for(;;) {
+        // images are taken first, since their decoding usually takes longer
+        const int32_t aJobIter = StAtomicOp::Increment(myNbJobsTaken) - 1;
+        if(aJobIter >= aNbJobs) {
+            return;
+        } else if(aJobIter < aNbTextures) {
+            // the rest of textures will be decoded on demand by rendering thread
+            if(myPrefetchedKiB >= THE_PREFETCH_LIMIT_KIB) {
+                continue;
+            }
+
+            const int32_t aSizeKiB = int32_t(myTextures[aJobIter]->prefetch() / 1024);
+            for(int32_t anOld = myPrefetchedKiB; !StAtomicOp::CompareAndSwap(myPrefetchedKiB, anOld, anOld + aSizeKiB); anOld = myPrefetchedKiB) {}
+        } else {
+            gltfDecodePrimArray(myPrimArrays[aJobIter - aNbTextures]);
         }
+    }
+}
+
+bool StAssetImportGltf::gltfDecodeData() {
+    const int aNbJobs    = int(myTextures.size() + myPrimArrays.size());
+    const int aNbThreads = stMin(StThread::countLogicalProcessors(), aNbJobs);
+    myNbJobsTaken   = 0;
+    myPrefetchedKiB = 0;
+
+    // calling thread decodes data as well
+    std::vector< StHandle<StThread> > aThreads;
+    for(int aThreadIter = 1; aThreadIter < aNbThreads; ++aThreadIter) {
+        aThreads.push_back(new StThread(decodeThread, (void* )this, "StAssetGltf"));
+    }
+    decodeLoop();
+    for(size_t aThreadIter = 0; aThreadIter < aThreads.size(); ++aThreadIter) {
+        aThreads[aThreadIter]->wait();
+    }
 
-        return gltfReadBuffer(thePrimArray, theName, theAccessor, aFile, theType, theMode);
+    bool isDone = true;
+    for(std::vector<GltfPrimArrayData>::const_iterator aPrimIter = myPrimArrays.begin(); aPrimIter != myPrimArrays.end(); ++aPrimIter) {
+        if(!aPrimIter->Error.isEmpty()) {
+            signals.onError(aPrimIter->Error);
+            isDone = false;
+            break;
+        }
     }
+
+    myPrimArrays.clear();
+    myTextures.clear();
+    myBuffers.Clear();
+    return isDone;
 }
 
-bool StAssetImportGltf::gltfReadBuffer(const Handle(StPrimArray)& thePrimArray,
-                                       const TCollection_AsciiString& theName,
-                                       const GltfAccessor&     theAccessor,
-                                       std::istream&           theStream,
-                                       const GltfArrayType     theType,
-                                       const GltfPrimitiveMode theMode) {
-    if(theMode != GltfPrimitiveMode_Triangles) {
-        ST_DEBUG_LOG("Buffer '" + theName.ToCString() + "' skipped unsupported primitive array.");
-        return true;
+void StAssetImportGltf::gltfDecodePrimArray(GltfPrimArrayData& thePrimData) const {
+    for(std::vector<GltfAccessorData>::const_iterator anAccessorIter = thePrimData.Accessors.begin();
+        anAccessorIter != thePrimData.Accessors.end(); ++anAccessorIter) {
+        if(!gltfDecodeAccessor(thePrimData.PrimArray, *anAccessorIter, thePrimData.Error)) {
+            return;
+        }
     }
+}
 
-    switch(theType) {
+bool StAssetImportGltf::gltfDecodeAccessor(const Handle(StPrimArray)& thePrimArray,
+                                           const GltfAccessorData& theData,
+                                           StString&               theError) const {
+    const GltfAccessor& anAccessor = theData.Accessor;
+    switch(theData.Type) {
         case GltfArrayType_Indices: {
-            if(theAccessor.Type != GltfAccessorLayout_Scalar
-            || theAccessor.Count <= 0) {
+            if(anAccessor.Type != GltfAccessorLayout_Scalar
+            || anAccessor.Count <= 0) {
                 break;
-            } else if((theAccessor.Count / 3) > std::numeric_limits<int>::max()) {
-                signals.onError(formatSyntaxError(myFileName, StString("Buffer '") + theName.ToCString() + "' defines too big array."));
+            } else if((anAccessor.Count / 3) > std::numeric_limits<int>::max()) {
+                theError = formatSyntaxError(myFileName, StString("Buffer '") + theData.Name.ToCString() + "' defines too big array.");
                 return false;
             }
 
-            const size_t aNbTris = size_t(theAccessor.Count / 3);
-            if(theAccessor.ComponentType == GltfAccessorCompType_UInt16) {
-                StVec3<uint16_t> aVec3_16u;
-                const int aNbSkipBytes = theAccessor.ByteStride != 0
-                                       ? (theAccessor.ByteStride - sizeof(uint16_t))
-                                       : 0;
-                thePrimArray->Indices.resize(aNbTris * 3);
-                for(size_t aTriIter = 0; aTriIter < aNbTris; ++aTriIter) {
-                    theStream.read((char* )&aVec3_16u[0], sizeof(uint16_t));
-                    if(aNbSkipBytes != 0) {
-                        theStream.seekg(aNbSkipBytes, std::ios_base::cur);
-                    }
-
-                    theStream.read((char* )&aVec3_16u[1], sizeof(uint16_t));
-                    if(aNbSkipBytes != 0) {
-                        theStream.seekg(aNbSkipBytes, std::ios_base::cur);
-                    }
-
-                    theStream.read((char* )&aVec3_16u[2], sizeof(uint16_t));
-                    if(aNbSkipBytes != 0) {
-                        theStream.seekg(aNbSkipBytes, std::ios_base::cur);
-                    }
-
-                    if((size_t )aVec3_16u[0] >= thePrimArray->Positions.size()
-                    || (size_t )aVec3_16u[1] >= thePrimArray->Positions.size()
-                    || (size_t )aVec3_16u[2] >= thePrimArray->Positions.size()) {
-                        signals.onError(formatSyntaxError(myFileName, StString("Buffer '") + theName.ToCString() + "' refers to invalid indices."));
-                        return false;
-                    }
-
-                    thePrimArray->Indices[aTriIter * 3 + 0] = aVec3_16u[0];
-                    thePrimArray->Indices[aTriIter * 3 + 1] = aVec3_16u[1];
-                    thePrimArray->Indices[aTriIter * 3 + 2] = aVec3_16u[2];
-                }
-            } else if(theAccessor.ComponentType == GltfAccessorCompType_UInt32) {
-                StVec3<uint32_t> aVec3_32u;
-                const int aNbSkipBytes = theAccessor.ByteStride != 0
-                                       ? (theAccessor.ByteStride - sizeof(uint32_t))
-                                       : 0;
-                thePrimArray->Indices.resize(aNbTris * 3);
-                for(size_t aTriIter = 0; aTriIter < aNbTris; ++aTriIter) {
-                    theStream.read((char* )&aVec3_32u[0], sizeof(uint32_t));
-                    if(aNbSkipBytes != 0) {
-                        theStream.seekg(aNbSkipBytes, std::ios_base::cur);
-                    }
-
-                    theStream.read((char* )&aVec3_32u[1], sizeof(uint32_t));
-                    if(aNbSkipBytes != 0) {
-                        theStream.seekg(aNbSkipBytes, std::ios_base::cur);
-                    }
-
-                    theStream.read((char* )&aVec3_32u[2], sizeof(uint32_t));
-                    if(aNbSkipBytes != 0) {
-                        theStream.seekg(aNbSkipBytes, std::ios_base::cur);
-                    }
-
-                    if((size_t )aVec3_32u[0] >= thePrimArray->Positions.size()
-                    || (size_t )aVec3_32u[1] >= thePrimArray->Positions.size()
-                    || (size_t )aVec3_32u[2] >= thePrimArray->Positions.size()) {
-                        signals.onError(formatSyntaxError(myFileName, StString("Buffer '") + theName.ToCString() + "' refers to invalid indices."));
-                        return false;
-                    }
-
-                    thePrimArray->Indices[aTriIter * 3 + 0] = aVec3_32u[0];
-                    thePrimArray->Indices[aTriIter * 3 + 1] = aVec3_32u[1];
-                    thePrimArray->Indices[aTriIter * 3 + 2] = aVec3_32u[2];
-                }
+            const size_t aNbIndices = size_t(anAccessor.Count / 3) * 3;
+            size_t anElemSize = 0;
+            if(anAccessor.ComponentType == GltfAccessorCompType_UInt16) {
+                anElemSize = sizeof(uint16_t);
+            } else if(anAccessor.ComponentType == GltfAccessorCompType_UInt32) {
+                anElemSize = sizeof(uint32_t);
             } else {
                 break;
             }
-            break;
-        }
-        case GltfArrayType_Position: {
-            if(theAccessor.ComponentType != GltfAccessorCompType_Float32
-            || theAccessor.Type != GltfAccessorLayout_Vec3) {
-                break;
-            } else if(theAccessor.Count > std::numeric_limits<int>::max()) {
-                signals.onError(formatSyntaxError(myFileName, StString("Buffer '") + theName.ToCString() + "' defines too big array."));
+
+            const size_t aStride = anAccessor.ByteStride != 0 ? size_t(anAccessor.ByteStride) : anElemSize;
+            if(!isValidRange(theData, anElemSize, aStride, aNbIndices)) {
+                theError = formatSyntaxError(myFileName, StString("Buffer '") + theData.Name.ToCString() + "' refers to invalid location.");
                 return false;
             }
 
-            const size_t aNbNodes = size_t(theAccessor.Count);
-            StGLVec4 aVec4(0.0f, 0.0f, 0.0f, 1.0f);
-            const int aNbSkipBytes = theAccessor.ByteStride != 0
-                                   ? (theAccessor.ByteStride - sizeof(StGLVec3))
-                                   : 0;
-            thePrimArray->Positions.resize(aNbNodes);
-            for(size_t aVertIter = 0; aVertIter < aNbNodes; ++aVertIter) {
-                theStream.read((char* )aVec4.getData(), sizeof(StGLVec3));
-                thePrimArray->Positions[aVertIter] = aVec4.xyz();
-                if(aNbSkipBytes != 0) {
-                    theStream.seekg(aNbSkipBytes, std::ios_base::cur);
-                }
+            thePrimArray->Indices.resize(aNbIndices);
+            const bool isValid = anElemSize == sizeof(uint16_t)
+                               ? copyIndices<uint16_t>(thePrimArray->Indices, theData.Data, aStride, thePrimArray->Positions.size())
+                               : copyIndices<uint32_t>(thePrimArray->Indices, theData.Data, aStride, thePrimArray->Positions.size());
+            if(!isValid) {
+                theError = formatSyntaxError(myFileName, StString("Buffer '") + theData.Name.ToCString() + "' refers to invalid indices.");
+                return false;
             }
-
             break;
         }
+        case GltfArrayType_Position:
         case GltfArrayType_Normal: {
-            if(theAccessor.ComponentType != GltfAccessorCompType_Float32
-            || theAccessor.Type != GltfAccessorLayout_Vec3) {
+            if(anAccessor.ComponentType != GltfAccessorCompType_Float32
+            || anAccessor.Type != GltfAccessorLayout_Vec3) {
                 break;
-            } else if(theAccessor.Count > std::numeric_limits<int>::max()) {
-                signals.onError(formatSyntaxError(myFileName, StString("Buffer '") + theName.ToCString() + "' defines too big array."));
+            } else if(anAccessor.Count > std::numeric_limits<int>::max()) {
+                theError = formatSyntaxError(myFileName, StString("Buffer '") + theData.Name.ToCString() + "' defines too big array.");
                 return false;
             }
 
-            const size_t aNbNodes = size_t(theAccessor.Count);
-            StGLVec4 aVec4(0.0f, 0.0f, 0.0f, 0.0f);
-            const int aNbSkipBytes = theAccessor.ByteStride != 0
-                                   ? (theAccessor.ByteStride - sizeof(StGLVec3))
-                                   : 0;
-            thePrimArray->Normals.resize(aNbNodes);
-            for(size_t aVertIter = 0; aVertIter < aNbNodes; ++aVertIter) {
-                theStream.read((char* )aVec4.getData(), sizeof(StGLVec3));
-                thePrimArray->Normals[aVertIter] = aVec4.xyz();
-                if(aNbSkipBytes != 0) {
-                    theStream.seekg(aNbSkipBytes, std::ios_base::cur);
-                }
+            const size_t aNbNodes = size_t(anAccessor.Count);
+            const size_t aStride  = anAccessor.ByteStride != 0 ? size_t(anAccessor.ByteStride) : sizeof(StGLVec3);
+            if(!isValidRange(theData, sizeof(StGLVec3), aStride, aNbNodes)) {
+                theError = formatSyntaxError(myFileName, StString("Buffer '") + theData.Name.ToCString() + "' refers to invalid location.");
+                return false;
             }
 
+            std::vector<StGLVec3>& anArray = theData.Type == GltfArrayType_Position
+                                           ? thePrimArray->Positions
+                                           : thePrimArray->Normals;
+            anArray.resize(aNbNodes);
+            copyStrided(anArray, theData.Data, aStride);
             break;
         }
         case GltfArrayType_TCoord0: {
-            if(theAccessor.ComponentType != GltfAccessorCompType_Float32
-            || theAccessor.Type != GltfAccessorLayout_Vec2) {
+            if(anAccessor.ComponentType != GltfAccessorCompType_Float32
+            || anAccessor.Type != GltfAccessorLayout_Vec2) {
                 break;
-            } else if(theAccessor.Count > std::numeric_limits<int>::max()) {
-                signals.onError(formatSyntaxError(myFileName, StString("Buffer '") + theName.ToCString() + "' defines too big array."));
+            } else if(anAccessor.Count > std::numeric_limits<int>::max()) {
+                theError = formatSyntaxError(myFileName, StString("Buffer '") + theData.Name.ToCString() + "' defines too big array.");
                 return false;
             }
 
-            const size_t aNbNodes = size_t(theAccessor.Count);
-            StGLVec2 aVec2(0.0f, 0.0f);
-            const int aNbSkipBytes = theAccessor.ByteStride != 0
-                                   ? (theAccessor.ByteStride - sizeof(StGLVec2))
-                                   : 0;
-            thePrimArray->TexCoords0.resize(aNbNodes);
-            for(size_t aVertIter = 0; aVertIter < aNbNodes; ++aVertIter) {
-                theStream.read((char* )aVec2.getData(), sizeof(StGLVec2));
-
-                thePrimArray->TexCoords0[aVertIter] = aVec2;
-                if(aNbSkipBytes != 0) {
-                    theStream.seekg(aNbSkipBytes, std::ios_base::cur);
-                }
+            const size_t aNbNodes = size_t(anAccessor.Count);
+            const size_t aStride  = anAccessor.ByteStride != 0 ? size_t(anAccessor.ByteStride) : sizeof(StGLVec2);
+            if(!isValidRange(theData, sizeof(StGLVec2), aStride, aNbNodes)) {
+                theError = formatSyntaxError(myFileName, StString("Buffer '") + theData.Name.ToCString() + "' refers to invalid location.");
+                return false;
             }
+
+            thePrimArray->TexCoords0.resize(aNbNodes);
+            copyStrided(thePrimArray->TexCoords0, theData.Data, aStride);
             break;
         }
         case GltfArrayType_Color:
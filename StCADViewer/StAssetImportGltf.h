@@ -11,12 +11,15 @@
 #include <rapidjson/document.h>
 #include <rapidjson/writer.h>
 #include <rapidjson/stringbuffer.h>
-#include <rapidjson/istreamwrapper.h>
+#include <rapidjson/memorystream.h>
 
 #include <StStrings/StString.h>
 #include <StFile/StFileNode.h>
+#include <StFile/StRawFile.h>
 #include <StSlots/StSignal.h>
+#include <StThreads/StThread.h>
 
+#include <NCollection_Buffer.hxx>
 #include <NCollection_DataMap.hxx>
 #include <TCollection_AsciiString.hxx>
 
@@ -152,8 +155,44 @@ struct GltfBufferView {
     GltfBufferView() : ByteOffset(0), ByteLength(0), Target(GltfBufferViewTarget_UNKNOWN) {}
 };
 
+/**
+ * Content of the buffer - either memory-mapped file or decoded base64 stream.
+ */
+struct GltfBufferData {
+    StHandle<StRawFile>        File;    //!< mapped (or read) file
+    Handle(NCollection_Buffer) Decoded; //!< decoded base64 stream
+    const stUByte_t*           Data;    //!< buffer start
+    int64_t                    Size;    //!< buffer length
+
+    GltfBufferData() : Data(NULL), Size(0) {}
+};
+
+/**
+ * Accessor pointing to the buffer data to be decoded.
+ */
+struct GltfAccessorData {
+    TCollection_AsciiString Name;     //!< accessor key for error messages
+    GltfAccessor            Accessor; //!< accessor definition
+    GltfArrayType           Type;     //!< array type
+    const stUByte_t*        Data;     //!< pointer to the first element
+    int64_t                 Size;     //!< number of bytes available starting from the first element
+
+    GltfAccessorData() : Type(GltfArrayType_UNKNOWN), Data(NULL), Size(0) {}
+};
+
+/**
+ * Primitive array with accessors to be decoded.
+ */
+struct GltfPrimArrayData {
+    Handle(StPrimArray)           PrimArray; //!< primitive array to fill in
+    std::vector<GltfAccessorData> Accessors; //!< accessors in parsing order (vertex attributes before indices)
+    StString                      Error;     //!< decoding error
+};
+
 /**
  * Tool for importing asset from GLTF file.
+ * The file is memory-mapped, the document is parsed in the calling thread,
+ * while decoding of buffers and images is postponed and distributed across working threads.
  */
 class StAssetImportGltf : public rapidjson::Document {
 
@@ -193,7 +232,8 @@ class StAssetImportGltf : public rapidjson::Document {
 
         gltfParseAsset();
         gltfParseMaterials();
-        return gltfParseScene(theParentNode);
+        return gltfParseScene(theParentNode)
+            && gltfDecodeData();
     }
 
         protected:
@@ -326,7 +366,7 @@ class StAssetImportGltf : public rapidjson::Document {
     /**
      * Parse accessor.
      */
-    bool gltfParseAccessor(const Handle(StPrimArray)& thePrimArray,
+    bool gltfParseAccessor(GltfPrimArrayData& thePrimData,
                            const TCollection_AsciiString& theName,
                            const GenericValue&     theAccessor,
                            const GltfArrayType     theType,
@@ -335,7 +375,7 @@ class StAssetImportGltf : public rapidjson::Document {
     /**
      * Parse buffer view.
      */
-    bool gltfParseBufferView(const Handle(StPrimArray)& thePrimArray,
+    bool gltfParseBufferView(GltfPrimArrayData& thePrimData,
                              const TCollection_AsciiString& theName,
                              const GenericValue&     theBufferView,
                              const GltfAccessor&     theAccessor,
@@ -345,7 +385,7 @@ class StAssetImportGltf : public rapidjson::Document {
     /**
      * Parse buffer.
      */
-    bool gltfParseBuffer(const Handle(StPrimArray)& thePrimArray,
+    bool gltfParseBuffer(GltfPrimArrayData& thePrimData,
                          const TCollection_AsciiString& theName,
                          const GenericValue&     theBuffer,
                          const GltfAccessor&     theAccessor,
@@ -354,14 +394,42 @@ class StAssetImportGltf : public rapidjson::Document {
                          const GltfPrimitiveMode theMode);
 
     /**
-     * Read buffer.
+     * Map the file or decode base64 stream defining the buffer (once per buffer).
      */
-    bool gltfReadBuffer(const Handle(StPrimArray)& thePrimArray,
+    bool gltfLoadBuffer(GltfBufferData& theData,
                         const TCollection_AsciiString& theName,
-                        const GltfAccessor&     theAccessor,
-                        std::istream&           theStream,
-                        const GltfArrayType     theType,
-                        const GltfPrimitiveMode theMode);
+                        const GenericValue& theBuffer);
+
+        protected:
+
+    /**
+     * Decode buffers of all primitive arrays and prefetch images using working threads.
+     */
+    bool gltfDecodeData();
+
+    /**
+     * Decode all accessors of the primitive array.
+     * Can be called from working thread; error is stored within GltfPrimArrayData::Error.
+     */
+    void gltfDecodePrimArray(GltfPrimArrayData& thePrimData) const;
+
+    /**
+     * Decode accessor.
+     * Can be called from working thread.
+     */
+    bool gltfDecodeAccessor(const Handle(StPrimArray)& thePrimArray,
+                            const GltfAccessorData& theData,
+                            StString&               theError) const;
+
+    /**
+     * Process decoding jobs until the queue is empty.
+     */
+    void decodeLoop();
+
+    /**
+     * Working thread function.
+     */
+    static SV_THREAD_FUNCTION decodeThread(void* theImporter);
 
 protected:
 
@@ -540,7 +608,13 @@ protected:
     NCollection_DataMap<TCollection_AsciiString, Handle(StDocObjectNode)> mySceneNodeMap;
     NCollection_DataMap<TCollection_AsciiString, Handle(StDocMeshNode)>   myMeshMap;
     NCollection_DataMap<TCollection_AsciiString, Handle(StGLMaterial)>    myMaterials;
+    NCollection_DataMap<TCollection_AsciiString, GltfBufferData>          myBuffers;      //!< loaded buffers
+    std::vector<GltfPrimArrayData>      myPrimArrays;   //!< primitive arrays to decode
+    std::vector<Handle(StAssetTexture)> myTextures;     //!< textures to prefetch
+    volatile int32_t                    myNbJobsTaken;  //!< number of decoding jobs taken by working threads
+    volatile int32_t                    myPrefetchedKiB;//!< size of images decoded in advance, in KiB
 
+    StHandle<StRawFile> myRawFile; //!< memory-mapped file, shared with textures embedded into binary body (when actually mapped)
     int64_t  myBinBodyOffset;  //!< offset to binary body
     int64_t  myBinBodyLen;     //!< binary body length
     bool     myIsBinary;       //!< binary document
@@ -1,7 +1,7 @@
 /**
  * This source is a part of sView program.
  *
- * Copyright © Kirill Gavrilov, 2016
+ * Copyright © Kirill Gavrilov, 2016-2017
  */
 
 #include "StImageOcct.h"
@@ -11,6 +11,16 @@
 #include <StFile/StMIME.h>
 
 Handle(Image_PixMap) StAssetTexture::GetImage() const {
+    if(!myPrefetched.IsNull()) {
+        // the texture is uploaded once, thus there is no need keeping decoded image
+        Handle(Image_PixMap) anImage = myPrefetched;
+        myPrefetched.Nullify();
+        return anImage;
+    }
+    return loadImage();
+}
+
+Handle(Image_PixMap) StAssetTexture::loadImage() const {
     Handle(Image_PixMap) anImage;
     {
         Handle(StImageOcct) anStImage = new StImageOcct();
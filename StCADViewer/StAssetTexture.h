@@ -1,7 +1,7 @@
 /**
  * This source is a part of sView program.
  *
- * Copyright © Kirill Gavrilov, 2016
+ * Copyright © Kirill Gavrilov, 2016-2017
  */
 
 #ifndef __StAssetTexture_h_
@@ -33,9 +33,20 @@ class StAssetTexture : public Graphic3d_Texture2Dmanual {
 
     /**
      * Image getter.
+     * Returns the image decoded by prefetch() (only once) or decodes it.
      */
     ST_LOCAL virtual Handle(Image_PixMap) GetImage() const Standard_OVERRIDE;
 
+    /**
+     * Decode the image in advance (e.g. from working thread),
+     * so that the following GetImage() call does not block rendering thread.
+     * @return size of decoded image in bytes
+     */
+    ST_LOCAL size_t prefetch() {
+        myPrefetched = loadImage();
+        return !myPrefetched.IsNull() ? myPrefetched->SizeBytes() : 0;
+    }
+
     /**
      * Compare with another texture.
      */
@@ -61,7 +72,15 @@ class StAssetTexture : public Graphic3d_Texture2Dmanual {
 
         protected:
 
-    StString myImageUri;
+    /**
+     * Decode the image.
+     */
+    ST_LOCAL virtual Handle(Image_PixMap) loadImage() const;
+
+        protected:
+
+    StString                     myImageUri;
+    mutable Handle(Image_PixMap) myPrefetched; //!< image decoded in advance, released by GetImage()
 
 };
 
@@ -16,6 +16,7 @@
 #include <StGL/StGLContext.h>
 #include <StGLStereo/StFormatEnum.h>
 #include <StFile/StFileNode.h>
+#include <StThreads/StThread.h>
 #include <StVersion.h>
 
 #include "StEventsBuffer.h"
@@ -292,6 +293,10 @@ void StApplication::beforeDraw() {
     //
 }
 
+bool StApplication::toSkipFrame() {
+    return false;
+}
+
 void StApplication::doDrawProxy(unsigned int theView) {
     stglDraw(!myWindow.isNull() && myWindow->isStereoOutput() ? theView : ST_DRAW_MONO);
 }
@@ -498,7 +503,12 @@ void StApplication::processEvents() {
 
     // draw iteration
     beforeDraw();
-    myWindow->stglDraw();
+    if(toSkipFrame()) {
+        // nothing to redraw - keep previously presented frame and just poll events
+        StThread::sleep(10);
+    } else {
+        myWindow->stglDraw();
+    }
 
     const StString aDevice = myWindow->getDeviceId();
     const int32_t  aDevNum = params.ActiveDevice->getValue();
@@ -280,6 +280,11 @@ bool StWindow::isMouseMoved() const {
     return myWin->myIsMouseMoved;
 }
 
+bool StWindow::hasDispatchedEvents() const {
+    return myWin->myHasEvents
+        || myWin->myIsMouseMoved;
+}
+
 const StHandle<StResourceManager>& StWindow::getResourceManager() const {
     return myWin->myResMgr;
 }
@@ -436,3 +441,7 @@ StQuaternion<double> StWindow::getDeviceOrientation() const {
 bool StWindow::toSwapEyesHW() const {
     return myWin->myToSwapEyesHW;
 }
+
+bool StWindow::toDrawContinuously() const {
+    return false;
+}
@@ -94,7 +94,8 @@ StWindowImpl::StWindowImpl(const StHandle<StResourceManager>& theResMgr,
   myAlignDB(0),
   myLastEventsTime(0.0),
   myEventsThreaded(false),
-  myIsMouseMoved(false) {
+  myIsMouseMoved(false),
+  myHasEvents(false) {
     stMemZero(&attribs, sizeof(attribs));
     stMemZero(&signals, sizeof(signals));
     attribs.IsNoDecor      = false;
@@ -1389,6 +1390,7 @@ void StWindowImpl::doTouch(const StTouchEvent& theTouches) {
 
 void StWindowImpl::swapEventsBuffers() {
     myEventsBuffer.swapBuffers();
+    myHasEvents = myEventsBuffer.getSize() > 0;
     for(size_t anEventIter = 0; anEventIter < myEventsBuffer.getSize(); ++anEventIter) {
         StEvent& anEvent = myEventsBuffer.changeEvent(anEventIter);
         switch(anEvent.Type) {
@@ -1456,6 +1458,7 @@ void StWindowImpl::swapEventsBuffers() {
     double aKeyTime = 0.0;
     for(int aKeyIter = 0; aKeyIter < 256; ++aKeyIter) {
         if(myKeysState.isKeyDown((StVirtKey )aKeyIter, aKeyTime)) {
+            myHasEvents = true;
             aHoldEvent.VKey     = (StVirtKey )aKeyIter;
             aHoldEvent.Duration = aHoldEvent.Time - aKeyTime;
             aHoldEvent.Progress = stMin(aHoldEvent.Time - myLastEventsTime, aHoldEvent.Duration);
@@ -484,6 +484,7 @@ class StWindowImpl {
     double         myLastEventsTime;   //!< time when processEvents() was last called
     bool           myEventsThreaded;
     bool           myIsMouseMoved;
+    bool           myHasEvents;        //!< some events have been dispatched by last swapEventsBuffers()
 
 };
 
@@ -1,6 +1,6 @@
 /**
  * StGLWidgets, small C++ toolkit for writing GUI using OpenGL.
- * Copyright © 2011-2015 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2011-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -8,6 +8,7 @@
  */
 
 #include <StGLWidgets/StGLCheckbox.h>
+#include <StGLWidgets/StGLDrawBatch.h>
 #include <StGLWidgets/StGLMenuProgram.h>
 #include <StGLWidgets/StGLRootWidget.h>
 
@@ -128,6 +129,7 @@ void StGLCheckbox::stglDraw(unsigned int theView) {
         stglResize();
     }
 
+    myRoot->getDrawBatch().flush(aCtx);
     aCtx.core20fwd->glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     aCtx.core20fwd->glEnable(GL_BLEND);
     aProgram.use(aCtx, getRoot()->getScreenDispX());
@@ -0,0 +1,268 @@
+/**
+ * StGLWidgets, small C++ toolkit for writing GUI using OpenGL.
+ * Copyright © 2017 Kirill Gavrilov <kirill@sview.ru>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file license-boost.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#include <StGLWidgets/StGLDrawBatch.h>
+
+#include <StGL/StGLContext.h>
+#include <StGL/StGLMatrix.h>
+#include <StGL/StGLProgram.h>
+#include <StGLCore/StGLCore20.h>
+
+/**
+ * GLSL program for batched primitives with per-vertex color.
+ * Solid primitives are marked by negative texture coordinates.
+ */
+class StGLDrawBatch::Program : public StGLProgram {
+
+        public:
+
+    Program() : StGLProgram("StGLDrawBatch") {}
+
+    StGLVarLocation getVVertexLoc()   const { return StGLVarLocation(0); }
+    StGLVarLocation getVTexCoordLoc() const { return StGLVarLocation(1); }
+    StGLVarLocation getVColorLoc()    const { return StGLVarLocation(2); }
+
+    void setProjMat(StGLContext&      theCtx,
+                    const StGLMatrix& theProjMat) {
+        theCtx.core20fwd->glUniformMatrix4fv(myUniformProjMat, 1, GL_FALSE, theProjMat);
+    }
+
+    virtual bool init(StGLContext& theCtx) ST_ATTR_OVERRIDE {
+        const char VERTEX_SHADER[] =
+           "uniform mat4 uProjMat;\n"
+           "attribute vec4 vVertex;\n"
+           "attribute vec2 vTexCoord;\n"
+           "attribute vec4 vColor;\n"
+           "varying vec2 fTexCoord;\n"
+           "varying vec4 fColor;\n"
+           "void main(void) {\n"
+           "    fTexCoord = vTexCoord;\n"
+           "    fColor    = vColor;\n"
+           "    gl_Position = uProjMat * vVertex;\n"
+           "}\n";
+
+        const char FRAGMENT_GET_RED[] =
+           "float getAlpha(void) { return texture2D(uTexture, fTexCoord).r; }\n";
+
+        const char FRAGMENT_GET_ALPHA[] =
+           "float getAlpha(void) { return texture2D(uTexture, fTexCoord).a; }\n";
+
+        const char FRAGMENT_SHADER[] =
+           "uniform sampler2D uTexture;\n"
+           "varying vec2 fTexCoord;\n"
+           "varying vec4 fColor;\n"
+           "float getAlpha(void);\n"
+           "void main(void) {\n"
+           "    vec4 aColor = fColor;\n"
+           "    if(fTexCoord.x >= 0.0) {\n"
+           "        aColor.a *= getAlpha();\n"
+           "    }\n"
+           "    gl_FragColor = aColor;\n"
+           "}\n";
+
+        StGLVertexShader aVertexShader(StGLProgram::getTitle());
+        aVertexShader.init(theCtx, VERTEX_SHADER);
+        StGLAutoRelease aTmp1(theCtx, aVertexShader);
+
+        StGLFragmentShader aFragmentShader(StGLProgram::getTitle());
+        aFragmentShader.init(theCtx, FRAGMENT_SHADER,
+                             theCtx.arbTexRG ? FRAGMENT_GET_RED : FRAGMENT_GET_ALPHA);
+        StGLAutoRelease aTmp2(theCtx, aFragmentShader);
+        if(!StGLProgram::create(theCtx)
+           .attachShader(theCtx, aVertexShader)
+           .attachShader(theCtx, aFragmentShader)
+           .bindAttribLocation(theCtx, "vVertex",   getVVertexLoc())
+           .bindAttribLocation(theCtx, "vTexCoord", getVTexCoordLoc())
+           .bindAttribLocation(theCtx, "vColor",    getVColorLoc())
+           .link(theCtx)) {
+            return false;
+        }
+
+        myUniformProjMat = StGLProgram::getUniformLocation(theCtx, "uProjMat");
+        StGLVarLocation aUniformTexture = StGLProgram::getUniformLocation(theCtx, "uTexture");
+        if(aUniformTexture.isValid()) {
+            StGLProgram::use(theCtx);
+            theCtx.core20fwd->glUniform1i(aUniformTexture, StGLProgram::TEXTURE_SAMPLE_0);
+            StGLProgram::unuse(theCtx);
+        }
+        return myUniformProjMat.isValid()
+            && aUniformTexture.isValid();
+    }
+
+        private:
+
+    StGLVarLocation myUniformProjMat; //!< location of uniform variable of projection matrix
+
+};
+
+StGLDrawBatch::StGLDrawBatch()
+: myProgram(new Program()),
+  myNbLayers(0),
+  myIsValid(false) {
+    //
+}
+
+StGLDrawBatch::~StGLDrawBatch() {
+    //
+}
+
+void StGLDrawBatch::release(StGLContext& theCtx) {
+    myProgram->release(theCtx);
+    myVertBuf .release(theCtx);
+    myTCrdBuf .release(theCtx);
+    myColorBuf.release(theCtx);
+    myVerts   .clear();
+    myTCrds   .clear();
+    myColors  .clear();
+    myCommands.clear();
+    myIsValid = false;
+}
+
+bool StGLDrawBatch::init(StGLContext& theCtx) {
+    if(!myProgram->isValid()
+    && !myProgram->init(theCtx)) {
+        myIsValid = false;
+        return false;
+    }
+
+    myIsValid = myVertBuf .init(theCtx)
+             && myTCrdBuf .init(theCtx)
+             && myColorBuf.init(theCtx);
+    return myIsValid;
+}
+
+void StGLDrawBatch::setProjMat(StGLContext&      theCtx,
+                               const StGLMatrix& theProjMat) {
+    if(!myIsValid) {
+        return;
+    }
+
+    myProgram->use(theCtx);
+    myProgram->setProjMat(theCtx, theProjMat);
+    myProgram->unuse(theCtx);
+}
+
+void StGLDrawBatch::begin(StGLContext& theCtx) {
+    flush(theCtx);
+    ++myNbLayers;
+}
+
+void StGLDrawBatch::end(StGLContext& theCtx) {
+    flush(theCtx);
+    if(myNbLayers > 0) {
+        --myNbLayers;
+    }
+}
+
+void StGLDrawBatch::addCommand(const GLuint theTexture,
+                               const size_t theFirst) {
+    const GLsizei aCount = GLsizei(myVerts.size() - theFirst);
+    if(!myCommands.empty()) {
+        Command& aLast = myCommands.back();
+        if(theTexture == 0
+        || aLast.Texture == 0
+        || aLast.Texture == theTexture) {
+            if(theTexture != 0) {
+                aLast.Texture = theTexture;
+            }
+            aLast.Count += aCount;
+            return;
+        }
+    }
+
+    Command aCmd;
+    aCmd.Texture = theTexture;
+    aCmd.First   = GLsizei(theFirst);
+    aCmd.Count   = aCount;
+    myCommands.push_back(aCmd);
+}
+
+void StGLDrawBatch::addSolid(const StGLVec2*  theStrip,
+                             const size_t     theNbVerts,
+                             const StGLVec4&  theColor,
+                             const StGLVec3&  theTranslation) {
+    if(theNbVerts < 3) {
+        return;
+    }
+
+    const size_t   aFirst = myVerts.size();
+    const StGLVec2 aSolidTCrd(-1.0f, -1.0f);
+    for(size_t aVertIter = 2; aVertIter < theNbVerts; ++aVertIter) {
+        // convert triangle strip into the list of triangles
+        const size_t anIndices[3] = { aVertIter - 2, aVertIter - 1, aVertIter };
+        for(size_t anIdxIter = 0; anIdxIter < 3; ++anIdxIter) {
+            const StGLVec2& aVert = theStrip[anIndices[anIdxIter]];
+            myVerts .push_back(StGLVec3(theTranslation.x() + aVert.x(),
+                                        theTranslation.y() + aVert.y(),
+                                        theTranslation.z()));
+            myTCrds .push_back(aSolidTCrd);
+            myColors.push_back(theColor);
+        }
+    }
+    addCommand(0, aFirst);
+}
+
+void StGLDrawBatch::addGlyphs(const GLuint                 theTexture,
+                              const std::vector<StGLVec2>& theVerts,
+                              const std::vector<StGLVec2>& theTCrds,
+                              const StGLVec4&              theColor,
+                              const StGLVec3&              theTranslation,
+                              const GLfloat                theScale) {
+    if(theVerts.empty()
+    || theVerts.size() != theTCrds.size()) {
+        return;
+    }
+
+    const size_t aFirst = myVerts.size();
+    for(size_t aVertIter = 0; aVertIter < theVerts.size(); ++aVertIter) {
+        const StGLVec2& aVert = theVerts[aVertIter];
+        myVerts .push_back(StGLVec3(theTranslation.x() + aVert.x() * theScale,
+                                    theTranslation.y() + aVert.y() * theScale,
+                                    theTranslation.z()));
+        myTCrds .push_back(theTCrds[aVertIter]);
+        myColors.push_back(theColor);
+    }
+    addCommand(theTexture, aFirst);
+}
+
+void StGLDrawBatch::flush(StGLContext& theCtx) {
+    if(myCommands.empty()) {
+        return;
+    }
+
+    myVertBuf .init(theCtx, myVerts);
+    myTCrdBuf .init(theCtx, myTCrds);
+    myColorBuf.init(theCtx, myColors);
+
+    theCtx.core20fwd->glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    theCtx.core20fwd->glEnable(GL_BLEND);
+    theCtx.core20fwd->glActiveTexture(GL_TEXTURE0);
+
+    myProgram->use(theCtx);
+    myVertBuf .bindVertexAttrib(theCtx, myProgram->getVVertexLoc());
+    myTCrdBuf .bindVertexAttrib(theCtx, myProgram->getVTexCoordLoc());
+    myColorBuf.bindVertexAttrib(theCtx, myProgram->getVColorLoc());
+    for(std::vector<Command>::const_iterator aCmdIter = myCommands.begin(); aCmdIter != myCommands.end(); ++aCmdIter) {
+        theCtx.core20fwd->glBindTexture(GL_TEXTURE_2D, aCmdIter->Texture);
+        theCtx.core20fwd->glDrawArrays(GL_TRIANGLES, aCmdIter->First, aCmdIter->Count);
+    }
+    myColorBuf.unBindVertexAttrib(theCtx, myProgram->getVColorLoc());
+    myTCrdBuf .unBindVertexAttrib(theCtx, myProgram->getVTexCoordLoc());
+    myVertBuf .unBindVertexAttrib(theCtx, myProgram->getVVertexLoc());
+    myProgram->unuse(theCtx);
+
+    theCtx.core20fwd->glBindTexture(GL_TEXTURE_2D, 0);
+    theCtx.core20fwd->glDisable(GL_BLEND);
+
+    // keep allocated memory for the next frame
+    myVerts   .clear();
+    myTCrds   .clear();
+    myColors  .clear();
+    myCommands.clear();
+}
@@ -1,6 +1,6 @@
 /**
  * StGLWidgets, small C++ toolkit for writing GUI using OpenGL.
- * Copyright © 2013-2015 Kirill Gavrilov <kirill@sview.ru
+ * Copyright © 2013-2017 Kirill Gavrilov <kirill@sview.ru
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -23,6 +23,7 @@ StGLFpsLabel::StGLFpsLabel(StGLWidget* theParent)
   myPlayFps(-1.0),
   myPlayQueued(0),
   myPlayQueueLen(0),
+  myLatency(NULL),
   myTimer(true),
   myCounter(0) {
     StGLWidget::signals.onMouseUnclick.connect(this, &StGLFpsLabel::doMouseUnclick);
@@ -63,6 +64,18 @@ void StGLFpsLabel::update(const bool      theIsStereo,
                   myPlayQueued, myPlayQueueLen, myPlayFps);
     }
     StString aText(aBuffer);
+
+    double aTotalAver = 0.0, aTotalMax = 0.0;
+    if(myPlayFps > 0.0
+    && myLatency != NULL
+    && myLatency->getStats(StLatencyMeter::Stage_Total, aTotalAver, aTotalMax)) {
+        double aDecAver = 0.0, anUpAver = 0.0, aDummy = 0.0;
+        myLatency->getStats(StLatencyMeter::Stage_Decode, aDecAver, aDummy);
+        myLatency->getStats(StLatencyMeter::Stage_Upload, anUpAver, aDummy);
+        stsprintf(aBuffer, 128, "\ndec %4.1f up %4.1f\nlat %4.0f (%4.0f)",
+                  aDecAver, anUpAver, aTotalAver, aTotalMax);
+        aText += aBuffer;
+    }
     if(!theExtraInfo.isEmpty()) {
         aText += "\n";
         aText += theExtraInfo;
@@ -195,6 +195,14 @@ StGLImageProgram::StGLImageProgram()
         + "const float TheRangeBits = 65535.0 / 1023.0;\n"
         + F_SHADER_YUV2RGB_MPEG);
 
+    regToRgb(FragToRgb_FromYuv12Full, StString()
+        + "const float TheRangeBits = 65535.0 / 4095.0;\n"
+        + F_SHADER_YUV2RGB_FULL);
+
+    regToRgb(FragToRgb_FromYuv12Mpeg, StString()
+        + "const float TheRangeBits = 65535.0 / 4095.0;\n"
+        + F_SHADER_YUV2RGB_MPEG);
+
     regToRgb(FragToRgb_FromYuvNvFull, StString()
         + "const float TheRangeBits = 1.0;\n"
         + F_SHADER_YUVNV2RGB_FULL);
@@ -345,8 +353,10 @@ static inline StGLImageProgram::FragToRgb getColorShader(const StImage::ImgColor
             switch(theColorScale) {
                 case StImage::ImgScale_Mpeg9:  return StGLImageProgram::FragToRgb_FromYuv9Mpeg;
                 case StImage::ImgScale_Mpeg10: return StGLImageProgram::FragToRgb_FromYuv10Mpeg;
+                case StImage::ImgScale_Mpeg12: return StGLImageProgram::FragToRgb_FromYuv12Mpeg;
                 case StImage::ImgScale_Jpeg9:  return StGLImageProgram::FragToRgb_FromYuv9Full;
                 case StImage::ImgScale_Jpeg10: return StGLImageProgram::FragToRgb_FromYuv10Full;
+                case StImage::ImgScale_Jpeg12: return StGLImageProgram::FragToRgb_FromYuv12Full;
                 case StImage::ImgScale_Mpeg:   return StGLImageProgram::FragToRgb_FromYuvMpeg;
                 case StImage::ImgScale_Full:   return StGLImageProgram::FragToRgb_FromYuvFull;
                 case StImage::ImgScale_NvMpeg: return StGLImageProgram::FragToRgb_FromYuvNvMpeg;
@@ -392,7 +392,7 @@ StGLImageRegion::StGLImageRegion(StGLWidget* theParent,
 StGLImageRegion::~StGLImageRegion() {
     // make sure GL objects are released within GL thread
     StGLContext& aCtx = getContext();
-    myTextureQueue->getQTexture().release(aCtx);
+    myTextureQueue->release(aCtx);
     myQuad.release(aCtx);
     myUVSphere.release(aCtx);
     myUVHemiSphere.release(aCtx);
@@ -1,6 +1,6 @@
 /**
  * StGLWidgets, small C++ toolkit for writing GUI using OpenGL.
- * Copyright © 2009-2016 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2009-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -9,6 +9,7 @@
 
 #include <StGLWidgets/StGLMenu.h>
 
+#include <StGLWidgets/StGLDrawBatch.h>
 #include <StGLWidgets/StGLMenuCheckbox.h>
 #include <StGLWidgets/StGLMenuItem.h>
 #include <StGLWidgets/StGLMenuProgram.h>
@@ -46,6 +47,8 @@ StGLMenu::StGLMenu(StGLWidget* theParent,
              StGLCorner(ST_VCORNER_TOP, ST_HCORNER_LEFT),
              theParent->getRoot()->scale(32),
              theParent->getRoot()->scale(32)),
+  myVertices(4),
+  myVerticesBnd(4),
   myColorVec(getRoot()->getColorForElement(StGLRootWidget::Color_Menu)),
   myOrient(theOrient),
   myItemHeight(theParent->getRoot()->scale(theParent->getRoot()->isMobile() ? 40 : 32)),
@@ -92,9 +95,8 @@ void StGLMenu::stglResize() {
 
     StGLContext& aCtx = getContext();
 
-    StArray<StGLVec2> aVertices(4);
-    getRectGl(aVertices);
-    myVertexBuf.init(aCtx, aVertices);
+    getRectGl(myVertices);
+    myVertexBuf.init(aCtx, myVertices);
 
     if(myToDrawBounds) {
         StRectI_t aRectBnd = getRectPxAbsolute();
@@ -102,8 +104,8 @@ void StGLMenu::stglResize() {
         aRectBnd.right()  += 1;
         aRectBnd.top()    -= 1;
         aRectBnd.bottom() += 1;
-        myRoot->getRectGl(aRectBnd, aVertices);
-        myVertexBndBuf.init(aCtx, aVertices);
+        myRoot->getRectGl(aRectBnd, myVerticesBnd);
+        myVertexBndBuf.init(aCtx, myVerticesBnd);
     }
     myIsResized = false;
 }
@@ -191,28 +193,40 @@ void StGLMenu::stglDraw(unsigned int theView) {
         stglResize();
     }
 
-    StGLContext& aCtx = getContext();
-    aCtx.core20fwd->glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    aCtx.core20fwd->glEnable(GL_BLEND);
-
-    StGLMenuProgram& aProgram = myRoot->getMenuProgram();
-    if(myVertexBndBuf.isValid()) {
-        aProgram.use(aCtx, StGLVec4(0.0f, 0.0f, 0.0f, 1.0f), myOpacity, myRoot->getScreenDispX());
-        myVertexBndBuf.bindVertexAttrib  (aCtx, aProgram.getVVertexLoc());
-        aCtx.core20fwd->glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-        myVertexBndBuf.unBindVertexAttrib(aCtx, aProgram.getVVertexLoc());
-    }
+    // menu background, items areas and labels are collected into single batch
+    StGLContext&   aCtx   = getContext();
+    StGLDrawBatch& aBatch = myRoot->getDrawBatch();
+    aBatch.begin(aCtx);
+    if(aBatch.isActive()) {
+        const StGLVec3 aTrsl(myRoot->getScreenDispX(), 0.0f, -getCamera()->getZScreen());
+        if(myVertexBndBuf.isValid()) {
+            aBatch.addSolid(&myVerticesBnd.getFirst(), 4, StGLVec4(0.0f, 0.0f, 0.0f, myOpacity), aTrsl);
+        }
+        aBatch.addSolid(&myVertices.getFirst(), 4, StGLVec4(myColorVec.rgb(), myColorVec.a() * myOpacity), aTrsl);
+    } else {
+        aCtx.core20fwd->glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        aCtx.core20fwd->glEnable(GL_BLEND);
+
+        StGLMenuProgram& aProgram = myRoot->getMenuProgram();
+        if(myVertexBndBuf.isValid()) {
+            aProgram.use(aCtx, StGLVec4(0.0f, 0.0f, 0.0f, 1.0f), myOpacity, myRoot->getScreenDispX());
+            myVertexBndBuf.bindVertexAttrib  (aCtx, aProgram.getVVertexLoc());
+            aCtx.core20fwd->glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+            myVertexBndBuf.unBindVertexAttrib(aCtx, aProgram.getVVertexLoc());
+        }
 
-    aProgram.use(aCtx, myColorVec, myOpacity, myRoot->getScreenDispX());
+        aProgram.use(aCtx, myColorVec, myOpacity, myRoot->getScreenDispX());
 
-    myVertexBuf.bindVertexAttrib  (aCtx, aProgram.getVVertexLoc());
-    aCtx.core20fwd->glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-    myVertexBuf.unBindVertexAttrib(aCtx, aProgram.getVVertexLoc());
+        myVertexBuf.bindVertexAttrib  (aCtx, aProgram.getVVertexLoc());
+        aCtx.core20fwd->glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        myVertexBuf.unBindVertexAttrib(aCtx, aProgram.getVVertexLoc());
 
-    aProgram.unuse(aCtx);
-    aCtx.core20fwd->glDisable(GL_BLEND);
+        aProgram.unuse(aCtx);
+        aCtx.core20fwd->glDisable(GL_BLEND);
+    }
 
     StGLWidget::stglDraw(theView);
+    aBatch.end(aCtx);
 }
 
 bool StGLMenu::doKeyDown(const StKeyEvent& theEvent) {
@@ -1,12 +1,13 @@
 /**
  * StGLWidgets, small C++ toolkit for writing GUI using OpenGL.
- * Copyright © 2009-2015 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2009-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
  * http://www.boost.org/LICENSE_1_0.txt
  */
 
+#include <StGLWidgets/StGLDrawBatch.h>
 #include <StGLWidgets/StGLMenu.h>
 #include <StGLWidgets/StGLMenuItem.h>
 #include <StGLWidgets/StGLMenuProgram.h>
@@ -38,6 +39,7 @@ StGLMenuItem::StGLMenuItem(StGLMenu* theParent,
                theParent->getItemHeight()),
   mySubMenu(theSubMenu),
   myIcon(NULL),
+  myBackVertices(4),
   myArrowIcon(Arrow_None),
   myIsItemSelected(false),
   myToHilightText(false) {
@@ -150,6 +152,7 @@ void StGLMenuItem::stglResize() {
         }
     }
     myBackVertexBuf.init(aCtx, aVertices);
+    myBackVertices = aVertices;
 
     StGLTextArea::stglResize();
 }
@@ -197,6 +200,19 @@ bool StGLMenuItem::stglInit() {
 
 void StGLMenuItem::stglDrawArea(const StGLMenuItem::State theState,
                                 const bool                theIsOnlyArrow) {
+    StGLDrawBatch& aBatch = myRoot->getDrawBatch();
+    if(aBatch.isActive()) {
+        const StGLVec3 aTrsl(getRoot()->getScreenDispX(), 0.0f, -getCamera()->getZScreen());
+        if(!theIsOnlyArrow) {
+            const StGLVec4& aColor = myBackColor[theState];
+            aBatch.addSolid(&myBackVertices.getFirst(), 4, StGLVec4(aColor.rgb(), aColor.a() * myOpacity), aTrsl);
+        }
+        if(myArrowIcon != Arrow_None) {
+            aBatch.addSolid(&myBackVertices.getValue(4), 3, StGLVec4(myTextColor.rgb(), myTextColor.a() * myOpacity * 0.5f), aTrsl);
+        }
+        return;
+    }
+
     StGLContext& aCtx = getContext();
     aCtx.core20fwd->glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     aCtx.core20fwd->glEnable(GL_BLEND);
@@ -254,6 +270,9 @@ void StGLMenuItem::stglDraw(unsigned int theView) {
 }
 
 void StGLMenuItem::setSelected(bool theToSelect) {
+    if(myIsItemSelected != theToSelect) {
+        invalidate();
+    }
     if(theToSelect) {
         for(StGLWidget* aChild = getParent()->getChildren()->getStart(); aChild != NULL; aChild = aChild->getNext()) {
             if(aChild != this) {
@@ -268,6 +287,9 @@ void StGLMenuItem::setSelected(bool theToSelect) {
 }
 
 void StGLMenuItem::setFocus(const bool theValue) {
+    if(myHasFocus != theValue) {
+        invalidate();
+    }
     myHasFocus = theValue;
 }
 
@@ -13,6 +13,7 @@
 #include <StGLWidgets/StGLMenuItem.h>
 #include <StGLWidgets/StGLScrollArea.h>
 #include <StGLWidgets/StGLTextureButton.h>
+#include <StGLWidgets/StGLThumbnail.h>
 
 #include <fstream>
 
@@ -34,7 +35,8 @@ StGLOpenFile::StGLOpenFile(StGLWidget*     theParent,
   myHotColor      (1.0f, 1.0f, 1.0f, 1.0f),
   myHotSizeX (theParent->getRoot()->scale(10)),
   myMarginX  (theParent->getRoot()->scale(8)),
-  myIconSizeX(theParent->getRoot()->scale(16)) {
+  myIconSizeX(theParent->getRoot()->scale(16)),
+  myThumbSizeX(0) {
     myToAdjustY = false;
 
     int aMarginTop = myMarginTop + myRoot->scale(30);
@@ -58,6 +60,7 @@ StGLOpenFile::StGLOpenFile(StGLWidget*     theParent,
     myList->setOpacity(1.0f, true);
     myList->setColor(StGLVec4(0.0f, 0.0f, 0.0f, 0.0f));
     myList->setItemWidthMin(myContent->getRectPx().width());
+    myThumbSizeX = stMax(myList->getItemHeight() - myRoot->scale(4), myIconSizeX);
 
     //if(!myRoot->isMobile()) {
         addButton(theCloseText);
@@ -250,6 +253,29 @@ void StGLOpenFile::setItemIcon(StGLMenuItem*   theItem,
     theItem->setIcon(anIcon);
 }
 
+void StGLOpenFile::setItemThumbnail(StGLMenuItem*     theItem,
+                                    const StGLVec4&   theColor,
+                                    const StFileNode* theNode) {
+    setItemIcon(theItem, theColor, theNode->isFolder());
+    if(theItem == NULL
+    || theItem->getIcon() == NULL) {
+        return;
+    }
+
+    // align labels of folders and files
+    theItem->changeMargins().left = myMarginX + myThumbSizeX + myMarginX;
+    if(theNode->isFolder()) {
+        theItem->getIcon()->changeRectPx().moveLeftTo(myMarginX + (myThumbSizeX - myIconSizeX) / 2);
+        return;
+    }
+
+    StGLThumbnail* aThumb = new StGLThumbnail(theItem, myMarginX, 0, StGLCorner(ST_VCORNER_CENTER, ST_HCORNER_LEFT), myThumbSizeX);
+    aThumb->setColor(theColor);
+    aThumb->setFallbackTextures(myTextureFile);
+    aThumb->setPath(theNode->getPath());
+    theItem->setIcon(aThumb);
+}
+
 void StGLOpenFile::openFolder(const StString& theFolder) {
     myItemToLoad.clear();
     myList->destroyChildren();
@@ -274,7 +300,7 @@ void StGLOpenFile::openFolder(const StString& theFolder) {
         anUpItem->setText("..");
         anUpItem->setTextColor(myItemColor);
         anUpItem->setHilightColor(myHighlightColor);
-        anUpItem->changeMargins().left = myMarginX + myIconSizeX + myMarginX;
+        anUpItem->changeMargins().left = myMarginX + myThumbSizeX + myMarginX;
         anUpItem->signals.onItemClick = stSlot(this, &StGLOpenFile::doFolderUpClick);
     }
 
@@ -283,7 +309,7 @@ void StGLOpenFile::openFolder(const StString& theFolder) {
         const StFileNode* aNode = myFolder->getValue(anItemIter);
         StString aName = aNode->getSubPath();
         StGLMenuItem* anItem = new StGLPassiveMenuItem(myList);
-        setItemIcon(anItem, aNode->isFolder() ? myItemColor : myFileColor, aNode->isFolder());
+        setItemThumbnail(anItem, aNode->isFolder() ? myItemColor : myFileColor, aNode);
         anItem->setText(aName);
         anItem->setTextColor(myItemColor);
         anItem->setHilightColor(myHighlightColor);
@@ -1,6 +1,6 @@
 /**
  * StGLWidgets, small C++ toolkit for writing GUI using OpenGL.
- * Copyright © 2013-2015 Kirill Gavrilov <kirill@sview.ru
+ * Copyright © 2013-2017 Kirill Gavrilov <kirill@sview.ru
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -12,6 +12,7 @@
 #include <StGLWidgets/StGLMenuItem.h>
 #include <StGLWidgets/StGLMenuProgram.h>
 #include <StGLWidgets/StGLRootWidget.h>
+#include <StGLWidgets/StGLThumbnail.h>
 
 #include <StCore/StEvent.h>
 #include <StGL/StGLContext.h>
@@ -27,6 +28,7 @@ StGLPlayList::StGLPlayList(StGLWidget*                 theParent,
   myItemsNb(0),
   myToResetList(false),
   myToUpdateList(false),
+  myToShowThumbs(false),
   myIsLeftClick(false),
   myDragDone(0),
   myFlingAccel((double )myRoot->scale(200)),
@@ -52,9 +54,23 @@ StGLPlayList::~StGLPlayList() {
 
 StGLMenuItem* StGLPlayList::addItem() {
     StGLMenuItem* aNewItem = new StGLPassiveMenuItem(myMenu);
+    if(myToShowThumbs) {
+        const int aMargin = myRoot->scale(4);
+        const int aSize   = myMenu->getItemHeight() - aMargin;
+        aNewItem->setIcon(new StGLThumbnail(aNewItem, aMargin, 0, StGLCorner(ST_VCORNER_CENTER, ST_HCORNER_LEFT), aSize));
+        aNewItem->changeMargins().left = aMargin + aSize + aMargin;
+    }
     return aNewItem;
 }
 
+void StGLPlayList::setItemPath(StGLMenuItem*   theItem,
+                               const StString& thePath) {
+    StGLThumbnail* aThumb = myToShowThumbs ? dynamic_cast<StGLThumbnail*>(theItem->getIcon()) : NULL;
+    if(aThumb != NULL) {
+        aThumb->setPath(thePath);
+    }
+}
+
 void StGLPlayList::doItemClick(const size_t theItem) {
     if(myList->walkToPosition(myFromId + theItem)) {
         signals.onOpenItem();
@@ -62,8 +78,8 @@ void StGLPlayList::doItemClick(const size_t theItem) {
 }
 
 void StGLPlayList::updateList() {
-    StArrayList<StString> aList;
-    myList->getSubList(aList, myFromId, myFromId + myItemsNb);
+    StArrayList<StString> aList, aPaths;
+    myList->getSubList(aList, aPaths, myFromId, myFromId + myItemsNb);
     const size_t aCurrent     = myList->getCurrentId() - myFromId;
     const size_t anUpperLimit = aList.size();
 
@@ -74,11 +90,13 @@ void StGLPlayList::updateList() {
         anItem->setClicked(ST_MOUSE_LEFT, false);
         if(size_t(anIter) < anUpperLimit) {
             anItem->setText(aList.getValue(anIter));
+            setItemPath(anItem, aPaths.getValue(anIter));
             anItem->setOpacity(1.0f, false);
             anItem->setFocus(size_t(anIter) == aCurrent);
             anItem->changeRectPx().right() = anItem->getRectPx().left() + myMenu->getItemWidth();
         } else {
             anItem->setText("");
+            setItemPath(anItem, StString());
             anItem->setOpacity(0.0f, false);
             //anItem->changeRectPx().right() = anItem->getRectPx().left();
         }
@@ -152,8 +170,8 @@ void StGLPlayList::stglResize() {
     const int anItemsOld = myItemsNb;
     myItemsNb = stMax(aNewHeight / myMenu->getItemHeight(), 0);
 
-    StArrayList<StString> aList;
-    myList->getSubList(aList, myFromId, myFromId + myItemsNb);
+    StArrayList<StString> aList, aPaths;
+    myList->getSubList(aList, aPaths, myFromId, myFromId + myItemsNb);
     const size_t anUpperLimit = aList.size();
 
     for(int anIter = anItemsOld; anIter > myItemsNb; --anIter) {
@@ -175,6 +193,7 @@ void StGLPlayList::stglResize() {
 
         if(size_t(anIter) < anUpperLimit) {
             anItem->setText(aList.getValue(anIter));
+            setItemPath(anItem, aPaths.getValue(anIter));
             anItem->setOpacity(1.0f, false);
         }
     }
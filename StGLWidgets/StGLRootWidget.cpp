@@ -9,6 +9,7 @@
 
 #include <StGLWidgets/StGLRootWidget.h>
 
+#include <StGLWidgets/StGLDrawBatch.h>
 #include <StGLWidgets/StGLMenuProgram.h>
 #include <StGLWidgets/StGLMessageBox.h>
 #include <StGLWidgets/StGLTextProgram.h>
@@ -18,6 +19,7 @@
 #include <StGL/StGLContext.h>
 #include <StGLCore/StGLCore20.h>
 #include <StFile/StFileNode.h>
+#include <StFile/StFolder.h>
 
 namespace {
 
@@ -56,6 +58,7 @@ StGLRootWidget::StGLRootWidget(const StHandle<StResourceManager>& theResMgr)
   myMenuProgram(new StGLMenuProgram()),
   myTextProgram(new StGLTextProgram()),
   myTextBorderProgram(new StGLTextBorderProgram()),
+  myDrawBatch(new StGLDrawBatch()),
   myIsMobile(false),
   myScaleGlX(1.0),
   myScaleGlY(1.0),
@@ -65,6 +68,7 @@ StGLRootWidget::StGLRootWidget(const StHandle<StResourceManager>& theResMgr)
   myFocusWidget(NULL),
   myModalDialog(NULL),
   myIsMenuPressed(false),
+  myIsDirty(true),
   myMenuIconSize(IconSize_16),
   myClickThreshold(3) {
     myRectPxFull = getRectPx();
@@ -81,6 +85,12 @@ StGLRootWidget::StGLRootWidget(const StHandle<StResourceManager>& theResMgr)
         myShareArray[aResId] = new StGLSharePointer();
     }
     myGlFontMgr = new StGLFontManager(myResolution);
+    if(!myResMgr.isNull()
+    && !myResMgr->getCacheFolder().isEmpty()) {
+        const StString aFontsCache = myResMgr->getCacheFolder() + "fonts" + SYS_FS_SPLITTER;
+        StFolder::createFolder(aFontsCache);
+        myGlFontMgr->setCacheFolder(aFontsCache);
+    }
 
     myColors[Color_Menu]            = StGLVec4(0.855f, 0.855f, 0.855f, 1.0f);
     myColors[Color_MenuHighlighted] = StGLVec4(0.765f, 0.765f, 0.765f, 1.0f);
@@ -111,6 +121,8 @@ StGLRootWidget::~StGLRootWidget() {
         myTextProgram.nullify();
         myTextBorderProgram->release(*myGlCtx);
         myTextBorderProgram.nullify();
+        myDrawBatch->release(*myGlCtx);
+        myDrawBatch.nullify();
         if(!myCheckboxIcon.isNull()) {
             for(size_t aTexIter = 0; aTexIter < myCheckboxIcon->size(); ++aTexIter) {
                 myCheckboxIcon->changeValue(aTexIter).release(*myGlCtx);
@@ -140,6 +152,13 @@ void StGLRootWidget::setContext(const StHandle<StGLContext>& theCtx) {
     myGlCtx = theCtx;
 }
 
+const StHandle<StThumbnailCache>& StGLRootWidget::getThumbnails() {
+    if(myThumbnails.isNull()) {
+        myThumbnails = new StThumbnailCache(!myResMgr.isNull() ? myResMgr->getCacheFolder() : StString());
+    }
+    return myThumbnails;
+}
+
 void StGLRootWidget::setupTextures() {
     const IconSize anIconSize = scaleIcon(16);
     myIcons[IconImage_CheckboxOff]    = iconTexture(StString("textures" ST_FILE_SPLITTER) + "checkboxOff",    anIconSize);
@@ -256,6 +275,11 @@ bool StGLRootWidget::stglInit() {
         return false;
     }
 
+    // widgets are drawn directly when batching is unavailable
+    if(!myDrawBatch->init(*myGlCtx)) {
+        ST_DEBUG_LOG("StGLRootWidget, batched drawing of widgets is unavailable");
+    }
+
     return StGLWidget::stglInit();
 }
 
@@ -289,6 +313,7 @@ void StGLRootWidget::stglDraw(unsigned int theView) {
         myTextBorderProgram->setProjMat(*myGlCtx, myProjCamera.getProjMatrix());
         myTextBorderProgram->unuse(*myGlCtx);
     }
+    myDrawBatch->setProjMat(*myGlCtx, myProjCamera.getProjMatrix());
 
     StGLWidget::stglDraw(theView);
 }
@@ -310,6 +335,9 @@ StGLSharePointer* StGLRootWidget::getShare(const size_t theResId) {
 
 void StGLRootWidget::stglUpdate(const StPointD_t& theCursorZo,
                                 bool theIsPreciseInput) {
+    // widgets changed within this update will request the next frame
+    myIsDirty = myCursorZo != theCursorZo
+             || !myDestroyList.isEmpty();
     myCursorZo = theCursorZo;
     StGLWidget::stglUpdate(theCursorZo, theIsPreciseInput);
 }
@@ -485,6 +513,7 @@ void StGLRootWidget::destroyWithDelay(StGLWidget* theWidget) {
         }
     }
     myDestroyList.add(theWidget);
+    myIsDirty = true;
 }
 
 void StGLRootWidget::clearDestroyList() {
@@ -1,6 +1,6 @@
 /**
  * StGLWidgets, small C++ toolkit for writing GUI using OpenGL.
- * Copyright © 2009-2016 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2009-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -95,6 +95,88 @@ class StGLSeekBar::StProgramSB : public StGLProgram {
 
 };
 
+/**
+ * GLSL program for thumbnail preview.
+ */
+class StGLSeekBar::StProgramThumb : public StGLProgram {
+
+        public:
+
+    StProgramThumb() : StGLProgram("StGLSeekBar::Thumb") {}
+
+    StGLVarLocation getVVertexLoc()   const { return StGLVarLocation(0); }
+    StGLVarLocation getVTexCoordLoc() const { return StGLVarLocation(1); }
+
+    void setProjMat(StGLContext&      theCtx,
+                    const StGLMatrix& theProjMat) {
+        theCtx.core20fwd->glUniformMatrix4fv(uniProjMatLoc, 1, GL_FALSE, theProjMat);
+    }
+
+    using StGLProgram::use;
+    void use(StGLContext&  theCtx,
+             const GLfloat theOpacityValue,
+             const GLfloat theDispX) {
+        StGLProgram::use(theCtx);
+        theCtx.core20fwd->glUniform1f(uniOpacityLoc, theOpacityValue);
+        theCtx.core20fwd->glUniform4fv(uniDispLoc,  1, StGLVec4(theDispX, 0.0f, 0.0f, 0.0f));
+    }
+
+    virtual bool init(StGLContext& theCtx) ST_ATTR_OVERRIDE {
+        const char VERTEX_SHADER[] =
+           "uniform mat4  uProjMatrix;\n"
+           "uniform vec4  uDisp;\n"
+           "attribute vec4 vVertex;\n"
+           "attribute vec2 vTexCoord;\n"
+           "varying vec2 fTexCoord;\n"
+           "void main(void) {\n"
+           "    fTexCoord = vTexCoord;\n"
+           "    gl_Position = uProjMatrix * (vVertex + uDisp);\n"
+           "}\n";
+
+        const char FRAGMENT_SHADER[] =
+           "uniform sampler2D uTexture;\n"
+           "uniform float     uOpacity;\n"
+           "varying vec2 fTexCoord;\n"
+           "void main(void) {\n"
+           "    gl_FragColor = vec4(texture2D(uTexture, fTexCoord).rgb, uOpacity);\n"
+           "}\n";
+
+        StGLVertexShader aVertexShader(StGLProgram::getTitle());
+        StGLAutoRelease aTmp1(theCtx, aVertexShader);
+        aVertexShader.init(theCtx, VERTEX_SHADER);
+
+        StGLFragmentShader aFragmentShader(StGLProgram::getTitle());
+        StGLAutoRelease aTmp2(theCtx, aFragmentShader);
+        aFragmentShader.init(theCtx, FRAGMENT_SHADER);
+        if(!StGLProgram::create(theCtx)
+           .attachShader(theCtx, aVertexShader)
+           .attachShader(theCtx, aFragmentShader)
+           .bindAttribLocation(theCtx, "vVertex",   getVVertexLoc())
+           .bindAttribLocation(theCtx, "vTexCoord", getVTexCoordLoc())
+           .link(theCtx)) {
+            return false;
+        }
+
+        uniProjMatLoc = StGLProgram::getUniformLocation(theCtx, "uProjMatrix");
+        uniDispLoc    = StGLProgram::getUniformLocation(theCtx, "uDisp");
+        uniOpacityLoc = StGLProgram::getUniformLocation(theCtx, "uOpacity");
+        StGLVarLocation uniTextureLoc = StGLProgram::getUniformLocation(theCtx, "uTexture");
+        if(uniTextureLoc.isValid()) {
+            StGLProgram::use(theCtx);
+            theCtx.core20fwd->glUniform1i(uniTextureLoc, StGLProgram::TEXTURE_SAMPLE_0);
+            StGLProgram::unuse(theCtx);
+        }
+        return uniProjMatLoc.isValid() && uniOpacityLoc.isValid() && uniTextureLoc.isValid();
+    }
+
+        private:
+
+    StGLVarLocation uniProjMatLoc;
+    StGLVarLocation uniDispLoc;
+    StGLVarLocation uniOpacityLoc;
+
+};
+
 StGLSeekBar::StGLSeekBar(StGLWidget* theParent,
                          int theTop,
                          int theMargin,
@@ -106,7 +188,11 @@ StGLSeekBar::StGLSeekBar(StGLWidget* theParent,
   myProgress(0.0f),
   myProgressPx(0),
   myClickPos(-1),
-  myMoveTolerPx(0) {
+  myMoveTolerPx(0),
+  myThumbProgram(new StProgramThumb()),
+  myThumbTexture(GL_RGB8),
+  myThumbRevision(0),
+  myHoverPos(-1.0) {
     StGLWidget::signals.onMouseClick  .connect(this, &StGLSeekBar::doMouseClick);
     StGLWidget::signals.onMouseUnclick.connect(this, &StGLSeekBar::doMouseUnclick);
     myMargins.top    = theMargin;
@@ -120,6 +206,12 @@ StGLSeekBar::~StGLSeekBar() {
     }
     myVertices.release(aCtx);
     myColors.release(aCtx);
+    if(!myThumbProgram.isNull()) {
+        myThumbProgram->release(aCtx);
+    }
+    myThumbTexture.release(aCtx);
+    myThumbVertices.release(aCtx);
+    myThumbTCoords.release(aCtx);
 }
 
 void StGLSeekBar::stglResize() {
@@ -134,6 +226,12 @@ void StGLSeekBar::stglResize() {
         myProgram->setProjMat(aCtx, getRoot()->getScreenProjection());
         myProgram->unuse(aCtx);
     }
+    if(!myThumbProgram.isNull()
+    &&  myThumbProgram->isValid()) {
+        myThumbProgram->use(aCtx);
+        myThumbProgram->setProjMat(aCtx, getRoot()->getScreenProjection());
+        myThumbProgram->unuse(aCtx);
+    }
 }
 
 void StGLSeekBar::stglUpdateVertices() {
@@ -190,6 +288,16 @@ bool StGLSeekBar::stglInit() {
 
     stglUpdateVertices();
 
+    // thumbnail preview is optional
+    if(myThumbProgram->init(aCtx)) {
+        myThumbProgram->use(aCtx);
+        myThumbProgram->setProjMat(aCtx, getRoot()->getScreenProjection());
+        myThumbProgram->unuse(aCtx);
+    } else {
+        myThumbProgram->release(aCtx);
+        myThumbProgram.nullify();
+    }
+
     return myProgram->init(aCtx)
         && StGLWidget::stglInit();
 }
@@ -223,12 +331,111 @@ void StGLSeekBar::stglDraw(unsigned int theView) {
     myProgram->unuse(aCtx);
     aCtx.core20fwd->glDisable(GL_BLEND);
 
+    stglDrawThumbnail();
+
     StGLWidget::stglDraw(theView);
 }
 
+void StGLSeekBar::stglDrawThumbnail() {
+    if(myThumbs.isNull()
+    || myThumbProgram.isNull()
+    || myHoverPos < 0.0) {
+        return;
+    }
+
+    const int aCell = myThumbs->findCell(myHoverPos);
+    if(aCell < 0) {
+        return;
+    }
+
+    StGLContext& aCtx = getContext();
+    GLfloat aCellSizeX = 0.0f, aCellSizeY = 0.0f;
+    size_t  aCellCol   = 0,    aCellRow   = 0;
+    {
+        StMutexAuto aLock(myThumbs->getMutex());
+        const StImagePlane& anAtlas = myThumbs->getPlane();
+        if(anAtlas.isNull()
+        || myThumbs->getNbCellsX() == 0) {
+            return;
+        }
+
+        // atlas is filled progressively - limit re-uploading frequency
+        const bool isSizeChanged = size_t(myThumbTexture.getSizeX()) != anAtlas.getSizeX()
+                                || size_t(myThumbTexture.getSizeY()) != anAtlas.getSizeY();
+        if(!myThumbTexture.isValid()
+        || isSizeChanged
+        || (myThumbRevision != myThumbs->getRevision()
+         && (!myThumbTimer.isOn() || myThumbTimer.getElapsedTimeInSec() > 0.25))) {
+            const bool isDone = isSizeChanged || !myThumbTexture.isValid()
+                              ? myThumbTexture.init(aCtx, anAtlas)
+                              : myThumbTexture.fill(aCtx, anAtlas);
+            if(!isDone) {
+                myThumbTexture.release(aCtx);
+                return;
+            }
+            myThumbRevision = myThumbs->getRevision();
+            myThumbTimer.restart();
+        }
+
+        aCellSizeX = GLfloat(myThumbs->getCellSizeX());
+        aCellSizeY = GLfloat(myThumbs->getCellSizeY());
+        aCellCol   = size_t(aCell) % myThumbs->getNbCellsX();
+        aCellRow   = size_t(aCell) / myThumbs->getNbCellsX();
+    }
+
+    // place preview above the bar, centered at hovered position
+    const StRectI_t aBarRectPx = getRectPxAbsolute();
+    const int aSizeX = myRoot->scale(int(aCellSizeX));
+    const int aSizeY = myRoot->scale(int(aCellSizeY));
+    const int aBarLeft  = aBarRectPx.left()  + myMargins.left;
+    const int aBarRight = aBarRectPx.right() - myMargins.right;
+    int aLeft = aBarLeft + int(myHoverPos * double(aBarRight - aBarLeft)) - aSizeX / 2;
+    aLeft = stMax(stMin(aLeft, aBarRight - aSizeX), aBarLeft);
+    StRectI_t aRectPx;
+    aRectPx.left()   = aLeft;
+    aRectPx.right()  = aLeft + aSizeX;
+    aRectPx.bottom() = aBarRectPx.top() + myMargins.top - myRoot->scale(4);
+    aRectPx.top()    = aRectPx.bottom() - aSizeY;
+
+    StArray<StGLVec2> aVertices(4);
+    myRoot->getRectGl(aRectPx, aVertices, 0);
+
+    const GLfloat aTexSizeX = GLfloat(myThumbTexture.getSizeX());
+    const GLfloat aTexSizeY = GLfloat(myThumbTexture.getSizeY());
+    const GLfloat aU0 = GLfloat(aCellCol)     * aCellSizeX / aTexSizeX;
+    const GLfloat aU1 = GLfloat(aCellCol + 1) * aCellSizeX / aTexSizeX;
+    const GLfloat aV0 = GLfloat(aCellRow)     * aCellSizeY / aTexSizeY;
+    const GLfloat aV1 = GLfloat(aCellRow + 1) * aCellSizeY / aTexSizeY;
+    StArray<StGLVec2> aTCoords(4);
+    aTCoords[0] = StGLVec2(aU1, aV0);
+    aTCoords[1] = StGLVec2(aU1, aV1);
+    aTCoords[2] = StGLVec2(aU0, aV0);
+    aTCoords[3] = StGLVec2(aU0, aV1);
+    myThumbVertices.init(aCtx, aVertices);
+    myThumbTCoords .init(aCtx, aTCoords);
+
+    aCtx.core20fwd->glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    aCtx.core20fwd->glEnable(GL_BLEND);
+    myThumbTexture.bind(aCtx);
+    myThumbProgram->use(aCtx, myOpacity, myRoot->getScreenDispX());
+
+    myThumbVertices.bindVertexAttrib(aCtx, myThumbProgram->getVVertexLoc());
+    myThumbTCoords .bindVertexAttrib(aCtx, myThumbProgram->getVTexCoordLoc());
+    aCtx.core20fwd->glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    myThumbTCoords .unBindVertexAttrib(aCtx, myThumbProgram->getVTexCoordLoc());
+    myThumbVertices.unBindVertexAttrib(aCtx, myThumbProgram->getVVertexLoc());
+
+    myThumbProgram->unuse(aCtx);
+    myThumbTexture.unbind(aCtx);
+    aCtx.core20fwd->glDisable(GL_BLEND);
+}
+
 void StGLSeekBar::stglUpdate(const StPointD_t& theCursor,
                              bool theIsPreciseInput) {
     StGLWidget::stglUpdate(theCursor, theIsPreciseInput);
+    myHoverPos = isVisibleAndPointIn(theCursor)
+               ? stMin(stMax(getPointInEx(theCursor), 0.0), 1.0)
+               : -1.0;
     if(!isClicked(ST_MOUSE_LEFT)) {
         return;
     }
@@ -1,6 +1,6 @@
 /**
  * StGLWidgets, small C++ toolkit for writing GUI using OpenGL.
- * Copyright © 2010-2015 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2010-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -193,7 +193,9 @@ StGLSubtitles::StGLSubtitles(StGLWidget*                     theParent,
             aFontFt->load(aFontGlSrc->getFont()->getFilePath((StFTFont::Style )aStyleIt), (StFTFont::Style )aStyleIt);
         }
         aFontFt->init(aSize, aResolution);
-        aFontNew->changeFont((StFTFont::Subset )anIter) = new StGLFontEntry(aFontFt);
+        StHandle<StGLFontEntry>& aFontGl = aFontNew->changeFont((StFTFont::Subset )anIter);
+        aFontGl = new StGLFontEntry(aFontFt);
+        aFontGl->setGlyphCache(getRoot()->getFontManager()->findCreateGlyphCache(aFontFt, aSize));
     }
     mySize = aSize;
     myFont = aFontNew;
@@ -299,6 +301,15 @@ void StGLSubtitles::stglUpdate(const StPointD_t& ,
         myToRecompute = true;
 
         myFont->stglInit(aCtx, getFontSize(), myRoot->getResolution());
+        myFormatter.reset(); // glyphs refer to released textures
+
+        // glyph caches are bound to the font size
+        for(size_t anIter = 0; anIter < StFTFont::SubsetsNB; ++anIter) {
+            StHandle<StGLFontEntry>& aFontGl = myFont->changeFont((StFTFont::Subset )anIter);
+            if(!aFontGl.isNull()) {
+                aFontGl->setGlyphCache(myRoot->getFontManager()->findCreateGlyphCache(aFontGl->getFont(), getFontSize()));
+            }
+        }
     }
 }
 
@@ -9,6 +9,7 @@
 
 #include <StGLWidgets/StGLTextArea.h>
 
+#include <StGLWidgets/StGLDrawBatch.h>
 #include <StGLWidgets/StGLRootWidget.h>
 #include <StGLWidgets/StGLTextProgram.h>
 #include <StGLWidgets/StGLTextBorderProgram.h>
@@ -60,6 +61,7 @@ bool StGLTextArea::setText(const StString& theText) {
     if(myText != theText) {
         myText = theText;
         myToRecompute = true;
+        invalidate();
         return true;
     }
     return false;
@@ -68,6 +70,7 @@ bool StGLTextArea::setText(const StString& theText) {
 void StGLTextArea::setTextWidth(const int theWidth) {
     myTextWidth = (GLfloat )theWidth;
     myToRecompute = true;
+    invalidate();
 }
 
 void StGLTextArea::computeTextWidthFake(const StString& theText,
@@ -164,6 +167,9 @@ bool StGLTextArea::stglInitAutoHeightWidth(const int theMaxWidth) {
 bool StGLTextArea::stglInit() {
     StGLContext& aCtx = getContext();
     if(myIsInitialized) {
+        // font might have been re-initialized, so that formatted glyphs refer to released textures
+        myFormatter.reset();
+        myToRecompute = true;
         if(isVisible()) {
             formatText(aCtx);
         }
@@ -221,8 +227,7 @@ void StGLTextArea::recomputeBorder(StGLContext& theCtx) {
 
 void StGLTextArea::formatText(StGLContext& theCtx) {
     if(myToRecompute) {
-        myFormatter.reset();
-        myFormatter.append(theCtx, myText, *myFont);
+        myFormatter.update(theCtx, myText, *myFont);
         myFormatter.format(myTextWidth, GLfloat(getRectPx().height()));
         myFormatter.getResult(theCtx, myTexturesList, myTextVertBuf, myTextTCrdBuf);
         myFormatter.getBndBox(myTextBndBox);
@@ -254,6 +259,18 @@ void StGLTextArea::drawText(StGLContext& theCtx) {
     theCtx.core20fwd->glBindTexture(GL_TEXTURE_2D, 0);
 }
 
+void StGLTextArea::addTextToBatch(StGLDrawBatch&  theBatch,
+                                  const StGLVec3& theTranslation,
+                                  const GLfloat   theScale,
+                                  const StGLVec4& theColor) {
+    const std::vector< StHandle < std::vector<StGLVec2> > >& aVerts = myFormatter.getResultVertices();
+    const std::vector< StHandle < std::vector<StGLVec2> > >& aTCrds = myFormatter.getResultTexCoords();
+    for(size_t aTextureIter = 0; aTextureIter < myTexturesList.size() && aTextureIter < aVerts.size(); ++aTextureIter) {
+        theBatch.addGlyphs(myTexturesList[aTextureIter], *aVerts[aTextureIter], *aTCrds[aTextureIter],
+                           theColor, theTranslation, theScale);
+    }
+}
+
 void StGLTextArea::stglDraw(unsigned int theView) {
     if(!myIsInitialized || !isVisible()) {
         return;
@@ -283,6 +300,12 @@ void StGLTextArea::stglDraw(unsigned int theView) {
                                  0.0f));
     aModelMat.scale(aSizeOut, aSizeOut, 0.0f);
 
+    // borders are drawn directly, so that pending primitives should be drawn first
+    StGLDrawBatch& aBatch = myRoot->getDrawBatch();
+    if(myToShowBorder) {
+        aBatch.flush(aCtx);
+    }
+
     aCtx.core20fwd->glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     aCtx.core20fwd->glEnable(GL_BLEND);
 
@@ -309,32 +332,47 @@ void StGLTextArea::stglDraw(unsigned int theView) {
     }
 
     // draw text
-    aCtx.core20fwd->glActiveTexture(GL_TEXTURE0); // our shader is bound to first texture unit
-    StGLTextProgram& aTextProgram = myRoot->getTextProgram();
-    aTextProgram.use(aCtx);
-        aTextProgram.setModelMat(aCtx, aModelMat);
-        aTextProgram.setColor(aCtx, myToDrawShadow ? myShadowColor : aTextColor);
-
-        drawText(aCtx);
-
+    if(aBatch.isActive()) {
+        StGLVec3 aTrsl(getRoot()->getScreenDispX() + myTextDX + GLfloat(aTextRectGl.left()),
+                       GLfloat(aTextRectGl.top()),
+                       -getCamera()->getZScreen());
+        addTextToBatch(aBatch, aTrsl, aSizeOut, myToDrawShadow ? myShadowColor : aTextColor);
         if(myToDrawShadow) {
-            aModelMat.initIdentity();
             aTextRectPx.left() -= 1;
             aTextRectPx.top()  -= 1;
             aTextRectGl = getRoot()->getRectGl(getAbsolute(aTextRectPx));
-            aModelMat.translate(StGLVec3(getRoot()->getScreenDispX() + myTextDX, 0.0f, -getCamera()->getZScreen()));
-            aModelMat.translate(StGLVec3(GLfloat(aTextRectGl.left()),
-                                         GLfloat(aTextRectGl.top()),
-                                         0.0f));
-            aModelMat.scale(aSizeOut, aSizeOut, 0.0f);
-
+            aTrsl.x() = getRoot()->getScreenDispX() + myTextDX + GLfloat(aTextRectGl.left());
+            aTrsl.y() = GLfloat(aTextRectGl.top());
+            addTextToBatch(aBatch, aTrsl, aSizeOut, aTextColor);
+        }
+    } else {
+        aCtx.core20fwd->glActiveTexture(GL_TEXTURE0); // our shader is bound to first texture unit
+        StGLTextProgram& aTextProgram = myRoot->getTextProgram();
+        aTextProgram.use(aCtx);
             aTextProgram.setModelMat(aCtx, aModelMat);
-            aTextProgram.setColor(aCtx, aTextColor);
+            aTextProgram.setColor(aCtx, myToDrawShadow ? myShadowColor : aTextColor);
 
             drawText(aCtx);
-        }
 
-    aTextProgram.unuse(aCtx);
+            if(myToDrawShadow) {
+                aModelMat.initIdentity();
+                aTextRectPx.left() -= 1;
+                aTextRectPx.top()  -= 1;
+                aTextRectGl = getRoot()->getRectGl(getAbsolute(aTextRectPx));
+                aModelMat.translate(StGLVec3(getRoot()->getScreenDispX() + myTextDX, 0.0f, -getCamera()->getZScreen()));
+                aModelMat.translate(StGLVec3(GLfloat(aTextRectGl.left()),
+                                             GLfloat(aTextRectGl.top()),
+                                             0.0f));
+                aModelMat.scale(aSizeOut, aSizeOut, 0.0f);
+
+                aTextProgram.setModelMat(aCtx, aModelMat);
+                aTextProgram.setColor(aCtx, aTextColor);
+
+                drawText(aCtx);
+            }
+
+        aTextProgram.unuse(aCtx);
+    }
 
     aCtx.core20fwd->glDisable(GL_BLEND);
 
@@ -8,6 +8,7 @@
  */
 
 #include <StGLWidgets/StGLTextureButton.h>
+#include <StGLWidgets/StGLDrawBatch.h>
 #include <StGLWidgets/StGLRootWidget.h>
 
 #include <StGL/StGLProgramMatrix.h>
@@ -460,6 +461,7 @@ void StGLTextureButton::stglUpdate(const StPointD_t& theCursorZo,
         const double aProgress = anElapsed - myHoldDuration;
         myHoldDuration = anElapsed;
         signals.onBtnHold(getUserData(), aProgress);
+        invalidate();
         if(!isClicked(ST_MOUSE_LEFT)) {
             myHoldTimer.stop();
         }
@@ -475,9 +477,11 @@ void StGLTextureButton::stglUpdate(const StPointD_t& theCursorZo,
                 myWaveTimer.restart();
             }
             myAnimTime = (float )myWaveTimer.getElapsedTimeInSec();
-        } else {
+            invalidate(); // wave animation is in progress
+        } else if(myWaveTimer.isOn()) {
             myWaveTimer.stop();
             myAnimTime = 0.0f;
+            invalidate();
         }
     }
     StGLWidget::stglUpdate(theCursorZo, theIsPreciseInput);
@@ -497,7 +501,9 @@ void StGLTextureButton::stglDraw(unsigned int ) {
         return;
     }
 
+    // icons are not batched, draw pending primitives first to preserve order
     StGLContext& aCtx = getContext();
+    myRoot->getDrawBatch().flush(aCtx);
     aCtx.core20fwd->glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     aCtx.core20fwd->glEnable(GL_BLEND);
     aTexture.bind(aCtx);
@@ -0,0 +1,200 @@
+/**
+ * StGLWidgets, small C++ toolkit for writing GUI using OpenGL.
+ * Copyright © 2017 Kirill Gavrilov <kirill@sview.ru>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file license-boost.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#include <StGLWidgets/StGLThumbnail.h>
+
+#include <StAV/StAVImage.h>
+#include <StGL/StGLContext.h>
+#include <StGLCore/StGLCore20.h>
+
+StGLThumbnail::StGLThumbnail(StGLWidget*      theParent,
+                             const int        theLeft,
+                             const int        theTop,
+                             const StGLCorner theCorner,
+                             const int        theSize)
+: StGLIcon(theParent, theLeft, theTop, theCorner, 0),
+  myCache(theParent->getRoot()->getThumbnails()),
+  myThumbTex(new StGLTextureArray(1)),
+  myLastStamp(size_t(-1)),
+  mySize(theSize),
+  myIsReady(false),
+  myIsInit(false) {
+    // textures are managed by this class
+    myTextures          = myThumbTex;
+    myIsExternalTexture = true;
+    changeRectPx().right()  = getRectPx().left() + theSize;
+    changeRectPx().bottom() = getRectPx().top()  + theSize;
+}
+
+StGLThumbnail::~StGLThumbnail() {
+    myThumbTex->changeValue(0).release(getContext());
+}
+
+void StGLThumbnail::setPath(const StString& thePath) {
+    if(myPath == thePath) {
+        return;
+    }
+
+    myPath = thePath;
+    releaseThumbnail();
+}
+
+void StGLThumbnail::setFallbackTextures(const StHandle<StGLTextureArray>& theTextures) {
+    myFallback = theTextures;
+    updateFace();
+}
+
+bool StGLThumbnail::stglInit() {
+    // initialize fallback texture, but keep widget area
+    const StRectI_t aRect = getRectPx();
+    myTextures = !myFallback.isNull() ? myFallback : myThumbTex;
+    myFaceId   = 0;
+    const bool isInit = StGLIcon::stglInit();
+    setRectPx(aRect);
+    myIsInit = true;
+    updateFace();
+    return isInit;
+}
+
+bool StGLThumbnail::isOnScreen() {
+    if(!isVisibleWithParents()) {
+        return false;
+    }
+
+    const StRectI_t aRect = getRectPxAbsolute();
+    for(StGLWidget* aParent = getParent(); aParent != NULL; aParent = aParent->getParent()) {
+        if(aParent->getRectPxAbsolute().isOut(aRect)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void StGLThumbnail::stglUpdate(const StPointD_t& theCursorZo,
+                               bool theIsPreciseInput) {
+    StGLIcon::stglUpdate(theCursorZo, theIsPreciseInput);
+    if(!myIsInit
+    ||  myCache.isNull()
+    ||  myPath.isEmpty()) {
+        return;
+    }
+
+    if(!isOnScreen()) {
+        // release video memory of items scrolled out
+        if(myIsReady) {
+            releaseThumbnail();
+        }
+        return;
+    } else if(myIsReady) {
+        return;
+    }
+
+    // find() is skipped until some request has been processed
+    const size_t aStamp = myCache->getNbProcessed();
+    if(aStamp == myLastStamp) {
+        return;
+    }
+
+    myLastStamp = aStamp;
+    StHandle<StImage> anImage;
+    if(!myCache->find(myPath, anImage)) {
+        return;
+    }
+
+    myIsReady = true;
+    if(!anImage.isNull()) {
+        uploadThumbnail(*anImage);
+        updateFace();
+    }
+}
+
+void StGLThumbnail::releaseThumbnail() {
+    const bool wasValid = myThumbTex->getValue(0).isValid();
+    myThumbTex->changeValue(0).release(getContext());
+    myIsReady   = false;
+    myLastStamp = size_t(-1);
+    if(wasValid) {
+        updateFace();
+    }
+}
+
+void StGLThumbnail::uploadThumbnail(const StImage& theImage) {
+    if(theImage.isNull()
+    || theImage.getSizeY() == 0) {
+        return;
+    }
+
+    // fit into widget area keeping aspect ratio
+    const double aRatio = double(theImage.getSizeX()) / double(theImage.getSizeY());
+    size_t aSizeX = size_t(mySize);
+    size_t aSizeY = size_t(mySize);
+    if(aRatio >= 1.0) {
+        aSizeY = stMax(size_t(double(mySize) / aRatio + 0.5), size_t(1));
+    } else {
+        aSizeX = stMax(size_t(double(mySize) * aRatio + 0.5), size_t(1));
+    }
+
+    StImage aScaled;
+    const StImage* anImage = &theImage;
+    if((theImage.getSizeX() > aSizeX
+     || theImage.getSizeY() > aSizeY)
+    && aScaled.initTrashLimited(theImage, aSizeX, aSizeY)
+    && StAVImage::resize(theImage, aScaled)) {
+        anImage = &aScaled;
+    }
+
+    StGLContext& aCtx = getContext();
+    GLint anInternalFormat = GL_RGB;
+    if(!StGLTexture::getInternalFormat(aCtx, anImage->getPlane(), anInternalFormat)) {
+        return;
+    }
+
+    StGLNamedTexture& aTexture = myThumbTex->changeValue(0);
+    aTexture.setTextureFormat(anInternalFormat);
+    aTexture.init(aCtx, anImage->getPlane());
+}
+
+void StGLThumbnail::updateFace() {
+    int aSizeX = mySize;
+    int aSizeY = mySize;
+    const StGLNamedTexture& aThumb = myThumbTex->getValue(0);
+    if(aThumb.isValid()) {
+        myTextures     = myThumbTex;
+        myProgramIndex = StGLTexture::isAlphaFormat(aThumb.getTextureFormat())
+                       ? StGLTextureButton::ProgramIndex_WaveAlpha
+                       : StGLTextureButton::ProgramIndex_WaveRGB;
+        aSizeX = aThumb.getSizeX();
+        aSizeY = aThumb.getSizeY();
+    } else if(!myFallback.isNull()) {
+        const StGLNamedTexture& aFallback = myFallback->getValue(0);
+        myTextures     = myFallback;
+        myProgramIndex = StGLTexture::isAlphaFormat(aFallback.getTextureFormat())
+                       ? StGLTextureButton::ProgramIndex_WaveAlpha
+                       : StGLTextureButton::ProgramIndex_WaveRGB;
+        if(aFallback.isValid()) {
+            aSizeX = aFallback.getSizeX();
+            aSizeY = aFallback.getSizeY();
+        }
+    } else {
+        myTextures = myThumbTex;
+    }
+    myFaceId = 0;
+
+    // center the image within widget area
+    const int aGapX = stMax(mySize - aSizeX, 0);
+    const int aGapY = stMax(mySize - aSizeY, 0);
+    myMargins.left   = aGapX / 2;
+    myMargins.right  = aGapX - myMargins.left;
+    myMargins.top    = aGapY / 2;
+    myMargins.bottom = aGapY - myMargins.top;
+    if(myIsInit) {
+        stglResize();
+    }
+    invalidate();
+}
@@ -37,6 +37,7 @@ StGLWidget::StGLWidget(StGLWidget* theParent,
         myParent->getChildren()->add(this);
     }
     stMemSet(myMouseClicked, 0, sizeof(myMouseClicked));
+    invalidate();
 }
 
 StGLWidget::~StGLWidget() {
@@ -52,6 +53,12 @@ StGLWidget::~StGLWidget() {
     destroyChildren();
 }
 
+void StGLWidget::invalidate() {
+    if(myRoot != NULL) {
+        myRoot->setDirty();
+    }
+}
+
 void StGLWidget::destroyChildren() {
     // remove own children
     for(StGLWidget* aChildIter = myChildren.getStart(); aChildIter != NULL;) {
@@ -266,7 +273,10 @@ void StGLWidget::setClicked(int theMouseBtn, bool theIsClicked) {
         ST_DEBUG_LOG("StGLWidget, mouse button click #" + theMouseBtn + " ignored!");
         return;
     }
-    myMouseClicked[theMouseBtn] = theIsClicked;
+    if(myMouseClicked[theMouseBtn] != theIsClicked) {
+        myMouseClicked[theMouseBtn] = theIsClicked;
+        invalidate();
+    }
 }
 
 bool StGLWidget::tryClick(const StClickEvent& theEvent,
@@ -391,7 +401,10 @@ bool StGLContainer::tryUnClick(const StClickEvent& theEvent,
 }
 
 void StGLWidget::setOpacity(const float theOpacity, bool theToSetChildren) {
-    myOpacity = theOpacity;
+    if(myOpacity != theOpacity) {
+        myOpacity = theOpacity;
+        invalidate();
+    }
     if(!theToSetChildren) {
         return;
     }
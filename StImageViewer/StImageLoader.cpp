@@ -44,6 +44,113 @@ namespace {
         return SV_THREAD_RETURN 0;
     }
 
+    static SV_THREAD_FUNCTION prefetchThreadFunction(void* theImageLoader) {
+        StImageLoader* anImageLoader = (StImageLoader* )theImageLoader;
+        anImageLoader->prefetchLoop();
+        return SV_THREAD_RETURN 0;
+    }
+
+    /**
+     * Auxiliary class decoding the second view of stereo pair in another thread.
+     */
+    class StImageDecodeTask {
+
+            public:
+
+        StImageDecodeTask(const StHandle<StImageFile>& theImage,
+                          const StString&              theFilePath,
+                          StImageFile::ImageType       theImageType,
+                          uint8_t*                     theData,
+                          int                          theDataSize)
+        : myImage(theImage),
+          myFilePath(theFilePath),
+          myImageType(theImageType),
+          myData(theData),
+          myDataSize(theDataSize),
+          myIsLoaded(false) {}
+
+        ~StImageDecodeTask() {
+            wait();
+        }
+
+        /**
+         * Start decoding, within caller thread if image library is not thread-safe.
+         */
+        void start(const StImageFile::ImageClass theImageLib) {
+            if(theImageLib == StImageFile::ST_DEVIL) {
+                decode();
+                return;
+            }
+            myThread = new StThread(threadFunction, (void* )this, "StImageDecodeTask");
+        }
+
+        /**
+         * Wait decoding to finish.
+         * @return true if image has been decoded
+         */
+        bool wait() {
+            if(!myThread.isNull()) {
+                myThread->wait();
+                myThread.nullify();
+            }
+            return myIsLoaded;
+        }
+
+            private:
+
+        void decode() {
+            myIsLoaded = myImage->load(myFilePath, myImageType, myData, myDataSize);
+        }
+
+        static SV_THREAD_FUNCTION threadFunction(void* theTask) {
+            ((StImageDecodeTask* )theTask)->decode();
+            return SV_THREAD_RETURN 0;
+        }
+
+            private:
+
+        StHandle<StThread>     myThread;
+        StHandle<StImageFile>  myImage;
+        StString               myFilePath;
+        StImageFile::ImageType myImageType;
+        uint8_t*               myData;
+        int                    myDataSize;
+        volatile bool          myIsLoaded;
+
+    };
+
+    /**
+     * Map local file into memory to be decoded without intermediate copy.
+     * Remote files and files exceeding decoder API limits are left to image library.
+     */
+    static void mapImageFile(StRawFile&                         theRawFile,
+                             const StString&                    theFilePath,
+                             const StHandle<StResourceManager>& theResMgr) {
+        if(StFileNode::isContentProtocolPath(theFilePath)) {
+            int aFileDescriptor = theResMgr->openFileDescriptor(theFilePath);
+            theRawFile.mapFile(theFilePath, aFileDescriptor);
+        } else if(!StFileNode::isRemoteProtocolPath(theFilePath)) {
+            theRawFile.mapFile(theFilePath);
+        }
+        if(theRawFile.getSize() > size_t(INT_MAX)) {
+            theRawFile.freeBuffer();
+        }
+    }
+
+    /**
+     * Return memory occupied by decoded image.
+     */
+    static size_t imageSizeBytes(const StHandle<StImageFile>& theImage) {
+        size_t aSize = 0;
+        if(theImage.isNull()) {
+            return aSize;
+        }
+        for(size_t aPlaneId = 0; aPlaneId < 4; ++aPlaneId) {
+            aSize += theImage->getPlane(aPlaneId).getSizeBytes();
+        }
+        return aSize;
+    }
+
 }
 
 StImageLoader::StImageLoader(const StImageFile::ImageClass      theImageLib,
@@ -62,6 +169,11 @@ StImageLoader::StImageLoader(const StImageFile::ImageClass      theImageLib,
   myMaxTexDim(theMaxTexDim),
   myTextureQueue(theTextureQueue),
   myMsgQueue(theMsgQueue),
+  myPrefetchEvent(false),
+  myPrefetchDone(true),
+  myCacheLimit(0),
+  myToCompressMem(false),
+  myToQuitPrefetch(false),
   myImageLib(theImageLib),
   myAction(Action_NONE),
   myToStickPano360(false),
@@ -69,17 +181,170 @@ StImageLoader::StImageLoader(const StImageFile::ImageClass      theImageLib,
   myToFlipCubeZ3x2(false) {
       myPlayList->setExtensions(myMimeList.getExtensionsList());
       myThread = new StThread(threadFunction, (void* )this, "StImageLoader");
+      myPrefetchThread = new StThread(prefetchThreadFunction, (void* )this, "StImageLoaderPrefetch");
 }
 
 StImageLoader::~StImageLoader() {
+    myToQuitPrefetch = true;
+    myPrefetchEvent.set();
     myAction = Action_Quit;
     myLoadNextEvent.set(); // stop the thread
     myThread->wait();
     myThread.nullify();
+    myPrefetchThread->wait();
+    myPrefetchThread.nullify();
+    cacheClear();
 }
 
 void StImageLoader::setCompressMemory(const bool theToCompress) {
     myTextureQueue->setCompressMemory(theToCompress);
+    myToCompressMem = theToCompress;
+    if(theToCompress) {
+        cacheClear();
+    }
+}
+
+void StImageLoader::setCacheLimit(const size_t theSizeBytes) {
+    myCacheLimit = theSizeBytes;
+    if(theSizeBytes == 0) {
+        cacheClear();
+        return;
+    }
+
+    // shrink the cache to fit new limit
+    myCacheLock.lock();
+    cacheEvict(theSizeBytes, 0);
+    myCacheLock.unlock();
+}
+
+/**
+ * Append file path with its size and modification time,
+ * so that file modified on disk would not be taken from the cache.
+ */
+inline void appendCacheKey(StString&       theKey,
+                           const StString& thePath) {
+    uint64_t aFileSize = 0;
+    int64_t  aModTime  = 0;
+    theKey += thePath;
+    if(StFileNode::getFileStat(thePath, aFileSize, aModTime)) {
+        theKey += StString("\n") + aFileSize + " " + aModTime;
+    }
+}
+
+StString StImageLoader::cacheKey(const StHandle<StFileNode>& theSource) const {
+    StString aKey = StImageFile::imgLibToString(myImageLib) + "\n";
+    if(theSource->size() >= 2) {
+        appendCacheKey(aKey, theSource->getValue(0)->getPath());
+        aKey += "\n";
+        appendCacheKey(aKey, theSource->getValue(1)->getPath());
+        return aKey;
+    }
+    appendCacheKey(aKey, theSource->getPath());
+    return aKey;
+}
+
+void StImageLoader::cacheEvict(const size_t theLimit,
+                               const size_t theReserved) {
+    // the item of displayed image is kept and counted first
+    size_t aSize = theReserved;
+    for(size_t anIter = 0; anIter < myCache.size(); ++anIter) {
+        if(myCache[anIter]->Key.isEquals(myCurrentKey)) {
+            aSize += myCache[anIter]->SizeBytes;
+            break;
+        }
+    }
+
+    // evict least recently used items
+    bool isFull = false;
+    for(size_t anIter = 0; anIter < myCache.size();) {
+        const StHandle<StImageCacheItem>& aCached = myCache[anIter];
+        if(aCached->Key.isEquals(myCurrentKey)) {
+            ++anIter;
+            continue;
+        }
+
+        aSize += aCached->SizeBytes;
+        isFull = isFull || aSize > theLimit;
+        if(isFull) {
+            myCache.erase(myCache.begin() + anIter);
+        } else {
+            ++anIter;
+        }
+    }
+}
+
+StHandle<StImageCacheItem> StImageLoader::cacheFind(const StString& theKey) {
+    if(!isCacheEnabled()) {
+        return StHandle<StImageCacheItem>();
+    }
+
+    myCacheLock.lock();
+    if(myPrefetchKey.isEquals(theKey)) {
+        // the file is being decoded right now - just wait for result
+        myCacheLock.unlock();
+        myPrefetchDone.wait();
+        myCacheLock.lock();
+    }
+
+    StHandle<StImageCacheItem> anItem;
+    for(size_t anIter = 0; anIter < myCache.size(); ++anIter) {
+        if(myCache[anIter]->Key.isEquals(theKey)) {
+            anItem = myCache[anIter];
+            myCache.erase(myCache.begin() + anIter);
+            myCache.insert(myCache.begin(), anItem);
+            break;
+        }
+    }
+    myCacheLock.unlock();
+    return anItem;
+}
+
+bool StImageLoader::cacheAdd(const StHandle<StImageCacheItem>& theItem) {
+    const size_t aLimit = myCacheLimit;
+    if(!isCacheEnabled()
+    || theItem->SizeBytes > aLimit) {
+        return false;
+    }
+
+    myCacheLock.lock();
+    if(!theItem->Key.isEquals(myCurrentKey)) {
+        for(size_t anIter = 0; anIter < myCache.size(); ++anIter) {
+            if(myCache[anIter]->Key.isEquals(myCurrentKey)
+            && myCache[anIter]->SizeBytes + theItem->SizeBytes > aLimit) {
+                // prefetched item does not fit together with displayed one
+                myCacheLock.unlock();
+                return false;
+            }
+        }
+    }
+
+    for(size_t anIter = 0; anIter < myCache.size(); ++anIter) {
+        if(myCache[anIter]->Key.isEquals(theItem->Key)) {
+            myCache.erase(myCache.begin() + anIter);
+            break;
+        }
+    }
+    cacheEvict(aLimit, theItem->SizeBytes);
+    myCache.insert(myCache.begin(), theItem);
+    myCacheLock.unlock();
+    return true;
+}
+
+void StImageLoader::cacheRemove(const StString& theKey) {
+    myCacheLock.lock();
+    for(size_t anIter = 0; anIter < myCache.size(); ++anIter) {
+        if(myCache[anIter]->Key.isEquals(theKey)) {
+            myCache.erase(myCache.begin() + anIter);
+            break;
+        }
+    }
+    myCacheLock.unlock();
+}
+
+void StImageLoader::cacheClear() {
+    myCacheLock.lock();
+    myCache.clear();
+    myCacheLock.unlock();
 }
 
 void StImageLoader::processLoadFail(const StString& theErrorDesc) {
@@ -89,21 +354,21 @@ void StImageLoader::processLoadFail(const StString& theErrorDesc) {
 }
 
 void StImageLoader::metadataFromExif(const StHandle<StExifDir>& theDir,
-                                     StHandle<StImageInfo>&     theInfo) {
+                                     StArgumentsMap&            theInfo) {
     if(theDir.isNull()) {
         return;
     }
 
     if(!theDir->CameraMaker.isEmpty()) {
-        StDictEntry& anEntry  = theInfo->Info.addChange("Exif.Image.Make");
+        StDictEntry& anEntry  = theInfo.addChange("Exif.Image.Make");
         anEntry.changeValue() = theDir->CameraMaker;
     }
     if(!theDir->CameraModel.isEmpty()) {
-        StDictEntry& anEntry  = theInfo->Info.addChange("Exif.Image.Model");
+        StDictEntry& anEntry  = theInfo.addChange("Exif.Image.Model");
         anEntry.changeValue() = theDir->CameraModel;
     }
     if(!theDir->UserComment.isEmpty()) {
-        StDictEntry& anEntry  = theInfo->Info.addChange("Exif.UserComment");
+        StDictEntry& anEntry  = theInfo.addChange("Exif.UserComment");
         anEntry.changeValue() = theDir->UserComment;
     }
 
@@ -117,7 +382,8 @@ inline StHandle<StImage> scaledImage(StHandle<StImageFile>& theRef,
                                      const size_t           theMaxSizeY,
                                      StCubemap              theCubemap,
                                      const size_t*          theCubeCoeffs,
-                                     StPairRatio            thePairRatio) {
+                                     StPairRatio            thePairRatio,
+                                     const bool             theToReleaseSrc) {
     if(theRef->isNull()) {
         return theRef;
     }
@@ -165,7 +431,9 @@ inline StHandle<StImage> scaledImage(StHandle<StImageFile>& theRef,
             ST_ERROR_LOG("Scale failed!");
             return theRef;
         }
-        theRef->close();
+        if(theToReleaseSrc) {
+            theRef->close();
+        }
         return anImage;
     }
 
@@ -182,7 +450,9 @@ inline StHandle<StImage> scaledImage(StHandle<StImageFile>& theRef,
         ST_ERROR_LOG("Scale failed!");
         return theRef;
     }
-    theRef->close();
+    if(theToReleaseSrc) {
+        theRef->close();
+    }
     return anImage;
 }
 
@@ -201,43 +471,38 @@ inline StString formatSize(size_t theSizeX,
     return aText;
 }
 
-bool StImageLoader::loadImage(const StHandle<StFileNode>& theSource,
-                              StHandle<StStereoParams>&   theParams) {
-    const StString               aFilePath = theSource->getPath();
-    const StImageFile::ImageType anImgType = StImageFile::guessImageType(aFilePath, theSource->getMIME());
+bool StImageLoader::decodeImage(const StHandle<StFileNode>& theSource,
+                                StImageCacheItem&           theItem,
+                                StString&                   theError) {
+    const StString                aFilePath = theSource->getPath();
+    const StImageFile::ImageType  anImgType = StImageFile::guessImageType(aFilePath, theSource->getMIME());
+    const StImageFile::ImageClass anImgLib  = myImageLib;
 
-    StHandle<StImageFile> anImageFileL = StImageFile::create(myImageLib, anImgType);
-    StHandle<StImageFile> anImageFileR = StImageFile::create(myImageLib, anImgType);
+    StHandle<StImageFile> anImageFileL = StImageFile::create(anImgLib, anImgType);
+    StHandle<StImageFile> anImageFileR = StImageFile::create(anImgLib, anImgType);
     if(anImageFileL.isNull()
     || anImageFileR.isNull()) {
-        processLoadFail("No any image library was found!");
+        theError = "No any image library was found!";
         return false;
     }
 
-    // clear active
-    myTextureQueue->clear();
+    theItem.ImageType = anImgType;
+    theItem.IsSavable = false;
 
-    StHandle<StImageInfo> anImgInfo = new StImageInfo();
-    anImgInfo->Id        = theParams;
-    anImgInfo->Path      = aFilePath;
-    anImgInfo->ImageType = anImgType;
-    anImgInfo->IsSavable = false;
-
-    StString aTitleString, aFolder;
+    StString aFolder;
     if(theSource->size() >= 2) {
         StString aTitleString2;
-        StFileNode::getFolderAndFile(theSource->getValue(0)->getPath(), aFolder, aTitleString);
+        StFileNode::getFolderAndFile(theSource->getValue(0)->getPath(), aFolder, theItem.Title);
         StFileNode::getFolderAndFile(theSource->getValue(1)->getPath(), aFolder, aTitleString2);
-        anImgInfo->Info.add(StArgument(tr(INFO_FILE_NAME),
-                                       aTitleString  + " " + tr(INFO_LEFT) + "\n"
-                                     + aTitleString2 + " " + tr(INFO_RIGHT)));
+        theItem.Info.add(StArgument(tr(INFO_FILE_NAME),
+                                    theItem.Title + " " + tr(INFO_LEFT) + "\n"
+                                  + aTitleString2 + " " + tr(INFO_RIGHT)));
     } else {
-        StFileNode::getFolderAndFile(aFilePath, aFolder, aTitleString);
-        anImgInfo->Info.add(StArgument(tr(INFO_FILE_NAME), aTitleString));
+        StFileNode::getFolderAndFile(aFilePath, aFolder, theItem.Title);
+        theItem.Info.add(StArgument(tr(INFO_FILE_NAME), theItem.Title));
     }
 
     StTimer aLoadTimer(true);
-    StFormat  aSrcFormatCurr = myStFormatByUser;
     if(anImgType == StImageFile::ST_TYPE_MPO
     || anImgType == StImageFile::ST_TYPE_JPEG
     || anImgType == StImageFile::ST_TYPE_JPS) {
@@ -273,75 +538,78 @@ bool StImageLoader::loadImage(const StHandle<StFileNode>& theSource,
                     continue;
                 }
             }
-            anImgInfo->Info.add(StArgument(tr(INFO_DIMENSIONS) + (" (") + anImgCounter + ")",
-                                           StString() + anImgIter->SizeX + " x " + anImgIter->SizeY));
+            theItem.Info.add(StArgument(tr(INFO_DIMENSIONS) + (" (") + anImgCounter + ")",
+                                        StString() + anImgIter->SizeX + " x " + anImgIter->SizeY));
         }
 
         // copy metadata
         if(!aParser.getComment().isEmpty()) {
-            StDictEntry& anEntry  = anImgInfo->Info.addChange("Jpeg.Comment");
+            StDictEntry& anEntry  = theItem.Info.addChange("Jpeg.Comment");
             anEntry.changeValue() = aParser.getComment();
         }
         if(!aParser.getJpsComment().isEmpty()) {
-            StDictEntry& anEntry  = anImgInfo->Info.addChange("Jpeg.JpsComment");
+            StDictEntry& anEntry  = theItem.Info.addChange("Jpeg.JpsComment");
             anEntry.changeValue() = aParser.getJpsComment();
         }
         if(!anImg1.isNull()) {
             for(size_t anExifId = 0; anExifId < anImg1->Exif.size(); ++anExifId) {
-                metadataFromExif(anImg1->Exif[anExifId], anImgInfo);
+                metadataFromExif(anImg1->Exif[anExifId], theItem.Info);
             }
             const StString aTime = anImg1->getDateTime();
             if(!aTime.isEmpty()) {
-                StDictEntry& anEntry  = anImgInfo->Info.addChange("Exif.Image.DateTime");
+                StDictEntry& anEntry  = theItem.Info.addChange("Exif.Image.DateTime");
                 anEntry.changeValue() = aTime;
             }
         }
-        if(myStFormatByUser == StFormat_AUTO
-        && aParser.getSrcFormat() != StFormat_AUTO) {
-            aSrcFormatCurr = aParser.getSrcFormat();
-        }
 
-        //aParser.fillDictionary(anImgInfo->Info, true);
+        //aParser.fillDictionary(theItem.Info, true);
         if(!isParsed) {
-            processLoadFail(StString("Can not read the file \"") + aFilePath + '\"');
+            theError = StString("Can not read the file \"") + aFilePath + '\"';
             return false;
         }
 
-        anImgInfo->IsSavable = anImg2.isNull();
-        anImgInfo->StInfoStream = aParser.getSrcFormat();
-        if(anImgInfo->StInfoStream != StFormat_AUTO) {
-            StDictEntry& anEntry  = anImgInfo->Info.addChange("Jpeg.JpsStereo");
-            anEntry.changeValue() = tr(StImageViewerGUI::trSrcFormatId(anImgInfo->StInfoStream));
+        theItem.IsSavable    = anImg2.isNull();
+        theItem.StInfoStream = aParser.getSrcFormat();
+        if(theItem.StInfoStream != StFormat_AUTO) {
+            StDictEntry& anEntry  = theItem.Info.addChange("Jpeg.JpsStereo");
+            anEntry.changeValue() = tr(StImageViewerGUI::trSrcFormatId(theItem.StInfoStream));
         }
 
         // read image from memory
         const StJpegParser::Orient anOrient = anImg1->getOrientation();
-        theParams->setZRotateZero((GLfloat )StJpegParser::getRotationAngle(anOrient));
+        theItem.ZRotateZero = StJpegParser::getRotationAngle(anOrient);
+        theItem.HasZRotate  = true;
         anImg1->getParallax(anHParallax);
+
+        // decode the second image in parallel
+        StHandle<StImageDecodeTask> aTaskR;
+        if(!anImg2.isNull()) {
+            aTaskR = new StImageDecodeTask(anImageFileR, aFilePath, StImageFile::ST_TYPE_JPEG,
+                                           (uint8_t* )anImg2->Data, (int )anImg2->Length);
+            aTaskR->start(anImgLib);
+        }
+
         if(!anImageFileL->load(aFilePath, StImageFile::ST_TYPE_JPEG,
                                (uint8_t* )anImg1->Data, (int )anImg1->Length)
         && !anImageFileL->load(aFilePath, StImageFile::ST_TYPE_JPEG,
                                (uint8_t* )aParser.getBuffer(), (int )aParser.getSize())) {
-            processLoadFail(formatError(aFilePath, anImageFileL->getState()));
+            theError = formatError(aFilePath, anImageFileL->getState());
             return false;
         }
 
-        if(!anImg2.isNull()) {
-            // read image from memory
+        if(!aTaskR.isNull()) {
             anImg2->getParallax(anHParallax); // in MPO parallax generally stored ONLY in second frame
-            if(!anImageFileR->load(aFilePath, StImageFile::ST_TYPE_JPEG,
-                                   (uint8_t* )anImg2->Data, (int )anImg2->Length)) {
-                processLoadFail(formatError(aFilePath, anImageFileR->getState()));
+            if(!aTaskR->wait()) {
+                theError = formatError(aFilePath, anImageFileR->getState());
                 return false;
             }
 
-            // convert percents to pixels
-            const GLint aParallaxPx = GLint(anHParallax * anImageFileR->getSizeX() * 0.01);
-            if(aParallaxPx != 0) {
-                StDictEntry& anEntry  = anImgInfo->Info.addChange("Exif.Fujifilm.Parallax");
+            if(GLint(anHParallax * anImageFileR->getSizeX() * 0.01) != 0) {
+                StDictEntry& anEntry  = theItem.Info.addChange("Exif.Fujifilm.Parallax");
                 anEntry.changeValue() = StString(anHParallax);
             }
-            theParams->setSeparationNeutral(aParallaxPx);
+            theItem.ParallaxPercent = anHParallax;
+            theItem.HasParallax     = true;
         } else if(anImgType == StImageFile::ST_TYPE_MPO) {
             ST_DEBUG_LOG("MPO image \"" + aFilePath + "\" is invalid!");
         }
@@ -350,53 +618,102 @@ bool StImageLoader::loadImage(const StHandle<StFileNode>& theSource,
         const StString aFilePathRight = theSource->getValue(1)->getPath();
 
         // loading image with format autodetection
-        StRawFile aRawFileL;
-        if(StFileNode::isContentProtocolPath(aFilePathLeft)) {
-            int aFileDescriptor = myResMgr->openFileDescriptor(aFilePathLeft);
-            aRawFileL.readFile(aFilePathLeft, aFileDescriptor);
-        }
+        StRawFile aRawFileL, aRawFileR;
+        mapImageFile(aRawFileL, aFilePathLeft,  myResMgr);
+        mapImageFile(aRawFileR, aFilePathRight, myResMgr);
+
+        // decode the right image in parallel
+        StImageDecodeTask aTaskR(anImageFileR, aFilePathRight, anImgType,
+                                 (uint8_t* )aRawFileR.getBuffer(), (int )aRawFileR.getSize());
+        aTaskR.start(anImgLib);
         if(!anImageFileL->load(aFilePathLeft, anImgType, (uint8_t* )aRawFileL.getBuffer(), (int )aRawFileL.getSize())) {
-            processLoadFail(formatError(aFilePathLeft, anImageFileL->getState()));
+            theError = formatError(aFilePathLeft, anImageFileL->getState());
             return false;
         }
         aRawFileL.freeBuffer();
 
-        StRawFile aRawFileR;
-        if(StFileNode::isContentProtocolPath(aFilePathRight)) {
-            int aFileDescriptor = myResMgr->openFileDescriptor(aFilePathRight);
-            aRawFileR.readFile(aFilePathRight, aFileDescriptor);
-        }
-        if(!anImageFileR->load(aFilePathRight, anImgType, (uint8_t* )aRawFileR.getBuffer(), (int )aRawFileR.getSize())) {
-            processLoadFail(formatError(aFilePathRight, anImageFileR->getState()));
+        if(!aTaskR.wait()) {
+            theError = formatError(aFilePathRight, anImageFileR->getState());
             return false;
         }
     } else {
         StRawFile aRawFile;
-        if(StFileNode::isContentProtocolPath(aFilePath)) {
-            int aFileDescriptor = myResMgr->openFileDescriptor(aFilePath);
-            aRawFile.readFile(aFilePath, aFileDescriptor);
-        }
+        mapImageFile(aRawFile, aFilePath, myResMgr);
         if(!anImageFileL->load(aFilePath, anImgType, (uint8_t* )aRawFile.getBuffer(), (int )aRawFile.getSize())) {
-            processLoadFail(formatError(aFilePath, anImageFileL->getState()));
+            theError = formatError(aFilePath, anImageFileL->getState());
             return false;
         }
 
-        anImgInfo->StInfoStream = anImageFileL->getFormat();
-        if(myStFormatByUser == StFormat_AUTO) {
-            aSrcFormatCurr = anImgInfo->StInfoStream;
-        }
+        theItem.StInfoStream = anImageFileL->getFormat();
     }
-    const double aLoadTimeMSec = aLoadTimer.getElapsedTimeInMilliSec();
+    theItem.LoadTimeMSec = aLoadTimer.getElapsedTimeInMilliSec();
 
     // copy metadata
     for(size_t aTagIter = 0; aTagIter < anImageFileL->getMetadata().size(); ++aTagIter) {
         const StDictEntry& aTag = anImageFileL->getMetadata().getFromIndex(aTagIter);
-        anImgInfo->Info.add(aTag);
+        theItem.Info.add(aTag);
+    }
+
+    theItem.ImageL    = anImageFileL;
+    theItem.ImageR    = anImageFileR;
+    theItem.SizeBytes = imageSizeBytes(anImageFileL) + imageSizeBytes(anImageFileR);
+    return true;
+}
+
+bool StImageLoader::loadImage(const StHandle<StFileNode>& theSource,
+                              StHandle<StStereoParams>&   theParams) {
+    const StString aFilePath = theSource->getPath();
+    const StString aCacheKey = cacheKey(theSource);
+
+    // clear active
+    myTextureQueue->clear();
+
+    myCacheLock.lock();
+    myCurrentKey = aCacheKey;
+    myCacheLock.unlock();
+
+    StTimer aLoadTimer(true);
+    StHandle<StImageCacheItem> anItem = cacheFind(aCacheKey);
+    bool isCached = !anItem.isNull();
+    if(!isCached) {
+        anItem = new StImageCacheItem();
+        anItem->Key = aCacheKey;
+        StString anError;
+        if(!decodeImage(theSource, *anItem, anError)) {
+            processLoadFail(anError);
+            return false;
+        }
+        isCached = cacheAdd(anItem);
+    }
+    const double aLoadTimeMSec = aLoadTimer.getElapsedTimeInMilliSec();
+
+    StHandle<StImageFile> anImageFileL = anItem->ImageL;
+    StHandle<StImageFile> anImageFileR = anItem->ImageR;
+    if(anItem->HasZRotate) {
+        theParams->setZRotateZero((GLfloat )anItem->ZRotateZero);
+    }
+    if(anItem->HasParallax) {
+        // convert percents to pixels
+        theParams->setSeparationNeutral(GLint(anItem->ParallaxPercent * anImageFileR->getSizeX() * 0.01));
+    }
+
+    StHandle<StImageInfo> anImgInfo = new StImageInfo();
+    anImgInfo->Id           = theParams;
+    anImgInfo->Path         = aFilePath;
+    anImgInfo->ImageType    = anItem->ImageType;
+    anImgInfo->IsSavable    = anItem->IsSavable;
+    anImgInfo->StInfoStream = anItem->StInfoStream;
+    anImgInfo->Info         = anItem->Info;
+
+    StFormat aSrcFormatCurr = myStFormatByUser;
+    if(aSrcFormatCurr == StFormat_AUTO
+    && anItem->StInfoStream != StFormat_AUTO) {
+        aSrcFormatCurr = anItem->StInfoStream;
     }
 
     // detect information from file name
     bool isAnamorphByName = false;
-    anImgInfo->StInfoFileName = st::formatFromName(aTitleString, isAnamorphByName);
+    anImgInfo->StInfoFileName = st::formatFromName(anItem->Title, isAnamorphByName);
     if(aSrcFormatCurr == StFormat_AUTO
     && anImgInfo->StInfoFileName != StFormat_AUTO) {
         aSrcFormatCurr = anImgInfo->StInfoFileName;
@@ -466,8 +783,8 @@ bool StImageLoader::loadImage(const StHandle<StFileNode>& theSource,
         }
     }
 
-    StHandle<StImage> anImageL = scaledImage(anImageFileL, aSizeXLim, aSizeYLim, aSrcCubemap, aCubeCoeffs, aPairRatio);
-    StHandle<StImage> anImageR = scaledImage(anImageFileR, aSizeXLim, aSizeYLim, aSrcCubemap, aCubeCoeffs, aPairRatio);
+    StHandle<StImage> anImageL = scaledImage(anImageFileL, aSizeXLim, aSizeYLim, aSrcCubemap, aCubeCoeffs, aPairRatio, !isCached);
+    StHandle<StImage> anImageR = scaledImage(anImageFileR, aSizeXLim, aSizeYLim, aSrcCubemap, aCubeCoeffs, aPairRatio, !isCached);
 #ifdef ST_DEBUG
     const double aScaleTimeMSec = aLoadTimer.getElapsedTimeInMilliSec() - aLoadTimeMSec;
     if(anImageL != anImageFileL) {
@@ -535,11 +852,18 @@ bool StImageLoader::loadImage(const StHandle<StFileNode>& theSource,
     anImageR.nullify();
     anImageFileL.nullify();
     anImageFileR.nullify();
+    anItem.nullify();
 
     myTextureQueue->stglSwapFB(0);
 
     // indicate new file opened
     signals.onLoaded();
+
+    // decode neighbors in background
+    if(isCacheEnabled()
+    && myImageLib != StImageFile::ST_DEVIL) {
+        myPrefetchEvent.set();
+    }
     return true;
 }
 
@@ -714,6 +1038,9 @@ void StImageLoader::mainLoop() {
                 if(!saveImageInfo(anInfo)) {
                     break;
                 }
+                if(myPlayList->getCurrentFile(aFileToLoad, aFileParams)) {
+                    cacheRemove(cacheKey(aFileToLoad));
+                }
                 // re-load image file
             }
             case Action_NONE:
@@ -728,3 +1055,56 @@ void StImageLoader::mainLoop() {
         }
     }
 }
+
+void StImageLoader::prefetchLoop() {
+    const int anOffsets[2] = { 1, -1 };
+    for(;;) {
+        myPrefetchEvent.wait();
+        myPrefetchEvent.reset();
+        for(int anIter = 0; anIter < 2; ++anIter) {
+            if(myToQuitPrefetch) {
+                return;
+            } else if(!isCacheEnabled()
+                   ||  myImageLib == StImageFile::ST_DEVIL // DevIL is not thread-safe
+                   ||  myPrefetchEvent.check()) {
+                break;
+            }
+
+            StHandle<StFileNode> aFileNode;
+            if(!myPlayList->getNeighbourFile(anOffsets[anIter], aFileNode)
+            ||  StFileNode::isContentProtocolPath(aFileNode->getPath())) {
+                continue;
+            }
+
+            const StString aKey = cacheKey(aFileNode);
+            bool isCached = false;
+            myCacheLock.lock();
+            for(size_t anItemIter = 0; anItemIter < myCache.size(); ++anItemIter) {
+                if(myCache[anItemIter]->Key.isEquals(aKey)) {
+                    isCached = true;
+                    break;
+                }
+            }
+            if(!isCached) {
+                myPrefetchKey = aKey;
+                myPrefetchDone.reset();
+            }
+            myCacheLock.unlock();
+            if(isCached) {
+                continue;
+            }
+
+            StHandle<StImageCacheItem> anItem = new StImageCacheItem();
+            anItem->Key = aKey;
+            StString anError;
+            if(decodeImage(aFileNode, *anItem, anError)) {
+                cacheAdd(anItem);
+            }
+
+            myCacheLock.lock();
+            myPrefetchKey = StString();
+            myPrefetchDone.set();
+            myCacheLock.unlock();
+        }
+    }
+}
@@ -30,6 +30,8 @@
 #include <StThreads/StProcess.h>
 #include <StThreads/StResourceManager.h>
 
+#include <vector>
+
 class StThread;
 
 struct StImageInfo {
@@ -46,8 +48,44 @@ struct StImageInfo {
 
 };
 
+/**
+ * Decoded image file(s) with metadata, independent from viewing parameters.
+ * Kept in memory to switch between neighbor playlist items without decoding.
+ */
+struct StImageCacheItem {
+
+    StString               Key;             //!< cache key - file path(s) and image library
+    StHandle<StImageFile>  ImageL;          //!< decoded left (or single) image
+    StHandle<StImageFile>  ImageR;          //!< decoded right image (empty for single image)
+    StArgumentsMap         Info;            //!< metadata read from file(s)
+    StString               Title;           //!< file name, used for format detection
+    StImageFile::ImageType ImageType;       //!< image type
+    StFormat               StInfoStream;    //!< source format as stored in file metadata
+    double                 ZRotateZero;     //!< orientation angle from EXIF
+    double                 ParallaxPercent; //!< horizontal parallax in percents (MPO)
+    double                 LoadTimeMSec;    //!< decoding time
+    size_t                 SizeBytes;       //!< memory occupied by decoded data
+    bool                   IsSavable;       //!< indicate that file can be saved without re-encoding
+    bool                   HasZRotate;      //!< ZRotateZero is defined
+    bool                   HasParallax;     //!< ParallaxPercent is defined
+
+    StImageCacheItem()
+    : ImageType(StImageFile::ST_TYPE_NONE),
+      StInfoStream(StFormat_AUTO),
+      ZRotateZero(0.0),
+      ParallaxPercent(0.0),
+      LoadTimeMSec(0.0),
+      SizeBytes(0),
+      IsSavable(false),
+      HasZRotate(false),
+      HasParallax(false) {}
+
+};
+
 /**
  * Auxiliary class to load images from dedicated thread.
+ * Decoded images are kept in LRU cache within specified memory budget,
+ * and neighbor playlist items are decoded ahead of time by another thread.
  */
 class StImageLoader {
 
@@ -86,6 +124,11 @@ class StImageLoader {
 
     ST_LOCAL void mainLoop();
 
+    /**
+     * Loop decoding neighbor playlist items into the cache.
+     */
+    ST_LOCAL void prefetchLoop();
+
     ST_LOCAL void doLoadNext() {
         myLoadNextEvent.set();
     }
@@ -131,9 +174,15 @@ class StImageLoader {
 
     /**
      * Release unused memory as fast as possible.
+     * Disables the cache of decoded images.
      */
     ST_LOCAL void setCompressMemory(const bool theToCompress);
 
+    /**
+     * Set memory budget for the cache of decoded images, 0 disables the cache.
+     */
+    ST_LOCAL void setCacheLimit(const size_t theSizeBytes);
+
     /**
      * Stick to panorama 360 mode.
      */
@@ -169,6 +218,63 @@ class StImageLoader {
 
     ST_LOCAL bool loadImage(const StHandle<StFileNode>& theSource,
                             StHandle<StStereoParams>&   theParams);
+
+    /**
+     * Read and decode image file(s).
+     * This method does not modify loader state and can be called from any thread.
+     * @param theSource file(s) to decode
+     * @param theItem   decoded image to fill in
+     * @param theError  error description
+     * @return true on success
+     */
+    ST_LOCAL bool decodeImage(const StHandle<StFileNode>& theSource,
+                              StImageCacheItem&           theItem,
+                              StString&                   theError);
+
+    /**
+     * @return key identifying file(s) within the cache, including file size and modification time
+     */
+    ST_LOCAL StString cacheKey(const StHandle<StFileNode>& theSource) const;
+
+    /**
+     * @return true if decoded images should be cached
+     */
+    ST_LOCAL bool isCacheEnabled() const {
+        return myCacheLimit != 0 && !myToCompressMem;
+    }
+
+    /**
+     * Find decoded image in the cache and mark it as recently used.
+     * Waits for prefetching thread if it decodes the same file at the moment.
+     */
+    ST_LOCAL StHandle<StImageCacheItem> cacheFind(const StString& theKey);
+
+    /**
+     * Put decoded image into the cache, least recently used items are removed to fit memory budget.
+     * The item of currently displayed image is never removed.
+     * @return false if item has not been cached (cache is disabled or item does not fit)
+     */
+    ST_LOCAL bool cacheAdd(const StHandle<StImageCacheItem>& theItem);
+
+    /**
+     * Remove least recently used items to fit memory budget (within locked mutex).
+     * The item of currently displayed image is never removed.
+     * @param theLimit    memory budget in bytes
+     * @param theReserved size of the item to be added
+     */
+    ST_LOCAL void cacheEvict(const size_t theLimit,
+                             const size_t theReserved);
+
+    /**
+     * Remove item from the cache.
+     */
+    ST_LOCAL void cacheRemove(const StString& theKey);
+
+    /**
+     * Release all cached images.
+     */
+    ST_LOCAL void cacheClear();
+
     ST_LOCAL bool saveImage(const StHandle<StFileNode>& theSource,
                             const StHandle<StStereoParams>& theParams,
                             StImageFile::ImageType theImgType);
@@ -188,7 +294,7 @@ class StImageLoader {
      * Fill metadata map from EXIF.
      */
     ST_LOCAL void metadataFromExif(const StHandle<StExifDir>& theDir,
-                                   StHandle<StImageInfo>&     theInfo);
+                                   StArgumentsMap&            theInfo);
 
     ST_LOCAL const StString& tr(const size_t theId) const {
         return myLangMap->getValue(theId);
@@ -210,6 +316,18 @@ class StImageLoader {
     StHandle<StImageInfo>       myInfoToSave;    //!< modified info to be saved
     StHandle<StMsgQueue>        myMsgQueue;      //!< messages queue
 
+    StHandle<StThread>          myPrefetchThread;//!< thread decoding neighbor playlist items
+    StCondition                 myPrefetchEvent; //!< event to start prefetching
+    StCondition                 myPrefetchDone;  //!< event indicating that prefetching thread is idle
+    mutable StMutex             myCacheLock;     //!< lock to access the cache
+    std::vector< StHandle<StImageCacheItem> >
+                                myCache;         //!< decoded images, most recently used first
+    StString                    myPrefetchKey;   //!< key of the item being decoded by prefetching thread
+    StString                    myCurrentKey;    //!< key of the item being displayed, pinned within the cache
+    volatile size_t             myCacheLimit;    //!< memory budget for the cache in bytes
+    volatile bool               myToCompressMem; //!< release unused memory as fast as possible
+    volatile bool               myToQuitPrefetch;//!< flag to stop prefetching thread
+
     volatile StImageFile::ImageClass myImageLib;
     volatile Action            myAction;
     volatile bool              myToStickPano360; //!< stick to panorama 360 mode
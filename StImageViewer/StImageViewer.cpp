@@ -113,9 +113,11 @@ void StImageViewer::updateStrings() {
     params.ToHideStatusBar->setName("Hide system status bar");
     params.ToHideNavBar   ->setName(tr(OPTION_HIDE_NAVIGATION_BAR));
     params.IsVSyncOn->setName(tr(MENU_VSYNC));
+    params.ToSkipIdleFrames->setName(stCString("Skip idle frames"));
     params.ToOpenLast->setName(tr(OPTION_OPEN_LAST_ON_STARTUP));
     params.ToSaveRecent->setName(stCString("Remember recent file"));
     params.TargetFps->setName(stCString("FPS Target"));
+    params.ImageCacheMiB->setName(tr(OPTION_IMAGE_CACHE_SIZE));
     myLangMap->params.language->setName(tr(MENU_HELP_LANGS));
 }
 
@@ -129,6 +131,8 @@ StImageViewer::StImageViewer(const StHandle<StResourceManager>& theResMgr,
   myEventLoaded(false),
   //
   mySlideShowTimer(false),
+  myNbPendingDraws(0),
+  myThumbsStamp(0),
   //
   myToCheckUpdates(true),
   myToSaveSrcFormat(false),
@@ -192,10 +196,18 @@ StImageViewer::StImageViewer(const StHandle<StResourceManager>& theResMgr,
     params.IsVSyncOn     = new StBoolParamNamed(true,  stCString("vsync"));
     params.IsVSyncOn->signals.onChanged = stSlot(this, &StImageViewer::doSwitchVSync);
     StApplication::params.VSyncMode->setValue(StGLContext::VSync_ON);
+    params.ToSkipIdleFrames = new StBoolParamNamed(false, stCString("toSkipIdleFrames"));
     params.ToOpenLast   = new StBoolParamNamed(false, stCString("toOpenLast"));
     params.ToSaveRecent = new StBoolParamNamed(false, stCString("toSaveRecent"));
     params.imageLib = StImageFile::ST_LIBAV,
     params.TargetFps = new StInt32ParamNamed(0, stCString("fpsTarget"));
+    params.ImageCacheMiB = new StFloat32Param(512.0f, stCString("imageCacheMiB2"));
+    params.ImageCacheMiB->setMinMaxValues(0.0f, 4096.0f);
+    params.ImageCacheMiB->setDefValue(512.0f);
+    params.ImageCacheMiB->setStep(128.0f);
+    params.ImageCacheMiB->setTolerance(1.0f);
+    params.ImageCacheMiB->setFormat(stCString("%01.0f MiB"));
+    params.ImageCacheMiB->signals.onChanged = stSlot(this, &StImageViewer::doChangeImageCache);
     updateStrings();
 
     mySettings->loadParam(params.ExitOnEscape);
@@ -204,6 +216,7 @@ StImageViewer::StImageViewer(const StHandle<StResourceManager>& theResMgr,
     mySettings->loadParam (params.ScaleHiDPI2X);
     params.ScaleHiDPI2X->signals.onChanged = stSlot(this, &StImageViewer::doScaleHiDPI);
     mySettings->loadParam (params.TargetFps);
+    mySettings->loadParam (params.ImageCacheMiB);
     mySettings->loadString(ST_SETTING_LAST_FOLDER,        params.lastFolder);
     mySettings->loadParam (params.LastUpdateDay);
     mySettings->loadParam (params.CheckUpdatesDays);
@@ -218,6 +231,7 @@ StImageViewer::StImageViewer(const StHandle<StResourceManager>& theResMgr,
     mySettings->loadParam (params.ToHideNavBar);
     mySettings->loadParam (params.ToOpenLast);
     mySettings->loadParam (params.IsVSyncOn);
+    mySettings->loadParam (params.ToSkipIdleFrames);
     mySettings->loadParam (params.ToShowPlayList);
     mySettings->loadParam (params.ToShowAdjustImage);
 
@@ -360,6 +374,7 @@ void StImageViewer::saveAllParams() {
         mySettings->saveParam (params.ScaleAdjust);
         mySettings->saveParam (params.ScaleHiDPI2X);
         mySettings->saveParam (params.TargetFps);
+        mySettings->saveParam (params.ImageCacheMiB);
         mySettings->saveParam(params.LastUpdateDay);
         mySettings->saveParam(params.CheckUpdatesDays);
         mySettings->saveString(ST_SETTING_IMAGELIB,  StImageFile::imgLibToString(params.imageLib));
@@ -374,6 +389,7 @@ void StImageViewer::saveAllParams() {
         mySettings->saveParam (params.ToHideNavBar);
         mySettings->saveParam (params.ToOpenLast);
         mySettings->saveParam (params.IsVSyncOn);
+        mySettings->saveParam (params.ToSkipIdleFrames);
         mySettings->saveParam (params.ToShowPlayList);
         mySettings->saveParam (params.ToShowAdjustImage);
         if(myToSaveSrcFormat) {
@@ -529,6 +545,7 @@ bool StImageViewer::init() {
     myLoader = new StImageLoader(params.imageLib, myResMgr, myMsgQueue, myLangMap, myPlayList,
                                  myGUI->myImage->getTextureQueue(), myContext->getMaxTextureSize());
     myLoader->signals.onLoaded.connect(this, &StImageViewer::doLoaded);
+    doChangeImageCache(params.ImageCacheMiB->getValue());
     myLoader->setCompressMemory(myWindow->isMobile());
     myLoader->setStickPano360(params.ToStickPanorama->getValue());
     myLoader->setFlipCubeZ6x1(params.ToFlipCubeZ6x1->getValue());
@@ -1068,6 +1085,56 @@ void StImageViewer::beforeDraw() {
     myWindow->showCursor(!toHideCursor);
 }
 
+bool StImageViewer::hasPendingThumbnails() {
+    if(!myGUI->hasThumbnails()) {
+        return false;
+    }
+
+    // one more frame is drawn after the last request has been processed,
+    // so that StGLThumbnail::stglUpdate() would fetch the result
+    const StHandle<StThumbnailCache>& aThumbs = myGUI->getThumbnails();
+    const size_t aStamp = aThumbs->getNbProcessed();
+    if(aThumbs->hasPendingRequests()
+    || aStamp != myThumbsStamp) {
+        myThumbsStamp = aStamp;
+        return true;
+    }
+    return false;
+}
+
+bool StImageViewer::toSkipFrame() {
+    if(!params.ToSkipIdleFrames->getValue()
+    ||  myGUI.isNull()
+    ||  myWindow->isPaused()
+    ||  myWindow->toDrawContinuously()
+    ||  myWindow->toTrackOrientation()
+    ||  myWindow->hasDispatchedEvents()
+    ||  myGUI->isDirty()
+    // display thumbnails as soon as they are generated
+    ||  hasPendingThumbnails()) {
+        myRedrawTimer.restart();
+        myNbPendingDraws = 0;
+        return false;
+    }
+
+    if(myGUI->myImage->getTextureQueue()->hasPendingFrames()) {
+        // image should become idle after a few frames, otherwise something keeps the queue busy
+        if(++myNbPendingDraws == 300) {
+            ST_DEBUG_LOG("StImageViewer, texture queue has been busy for 300 frames - idle frames are not skipped!");
+        }
+        myRedrawTimer.restart();
+        return false;
+    }
+
+    myNbPendingDraws = 0;
+    // redraw from time to time to catch up timer-driven widgets not tracked by dirty flags
+    if(myRedrawTimer.getElapsedTimeInSec() > 1.0) {
+        myRedrawTimer.restart();
+        return false;
+    }
+    return true;
+}
+
 void StImageViewer::stglDraw(unsigned int theView) {
     const bool hasCtx = !myContext.isNull() && myContext->isBound();
     if(!hasCtx || myWindow->isPaused()) {
@@ -1232,6 +1299,14 @@ void StImageViewer::doChangeStickPano360(const bool ) {
     }
 }
 
+void StImageViewer::doChangeImageCache(const float ) {
+    if(myLoader.isNull()) {
+        return;
+    }
+
+    myLoader->setCacheLimit(size_t(stMax(params.ImageCacheMiB->getValue(), 0.0f)) * 1024 * 1024);
+}
+
 void StImageViewer::doChangeFlipCubeZ(const bool ) {
     if(myLoader.isNull()) {
         return;
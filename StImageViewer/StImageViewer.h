@@ -65,6 +65,11 @@ class StImageViewer : public StApplication {
      */
     ST_CPPEXPORT virtual void beforeDraw() ST_ATTR_OVERRIDE;
 
+    /**
+     * Skip frame when neither image nor GUI have been changed.
+     */
+    ST_CPPEXPORT virtual bool toSkipFrame() ST_ATTR_OVERRIDE;
+
     /**
      * Draw frame for requested view.
      */
@@ -146,11 +151,13 @@ class StImageViewer : public StApplication {
         StHandle<StBoolParamNamed>    ToHideStatusBar;  //!< hide system-provided status bar
         StHandle<StBoolParamNamed>    ToHideNavBar;     //!< hide system-provided navigation bar
         StHandle<StBoolParamNamed>    IsVSyncOn;        //!< flag to use VSync
+        StHandle<StBoolParamNamed>    ToSkipIdleFrames; //!< skip redraws while neither image nor GUI are changed
         StHandle<StBoolParamNamed>    ToOpenLast;       //!< option to open last file from recent list by default
         StHandle<StBoolParamNamed>    ToSaveRecent;     //!< load/save recent file
         StString                      lastFolder;       //!< laster folder used to open / save file
         StImageFile::ImageClass       imageLib;         //!< preferred image library
         StHandle<StInt32ParamNamed>   TargetFps;        //!< limit or not rendering FPS
+        StHandle<StFloat32Param>      ImageCacheMiB;    //!< memory budget for decoded images cache in MiB
 
     } params;
 
@@ -190,6 +197,7 @@ class StImageViewer : public StApplication {
     ST_LOCAL void doSetStereoOutput(const size_t theMode);
     ST_LOCAL void doPanoramaOnOff(const size_t );
     ST_LOCAL void doChangeStickPano360(const bool );
+    ST_LOCAL void doChangeImageCache(const float );
     ST_LOCAL void doChangeFlipCubeZ(const bool );
     ST_LOCAL void doShowPlayList(const bool theToShow);
     ST_LOCAL void doShowAdjustImage(const bool theToShow);
@@ -249,6 +257,11 @@ class StImageViewer : public StApplication {
      */
     ST_LOCAL void releaseDevice();
 
+    /**
+     * @return true if thumbnails are being generated or generated thumbnails have not been yet displayed
+     */
+    ST_LOCAL bool hasPendingThumbnails();
+
         private: //! @name private fields
 
     StHandle<StGLContext>       myContext;
@@ -265,6 +278,9 @@ class StImageViewer : public StApplication {
     StCondition                 myEventLoaded;     //!< indicate that new file was open
     StTimer                     myInactivityTimer; //!< timer initialized when application goes into paused state
     StTimer                     mySlideShowTimer;  //!< slideshow timer
+    StTimer                     myRedrawTimer;     //!< time since last drawn frame
+    size_t                      myNbPendingDraws;  //!< number of successive frames drawn only due to pending texture queue
+    size_t                      myThumbsStamp;     //!< value of StThumbnailCache::getNbProcessed() on last drawn frame
 
     bool                        myToCheckUpdates;
     bool                        myToSaveSrcFormat; //!< indicates that active source format should be saved or not
@@ -112,6 +112,7 @@ void StImageViewerGUI::createDesktopUI(const StHandle<StPlayList>& thePlayList)
     myDescr = new StGLDescription(this);
 
     myPlayList = new StGLPlayList(this, thePlayList);
+    myPlayList->setShowThumbnails(true);
     myPlayList->setCorner(StGLCorner(ST_VCORNER_TOP, ST_HCORNER_RIGHT));
     myPlayList->changeFitMargins().top    = scale(110);
     myPlayList->changeFitMargins().bottom = scale(110);
@@ -521,6 +522,7 @@ StGLMenu* StImageViewerGUI::createOutputMenu() {
          ->signals.onItemClick.connect(this, &StImageViewerGUI::doAboutRenderer);
     aMenu->addItem(myPlugin->params.ToShowFps);
     aMenu->addItem(myPlugin->params.IsVSyncOn);
+    aMenu->addItem(myPlugin->params.ToSkipIdleFrames);
 
     const StHandle<StWindow>& aRend = myPlugin->getMainWindow();
     StParamsList aParams;
@@ -787,7 +789,9 @@ void StImageViewerGUI::doMobileSettings(const size_t ) {
     aParams.add(myPlugin->params.ToFlipCubeZ6x1);
     aParams.add(myPlugin->params.ToFlipCubeZ3x2);
     aParams.add(myPlugin->params.ToShowFps);
+    aParams.add(myPlugin->params.ToSkipIdleFrames);
     aParams.add(myPlugin->params.SlideShowDelay);
+    aParams.add(myPlugin->params.ImageCacheMiB);
     aParams.add(myLangMap->params.language);
     aParams.add(myPlugin->params.IsMobileUI);
     if(isMobile()) {
@@ -892,6 +896,7 @@ void StImageViewerGUI::createMobileUI(const StHandle<StPlayList>& thePlayList) {
     createMobileBottomToolbar();
 
     myPlayList = new StGLPlayList(this, thePlayList);
+    myPlayList->setShowThumbnails(true);
     myPlayList->setCorner(StGLCorner(ST_VCORNER_TOP, ST_HCORNER_RIGHT));
     myPlayList->changeFitMargins().top    = scale(56);
     myPlayList->changeFitMargins().bottom = scale(100);
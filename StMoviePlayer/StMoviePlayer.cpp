@@ -104,6 +104,8 @@ void StMoviePlayer::updateStrings() {
     params.ScaleHiDPI2X->setName(tr(MENU_HELP_SCALE_HIDPI2X));
     params.SubtitlesPlace->setName(stCString("Subtitles Placement"));
     params.ToSearchSubs->setName(stCString("Search additional tracks"));
+    params.ToCacheKeyframes->setName(stCString("Cache key frames index"));
+    params.ToShowThumbnails->setName(stCString("Seek bar thumbnails"));
     params.SubtitlesParser->setName(tr(MENU_SUBTITLES_PARSER));
     params.SubtitlesParser->defineOption(0, tr(MENU_SUBTITLES_PLAIN_TEXT));
     params.SubtitlesParser->defineOption(1, tr(MENU_SUBTITLES_LITE_HTML));
@@ -228,6 +230,8 @@ StMoviePlayer::StMoviePlayer(const StHandle<StResourceManager>& theResMgr,
     params.SubtitlesParallax->setStep(1.0f);
     params.SubtitlesParallax->setTolerance(0.1f);
     params.ToSearchSubs = new StBoolParamNamed(true, stCString("toSearchSubs"));
+    params.ToCacheKeyframes = new StBoolParamNamed(false, stCString("toCacheKeyframes"));
+    params.ToShowThumbnails = new StBoolParamNamed(true,  stCString("toShowSeekThumbs"));
     params.SubtitlesParser = new StEnumParam(1, stCString("subsParser"));
     params.AudioAlDevice = new StALDeviceParam();
     params.AudioAlHrtf   = new StEnumParam(0, stCString("alHrtfRequest"));
@@ -323,6 +327,8 @@ StMoviePlayer::StMoviePlayer(const StHandle<StResourceManager>& theResMgr,
     mySettings->loadParam (params.SubtitlesParallax);
     mySettings->loadParam (params.SubtitlesParser);
     mySettings->loadParam (params.ToSearchSubs);
+    mySettings->loadParam (params.ToCacheKeyframes);
+    mySettings->loadParam (params.ToShowThumbnails);
 
     myToCheckPoorOrient = !mySettings->loadParam(params.ToTrackHead);
     mySettings->loadParam (params.ToStickPanorama);
@@ -562,6 +568,8 @@ void StMoviePlayer::saveAllParams() {
         mySettings->saveParam (params.SubtitlesParallax);
         mySettings->saveParam (params.SubtitlesParser);
         mySettings->saveParam (params.ToSearchSubs);
+        mySettings->saveParam (params.ToCacheKeyframes);
+        mySettings->saveParam (params.ToShowThumbnails);
         mySettings->saveParam (params.TargetFps);
         mySettings->saveString(params.AudioAlDevice->getKey(), params.AudioAlDevice->getUtfTitle());
         mySettings->saveParam (params.AudioAlHrtf);
@@ -843,6 +851,8 @@ bool StMoviePlayer::init() {
         myVideo->params.UseGpu       = params.UseGpu;
         myVideo->params.UseOpenJpeg  = params.UseOpenJpeg;
         myVideo->params.ToSearchSubs = params.ToSearchSubs;
+        myVideo->params.ToCacheKeyframes = params.ToCacheKeyframes;
+        myVideo->params.ToShowThumbnails = params.ToShowThumbnails;
         myVideo->params.ToTrackHeadAudio = params.ToTrackHeadAudio;
         myVideo->setStickPano360(params.ToStickPanorama->getValue());
         myVideo->setForceBFormat(params.ToForceBFormat->getValue());
@@ -1473,6 +1483,7 @@ void StMoviePlayer::beforeDraw() {
     }
     if(myGUI->mySeekBar != NULL) {
         myGUI->mySeekBar->setProgress(GLfloat(aPosition));
+        myGUI->mySeekBar->setThumbnails(myVideo->getThumbnails());
     }
     myGUI->stglUpdate(myWindow->getMousePos(), myWindow->isPreciseCursor());
 
@@ -2054,6 +2065,20 @@ int StMoviePlayer::beginRequest(mg_connection*         theConnection,
         myVideo->pushPlayEvent(ST_PLAYEVENT_RESUME);
         myVideo->doLoadNext();
         aContent = "open item...";
+    } else if(anURI.isEquals(stCString("/latency"))) {
+        // return per-stage latency of playback pipeline in JSON format
+        aContent = "{";
+        if(!myVideo.isNull()) {
+            const StLatencyMeter& aMeter = myVideo->getTextureQueue()->getLatencyMeter();
+            for(int aStageIter = 0; aStageIter < StLatencyMeter::StageNb; ++aStageIter) {
+                double anAver = 0.0, aMax = 0.0;
+                aMeter.getStats(StLatencyMeter::Stage(aStageIter), anAver, aMax);
+                aContent = aContent + (aStageIter != 0 ? ", " : " ")
+                         + "\"" + StLatencyMeter::getStageName(StLatencyMeter::Stage(aStageIter)) + "\": "
+                         + "{ \"aver\": " + anAver + ", \"max\": " + aMax + " }";
+            }
+        }
+        aContent += " }";
     } else if(anURI.isEquals(stCString("/version"))) {
         aContent = StVersionInfo::getSDKVersionString();
     } else if(anURI.isEquals(stCString("/playlist"))) {
@@ -185,6 +185,8 @@ class StMoviePlayer : public StApplication {
         StHandle<StFloat32Param>      SubtitlesSize;     //!< subtitles font size
         StHandle<StFloat32Param>      SubtitlesParallax; //!< subtitles parallax
         StHandle<StBoolParamNamed>    ToSearchSubs;      //!< automatically search for additional subtitles/audio track files nearby video file
+        StHandle<StBoolParamNamed>    ToCacheKeyframes;  //!< persist key frames index of opened files to speed up seeking
+        StHandle<StBoolParamNamed>    ToShowThumbnails;  //!< show thumbnails preview on seek bar hover
         StHandle<StEnumParam>         SubtitlesParser;   //!< subtitles parser
         StHandle<StALDeviceParam>     AudioAlDevice;     //!< active OpenAL device
         StHandle<StEnumParam>         AudioAlHrtf;       //!< OpenAL HRTF flag
@@ -2114,6 +2114,7 @@ void StMoviePlayerGUI::stglDraw(unsigned int theView) {
         myImage->getTextureQueue()->getQueueInfo(myFpsWidget->changePlayQueued(),
                                                  myFpsWidget->changePlayQueueLength(),
                                                  myFpsWidget->changePlayFps());
+        myFpsWidget->setLatencyMeter(&myImage->getTextureQueue()->getLatencyMeter());
         myFpsWidget->update(myPlugin->getMainWindow()->isStereoOutput(),
                             myPlugin->getMainWindow()->getTargetFps(),
                             myPlugin->getMainWindow()->getStatistics());
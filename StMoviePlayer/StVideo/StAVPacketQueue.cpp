@@ -1,5 +1,5 @@
 /**
- * Copyright © 2009-2016 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2009-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * StMoviePlayer program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -25,6 +25,11 @@ namespace {
     const StAVPacket ST_FLUSH_PACKET(NULL, StAVPacket::FLUSH_PACKET);
     const StAVPacket ST_QUIT_PACKET (NULL, StAVPacket::QUIT_PACKET);
 
+    /**
+     * Maximum number of decoded packets kept for reuse.
+     */
+    const size_t ST_PACKET_POOL_SIZE = 32;
+
 }
 
 // auxiliary structure
@@ -33,9 +38,8 @@ struct StAVPacketQueue::QueueItem {
     StHandle<StAVPacket> myItem; //!< handle for packet
     QueueItem* myNext; //!< link to the next queue item
 
-    ST_LOCAL QueueItem(const StAVPacket& thePacket)
-    : myItem(new StAVPacket(thePacket)), // copy with content
-      myNext(NULL) {}
+    ST_LOCAL QueueItem()
+    : myNext(NULL) {}
 
 };
 
@@ -61,6 +65,9 @@ StAVPacketQueue::StAVPacketQueue(const size_t theSizeLimit)
   // queue
   myFront(NULL),
   myBack(NULL),
+  myPoolFront(NULL),
+  myPoolBack(NULL),
+  myPoolSize(0),
   mySize(0),
   mySizeLimit(theSizeLimit),
   mySizeSeconds(0.0),
@@ -115,6 +122,7 @@ bool StAVPacketQueue::init(AVFormatContext*   theFormatCtx,
 }
 
 void StAVPacketQueue::deinit() {
+    releasePool();
     myFileName.clear();
     myFormatCtx = NULL;
     myStream    = NULL;
@@ -171,24 +179,103 @@ StHandle<StAVPacket> StAVPacketQueue::pop() {
         QueueItem* anItem = myFront;
         myFront = myFront->myNext;
         StHandle<StAVPacket> aPacket = anItem->myItem;
-        delete anItem;
+        aPacket->changeStamps().Dequeued = StFrameStamps::now();
         --mySize;
         mySizeSeconds -= aPacket->getDurationSeconds();
+
+        // keep the item for reuse, but do not hold the packet (and its payload) which is now owned by decoder
+        anItem->myItem.nullify();
+        anItem->myNext = NULL;
+        if(myPoolBack == NULL) {
+            myPoolFront = myPoolBack = anItem;
+        } else {
+            myPoolBack->myNext = anItem;
+            myPoolBack = anItem;
+        }
+        if(++myPoolSize > mySizeLimit) {
+            QueueItem* anOldest = myPoolFront;
+            myPoolFront = anOldest->myNext;
+            delete anOldest;
+            --myPoolSize;
+        }
     myMutex.unlock();
     return aPacket;
 }
 
-void StAVPacketQueue::push(const StAVPacket& thePacket) {
+StAVPacketQueue::QueueItem* StAVPacketQueue::allocItem() {
+    QueueItem* anItem = myPoolFront;
+    if(anItem == NULL) {
+        anItem = new QueueItem();
+    } else {
+        myPoolFront = anItem->myNext;
+        if(myPoolFront == NULL) {
+            myPoolBack = NULL;
+        }
+        --myPoolSize;
+        anItem->myNext = NULL;
+    }
+
+    if(myPacketPool.empty()) {
+        anItem->myItem = new StAVPacket();
+    } else {
+        anItem->myItem = myPacketPool.back();
+        myPacketPool.pop_back();
+    }
+    return anItem;
+}
+
+void StAVPacketQueue::pushItem(QueueItem* theItem) {
+    if(isEmpty()) {
+        myFront = myBack = theItem;
+    } else {
+        myBack->myNext = theItem;
+        myBack = theItem;
+    }
+    ++mySize;
+    mySizeSeconds += theItem->myItem->getDurationSeconds();
+    theItem->myItem->changeStamps().Queued = StFrameStamps::now();
+}
+
+void StAVPacketQueue::releasePool() {
     myMutex.lock();
-        QueueItem* anItem = new QueueItem(thePacket);
-        if(isEmpty()) {
-            myFront = myBack = anItem;
-        } else {
-            myBack->myNext = anItem;
-            myBack = anItem;
+    while(myPoolFront != NULL) {
+        QueueItem* anItem = myPoolFront;
+        myPoolFront = anItem->myNext;
+        delete anItem;
+    }
+    myPoolBack = NULL;
+    myPoolSize = 0;
+    myPacketPool.clear();
+    myMutex.unlock();
+}
+
+void StAVPacketQueue::recycle(StHandle<StAVPacket>& thePacket) {
+    if(!thePacket.isNull()
+    &&  thePacket.isUnique()
+    &&  thePacket->getType() == StAVPacket::DATA_PACKET) {
+        thePacket->recycle();
+        myMutex.lock();
+        if(myPacketPool.size() < ST_PACKET_POOL_SIZE) {
+            myPacketPool.push_back(thePacket);
         }
-        ++mySize;
-        mySizeSeconds += thePacket.getDurationSeconds();
+        myMutex.unlock();
+    }
+    thePacket.nullify();
+}
+
+void StAVPacketQueue::push(const StAVPacket& thePacket) {
+    myMutex.lock();
+        QueueItem* anItem = allocItem();
+        anItem->myItem->copyFrom(thePacket); // copy with content
+        pushItem(anItem);
+    myMutex.unlock();
+}
+
+void StAVPacketQueue::pushMove(StAVPacket& thePacket) {
+    myMutex.lock();
+        QueueItem* anItem = allocItem();
+        anItem->myItem->moveFrom(thePacket);
+        pushItem(anItem);
     myMutex.unlock();
 }
 
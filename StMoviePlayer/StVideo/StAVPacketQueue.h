@@ -1,5 +1,5 @@
 /**
- * Copyright © 2009-2016 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2009-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * StMoviePlayer program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -25,6 +25,8 @@
 
 #include <StAV/StAVPacket.h>
 
+#include <vector>
+
 typedef enum {
     ST_PLAYEVENT_NONE = 0,
     ST_PLAYEVENT_RESET,
@@ -74,6 +76,20 @@ class StAVPacketQueue {
      */
     ST_LOCAL void push(const StAVPacket& thePacket);
 
+    /**
+     * Add packet to the queue without copying its content.
+     * @param thePacket packet to add, will be left empty
+     */
+    ST_LOCAL void pushMove(StAVPacket& thePacket);
+
+    /**
+     * Return decoded packet to the pool for reuse.
+     * The packet (with its data buffer) is recycled only when the handle is unique,
+     * otherwise it is just released.
+     * @param thePacket packet to release, will be nullified
+     */
+    ST_LOCAL void recycle(StHandle<StAVPacket>& thePacket);
+
     ST_LOCAL void pushStart();
     ST_LOCAL void pushEnd();
     ST_LOCAL void pushQuit();
@@ -259,12 +275,35 @@ class StAVPacketQueue {
     bool             myIsPlaying;      //!< playback state
     bool             myIsAttachedPic;  //!< flag indicating the stream is attached image
 
-        private: //! @name Private fields
+        private: //! @name Private methods
 
     struct QueueItem;
 
+    /**
+     * Take queue item from the pool of recycled items or allocate new one.
+     * Should be called within locked myMutex.
+     */
+    ST_LOCAL QueueItem* allocItem();
+
+    /**
+     * Append filled item to the queue.
+     */
+    ST_LOCAL void pushItem(QueueItem* theItem);
+
+    /**
+     * Release the pools of recycled items and packets.
+     */
+    ST_LOCAL void releasePool();
+
+        private: //! @name Private fields
+
     QueueItem*       myFront;          //!< queue front packet (first to pop)
     QueueItem*       myBack;           //!< queue back  packet (last  to pop)
+    QueueItem*       myPoolFront;      //!< oldest popped item (without packet), first candidate for reuse
+    QueueItem*       myPoolBack;       //!< last   popped item
+    size_t           myPoolSize;       //!< number of items in the pool
+    std::vector< StHandle<StAVPacket> >
+                     myPacketPool;     //!< decoded packets returned for reuse, keeping their data buffers
     size_t           mySize;           //!< packets number in queue
     size_t           mySizeLimit;      //!< packets limit
     double           mySizeSeconds;    //!< cumulative packets length in seconds
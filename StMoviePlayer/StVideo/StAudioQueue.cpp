@@ -1292,7 +1292,7 @@ void StAudioQueue::decodeLoop() {
 
         // we got the data packet, so decode it
         decodePacket(aPacket, aPts);
-        aPacket.nullify();
+        recycle(aPacket);
     }
 }
 
@@ -0,0 +1,409 @@
+/**
+ * Copyright © 2017 Kirill Gavrilov <kirill@sview.ru>
+ *
+ * StMoviePlayer program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * StMoviePlayer program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "StKeyframeIndex.h"
+
+#include <StAV/StAVPacket.h>
+#include <StFile/StFileNode.h>
+#include <StFile/StRawFile.h>
+#include <StStrings/StLogger.h>
+#include <StThreads/StTimer.h>
+
+namespace {
+
+    static const char     THE_INDEX_MAGIC[4] = { 'S', 'V', 'K', 'I' };
+    static const uint32_t THE_INDEX_VERSION  = 3;
+    static const int      THE_PAUSE_DELAY_MS = 50; //!< delay while scan is paused
+
+    /**
+     * Header of persisted index.
+     */
+    struct StKeyframeIndexHeader {
+        char     Magic[4];
+        uint32_t Version;
+        int64_t  FileSize;
+        int64_t  FileTime;
+        int32_t  StreamId;
+        uint32_t IsComplete;
+        uint32_t IsBroken;
+        uint32_t Reserved;
+        uint64_t NbEntries;
+    };
+
+    /**
+     * Entry of persisted index.
+     */
+    struct StKeyframeIndexEntry {
+        int64_t Timestamp;
+        int64_t Pos;
+        int64_t IsFollowing;
+    };
+
+    /**
+     * FNV-1a hash of the string.
+     */
+    static uint64_t hashString(const StString& theString) {
+        uint64_t aHash = 14695981039346656037ULL;
+        const char* aStr = theString.toCString();
+        for(size_t anIter = 0; anIter < theString.getSize(); ++anIter) {
+            aHash ^= uint64_t((unsigned char )aStr[anIter]);
+            aHash *= 1099511628211ULL;
+        }
+        return aHash;
+    }
+
+}
+
+StKeyframeIndex::StKeyframeIndex()
+: myFileSize(0),
+  myFileTime(0),
+  myStreamId(-1),
+  myIsComplete(false),
+  myIsBroken(false),
+  myIsModified(false),
+  myToPause(false),
+  myToQuit(false) {
+    //
+}
+
+StKeyframeIndex::~StKeyframeIndex() {
+    release();
+}
+
+void StKeyframeIndex::open(const StString& theFilePath,
+                           const int       theStreamId,
+                           const int64_t   theFileSize,
+                           const StString& theCacheFolder,
+                           const bool      theToScan) {
+    release();
+
+    myFilePath    = theFilePath;
+    myCacheFolder = theCacheFolder;
+    myFileSize    = theFileSize;
+    myFileTime    = 0;
+    myStreamId    = theStreamId;
+    uint64_t aStatSize = 0;
+    StFileNode::getFileStat(myFilePath, aStatSize, myFileTime);
+    if(!myCacheFolder.isEmpty()) {
+        load();
+    }
+
+    if(theToScan
+    && !myIsComplete
+    && !myIsBroken) {
+        myToQuit  = false;
+        myToPause = false;
+        myScanThread = new StThread(scanThread, (void* )this, "StKeyframeIndex");
+    }
+}
+
+void StKeyframeIndex::release() {
+    if(!myScanThread.isNull()) {
+        myToQuit = true;
+        myScanThread->wait();
+        myScanThread.nullify();
+    }
+    if(myIsModified
+    && !myCacheFolder.isEmpty()) {
+        save();
+    }
+
+    StMutexAuto aLock(myMutex);
+    myEntries.clear();
+    myFilePath.clear();
+    myCacheFolder.clear();
+    myFileSize   = 0;
+    myFileTime   = 0;
+    myStreamId   = -1;
+    myIsComplete = false;
+    myIsBroken   = false;
+    myIsModified = false;
+}
+
+void StKeyframeIndex::breakIndex() {
+    if(myIsBroken) {
+        return;
+    }
+
+    ST_DEBUG_LOG("StKeyframeIndex, timestamp discontinuity detected - index is dropped");
+    myEntries.clear();
+    myIsBroken   = true;
+    myIsComplete = false;
+    myIsModified = true;
+}
+
+void StKeyframeIndex::add(const int64_t theTimestamp,
+                          const int64_t thePos,
+                          const int64_t thePrevTimestamp) {
+    if(theTimestamp == stAV::NOPTS_VALUE
+    || thePos < 0) {
+        return;
+    }
+
+    StMutexAuto aLock(myMutex);
+    if(myIsBroken) {
+        return;
+    } else if(thePrevTimestamp != stAV::NOPTS_VALUE
+           && thePrevTimestamp >= theTimestamp) {
+        // timestamps go backward in reading order
+        breakIndex();
+        return;
+    }
+
+    // find the first entry with timestamp not less than new one
+    size_t aLower = 0;
+    for(size_t aCount = myEntries.size(); aCount > 0;) {
+        const size_t aStep = aCount / 2;
+        if(myEntries[aLower + aStep].Timestamp < theTimestamp) {
+            aLower += aStep + 1;
+            aCount -= aStep + 1;
+        } else {
+            aCount = aStep;
+        }
+    }
+
+    Entry* aPrev = aLower != 0                ? &myEntries[aLower - 1] : NULL;
+    Entry* aNext = aLower != myEntries.size() ? &myEntries[aLower]     : NULL;
+
+    // the entry follows its sorted predecessor only if the same reader has read them one after another
+    const bool isFollowing = aPrev != NULL
+                          && thePrevTimestamp != stAV::NOPTS_VALUE
+                          && aPrev->Timestamp == thePrevTimestamp;
+    if(aNext != NULL
+    && aNext->Timestamp == theTimestamp) {
+        if(aNext->Pos != thePos) {
+            breakIndex();
+        } else if(isFollowing
+              && !aNext->IsFollowing) {
+            // already known key frame - just extend the continuous range
+            aNext->IsFollowing = true;
+            myIsModified = true;
+        }
+        return;
+    }
+
+    if((aPrev != NULL && aPrev->Pos >= thePos)
+    || (aNext != NULL && aNext->Pos <= thePos)
+    || (aNext != NULL && aNext->IsFollowing)) {
+        // byte positions do not grow together with timestamps,
+        // or new key frame appears between the key frames known to be adjacent
+        breakIndex();
+        return;
+    }
+
+    Entry anEntry;
+    anEntry.Timestamp   = theTimestamp;
+    anEntry.Pos         = thePos;
+    anEntry.IsFollowing = isFollowing;
+    myEntries.insert(myEntries.begin() + aLower, anEntry);
+    myIsModified = true;
+}
+
+bool StKeyframeIndex::find(const int64_t theTarget,
+                           const bool    theToSeekBack,
+                           int64_t&      thePos) const {
+    StMutexAuto aLock(myMutex);
+    if(myEntries.empty()) {
+        return false;
+    }
+
+    // find the first entry with timestamp greater than target
+    size_t aNext = 0;
+    for(size_t aCount = myEntries.size(); aCount > 0;) {
+        const size_t aStep = aCount / 2;
+        if(myEntries[aNext + aStep].Timestamp <= theTarget) {
+            aNext  += aStep + 1;
+            aCount -= aStep + 1;
+        } else {
+            aCount = aStep;
+        }
+    }
+
+    if(theToSeekBack) {
+        if(aNext == 0) {
+            return false;
+        }
+
+        const Entry& aPrev = myEntries[aNext - 1];
+        const bool isCovered = aPrev.Timestamp == theTarget
+                            || (aNext <  myEntries.size() && myEntries[aNext].IsFollowing)
+                            || (aNext == myEntries.size() && myIsComplete);
+        if(!isCovered) {
+            return false;
+        }
+        thePos = aPrev.Pos;
+        return true;
+    }
+
+    if(aNext != 0
+    && myEntries[aNext - 1].Timestamp == theTarget) {
+        thePos = myEntries[aNext - 1].Pos;
+        return true;
+    } else if(aNext == 0
+           || aNext == myEntries.size()
+           || !myEntries[aNext].IsFollowing) {
+        return false;
+    }
+    thePos = myEntries[aNext].Pos;
+    return true;
+}
+
+SV_THREAD_FUNCTION StKeyframeIndex::scanThread(void* theIndex) {
+    ((StKeyframeIndex* )theIndex)->scanLoop();
+    return SV_THREAD_RETURN 0;
+}
+
+void StKeyframeIndex::scanLoop() {
+    AVFormatContext* aFormatCtx = NULL;
+#if(LIBAVFORMAT_VERSION_INT >= AV_VERSION_INT(53, 2, 0))
+    int anErr = avformat_open_input(&aFormatCtx, myFilePath.toCString(), NULL, NULL);
+#else
+    int anErr = av_open_input_file (&aFormatCtx, myFilePath.toCString(), NULL, 0, NULL);
+#endif
+    if(anErr != 0) {
+        if(aFormatCtx != NULL) {
+        #if(LIBAVFORMAT_VERSION_INT >= AV_VERSION_INT(53, 17, 0))
+            avformat_close_input(&aFormatCtx);
+        #else
+            av_close_input_file(aFormatCtx);
+        #endif
+        }
+        return;
+    }
+
+#if(LIBAVFORMAT_VERSION_INT >= AV_VERSION_INT(53, 6, 0))
+    anErr = avformat_find_stream_info(aFormatCtx, NULL);
+#else
+    anErr = av_find_stream_info(aFormatCtx);
+#endif
+    if(anErr >= 0
+    && myStreamId < int(aFormatCtx->nb_streams)) {
+        // skip all other streams
+        for(unsigned int aStreamId = 0; aStreamId < aFormatCtx->nb_streams; ++aStreamId) {
+            aFormatCtx->streams[aStreamId]->discard = int(aStreamId) == myStreamId ? AVDISCARD_DEFAULT : AVDISCARD_ALL;
+        }
+
+        StTimer aTimer(true);
+        StAVPacket aPacket;
+        int64_t aPrevTimestamp = stAV::NOPTS_VALUE;
+        size_t aNbKeyFrames = 0;
+        while(!myToQuit
+           && !myIsBroken) {
+            while(myToPause && !myToQuit) {
+                StThread::sleep(THE_PAUSE_DELAY_MS);
+            }
+
+            anErr = av_read_frame(aFormatCtx, aPacket.getAVpkt());
+            if(anErr < 0) {
+                if(anErr == AVERROR_EOF) {
+                    myIsComplete = true;
+                    myIsModified = true;
+                    ST_DEBUG_LOG(StString("StKeyframeIndex, ") + aNbKeyFrames + " key frames indexed within "
+                               + aTimer.getElapsedTimeInSec() + " seconds");
+                }
+                break;
+            }
+
+            if(aPacket.getStreamId() == myStreamId
+            && aPacket.isKeyFrame()) {
+                const int64_t aTimestamp = aPacket.getPts() != stAV::NOPTS_VALUE ? aPacket.getPts() : aPacket.getDts();
+                if(aTimestamp != stAV::NOPTS_VALUE) {
+                    add(aTimestamp, aPacket.getAVpkt()->pos, aPrevTimestamp);
+                    aPrevTimestamp = aTimestamp;
+                    ++aNbKeyFrames;
+                }
+            }
+            aPacket.free();
+        }
+    }
+
+#if(LIBAVFORMAT_VERSION_INT >= AV_VERSION_INT(53, 17, 0))
+    avformat_close_input(&aFormatCtx);
+#else
+    av_close_input_file(aFormatCtx);
+#endif
+}
+
+StString StKeyframeIndex::getCachePath() const {
+    const uint64_t aHash = hashString(myFilePath);
+    char aBuffer[64];
+    stsprintf(aBuffer, 64, "%08x%08x_%d.kfi",
+              (unsigned int )(aHash >> 32), (unsigned int )(aHash & 0xFFFFFFFF), myStreamId);
+    return myCacheFolder + aBuffer;
+}
+
+bool StKeyframeIndex::load() {
+    StRawFile aFile(getCachePath());
+    if(!aFile.readFile()
+    ||  aFile.getSize() < sizeof(StKeyframeIndexHeader)) {
+        return false;
+    }
+
+    const StKeyframeIndexHeader* aHeader = (const StKeyframeIndexHeader* )aFile.getBuffer();
+    if(!stAreEqual(aHeader->Magic, THE_INDEX_MAGIC, sizeof(THE_INDEX_MAGIC))
+    || aHeader->Version   != THE_INDEX_VERSION
+    || aHeader->FileSize  != myFileSize
+    || aHeader->FileTime  != myFileTime
+    || aHeader->StreamId  != myStreamId
+    || aHeader->NbEntries != (aFile.getSize() - sizeof(StKeyframeIndexHeader)) / sizeof(StKeyframeIndexEntry)) {
+        ST_DEBUG_LOG(StString("StKeyframeIndex, outdated index '") + aFile.getPath() + "' is ignored");
+        return false;
+    }
+
+    const StKeyframeIndexEntry* anEntries = (const StKeyframeIndexEntry* )(aFile.getBuffer() + sizeof(StKeyframeIndexHeader));
+    StMutexAuto aLock(myMutex);
+    myEntries.resize(size_t(aHeader->NbEntries));
+    for(size_t anIter = 0; anIter < myEntries.size(); ++anIter) {
+        myEntries[anIter].Timestamp   = anEntries[anIter].Timestamp;
+        myEntries[anIter].Pos         = anEntries[anIter].Pos;
+        myEntries[anIter].IsFollowing = anEntries[anIter].IsFollowing != 0;
+    }
+    myIsComplete = aHeader->IsComplete != 0;
+    myIsBroken   = aHeader->IsBroken   != 0;
+    myIsModified = false;
+    return true;
+}
+
+bool StKeyframeIndex::save() const {
+    StMutexAuto aLock(myMutex);
+    if(myEntries.size() < 2
+    && !myIsBroken) {
+        return false;
+    }
+
+    StRawFile aFile(getCachePath());
+    aFile.initBuffer(sizeof(StKeyframeIndexHeader) + sizeof(StKeyframeIndexEntry) * myEntries.size());
+    StKeyframeIndexHeader* aHeader = (StKeyframeIndexHeader* )aFile.changeBuffer();
+    stMemZero(aHeader, sizeof(StKeyframeIndexHeader));
+    stMemCpy(aHeader->Magic, THE_INDEX_MAGIC, sizeof(THE_INDEX_MAGIC));
+    aHeader->Version    = THE_INDEX_VERSION;
+    aHeader->FileSize   = myFileSize;
+    aHeader->FileTime   = myFileTime;
+    aHeader->StreamId   = myStreamId;
+    aHeader->IsComplete = myIsComplete ? 1 : 0;
+    aHeader->IsBroken   = myIsBroken   ? 1 : 0;
+    aHeader->NbEntries  = myEntries.size();
+
+    StKeyframeIndexEntry* anEntries = (StKeyframeIndexEntry* )(aFile.changeBuffer() + sizeof(StKeyframeIndexHeader));
+    for(size_t anIter = 0; anIter < myEntries.size(); ++anIter) {
+        anEntries[anIter].Timestamp   = myEntries[anIter].Timestamp;
+        anEntries[anIter].Pos         = myEntries[anIter].Pos;
+        anEntries[anIter].IsFollowing = myEntries[anIter].IsFollowing ? 1 : 0;
+    }
+    return aFile.saveFile();
+}
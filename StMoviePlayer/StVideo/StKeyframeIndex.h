@@ -0,0 +1,180 @@
+/**
+ * Copyright © 2017 Kirill Gavrilov <kirill@sview.ru>
+ *
+ * StMoviePlayer program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * StMoviePlayer program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __StKeyframeIndex_h_
+#define __StKeyframeIndex_h_
+
+#include <StAV/stAV.h>
+#include <StStrings/StString.h>
+#include <StThreads/StMutex.h>
+#include <StThreads/StThread.h>
+
+#include <vector>
+
+/**
+ * In-memory index of key frames (timestamp -> byte offset) within single video stream.
+ * The index is filled lazily by demuxing thread during playback and by background scan of the file,
+ * so that seeking can jump straight to the byte position of the nearest key frame
+ * instead of relying on (possibly missing) container index.
+ *
+ * Each entry remembers whether it directly follows the previous entry (no key frames in-between),
+ * so that entries collected around different playback positions are never mistaken for neighbors.
+ *
+ * Byte positions are expected to grow together with timestamps.
+ * The index is dropped as soon as timestamp discontinuity is detected
+ * (timestamps going backward in reading order or not matching byte positions),
+ * since such stream (e.g. concatenated MPEG-TS) can not be seeked by timestamp -> position mapping.
+ */
+class StKeyframeIndex {
+
+        public:
+
+    /**
+     * Empty constructor.
+     */
+    ST_LOCAL StKeyframeIndex();
+
+    /**
+     * Destructor.
+     */
+    ST_LOCAL ~StKeyframeIndex();
+
+    /**
+     * Bind the index to the new stream.
+     * Previous index is released (and saved).
+     * @param theFilePath   path to the file
+     * @param theStreamId   stream index within the file
+     * @param theFileSize   file size in bytes used to validate persisted index (together with file modification time)
+     * @param theCacheFolder folder to persist index, empty string disables persistence
+     * @param theToScan     start background scan of the file
+     */
+    ST_LOCAL void open(const StString& theFilePath,
+                       const int       theStreamId,
+                       const int64_t   theFileSize,
+                       const StString& theCacheFolder,
+                       const bool      theToScan);
+
+    /**
+     * Stop background scan, save and clear the index.
+     */
+    ST_LOCAL void release();
+
+    /**
+     * Suspend background scan, so that it does not compete with playback for I/O.
+     */
+    ST_LOCAL void setPaused(const bool theToPause) {
+        myToPause = theToPause;
+    }
+
+    /**
+     * @return stream index within the file or -1 if index is not bound
+     */
+    ST_LOCAL int getStreamId() const {
+        return myStreamId;
+    }
+
+    /**
+     * Register key frame.
+     * @param theTimestamp     key frame timestamp in stream time units
+     * @param thePos           byte position of the packet in the file
+     * @param thePrevTimestamp timestamp of the key frame read right before this one by the same reader,
+     *                         or stAV::NOPTS_VALUE if reading has been started or restarted (after seeking)
+     */
+    ST_LOCAL void add(const int64_t theTimestamp,
+                      const int64_t thePos,
+                      const int64_t thePrevTimestamp);
+
+    /**
+     * @return true if index has been dropped due to timestamp discontinuity
+     */
+    ST_LOCAL bool isBroken() const {
+        return myIsBroken;
+    }
+
+    /**
+     * Find key frame for seeking.
+     * @param theTarget    seek target in stream time units
+     * @param theToSeekBack find the nearest preceding key frame when true, the nearest following one otherwise
+     * @param thePos       found byte position
+     * @return false if index does not cover requested position
+     */
+    ST_LOCAL bool find(const int64_t theTarget,
+                       const bool    theToSeekBack,
+                       int64_t&      thePos) const;
+
+        private:
+
+    /**
+     * Index entry.
+     */
+    struct Entry {
+        int64_t Timestamp;   //!< key frame timestamp in stream time units
+        int64_t Pos;         //!< byte position in the file
+        bool    IsFollowing; //!< no key frames between this and previous entry
+    };
+
+    /**
+     * Drop the index due to detected discontinuity.
+     * Should be called within locked mutex.
+     */
+    ST_LOCAL void breakIndex();
+
+    /**
+     * Background scan loop.
+     */
+    ST_LOCAL void scanLoop();
+
+    /**
+     * Thread function.
+     */
+    static SV_THREAD_FUNCTION scanThread(void* theIndex);
+
+    /**
+     * Load persisted index.
+     */
+    ST_LOCAL bool load();
+
+    /**
+     * Save the index.
+     */
+    ST_LOCAL bool save() const;
+
+    /**
+     * @return path to the file storing the index
+     */
+    ST_LOCAL StString getCachePath() const;
+
+        private:
+
+    std::vector<Entry> myEntries;     //!< index entries sorted by timestamp
+    StHandle<StThread> myScanThread;  //!< background scan thread
+    mutable StMutex    myMutex;       //!< lock for thread-safety
+    StString           myFilePath;    //!< file path
+    StString           myCacheFolder; //!< folder to persist index
+    int64_t            myFileSize;    //!< file size
+    int64_t            myFileTime;    //!< file modification time
+    int                myStreamId;    //!< stream index
+    volatile bool      myIsComplete;  //!< the whole file has been indexed
+    volatile bool      myIsBroken;    //!< index has been dropped due to timestamp discontinuity
+    volatile bool      myIsModified;  //!< index has been modified after loading
+    volatile bool      myToPause;     //!< flag to suspend background scan
+    volatile bool      myToQuit;      //!< flag to stop background scan
+
+};
+
+#endif // __StKeyframeIndex_h_
@@ -1,5 +1,5 @@
 /**
- * Copyright © 2009-2014 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2009-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * StMoviePlayer program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -21,6 +21,14 @@
 #include <stAssert.h>
 #include <StStrings/StLogger.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define ST_PCM_HAVE_SSE2
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON) || defined(__aarch64__)
+    #include <arm_neon.h>
+    #define ST_PCM_HAVE_NEON
+#endif
+
 /**
  * 1 second of 48khz 32bit audio (old AVCODEC_MAX_AUDIO_FRAME_SIZE).
  */
@@ -341,6 +349,186 @@ inline void sampleConv(const double& theSrcSample, double& theOutSample) {
     theOutSample = theSrcSample;
 }
 
+#if defined(ST_PCM_HAVE_SSE2) || defined(ST_PCM_HAVE_NEON)
+
+// Vectorized conversion works on 4 samples packed into float vector.
+// Integer samples are normalized into -1.0 .. 1.0 range just like scalar sampleConv() does.
+#if defined(ST_PCM_HAVE_SSE2)
+typedef __m128 StPcmVec4;
+
+inline StPcmVec4 pcmLoad4(const float* theSrc) {
+    return _mm_loadu_ps(theSrc);
+}
+
+inline StPcmVec4 pcmLoad4(const int16_t* theSrc) {
+    __m128i aVec = _mm_loadl_epi64((const __m128i* )theSrc);
+    aVec = _mm_srai_epi32(_mm_unpacklo_epi16(aVec, aVec), 16);
+    return _mm_mul_ps(_mm_cvtepi32_ps(aVec), _mm_set1_ps(ST_INT16_MAX_INV_F));
+}
+
+inline StPcmVec4 pcmLoad4(const int32_t* theSrc) {
+    const __m128i aVec = _mm_loadu_si128((const __m128i* )theSrc);
+    return _mm_mul_ps(_mm_cvtepi32_ps(aVec), _mm_set1_ps(ST_INT32_MAX_INV_F));
+}
+
+inline void pcmStore4(float* theOut, const StPcmVec4& theVec) {
+    _mm_storeu_ps(theOut, theVec);
+}
+
+inline void pcmStore2(float* theOut, const StPcmVec4& theVec) {
+    _mm_storel_pi((__m64* )theOut, theVec);
+}
+
+inline __m128i pcmToInt16(const StPcmVec4& theVec) {
+    const __m128i aVec = _mm_cvttps_epi32(_mm_mul_ps(theVec, _mm_set1_ps(ST_INT16_MAX_F)));
+    return _mm_packs_epi32(aVec, aVec); // saturate
+}
+
+inline void pcmStore4(int16_t* theOut, const StPcmVec4& theVec) {
+    _mm_storel_epi64((__m128i* )theOut, pcmToInt16(theVec));
+}
+
+inline void pcmStore2(int16_t* theOut, const StPcmVec4& theVec) {
+    const int32_t aPair = _mm_cvtsi128_si32(pcmToInt16(theVec));
+    stMemCpy(theOut, &aPair, sizeof(aPair));
+}
+
+inline StPcmVec4 pcmZero4() {
+    return _mm_setzero_ps();
+}
+
+inline void pcmTranspose4(StPcmVec4& theRow0, StPcmVec4& theRow1,
+                          StPcmVec4& theRow2, StPcmVec4& theRow3) {
+    _MM_TRANSPOSE4_PS(theRow0, theRow1, theRow2, theRow3);
+}
+#else
+typedef float32x4_t StPcmVec4;
+
+inline StPcmVec4 pcmLoad4(const float* theSrc) {
+    return vld1q_f32(theSrc);
+}
+
+inline StPcmVec4 pcmLoad4(const int16_t* theSrc) {
+    const int32x4_t aVec = vmovl_s16(vld1_s16(theSrc));
+    return vmulq_n_f32(vcvtq_f32_s32(aVec), ST_INT16_MAX_INV_F);
+}
+
+inline StPcmVec4 pcmLoad4(const int32_t* theSrc) {
+    return vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(theSrc)), ST_INT32_MAX_INV_F);
+}
+
+inline void pcmStore4(float* theOut, const StPcmVec4& theVec) {
+    vst1q_f32(theOut, theVec);
+}
+
+inline void pcmStore2(float* theOut, const StPcmVec4& theVec) {
+    vst1_f32(theOut, vget_low_f32(theVec));
+}
+
+inline int16x4_t pcmToInt16(const StPcmVec4& theVec) {
+    return vqmovn_s32(vcvtq_s32_f32(vmulq_n_f32(theVec, ST_INT16_MAX_F))); // saturate
+}
+
+inline void pcmStore4(int16_t* theOut, const StPcmVec4& theVec) {
+    vst1_s16(theOut, pcmToInt16(theVec));
+}
+
+inline void pcmStore2(int16_t* theOut, const StPcmVec4& theVec) {
+    const int16x4_t aVec = pcmToInt16(theVec);
+    vst1_lane_s16(theOut,     aVec, 0);
+    vst1_lane_s16(theOut + 1, aVec, 1);
+}
+
+inline StPcmVec4 pcmZero4() {
+    return vdupq_n_f32(0.0f);
+}
+
+inline void pcmTranspose4(StPcmVec4& theRow0, StPcmVec4& theRow1,
+                          StPcmVec4& theRow2, StPcmVec4& theRow3) {
+    const float32x4x2_t a01 = vtrnq_f32(theRow0, theRow1);
+    const float32x4x2_t a23 = vtrnq_f32(theRow2, theRow3);
+    theRow0 = vcombine_f32(vget_low_f32 (a01.val[0]), vget_low_f32 (a23.val[0]));
+    theRow1 = vcombine_f32(vget_low_f32 (a01.val[1]), vget_low_f32 (a23.val[1]));
+    theRow2 = vcombine_f32(vget_high_f32(a01.val[0]), vget_high_f32(a23.val[0]));
+    theRow3 = vcombine_f32(vget_high_f32(a01.val[1]), vget_high_f32(a23.val[1]));
+}
+#endif
+
+/**
+ * Convert planar samples into interleaved buffer, 4 samples per channel at once.
+ * Channels are processed in groups of 4 by transposing 4x4 block;
+ * the last group might contain only 2 channels (5.1 layout).
+ * @param theSrc      source planes, one per channel
+ * @param theOut      interleaved output
+ * @param theNbCh     number of channels, should be even
+ * @param theNbFrames number of samples per channel
+ * @return number of converted samples per channel, the rest should be processed by scalar code
+ */
+template<typename sampleSrc_t, typename sampleOut_t>
+inline size_t pcmInterleaveVec(const sampleSrc_t* const* theSrc,
+                               sampleOut_t*              theOut,
+                               const size_t              theNbCh,
+                               const size_t              theNbFrames) {
+    size_t aFrame = 0;
+    for(; aFrame + 4 <= theNbFrames; aFrame += 4) {
+        for(size_t aCh = 0; aCh < theNbCh; aCh += 4) {
+            const bool isPair = aCh + 2 >= theNbCh;
+            StPcmVec4 aRow0 = pcmLoad4(theSrc[aCh]     + aFrame);
+            StPcmVec4 aRow1 = pcmLoad4(theSrc[aCh + 1] + aFrame);
+            StPcmVec4 aRow2 = isPair ? pcmZero4() : pcmLoad4(theSrc[aCh + 2] + aFrame);
+            StPcmVec4 aRow3 = isPair ? pcmZero4() : pcmLoad4(theSrc[aCh + 3] + aFrame);
+            pcmTranspose4(aRow0, aRow1, aRow2, aRow3);
+
+            sampleOut_t* anOut = theOut + aFrame * theNbCh + aCh;
+            if(isPair) {
+                pcmStore2(anOut,               aRow0);
+                pcmStore2(anOut + theNbCh,     aRow1);
+                pcmStore2(anOut + theNbCh * 2, aRow2);
+                pcmStore2(anOut + theNbCh * 3, aRow3);
+            } else {
+                pcmStore4(anOut,               aRow0);
+                pcmStore4(anOut + theNbCh,     aRow1);
+                pcmStore4(anOut + theNbCh * 2, aRow2);
+                pcmStore4(anOut + theNbCh * 3, aRow3);
+            }
+        }
+    }
+    return aFrame;
+}
+
+#endif
+
+/**
+ * Vectorized planar to interleaved conversion.
+ * Only conversions which give the same result as scalar code are accelerated,
+ * otherwise 0 is returned and the whole buffer is processed by scalar code.
+ */
+template<typename sampleSrc_t, typename sampleOut_t>
+inline size_t pcmInterleave(const sampleSrc_t* const* ,
+                            sampleOut_t* ,
+                            const size_t ,
+                            const size_t ) {
+    return 0;
+}
+
+#if defined(ST_PCM_HAVE_SSE2) || defined(ST_PCM_HAVE_NEON)
+#define ST_PCM_INTERLEAVE_VEC(theSrcType, theOutType) \
+template<> \
+inline size_t pcmInterleave<theSrcType, theOutType>(const theSrcType* const* theSrc, \
+                                                    theOutType*              theOut, \
+                                                    const size_t             theNbCh, \
+                                                    const size_t             theNbFrames) { \
+    return pcmInterleaveVec(theSrc, theOut, theNbCh, theNbFrames); \
+}
+
+ST_PCM_INTERLEAVE_VEC(int16_t, int16_t)
+ST_PCM_INTERLEAVE_VEC(int16_t, float)
+ST_PCM_INTERLEAVE_VEC(int32_t, float)
+ST_PCM_INTERLEAVE_VEC(float,   int16_t)
+ST_PCM_INTERLEAVE_VEC(float,   float)
+#undef ST_PCM_INTERLEAVE_VEC
+#endif
+
 template<typename sampleSrc_t, typename sampleOut_t>
 bool StPCMBuffer::addConvert(const StPCMBuffer& theBuffer) {
     if(myPlanesNb > 1 && myPlanesNb != myChMap.count) {
@@ -371,16 +559,32 @@ bool StPCMBuffer::addConvert(const StPCMBuffer& theBuffer) {
         getChannelDataEnd(aChIter, aBuffersOut[aChIter]);
     }
 
+    // planar to interleaved conversion of 2.0/4.0/5.1/7.1 streams can be vectorized
+    // when output channels are in natural order
+    size_t aFrom = 0;
+    if(theBuffer.myPlanesNb > 1
+    && myPlanesNb == 1
+    && myChMap.count % 2 == 0
+    && theBuffer.myChMap.count >= myChMap.count) {
+        bool isNaturalOrder = true;
+        for(size_t aChIter = 1; aChIter < myChMap.count; ++aChIter) {
+            isNaturalOrder = isNaturalOrder && aBuffersOut[aChIter] == aBuffersOut[0] + aChIter;
+        }
+        if(isNaturalOrder) {
+            aFrom = pcmInterleave<sampleSrc_t, sampleOut_t>(aBuffersSrc, aBuffersOut[0], myChMap.count, aSamplesSrcCount);
+        }
+    }
+
     switch(myChMap.channels) {
         case StChannelMap::CH10: {
-            for(size_t sampleSrcId(0), sampleOutId(0); sampleSrcId < aSamplesSrcCount; sampleSrcId += aSmplSrcInc, sampleOutId += aSmplOutInc) {
+            for(size_t sampleSrcId(aFrom * aSmplSrcInc), sampleOutId(aFrom * aSmplOutInc); sampleSrcId < aSamplesSrcCount; sampleSrcId += aSmplSrcInc, sampleOutId += aSmplOutInc) {
                 sampleConv(aBuffersSrc[0][sampleSrcId], aBuffersOut[0][sampleOutId]);
             }
             myPlaneSize += anAddedPlaneSize;
             return true;
         }
         case StChannelMap::CH20: {
-            for(size_t sampleSrcId(0), sampleOutId(0); sampleSrcId < aSamplesSrcCount; sampleSrcId += aSmplSrcInc, sampleOutId += aSmplOutInc) {
+            for(size_t sampleSrcId(aFrom * aSmplSrcInc), sampleOutId(aFrom * aSmplOutInc); sampleSrcId < aSamplesSrcCount; sampleSrcId += aSmplSrcInc, sampleOutId += aSmplOutInc) {
                 sampleConv(aBuffersSrc[0][sampleSrcId], aBuffersOut[0][sampleOutId]);
                 sampleConv(aBuffersSrc[1][sampleSrcId], aBuffersOut[1][sampleOutId]);
             }
@@ -388,7 +592,7 @@ bool StPCMBuffer::addConvert(const StPCMBuffer& theBuffer) {
             return true;
         }
         case StChannelMap::CH30: {
-            for(size_t sampleSrcId(0), sampleOutId(0); sampleSrcId < aSamplesSrcCount; sampleSrcId += aSmplSrcInc, sampleOutId += aSmplOutInc) {
+            for(size_t sampleSrcId(aFrom * aSmplSrcInc), sampleOutId(aFrom * aSmplOutInc); sampleSrcId < aSamplesSrcCount; sampleSrcId += aSmplSrcInc, sampleOutId += aSmplOutInc) {
                 sampleConv(aBuffersSrc[0][sampleSrcId], aBuffersOut[0][sampleOutId]);
                 sampleConv(aBuffersSrc[1][sampleSrcId], aBuffersOut[1][sampleOutId]);
                 sampleConv(aBuffersSrc[2][sampleSrcId], aBuffersOut[2][sampleOutId]);
@@ -397,7 +601,7 @@ bool StPCMBuffer::addConvert(const StPCMBuffer& theBuffer) {
             return true;
         }
         case StChannelMap::CH40: {
-            for(size_t sampleSrcId(0), sampleOutId(0); sampleSrcId < aSamplesSrcCount; sampleSrcId += aSmplSrcInc, sampleOutId += aSmplOutInc) {
+            for(size_t sampleSrcId(aFrom * aSmplSrcInc), sampleOutId(aFrom * aSmplOutInc); sampleSrcId < aSamplesSrcCount; sampleSrcId += aSmplSrcInc, sampleOutId += aSmplOutInc) {
                 sampleConv(aBuffersSrc[0][sampleSrcId], aBuffersOut[0][sampleOutId]);
                 sampleConv(aBuffersSrc[1][sampleSrcId], aBuffersOut[1][sampleOutId]);
                 sampleConv(aBuffersSrc[2][sampleSrcId], aBuffersOut[2][sampleOutId]);
@@ -407,7 +611,7 @@ bool StPCMBuffer::addConvert(const StPCMBuffer& theBuffer) {
             return true;
         }
         case StChannelMap::CH50: {
-            for(size_t sampleSrcId(0), sampleOutId(0); sampleSrcId < aSamplesSrcCount; sampleSrcId += aSmplSrcInc, sampleOutId += aSmplOutInc) {
+            for(size_t sampleSrcId(aFrom * aSmplSrcInc), sampleOutId(aFrom * aSmplOutInc); sampleSrcId < aSamplesSrcCount; sampleSrcId += aSmplSrcInc, sampleOutId += aSmplOutInc) {
                 sampleConv(aBuffersSrc[0][sampleSrcId], aBuffersOut[0][sampleOutId]);
                 sampleConv(aBuffersSrc[1][sampleSrcId], aBuffersOut[1][sampleOutId]);
                 sampleConv(aBuffersSrc[2][sampleSrcId], aBuffersOut[2][sampleOutId]);
@@ -418,7 +622,7 @@ bool StPCMBuffer::addConvert(const StPCMBuffer& theBuffer) {
             return true;
         }
         case StChannelMap::CH51: {
-            for(size_t sampleSrcId(0), sampleOutId(0); sampleSrcId < aSamplesSrcCount; sampleSrcId += aSmplSrcInc, sampleOutId += aSmplOutInc) {
+            for(size_t sampleSrcId(aFrom * aSmplSrcInc), sampleOutId(aFrom * aSmplOutInc); sampleSrcId < aSamplesSrcCount; sampleSrcId += aSmplSrcInc, sampleOutId += aSmplOutInc) {
                 sampleConv(aBuffersSrc[0][sampleSrcId], aBuffersOut[0][sampleOutId]);
                 sampleConv(aBuffersSrc[1][sampleSrcId], aBuffersOut[1][sampleOutId]);
                 sampleConv(aBuffersSrc[2][sampleSrcId], aBuffersOut[2][sampleOutId]);
@@ -430,7 +634,7 @@ bool StPCMBuffer::addConvert(const StPCMBuffer& theBuffer) {
             return true;
         }
         case StChannelMap::CH71: {
-            for(size_t sampleSrcId(0), sampleOutId(0); sampleSrcId < aSamplesSrcCount; sampleSrcId += aSmplSrcInc, sampleOutId += aSmplOutInc) {
+            for(size_t sampleSrcId(aFrom * aSmplSrcInc), sampleOutId(aFrom * aSmplOutInc); sampleSrcId < aSamplesSrcCount; sampleSrcId += aSmplSrcInc, sampleOutId += aSmplOutInc) {
                 sampleConv(aBuffersSrc[0][sampleSrcId], aBuffersOut[0][sampleOutId]);
                 sampleConv(aBuffersSrc[1][sampleSrcId], aBuffersOut[1][sampleOutId]);
                 sampleConv(aBuffersSrc[2][sampleSrcId], aBuffersOut[2][sampleOutId]);
@@ -257,6 +257,6 @@ void StSubtitleQueue::decodeLoop() {
         }
 
         // and now packet finished
-        aPacket.nullify();
+        recycle(aPacket);
     }
 }
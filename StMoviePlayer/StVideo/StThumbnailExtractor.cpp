@@ -0,0 +1,268 @@
+/**
+ * Copyright © 2017 Kirill Gavrilov <kirill@sview.ru>
+ *
+ * StMoviePlayer program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * StMoviePlayer program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "StThumbnailExtractor.h"
+
+#include <StAV/StAVFrame.h>
+#include <StAV/StAVPacket.h>
+#include <StStrings/StLogger.h>
+#include <StThreads/StTimer.h>
+
+#include <vector>
+
+namespace {
+
+    static const int    THE_CELL_SIZE_X     = 160;  //!< thumbnail width
+    static const int    THE_NB_CELLS_X      = 10;   //!< number of atlas columns
+    static const int    THE_NB_CELLS_Y_MAX  = 10;   //!< maximum number of atlas rows
+    static const double THE_SLOT_SECONDS    = 2.0;  //!< minimal duration of single time slot
+    static const int    THE_PACKETS_MAX     = 512;  //!< maximum number of packets to read for single thumbnail
+    static const int    THE_IDLE_DELAY_MS   = 10;   //!< delay between thumbnails
+    static const int    THE_PAUSE_DELAY_MS  = 50;   //!< delay while extraction is paused
+
+    /**
+     * Fill cells order so that each next pass halves the gaps between already extracted thumbnails.
+     */
+    static void fillCoarseToFine(const int         theNbCells,
+                                 std::vector<int>& theOrder) {
+        theOrder.clear();
+        std::vector<bool> isAdded(theNbCells, false);
+        int aStep = 1;
+        while(aStep < theNbCells) {
+            aStep *= 2;
+        }
+        for(; aStep >= 1; aStep /= 2) {
+            for(int aCell = 0; aCell < theNbCells; aCell += aStep) {
+                if(!isAdded[aCell]) {
+                    isAdded[aCell] = true;
+                    theOrder.push_back(aCell);
+                }
+            }
+        }
+    }
+
+}
+
+StThumbnailExtractor::StThumbnailExtractor()
+: myScaleCtx(NULL),
+  myDuration(0.0),
+  myStreamId(-1),
+  myToPause(false),
+  myToQuit(false) {
+    //
+}
+
+StThumbnailExtractor::~StThumbnailExtractor() {
+    release();
+}
+
+void StThumbnailExtractor::open(const StString& theFilePath,
+                                const int       theStreamId,
+                                const double    theDuration,
+                                const StHandle<StThumbnailAtlas>& theAtlas) {
+    release();
+    if(theAtlas.isNull()
+    || theDuration <= 0.0) {
+        return;
+    }
+
+    myAtlas    = theAtlas;
+    myFilePath = theFilePath;
+    myStreamId = theStreamId;
+    myDuration = theDuration;
+    myToPause  = false;
+    myToQuit   = false;
+    myThread   = new StThread(extractThread, (void* )this, "StThumbnailExtractor");
+}
+
+void StThumbnailExtractor::release() {
+    if(!myThread.isNull()) {
+        myToQuit = true;
+        myThread->wait();
+        myThread.nullify();
+    }
+    if(!myAtlas.isNull()) {
+        myAtlas->clear();
+        myAtlas.nullify();
+    }
+    if(myScaleCtx != NULL) {
+        sws_freeContext(myScaleCtx);
+        myScaleCtx = NULL;
+    }
+    myThumb.nullify(StImagePlane::ImgRGB);
+    myFilePath.clear();
+    myDuration = 0.0;
+    myStreamId = -1;
+}
+
+SV_THREAD_FUNCTION StThumbnailExtractor::extractThread(void* theExtractor) {
+    ((StThumbnailExtractor* )theExtractor)->extractLoop();
+    return SV_THREAD_RETURN 0;
+}
+
+bool StThumbnailExtractor::convertFrame(const AVFrame* theFrame) {
+    if(theFrame->width  < 1
+    || theFrame->height < 1
+    || theFrame->format < 0) {
+        return false;
+    }
+
+    myScaleCtx = sws_getCachedContext(myScaleCtx,
+                                      theFrame->width, theFrame->height, (AVPixelFormat )theFrame->format,
+                                      (int )myThumb.getSizeX(), (int )myThumb.getSizeY(), stAV::PIX_FMT::RGB24,
+                                      SWS_FAST_BILINEAR, NULL, NULL, NULL);
+    if(myScaleCtx == NULL) {
+        return false;
+    }
+
+    uint8_t* aDstData[4]     = { myThumb.changeData(), NULL, NULL, NULL };
+    int      aDstLineSize[4] = { (int )myThumb.getSizeRowBytes(), 0, 0, 0 };
+    sws_scale(myScaleCtx,
+              (const uint8_t* const* )theFrame->data, theFrame->linesize,
+              0, theFrame->height,
+              aDstData, aDstLineSize);
+    return true;
+}
+
+void StThumbnailExtractor::extractLoop() {
+    AVFormatContext* aFormatCtx = NULL;
+#if(LIBAVFORMAT_VERSION_INT >= AV_VERSION_INT(53, 2, 0))
+    int anErr = avformat_open_input(&aFormatCtx, myFilePath.toCString(), NULL, NULL);
+#else
+    int anErr = av_open_input_file (&aFormatCtx, myFilePath.toCString(), NULL, 0, NULL);
+#endif
+    if(anErr != 0) {
+        if(aFormatCtx != NULL) {
+        #if(LIBAVFORMAT_VERSION_INT >= AV_VERSION_INT(53, 17, 0))
+            avformat_close_input(&aFormatCtx);
+        #else
+            av_close_input_file(aFormatCtx);
+        #endif
+        }
+        return;
+    }
+
+#if(LIBAVFORMAT_VERSION_INT >= AV_VERSION_INT(53, 6, 0))
+    anErr = avformat_find_stream_info(aFormatCtx, NULL);
+#else
+    anErr = av_find_stream_info(aFormatCtx);
+#endif
+    AVStream*       aStream   = anErr >= 0 && myStreamId < int(aFormatCtx->nb_streams) ? aFormatCtx->streams[myStreamId] : NULL;
+    AVCodecContext* aCodecCtx = aStream != NULL ? stAV::getCodecCtx(aStream) : NULL;
+    AVCodec*        aCodec    = aCodecCtx != NULL ? avcodec_find_decoder(aCodecCtx->codec_id) : NULL;
+    bool isCodecOpened = false;
+    if(aCodec != NULL
+    && aCodecCtx->width  > 0
+    && aCodecCtx->height > 0) {
+        // skip all other streams
+        for(unsigned int aStreamId = 0; aStreamId < aFormatCtx->nb_streams; ++aStreamId) {
+            aFormatCtx->streams[aStreamId]->discard = int(aStreamId) == myStreamId ? AVDISCARD_DEFAULT : AVDISCARD_ALL;
+        }
+
+        // decode only key frames, within single thread and at reduced resolution when supported by decoder
+        aCodecCtx->thread_count     = 1;
+        aCodecCtx->lowres           = stMin(2, int(aCodec->max_lowres));
+        aCodecCtx->skip_frame       = AVDISCARD_NONKEY;
+        aCodecCtx->skip_loop_filter = AVDISCARD_ALL;
+    #if(LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(53, 8, 0))
+        isCodecOpened = avcodec_open2(aCodecCtx, aCodec, NULL) >= 0;
+    #else
+        isCodecOpened = avcodec_open(aCodecCtx, aCodec) >= 0;
+    #endif
+    }
+
+    bool isOpened = isCodecOpened;
+    if(isOpened) {
+        double aRatio = double(aCodecCtx->width) / double(aCodecCtx->height);
+        if(aCodecCtx->sample_aspect_ratio.num > 0
+        && aCodecCtx->sample_aspect_ratio.den > 0) {
+            aRatio *= av_q2d(aCodecCtx->sample_aspect_ratio);
+        }
+        const int aCellSizeY = stClamp(int(double(THE_CELL_SIZE_X) / aRatio) / 2 * 2, 16, THE_CELL_SIZE_X);
+        const int aNbCellsY  = stClamp(int(myDuration / (THE_SLOT_SECONDS * THE_NB_CELLS_X)), 1, THE_NB_CELLS_Y_MAX);
+        if(!myThumb.initTrash(StImagePlane::ImgRGB, THE_CELL_SIZE_X, aCellSizeY)
+        || !myAtlas->init(THE_CELL_SIZE_X, aCellSizeY, THE_NB_CELLS_X, aNbCellsY)) {
+            isOpened = false;
+        }
+    }
+
+    if(isOpened) {
+        const int     aNbCells   = (int )myAtlas->getNbCells();
+        const double  aStartTime = aStream->start_time != stAV::NOPTS_VALUE ? stAV::unitsToSeconds(aStream, aStream->start_time) : 0.0;
+        std::vector<int> anOrder;
+        fillCoarseToFine(aNbCells, anOrder);
+
+        StTimer aTimer(true);
+        StAVFrame  aFrame;
+        StAVPacket aPacket;
+        size_t aNbExtracted = 0;
+        for(size_t anOrderIter = 0; anOrderIter < anOrder.size() && !myToQuit; ++anOrderIter) {
+            while(myToPause && !myToQuit) {
+                StThread::sleep(THE_PAUSE_DELAY_MS);
+            }
+            if(myToQuit) {
+                break;
+            }
+
+            // take the key frame nearest to the middle of time slot
+            const int    aCell   = anOrder[anOrderIter];
+            const double aTarget = aStartTime + (double(aCell) + 0.5) * myDuration / double(aNbCells);
+            if(av_seek_frame(aFormatCtx, myStreamId, stAV::secondsToUnits(aStream, aTarget), AVSEEK_FLAG_BACKWARD) < 0) {
+                continue;
+            }
+            avcodec_flush_buffers(aCodecCtx);
+
+            for(int aPacketIter = 0; aPacketIter < THE_PACKETS_MAX && !myToQuit; ++aPacketIter) {
+                if(av_read_frame(aFormatCtx, aPacket.getAVpkt()) < 0) {
+                    break;
+                }
+                if(aPacket.getStreamId() != myStreamId) {
+                    aPacket.free();
+                    continue;
+                }
+
+                int isFrameFinished = 0;
+                avcodec_decode_video2(aCodecCtx, aFrame.Frame, &isFrameFinished, aPacket.getAVpkt());
+                aPacket.free();
+                if(isFrameFinished == 0) {
+                    continue;
+                }
+
+                if(convertFrame(aFrame.Frame)
+                && myAtlas->setCell(aCell, myThumb)) {
+                    ++aNbExtracted;
+                }
+                aFrame.reset();
+                break;
+            }
+
+            StThread::sleep(THE_IDLE_DELAY_MS);
+        }
+        ST_DEBUG_LOG(StString("StThumbnailExtractor, ") + aNbExtracted + " thumbnails extracted within "
+                   + aTimer.getElapsedTimeInSec() + " seconds");
+    }
+
+    if(isCodecOpened) {
+        avcodec_close(aCodecCtx);
+    }
+#if(LIBAVFORMAT_VERSION_INT >= AV_VERSION_INT(53, 17, 0))
+    avformat_close_input(&aFormatCtx);
+#else
+    av_close_input_file(aFormatCtx);
+#endif
+}
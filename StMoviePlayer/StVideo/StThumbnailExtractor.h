@@ -0,0 +1,104 @@
+/**
+ * Copyright © 2017 Kirill Gavrilov <kirill@sview.ru>
+ *
+ * StMoviePlayer program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * StMoviePlayer program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __StThumbnailExtractor_h_
+#define __StThumbnailExtractor_h_
+
+#include <StAV/stAV.h>
+#include <StImage/StThumbnailAtlas.h>
+#include <StStrings/StString.h>
+#include <StThreads/StThread.h>
+
+/**
+ * Background generator of seek bar thumbnails.
+ * Opens the file within dedicated format context and decodes only key frames
+ * at reduced resolution (lowres) within single thread,
+ * filling the atlas in coarse-to-fine order so that partial result covers the whole duration.
+ * Extraction can be paused to avoid competing with playback for I/O and CPU.
+ */
+class StThumbnailExtractor {
+
+        public:
+
+    /**
+     * Empty constructor.
+     */
+    ST_LOCAL StThumbnailExtractor();
+
+    /**
+     * Destructor.
+     */
+    ST_LOCAL ~StThumbnailExtractor();
+
+    /**
+     * Start extraction for the new file.
+     * Previous extraction is stopped.
+     * @param theFilePath path to the file
+     * @param theStreamId video stream index within the file
+     * @param theDuration media duration in seconds
+     * @param theAtlas    atlas to fill
+     */
+    ST_LOCAL void open(const StString& theFilePath,
+                       const int       theStreamId,
+                       const double    theDuration,
+                       const StHandle<StThumbnailAtlas>& theAtlas);
+
+    /**
+     * Stop extraction and clear the atlas.
+     */
+    ST_LOCAL void release();
+
+    /**
+     * Temporarily suspend extraction (e.g. while playback is starving).
+     */
+    ST_LOCAL void setPaused(const bool theToPause) {
+        myToPause = theToPause;
+    }
+
+        private:
+
+    /**
+     * Extraction loop.
+     */
+    ST_LOCAL void extractLoop();
+
+    /**
+     * Thread function.
+     */
+    static SV_THREAD_FUNCTION extractThread(void* theExtractor);
+
+    /**
+     * Scale decoded frame into RGB thumbnail.
+     */
+    ST_LOCAL bool convertFrame(const AVFrame* theFrame);
+
+        private:
+
+    StHandle<StThumbnailAtlas> myAtlas;       //!< atlas to fill
+    StHandle<StThread>         myThread;      //!< extraction thread
+    StImagePlane               myThumb;       //!< RGB thumbnail buffer
+    SwsContext*                myScaleCtx;    //!< swscale context
+    StString                   myFilePath;    //!< file path
+    double                     myDuration;    //!< media duration
+    int                        myStreamId;    //!< video stream index
+    volatile bool              myToPause;     //!< flag to suspend extraction
+    volatile bool              myToQuit;      //!< flag to stop extraction
+
+};
+
+#endif // __StThumbnailExtractor_h_
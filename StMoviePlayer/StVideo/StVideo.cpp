@@ -111,6 +111,8 @@ StVideo::StVideo(const std::string&                 theALDeviceName,
   myLangMap(theLangMap),
   mySlaveCtx(NULL),
   mySlaveStream(-1),
+  myIsThreadsSplit(false),
+  myThumbAtlas(new StThumbnailAtlas()),
   myPlayList(thePlayList),
   myTextureQueue(theTextureQueue),
   myDuration(0.0),
@@ -136,6 +138,8 @@ StVideo::StVideo(const std::string&                 theALDeviceName,
 
     params.UseGpu          = new StBoolParam(false);
     params.UseOpenJpeg     = new StBoolParam(false);
+    params.ToCacheKeyframes= new StBoolParam(false);
+    params.ToShowThumbnails= new StBoolParam(true);
     params.activeAudio     = new StParamActiveStream();
     params.activeSubtitles = new StParamActiveStream();
 
@@ -265,6 +269,8 @@ StVideo::~StVideo() {
 }
 
 void StVideo::close() {
+    myKeyIndex.release();
+    myThumbExtractor.release();
     if(!myVideoSlave.isNull())  myVideoSlave->deinit();
     if(!myVideoMaster.isNull()) myVideoMaster->deinit();
     if(!myAudio.isNull())       myAudio->deinit();
@@ -392,6 +398,20 @@ bool StVideo::addFile(const StString& theFileToLoad,
     int32_t anAudioStreamId = (int32_t )theInfo.AudioList->size();
 
     theInfo.Duration = stMax(theInfo.Duration, stAV::unitsToSeconds(aFormatCtx->duration));
+    if(!myVideoMaster->isInitialized()) {
+        // the file contains both Master and Slave video streams
+        int aNbVideoStreams = 0;
+        for(unsigned int aStreamId = 0; aStreamId < aFormatCtx->nb_streams; ++aStreamId) {
+            if(stAV::getCodecType(aFormatCtx->streams[aStreamId]) == AVMEDIA_TYPE_VIDEO
+            && !stAV::isAttachedPicture(aFormatCtx->streams[aStreamId])) {
+                ++aNbVideoStreams;
+            }
+        }
+        if(aNbVideoStreams >= 2
+        && myVideoMaster->getStereoFormatByUser() == StFormat_AUTO) {
+            setDecodingThreadsSplit(true);
+        }
+    }
     for(unsigned int aStreamId = 0; aStreamId < aFormatCtx->nb_streams; ++aStreamId) {
         AVStream*         aStream    = aFormatCtx->streams[aStreamId];
         const AVMediaType aCodecType = stAV::getCodecType(aStream);
@@ -548,6 +568,15 @@ bool StVideo::addFile(const StString& theFileToLoad,
     return true;
 }
 
+void StVideo::setDecodingThreadsSplit(const bool theToSplit) {
+    // Master and Slave video streams are decoded concurrently,
+    // so that each decoder should use only half of logical processors
+    myIsThreadsSplit = theToSplit;
+    const int aNbThreads = theToSplit ? stMax(StThread::countLogicalProcessors() / 2, 1) : 0;
+    myVideoMaster->setThreadsLimit(aNbThreads);
+    myVideoSlave ->setThreadsLimit(aNbThreads);
+}
+
 bool StVideo::openSource(const StHandle<StFileNode>&     theNewSource,
                          const StHandle<StStereoParams>& theNewParams,
                          const StHandle<StFileNode>&     theNewPlsFile) {
@@ -567,6 +596,9 @@ bool StVideo::openSource(const StHandle<StFileNode>&     theNewSource,
     StStreamsInfo aStreamsInfo;
     aStreamsInfo.AudioList    = new StArrayList<StString>(8);
     aStreamsInfo.SubtitleList = new StArrayList<StString>(8);
+    // guess if Slave video stream will be decoded to avoid re-initialization of Master decoder
+    setDecodingThreadsSplit(theNewSource->size() >= 2
+                         && myVideoMaster->getStereoFormatByUser() == StFormat_AUTO);
     if(!theNewSource->isEmpty()) {
         bool isLoaded = false;
         for(size_t aNode = 0; aNode < theNewSource->size(); ++aNode) {
@@ -642,6 +674,26 @@ bool StVideo::openSource(const StHandle<StFileNode>&     theNewSource,
         return false;
     }
 
+    // threads should be split only when Slave video stream is actually decoded
+    // (e.g. second file might contain no video), otherwise re-initialize decoders
+    if(myVideoMaster->isInitialized()
+    && myIsThreadsSplit != myVideoSlave->isInitialized()) {
+        setDecodingThreadsSplit(myVideoSlave->isInitialized());
+        const StString   aFileNameMaster = myVideoMaster->getFileName();
+        AVFormatContext* aCtxMaster      = myVideoMaster->getContext();
+        const signed int aStreamIdMaster = myVideoMaster->getId();
+        myVideoMaster->deinit();
+        myVideoMaster->init(aCtxMaster, aStreamIdMaster, aFileNameMaster, theNewParams);
+        myVideoMaster->setSlave(NULL);
+        if(myIsThreadsSplit) {
+            myVideoSlave->deinit();
+            myVideoSlave->init(mySlaveCtx, mySlaveStream, "", theNewParams);
+            if(myVideoSlave->isInitialized()) {
+                myVideoMaster->setSlave(myVideoSlave);
+            }
+        }
+    }
+
     StArgument aTitle = myFileInfoTmp->Info["TITLE"];
     if(!aTitle.isValid()) {
         aTitle = myFileInfoTmp->Info["title"];
@@ -677,6 +729,47 @@ bool StVideo::openSource(const StHandle<StFileNode>&     theNewSource,
         }
     }
 
+    // index key frames of streams which can be seeked by byte position (MPEG-TS and similar);
+    // other demuxers can not resume reading from arbitrary packet position
+    for(size_t aCtxIter = 0; aCtxIter < myCtxList.size(); ++aCtxIter) {
+        AVFormatContext* aFormatCtx = myCtxList[aCtxIter];
+        if(!myVideoMaster->isInContext(aFormatCtx)
+        ||  myVideoMaster->isAttachedPicture()
+        || (aFormatCtx->iformat->flags & AVFMT_TS_DISCONT)   == 0
+        || (aFormatCtx->iformat->flags & AVFMT_NO_BYTE_SEEK) != 0) {
+            continue;
+        }
+
+        const StString& aFilePath = myFileList[aCtxIter];
+        StString aCacheFolder;
+        if(params.ToCacheKeyframes->getValue()
+        && !myResMgr->getCacheFolder().isEmpty()) {
+            aCacheFolder = myResMgr->getCacheFolder() + "keyframes" + SYS_FS_SPLITTER;
+            StFolder::createFolder(aCacheFolder);
+        }
+        const bool toScan = !StFileNode::isRemoteProtocolPath(aFilePath)
+                         && !StFileNode::isContentProtocolPath(aFilePath);
+        myKeyIndex.open(aFilePath, myVideoMaster->getId(),
+                        aFormatCtx->pb != NULL ? avio_size(aFormatCtx->pb) : 0,
+                        aCacheFolder, toScan);
+        break;
+    }
+
+    // generate seek bar thumbnails for local files
+    for(size_t aCtxIter = 0; aCtxIter < myCtxList.size(); ++aCtxIter) {
+        const StString& aFilePath = myFileList[aCtxIter];
+        if(!params.ToShowThumbnails->getValue()
+        || !myVideoMaster->isInContext(myCtxList[aCtxIter])
+        ||  myVideoMaster->isAttachedPicture()
+        ||  StFileNode::isRemoteProtocolPath(aFilePath)
+        ||  StFileNode::isContentProtocolPath(aFilePath)) {
+            continue;
+        }
+
+        myThumbExtractor.open(aFilePath, myVideoMaster->getId(), aStreamsInfo.Duration, myThumbAtlas);
+        break;
+    }
+
     myCurrNode    = theNewSource;
     myCurrParams  = theNewParams;
     myCurrPlsFile = theNewPlsFile;
@@ -779,6 +872,16 @@ bool StVideo::doSeekStream(AVFormatContext* theFormatCtx,
     }
 
     int64_t aSeekTarget = stAV::secondsToUnits(aStream, theSeekPts + stAV::unitsToSeconds(aStream, aStream->start_time));
+
+    // jump straight to the key frame position when it is known
+    int64_t aKeyFramePos = 0;
+    if(theStreamId == myKeyIndex.getStreamId()
+    && myVideoMaster->isInContext(theFormatCtx, theStreamId)
+    && myKeyIndex.find(aSeekTarget, toSeekBack, aKeyFramePos)
+    && av_seek_frame(theFormatCtx, theStreamId, aKeyFramePos, AVSEEK_FLAG_BYTE) >= 0) {
+        return true;
+    }
+
     bool isSeekDone = av_seek_frame(theFormatCtx, theStreamId, aSeekTarget, aFlags) >= 0;
 
     // try 10 more times in backward direction to work-around huge duration between key frames
@@ -803,7 +906,7 @@ bool StVideo::pushPacket(StHandle<StAVPacketQueue>& theAVPacketQueue,
         return false;
     }
     thePacket.setDurationSeconds(theAVPacketQueue->unitsToSeconds(thePacket.getDuration()));
-    theAVPacketQueue->push(thePacket);
+    theAVPacketQueue->pushMove(thePacket);
     return true;
 }
 
@@ -839,6 +942,7 @@ void StVideo::checkInitVideoStreams() {
 
             myVideoMaster->setUseGpu(toUseGpu, isGpuFailed);
             myVideoSlave ->setUseGpu(toUseGpu, isGpuFailed);
+            setDecodingThreadsSplit(toDecodeSlave);
             myVideoMaster->init(aCtxMaster, aStreamIdMaster, aFileNameMaster, myCurrParams);
             myVideoMaster->setSlave(NULL);
             if(toDecodeSlave) {
@@ -862,6 +966,7 @@ void StVideo::packetsLoop() {
 #endif
     double aSeekPts = 0.0;
     bool toSeekBack = false;
+    int64_t aPrevKeyTime = stAV::NOPTS_VALUE; // timestamp of previously indexed key frame
     StPlayEvent_t aPlayEvent = ST_PLAYEVENT_NONE;
     AVFormatContext* aFormatCtx = NULL;
 
@@ -925,6 +1030,15 @@ void StVideo::packetsLoop() {
                     ++anEmptyQueues;
                     continue;
                 }
+                aPacket.changeStamps().reset();
+                aPacket.changeStamps().Read = StFrameStamps::now();
+                if(aPacket.isKeyFrame()
+                && aPacket.getStreamId() == myKeyIndex.getStreamId()
+                && myVideoMaster->isInContext(aFormatCtx)) {
+                    const int64_t aKeyTime = aPacket.getPts() != stAV::NOPTS_VALUE ? aPacket.getPts() : aPacket.getDts();
+                    myKeyIndex.add(aKeyTime, aPacket.getAVpkt()->pos, aPrevKeyTime);
+                    aPrevKeyTime = aKeyTime;
+                }
             }
 
             // push packet to appropriate queue
@@ -1108,6 +1222,7 @@ void StVideo::packetsLoop() {
             pushPlayEvent(ST_PLAYEVENT_SEEK, aCurrPts);
         } else if(aPlayEvent == ST_PLAYEVENT_SEEK) {
             doSeek(aSeekPts, toSeekBack);
+            aPrevKeyTime = stAV::NOPTS_VALUE;
             // ignore current packet
             for(aCtxId = 0; aCtxId < myPlayCtxList.size(); ++aCtxId) {
                 aQueueIsFull[aCtxId] = false;
@@ -1115,6 +1230,14 @@ void StVideo::packetsLoop() {
             }
         }
 
+        // let thumbnails extraction and key frames scan compete for I/O and CPU
+        // only when decoder has enough packets (~0.5 second)
+        const bool toPauseBackground = myVideoMaster->isInitialized()
+                                    && myVideoMaster->getSize() < 16
+                                    && anEmptyQueues != myPlayCtxList.size();
+        myThumbExtractor.setPaused(toPauseBackground);
+        myKeyIndex.setPaused(toPauseBackground);
+
         ///
         if(aQueueIsFull[0]) {
             StThread::sleep(2);
@@ -24,6 +24,8 @@
 #include "StSubtitleQueue.h"// subtitles queue class
 #include "StVideoTimer.h"   // video refresher class
 #include "StParamActiveStream.h"
+#include "StKeyframeIndex.h"
+#include "StThumbnailExtractor.h"
 
 #include <StAV/StAVIOFileContext.h>
 #include <StFile/StMIMEList.h>
@@ -156,6 +158,13 @@ class StVideo {
         return myVideoMaster->isInitialized();
     }
 
+    /**
+     * @return seek bar thumbnails of currently opened file
+     */
+    ST_LOCAL const StHandle<StThumbnailAtlas>& getThumbnails() const {
+        return myThumbAtlas;
+    }
+
     /**
      * Set the stereoscopic format to be used for video
      * with ambiguous format information.
@@ -263,6 +272,8 @@ class StVideo {
         StHandle<StBoolParam>         UseGpu;          //!< use video decoding on GPU when available
         StHandle<StBoolParam>         UseOpenJpeg;     //!< use OpenJPEG (libopenjpeg) instead of built-in jpeg2000 decoder
         StHandle<StBoolParam>         ToSearchSubs;    //!< automatically search for additional subtitles/audio track files nearby video file
+        StHandle<StBoolParam>         ToCacheKeyframes;//!< persist key frames index of opened files
+        StHandle<StBoolParam>         ToShowThumbnails;//!< generate seek bar thumbnails of opened files
         StHandle<StBoolParamNamed>    ToTrackHeadAudio;//!< enable/disable head-tracking for audio listener
         StHandle<StParamActiveStream> activeAudio;     //!< active Audio stream
         StHandle<StParamActiveStream> activeSubtitles; //!< active Subtitles stream
@@ -352,6 +363,12 @@ class StVideo {
         signals.onError(theMsgText);
     }
 
+    /**
+     * Split logical processors between Master and Slave video decoders.
+     * Takes effect on next initialization of decoders.
+     */
+    ST_LOCAL void setDecodingThreadsSplit(const bool theToSplit);
+
     /**
      * Private method to append one format context (one file).
      */
@@ -448,6 +465,10 @@ class StVideo {
     StHandle<StSubtitleQueue>     mySubtitles;    //!< subtitles decoding thread
     AVFormatContext*              mySlaveCtx;     //!< Slave video format context
     signed int                    mySlaveStream;  //!< Slave video stream id
+    bool                          myIsThreadsSplit; //!< logical processors are split between Master and Slave video decoders
+    StKeyframeIndex               myKeyIndex;     //!< key frames index of Master video stream
+    StHandle<StThumbnailAtlas>    myThumbAtlas;   //!< seek bar thumbnails
+    StThumbnailExtractor          myThumbExtractor; //!< seek bar thumbnails generator
 
     StHandle<StPlayList>          myPlayList;     //!< play list
     StHandle<StMovieInfo>         myFileInfo;     //!< info about currently loaded file
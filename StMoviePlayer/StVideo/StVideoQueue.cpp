@@ -155,6 +155,7 @@ StVideoQueue::StVideoQueue(const StHandle<StGLTextureQueue>& theTextureQueue,
   myDowntimeState(true),
   myTextureQueue(theTextureQueue),
   myHasDataState(false),
+  myDataFreeState(true),
   myMaster(theMaster),
 #if defined(__APPLE__)
   myCodecH264HW(avcodec_find_decoder_by_name("h264_vda")),
@@ -165,9 +166,12 @@ StVideoQueue::StVideoQueue(const StHandle<StGLTextureQueue>& theTextureQueue,
   myUseGpu(false),
   myIsGpuFailed(false),
   myUseOpenJpeg(false),
+  myThreadsLimit(0),
   //
-  myToRgbCtx(NULL),
   myToRgbPixFmt(stAV::PIX_FMT::NONE),
+  myToRgbSizeX(0),
+  myToRgbSizeY(0),
+  myToRgbRowBytes(0),
   myToRgbIsBroken(false),
   //
   myAvDiscard(AVDISCARD_DEFAULT),
@@ -271,7 +275,7 @@ bool StVideoQueue::initCodec(AVCodec*   theCodec,
     // attached pics are sparse, therefore we would not want to delay their decoding till EOF
     int aNbThreads = theToUseGpu || isAttachedPicture()
                    ? 1
-                   : StThread::countLogicalProcessors();
+                   : (myThreadsLimit > 0 ? myThreadsLimit : StThread::countLogicalProcessors());
     myCodecCtx->thread_count = aNbThreads;
 #if(LIBAVCODEC_VERSION_INT < AV_VERSION_INT(52, 112, 0))
     avcodec_thread_init(myCodecCtx, aNbThreads);
@@ -507,8 +511,11 @@ void StVideoQueue::deinit() {
     myDataAdp.nullify();
 
     myDataRGB.nullify();
-    sws_freeContext(myToRgbCtx);
-    myToRgbCtx      = NULL;
+    myToRgbPool.release();
+    myToRgbRowBytes = 0;
+    myToRgbSizeX    = 0;
+    myToRgbSizeY    = 0;
+    myToRgbScaler.release();
     myToRgbPixFmt   = stAV::PIX_FMT::NONE;
     myToRgbIsBroken = false;
 
@@ -561,6 +568,9 @@ void StVideoQueue::prepareFrame(const StFormat theSrcFormat) {
         myDataAdp.changePlane(0).initWrapper(StImagePlane::ImgRGB48, myFrame.getPlane(0),
                                              size_t(aFrameSizeX), size_t(aFrameSizeY),
                                              myFrame.getLineSize(0));
+
+        myFrameBufRef->moveReferenceFrom(myFrame.Frame);
+        myDataAdp.setBufferCounter(myFrameBufRef);
     } else if(aPixFmt == stAV::PIX_FMT::RGB24) {
         myDataAdp.setColorModel(StImage::ImgColor_RGB);
         myDataAdp.setColorScale(StImage::ImgScale_Full);
@@ -568,6 +578,9 @@ void StVideoQueue::prepareFrame(const StFormat theSrcFormat) {
         myDataAdp.changePlane(0).initWrapper(StImagePlane::ImgRGB, myFrame.getPlane(0),
                                              size_t(aFrameSizeX), size_t(aFrameSizeY),
                                              myFrame.getLineSize(0));
+
+        myFrameBufRef->moveReferenceFrom(myFrame.Frame);
+        myDataAdp.setBufferCounter(myFrameBufRef);
 #if(LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(53, 5, 0))
     } else if(stAV::isFormatYUVPlanar(myFrame.Frame,
 #else
@@ -603,6 +616,9 @@ void StVideoQueue::prepareFrame(const StFormat theSrcFormat) {
         } else if(aDimsYUV.bitsPerComp == 10) {
             aPlaneFrmt = StImagePlane::ImgGray16;
             myDataAdp.setColorScale(aDimsYUV.isFullScale ? StImage::ImgScale_Jpeg10 : StImage::ImgScale_Mpeg10);
+        } else if(aDimsYUV.bitsPerComp == 12) {
+            aPlaneFrmt = StImagePlane::ImgGray16;
+            myDataAdp.setColorScale(aDimsYUV.isFullScale ? StImage::ImgScale_Jpeg12 : StImage::ImgScale_Mpeg12);
         } else if(aDimsYUV.bitsPerComp == 16) {
             aPlaneFrmt = StImagePlane::ImgGray16;
         }
@@ -617,7 +633,9 @@ void StVideoQueue::prepareFrame(const StFormat theSrcFormat) {
 
         myFrameBufRef->moveReferenceFrom(myFrame.Frame);
         myDataAdp.setBufferCounter(myFrameBufRef);
-    } else if(aPixFmt == stAV::PIX_FMT::NV12) {
+    } else if(aPixFmt == stAV::PIX_FMT::NV12
+           || aPixFmt == stAV::PIX_FMT::P010
+           || aPixFmt == stAV::PIX_FMT::P016) {
         aDimsYUV.isFullScale = false;
     #if(LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(52, 29, 0))
         if(myCodecCtx->color_range == AVCOL_RANGE_JPEG) {
@@ -625,44 +643,44 @@ void StVideoQueue::prepareFrame(const StFormat theSrcFormat) {
             aDimsYUV.isFullScale = true;
         }
     #endif
+        // P010 stores 10 bits in the most significant bits of 16-bit word,
+        // so that normalized texture values match P016 and the same shader can be used
+        const bool isWide = aPixFmt != stAV::PIX_FMT::NV12;
         myDataAdp.setColorScale(aDimsYUV.isFullScale ? StImage::ImgScale_NvFull : StImage::ImgScale_NvMpeg);
         myDataAdp.setColorModel(StImage::ImgColor_YUV);
         myDataAdp.setPixelRatio(getPixelRatio());
-        myDataAdp.changePlane(0).initWrapper(StImagePlane::ImgGray, myFrame.getPlane(0),
+        myDataAdp.changePlane(0).initWrapper(isWide ? StImagePlane::ImgGray16 : StImagePlane::ImgGray, myFrame.getPlane(0),
                                              size_t(aFrameSizeX), size_t(aFrameSizeY), myFrame.getLineSize(0));
-        myDataAdp.changePlane(1).initWrapper(StImagePlane::ImgUV, myFrame.getPlane(1),
+        myDataAdp.changePlane(1).initWrapper(isWide ? StImagePlane::ImgUV16 : StImagePlane::ImgUV, myFrame.getPlane(1),
                                              size_t(aFrameSizeX / 2), size_t(aFrameSizeY / 2), myFrame.getLineSize(1));
 
         myFrameBufRef->moveReferenceFrom(myFrame.Frame);
         myDataAdp.setBufferCounter(myFrameBufRef);
     } else if(!myToRgbIsBroken) {
-        if(myToRgbCtx    == NULL
+        if(!myToRgbScaler.isValid()
         || myToRgbPixFmt != aPixFmt
-        || size_t(aFrameSizeX) != myDataRGB.getSizeX()
-        || size_t(aFrameSizeY) != myDataRGB.getSizeY()) {
-            // initialize software scaler/converter
-        //#if LIBSWSCALE_VERSION_MAJOR >= 3
-            //myToRgbCtx = sws_getCachedContext(myToRgbCtx,
-            //                                  aFrameSizeX, aFrameSizeY, aPixFmt,
-            //                                  aFrameSizeX, aFrameSizeY, stAV::PIX_FMT::RGB24
-            //                                  SWS_BICUBIC, NULL, NULL, NULL);
-        //#else
-            sws_freeContext(myToRgbCtx);
-            myToRgbCtx = sws_getContext(aFrameSizeX, aFrameSizeY, aPixFmt,              // source
-                                        aFrameSizeX, aFrameSizeY, stAV::PIX_FMT::RGB24, // destination
-                                        SWS_BICUBIC, NULL, NULL, NULL);
-        //#endif
+        || aFrameSizeX   != myToRgbSizeX
+        || aFrameSizeY   != myToRgbSizeY) {
+            // initialize software scaler/converter,
+            // the frame is split into horizontal bands converted by several threads
             myToRgbPixFmt = aPixFmt;
-            if(myToRgbCtx == NULL
-            || aFrameSizeX <= 0
-            || aFrameSizeY <= 0) {
+            myToRgbSizeX  = aFrameSizeX;
+            myToRgbSizeY  = aFrameSizeY;
+            // use the same number of threads as decoder, so that Master and Slave streams share processors
+            if(!myToRgbScaler.init(aPixFmt, stAV::PIX_FMT::RGB24, aFrameSizeX, aFrameSizeY, myThreadsLimit)) {
                 signals.onError(stCString("FFmpeg: Failed to create SWScaler context"));
                 myToRgbIsBroken = true;
             } else {
-                if(!myDataRGB.initTrash(StImagePlane::ImgRGB, size_t(aFrameSizeX), size_t(aFrameSizeY))) {
+                // reference-counted buffers allow passing converted frame to the texture queue without copying
+                myToRgbRowBytes = (size_t(aFrameSizeX) * 3 + 15) & ~size_t(15);
+                if(myToRgbPool.init(int(myToRgbRowBytes * size_t(aFrameSizeY)))
+                && myFrameBufRef != NULL) {
+                    myDataRGB.nullify();
+                } else if(!myDataRGB.initTrash(StImagePlane::ImgRGB, size_t(aFrameSizeX), size_t(aFrameSizeY))) {
                     signals.onError(stCString("FFmpeg: Failed allocation of RGB frame (out of memory)"));
                     myToRgbIsBroken = true;
                 } else {
+                    myToRgbPool.release();
                     myFrameRGB.Frame->data[0]     = (uint8_t* )myDataRGB.changeData();
                     myFrameRGB.Frame->linesize[0] = (int      )myDataRGB.getSizeRowBytes();
                     for(int aPlaneIter = 1; aPlaneIter < AV_NUM_DATA_POINTERS; ++aPlaneIter) {
@@ -673,17 +691,39 @@ void StVideoQueue::prepareFrame(const StFormat theSrcFormat) {
             }
         }
 
+        AVBufferRef* aBufferRGB = NULL;
+        if(!myToRgbIsBroken
+        &&  myDataRGB.isNull()) {
+            aBufferRGB = myToRgbPool.getBuffer();
+            if(aBufferRGB == NULL) {
+                signals.onError(stCString("FFmpeg: Failed allocation of RGB frame (out of memory)"));
+                myToRgbIsBroken = true;
+            } else {
+                myFrameRGB.Frame->buf[0]      = aBufferRGB;
+                myFrameRGB.Frame->data[0]     = aBufferRGB->data;
+                myFrameRGB.Frame->linesize[0] = (int )myToRgbRowBytes;
+                myFrameRGB.Frame->width       = aFrameSizeX;
+                myFrameRGB.Frame->height      = aFrameSizeY;
+                myFrameRGB.Frame->format      = stAV::PIX_FMT::RGB24;
+            }
+        }
+
         if(!myToRgbIsBroken) {
-            sws_scale(myToRgbCtx,
-                      myFrame.Frame->data, myFrame.Frame->linesize,
-                      0, aFrameSizeY,
-                      myFrameRGB.Frame->data, myFrameRGB.Frame->linesize);
+            myToRgbScaler.convert(myFrame.Frame->data, myFrame.Frame->linesize,
+                                  myFrameRGB.Frame->data, myFrameRGB.Frame->linesize);
 
             myDataAdp.setColorModel(StImage::ImgColor_RGB);
             myDataAdp.setColorScale(StImage::ImgScale_Full);
             myDataAdp.setPixelRatio(getPixelRatio());
-            myDataAdp.changePlane(0).initWrapper(StImagePlane::ImgRGB, myDataRGB.changeData(),
-                                                 size_t(aFrameSizeX), size_t(aFrameSizeY));
+            if(aBufferRGB != NULL) {
+                myDataAdp.changePlane(0).initWrapper(StImagePlane::ImgRGB, aBufferRGB->data,
+                                                     size_t(aFrameSizeX), size_t(aFrameSizeY), myToRgbRowBytes);
+                myFrameBufRef->moveReferenceFrom(myFrameRGB.Frame);
+                myDataAdp.setBufferCounter(myFrameBufRef);
+            } else {
+                myDataAdp.changePlane(0).initWrapper(StImagePlane::ImgRGB, myDataRGB.changeData(),
+                                                     size_t(aFrameSizeX), size_t(aFrameSizeY));
+            }
         }
     } else {
         //ST_DEBUG_LOG("Frame skipped - unsupported pixel format!");
@@ -730,7 +770,7 @@ void StVideoQueue::pushFrame(const StImage&     theSrcDataLeft,
                                  : StViewSurface_Sphere;
     }
 
-    myTextureQueue->push(theSrcDataLeft, theSrcDataRight, theStParams, theSrcFormat, theCubemapFormat, theSrcPTS);
+    myTextureQueue->push(theSrcDataLeft, theSrcDataRight, theStParams, theSrcFormat, theCubemapFormat, theSrcPTS, &myFrameStamps);
     myTextureQueue->setConnectedStream(true);
     if(myWasFlushed) {
         // force frame update after seeking regardless playback timer
@@ -741,7 +781,7 @@ void StVideoQueue::pushFrame(const StImage&     theSrcDataLeft,
 
 void StVideoQueue::decodeLoop() {
     int isFrameFinished = 0;
-    double anAverageDelaySec = 40.0;
+    double anAverageDelaySec = 0.04;
     double aPrevPts  = 0.0;
     double aSlavePts = 0.0;
     myFramePts = 0.0;
@@ -781,7 +821,7 @@ void StVideoQueue::decodeLoop() {
             case StAVPacket::START_PACKET: {
                 myAudioClock = 0.0;
                 myVideoClock = 0.0;
-                myHasDataState.reset();
+                unlockData();
                 isStarted = true;
                 continue;
             }
@@ -792,6 +832,7 @@ void StVideoQueue::decodeLoop() {
                     }
                     // wake up Master
                     myDataAdp.nullify();
+                    myDataFreeState.reset();
                     myHasDataState.set();
                 } else {
                     if(!mySlave.isNull()) {
@@ -814,7 +855,9 @@ void StVideoQueue::decodeLoop() {
         }
 
         // wait master retrieve previous data
-        while(!myMaster.isNull() && myHasDataState.check()) {
+        while(!myMaster.isNull()
+           &&  myHasDataState.check()
+           && !myDataFreeState.wait(10)) {
             //
         }
 
@@ -839,10 +882,15 @@ void StVideoQueue::decodeLoop() {
     #endif
         if(isFrameFinished == 0) {
             // need more packets to decode whole frame
-            aPacket.nullify();
+            recycle(aPacket);
             continue;
         }
 
+        // take timestamps of the packet completed the frame
+        // (with frame threading or B-frames it is not the same packet the frame has been decoded from)
+        myFrameStamps = aPacket->getStamps();
+        myFrameStamps.Decoded = StFrameStamps::now();
+
         if(aPacket->isKeyFrame()) {
             myFramesCounter = 1;
         }
@@ -1020,6 +1068,7 @@ void StVideoQueue::decodeLoop() {
             }
         } else if(!myMaster.isNull()) {
             // push data to Master
+            myDataFreeState.reset();
             myHasDataState.set();
         } else {
             if(isStarted) {
@@ -1045,6 +1094,6 @@ void StVideoQueue::decodeLoop() {
         }
 
         myFrame.reset();
-        aPacket.nullify(); // and now packet finished
+        recycle(aPacket); // and now packet finished
     }
 }
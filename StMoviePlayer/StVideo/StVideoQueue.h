@@ -23,6 +23,8 @@
 
 #include "StAVPacketQueue.h"
 #include <StAV/StAVImage.h>
+#include <StAV/StAVBufferPool.h>
+#include <StAV/StAVScaler.h>
 
 // forward declarations
 class StVideoQueue;
@@ -130,6 +132,15 @@ class StVideoQueue : public StAVPacketQueue {
         myUseOpenJpeg = theToUseOpenJpeg;
     }
 
+    /**
+     * Setup maximum number of decoding threads, 0 means number of logical processors.
+     * Master and Slave streams are decoded concurrently and should share processors.
+     * Requires re-initialization to take effect!
+     */
+    ST_LOCAL void setThreadsLimit(const int theNbThreads) {
+        myThreadsLimit = theNbThreads;
+    }
+
     ST_LOCAL bool isInDowntime() {
         return myDowntimeState.check();
     }
@@ -149,6 +160,7 @@ class StVideoQueue : public StAVPacketQueue {
 
     ST_LOCAL void unlockData() {
         myHasDataState.reset();
+        myDataFreeState.set();
     }
 
     ST_LOCAL void setAClock(const double thePts) {
@@ -359,7 +371,8 @@ private:
     StCondition                myDowntimeState;   //!< event to indicate downtime state
     StHandle<StGLTextureQueue> myTextureQueue;    //!< decoded frames queue
 
-    StCondition                myHasDataState;
+    StCondition                myHasDataState;    //!< Slave frame is ready to be retrieved by Master
+    StCondition                myDataFreeState;   //!< Slave frame has been retrieved by Master
     StHandle<StVideoQueue>     myMaster;          //!< handle to Master decoding thread
     StHandle<StVideoQueue>     mySlave;           //!< handle to Slave  decoding thread
 
@@ -371,11 +384,16 @@ private:
     bool                       myUseGpu;          //!< activate decoding on GPU when possible
     bool                       myIsGpuFailed;     //!< flag indicating that GPU decoder can not handle input data
     bool                       myUseOpenJpeg;     //!< use OpenJPEG (libopenjpeg) instead of built-in jpeg2000 decoder
+    int                        myThreadsLimit;    //!< maximum number of decoding threads, 0 means number of logical processors
 
     StAVFrame                  myFrameRGB;        //!< frame, converted to RGB (soft)
-    StImagePlane               myDataRGB;         //!< RGB buffer data (for swscale)
-    SwsContext*                myToRgbCtx;        //!< software scaler context
+    StImagePlane               myDataRGB;         //!< RGB buffer data (for swscale), used only when myToRgbPool is unavailable
+    StAVBufferPool             myToRgbPool;       //!< pool of reference-counted RGB buffers (for swscale)
+    StAVScaler                 myToRgbScaler;     //!< software scaler (multi-threaded)
     AVPixelFormat              myToRgbPixFmt;     //!< current swscale context - from pixel format
+    int                        myToRgbSizeX;      //!< current swscale context - frame width
+    int                        myToRgbSizeY;      //!< current swscale context - frame height
+    size_t                     myToRgbRowBytes;   //!< row size within myToRgbPool buffers
     bool                       myToRgbIsBroken;   //!< indicates broke swscale context - to RGB conversion is impossible
 
     StAVFrame                  myFrame;           //!< original decoded video frame
@@ -384,6 +402,7 @@ private:
     AVDiscard                  myAvDiscard;       //!< discard parameter (to skip or not frames)
 
     double                     myFramePts;
+    StFrameStamps              myFrameStamps;     //!< pipeline timestamps of the frame being decoded
     GLfloat                    myPixelRatio;      //!< pixel aspect ratio
     int                        myHParallax;       //!< horizontal parallax in pixels stored in metadata
     int                        myRotateDeg;       //!< rotate angle in degrees
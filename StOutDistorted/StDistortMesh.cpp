@@ -0,0 +1,101 @@
+/**
+ * StOutDistorted, class providing stereoscopic output in anamorph side by side format using StCore toolkit.
+ * Copyright © 2017 Kirill Gavrilov <kirill@sview.ru>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file license-boost.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#include "StDistortMesh.h"
+
+#include <StGLCore/StGLCore20.h>
+#include <StGL/StGLContext.h>
+
+StDistortMesh::StDistortMesh(const size_t theNbCells)
+: StGLMesh(GL_TRIANGLES),
+  myNbCells(theNbCells > 0 ? theNbCells : 1),
+  myIsValid(false) {
+    //
+}
+
+void StDistortMesh::release(StGLContext& theCtx) {
+    StGLMesh::release(theCtx);
+    myIsValid = false;
+}
+
+bool StDistortMesh::update(StGLContext&    theCtx,
+                           const StGLVec4& theWarpCoef,
+                           const StGLVec4& theChromAb,
+                           const StGLVec2& theLensCenter,
+                           const StGLVec2& theScale,
+                           const StGLVec2& theScaleIn,
+                           const StGLVec2& theTexMax) {
+    if(myIsValid
+    && myWarpCoef   == theWarpCoef
+    && myChromAb    == theChromAb
+    && myLensCenter == theLensCenter
+    && myScale      == theScale
+    && myScaleIn    == theScaleIn
+    && myTexMax     == theTexMax) {
+        return true;
+    }
+
+    myWarpCoef   = theWarpCoef;
+    myChromAb    = theChromAb;
+    myLensCenter = theLensCenter;
+    myScale      = theScale;
+    myScaleIn    = theScaleIn;
+    myTexMax     = theTexMax;
+    myIsValid    = computeMesh()
+                && initVBOs(theCtx);
+    return myIsValid;
+}
+
+bool StDistortMesh::computeMesh() {
+    clearRAM();
+
+    const size_t aNbVertsRow = myNbCells + 1;
+    myVertices.initArray(aNbVertsRow * aNbVertsRow);
+    myTCoords .initArray(aNbVertsRow * aNbVertsRow);
+    myColors  .initArray(aNbVertsRow * aNbVertsRow);
+    for(size_t aRowIter = 0; aRowIter < aNbVertsRow; ++aRowIter) {
+        const GLfloat aV = GLfloat(aRowIter) / GLfloat(myNbCells);
+        for(size_t aColIter = 0; aColIter < aNbVertsRow; ++aColIter) {
+            const GLfloat aU = GLfloat(aColIter) / GLfloat(myNbCells);
+            const size_t  anIndex = aRowIter * aNbVertsRow + aColIter;
+            myVertices[anIndex] = StGLVec3(aU * 2.0f - 1.0f, aV * 2.0f - 1.0f, 0.0f);
+
+            // texture coordinates as interpolated across full-screen quad
+            const StGLVec2 aTCrd(aU * myTexMax.x(), aV * myTexMax.y());
+
+            // apply distortion, see StProgramBarrel
+            const StGLVec2 aTheta  = (aTCrd - myLensCenter) * myScaleIn;
+            const GLfloat  anRSq   = aTheta.x() * aTheta.x() + aTheta.y() * aTheta.y();
+            const StGLVec2 aTheta1 = aTheta * (myWarpCoef.x()
+                                             + myWarpCoef.y() * anRSq
+                                             + myWarpCoef.z() * anRSq * anRSq
+                                             + myWarpCoef.w() * anRSq * anRSq * anRSq);
+            const StGLVec2 aTCrdRed   = myLensCenter + myScale * (aTheta1 * (myChromAb.x() + myChromAb.y() * anRSq));
+            const StGLVec2 aTCrdGreen = myLensCenter + myScale *  aTheta1;
+            const StGLVec2 aTCrdBlue  = myLensCenter + myScale * (aTheta1 * (myChromAb.z() + myChromAb.w() * anRSq));
+            myTCoords[anIndex] = aTCrdGreen;
+            myColors [anIndex] = StGLVec4(aTCrdRed.x(), aTCrdRed.y(), aTCrdBlue.x(), aTCrdBlue.y());
+        }
+    }
+
+    myIndices.initList(myNbCells * myNbCells * 6);
+    for(size_t aRowIter = 0; aRowIter < myNbCells; ++aRowIter) {
+        for(size_t aColIter = 0; aColIter < myNbCells; ++aColIter) {
+            const GLuint aBottomLeft = GLuint(aRowIter * aNbVertsRow + aColIter);
+            const GLuint aTopLeft    = aBottomLeft + GLuint(aNbVertsRow);
+            myIndices.add(aBottomLeft);
+            myIndices.add(aBottomLeft + 1);
+            myIndices.add(aTopLeft);
+            myIndices.add(aTopLeft);
+            myIndices.add(aBottomLeft + 1);
+            myIndices.add(aTopLeft + 1);
+        }
+    }
+    return true;
+}
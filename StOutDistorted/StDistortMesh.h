@@ -0,0 +1,76 @@
+/**
+ * StOutDistorted, class providing stereoscopic output in anamorph side by side format using StCore toolkit.
+ * Copyright © 2017 Kirill Gavrilov <kirill@sview.ru>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file license-boost.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#ifndef __StDistortMesh_h_
+#define __StDistortMesh_h_
+
+#include <StGLMesh/StGLMesh.h>
+
+/**
+ * Tessellated full-screen quad with barrel distortion and chromatic aberration
+ * correction baked into per-vertex texture coordinates
+ * (same math as StProgramBarrel, but evaluated once per vertex on CPU).
+ * Vertex attributes layout:
+ * - vertices            - position in normalized device coordinates;
+ * - texture coordinates - green channel;
+ * - colors              - red channel in xy and blue channel in zw components.
+ */
+class StDistortMesh : public StGLMesh {
+
+        public:
+
+    /**
+     * Main constructor.
+     * @param theNbCells number of grid cells along each dimension
+     */
+    ST_LOCAL StDistortMesh(const size_t theNbCells = 40);
+
+    /**
+     * Recompute the mesh and upload it into VBOs if any parameter has been changed.
+     * @param theCtx        current context
+     * @param theWarpCoef   barrel distortion coefficients
+     * @param theChromAb    chromatic aberration coefficients
+     * @param theLensCenter lens center in texture coordinates
+     * @param theScale      scale from distorted space to texture coordinates
+     * @param theScaleIn    scale from texture coordinates to [-1, 1] range
+     * @param theTexMax     texture coordinates of the top-right quad corner
+     * @return true if mesh is valid
+     */
+    ST_LOCAL bool update(StGLContext&    theCtx,
+                         const StGLVec4& theWarpCoef,
+                         const StGLVec4& theChromAb,
+                         const StGLVec2& theLensCenter,
+                         const StGLVec2& theScale,
+                         const StGLVec2& theScaleIn,
+                         const StGLVec2& theTexMax);
+
+    /**
+     * Compute the mesh using parameters defined by last update() call.
+     */
+    ST_LOCAL virtual bool computeMesh() ST_ATTR_OVERRIDE;
+
+    /**
+     * Release GL resources.
+     */
+    ST_LOCAL virtual void release(StGLContext& theCtx) ST_ATTR_OVERRIDE;
+
+        private:
+
+    StGLVec4 myWarpCoef;   //!< barrel distortion coefficients
+    StGLVec4 myChromAb;    //!< chromatic aberration coefficients
+    StGLVec2 myLensCenter; //!< lens center
+    StGLVec2 myScale;      //!< output scale
+    StGLVec2 myScaleIn;    //!< input scale
+    StGLVec2 myTexMax;     //!< texture coordinates range
+    size_t   myNbCells;    //!< grid resolution
+    bool     myIsValid;    //!< VBOs correspond to current parameters
+
+};
+
+#endif // __StDistortMesh_h_
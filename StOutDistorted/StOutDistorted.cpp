@@ -9,7 +9,9 @@
 
 #include "StOutDistorted.h"
 
+#include "StDistortMesh.h"
 #include "StProgramBarrel.h"
+#include "StProgramBarrelMesh.h"
 #include "StProgramFlat.h"
 
 #include <StGL/StGLContext.h>
@@ -68,6 +70,7 @@ namespace {
         STTR_PARAMETER_DISTORTION = 1120,
         STTR_PARAMETER_DISTORTION_OFF    = 1121,
         STTR_PARAMETER_MONOCLONE         = 1123,
+        STTR_PARAMETER_DISTORT_MESH      = 1124,
 
         // about info
         STTR_PLUGIN_TITLE       = 2000,
@@ -183,6 +186,8 @@ void StOutDistorted::getOptions(StParamsList& theList) const {
     }
     if(myDevice != DEVICE_HMD) {
         theList.add(params.MonoClone);
+    } else {
+        theList.add(params.DistortMesh);
     }
 }
 
@@ -199,6 +204,7 @@ void StOutDistorted::updateStrings() {
     }
 
     params.MonoClone->setName(aLangMap.changeValueId(STTR_PARAMETER_MONOCLONE, "Show Mono in Stereo"));
+    params.DistortMesh->setName(aLangMap.changeValueId(STTR_PARAMETER_DISTORT_MESH, "Precomputed distortion mesh"));
 
     params.Layout->setName(aLangMap.changeValueId(STTR_PARAMETER_LAYOUT, "Layout"));
     params.Layout->defineOption(LAYOUT_SIDE_BY_SIDE_ANAMORPH, aLangMap.changeValueId(STTR_PARAMETER_LAYOUT_SBS_ANAMORPH,       "Side-by-Side (Anamorph)"));
@@ -236,6 +242,7 @@ StOutDistorted::StOutDistorted(const StHandle<StResourceManager>& theResMgr,
   myCursor(new StGLTexture(GL_RGBA8)),
   myProgramFlat(new StProgramFlat()),
   myProgramBarrel(new StProgramBarrel()),
+  myProgramMesh(new StProgramBarrelMesh()),
   myBarrelCoef(1.0f, 0.22f, 0.24f, 0.041f), // 7 inches
   //myBarrelCoef(1.0f, 0.18f, 0.115f, 0.0387f),
   myChromAb(0.996f, -0.004f, 1.014f, 0.0f),
@@ -268,6 +275,9 @@ StOutDistorted::StOutDistorted(const StHandle<StResourceManager>& theResMgr,
     myOvrSwapFbo[0] = 0;
     myOvrSwapFbo[1] = 0;
 #endif
+    myDistMesh[0] = new StDistortMesh();
+    myDistMesh[1] = new StDistortMesh();
+
     const StSearchMonitors& aMonitors = StWindow::getMonitors();
 
     // detect connected displays
@@ -342,6 +352,7 @@ StOutDistorted::StOutDistorted(const StHandle<StResourceManager>& theResMgr,
 
     // Distortion parameters
     params.MonoClone = new StBoolParamNamed(false, stCString("monoClone"), stCString("monoClone"));
+    params.DistortMesh = new StBoolParamNamed(true, stCString("distortMesh"), stCString("distortMesh"));
     // Layout option
     params.Layout = new StEnumParam(myCanHdmiPack ? LAYOUT_OVER_UNDER : LAYOUT_SIDE_BY_SIDE_ANAMORPH, stCString("layout"), stCString("layout"));
     updateStrings();
@@ -355,6 +366,7 @@ StOutDistorted::StOutDistorted(const StHandle<StResourceManager>& theResMgr,
         StWindow::setPlacement(aRect, true);
     }
     mySettings->loadParam(params.MonoClone);
+    mySettings->loadParam(params.DistortMesh);
     mySettings->loadParam(params.Layout);
     checkHdmiPack();
     StWindow::setTitle("sView - Distorted Renderer");
@@ -400,6 +412,9 @@ void StOutDistorted::releaseResources() {
 
         myProgramFlat->release(*myContext);
         myProgramBarrel->release(*myContext);
+        myProgramMesh->release(*myContext);
+        myDistMesh[0]->release(*myContext);
+        myDistMesh[1]->release(*myContext);
         myFrVertsBuf .release(*myContext);
         myFrTCrdsBuf .release(*myContext);
         myCurVertsBuf.release(*myContext);
@@ -423,6 +438,7 @@ void StOutDistorted::beforeClose() {
 
     mySettings->saveParam(params.Layout);
     mySettings->saveParam(params.MonoClone);
+    mySettings->saveParam(params.DistortMesh);
     mySettings->saveFloatVec4(ST_SETTING_WARP_COEF, myBarrelCoef);
     mySettings->saveFloatVec4(ST_SETTING_CHROME_AB, myChromAb);
     if(myWasUsed) {
@@ -478,6 +494,10 @@ bool StOutDistorted::create() {
     }
     myProgramBarrel->setupCoeff (*myContext, myBarrelCoef);
     myProgramBarrel->setupChrome(*myContext, myChromAb);
+    if(!myProgramMesh->init(*myContext)) {
+        // not critical - per-fragment distortion will be used instead
+        myProgramMesh->release(*myContext);
+    }
 
     // create vertices buffers to draw simple textured quad
     const GLfloat QUAD_VERTICES[4 * 4] = {
@@ -1222,27 +1242,44 @@ void StOutDistorted::stglDraw() {
     StGLProgram*    aProgram   = myProgramFlat.access();
     StGLVarLocation aVertexLoc = myProgramFlat->getVVertexLoc();
     StGLVarLocation aTexCrdLoc = myProgramFlat->getVTexCoordLoc();
+    const StGLVec2  aLensCenterL((0.5f + aLensDisp) * aDX, 0.5f * aDY);
+    const StGLVec2  aLensCenterR((0.5f - aLensDisp) * aDX, 0.5f * aDY);
+    const StGLVec2  aBarrelScaleIn(2.0f / aDX, 2.0f / aDY);
+    const StGLVec2  aBarrelScale  (0.4f * aDX, 0.4f * aDY);
+    bool toUseMesh = false;
     if(myDevice == DEVICE_HMD) {
         aProgram   = myProgramBarrel.access();
         aVertexLoc = myProgramBarrel->getVVertexLoc();
         aTexCrdLoc = myProgramBarrel->getVTexCoordLoc();
-        myProgramBarrel->setScaleIn(*myContext, StGLVec2(2.0f / aDX, 2.0f / aDY));
-        myProgramBarrel->setScale  (*myContext, StGLVec2(0.4f * aDX, 0.4f * aDY));
+        myProgramBarrel->setScaleIn(*myContext, aBarrelScaleIn);
+        myProgramBarrel->setScale  (*myContext, aBarrelScale);
+
+        // meshes are recomputed only when lens parameters or FBO dimensions have been changed
+        toUseMesh = params.DistortMesh->getValue()
+                 && myProgramMesh->isValid()
+                 && myDistMesh[0]->update(*myContext, myBarrelCoef, myChromAb, aLensCenterL, aBarrelScale, aBarrelScaleIn, StGLVec2(aDX, aDY))
+                 && myDistMesh[1]->update(*myContext, myBarrelCoef, myChromAb, aLensCenterR, aBarrelScale, aBarrelScaleIn, StGLVec2(aDX, aDY));
     }
 
     myFrBuffer->bindTexture(*myContext);
-    if(aProgram == myProgramBarrel.access()) {
-        myProgramBarrel->setLensCenter(*myContext, StGLVec2((0.5f + aLensDisp) * aDX, 0.5f * aDY));
-    }
-    aProgram->use(*myContext);
-        myFrVertsBuf.bindVertexAttrib(*myContext, aVertexLoc);
-        myFrTCrdsBuf.bindVertexAttrib(*myContext, aTexCrdLoc);
+    if(toUseMesh) {
+        myProgramMesh->use(*myContext);
+        myDistMesh[0]->draw(*myContext, *myProgramMesh);
+        myProgramMesh->unuse(*myContext);
+    } else {
+        if(aProgram == myProgramBarrel.access()) {
+            myProgramBarrel->setLensCenter(*myContext, aLensCenterL);
+        }
+        aProgram->use(*myContext);
+            myFrVertsBuf.bindVertexAttrib(*myContext, aVertexLoc);
+            myFrTCrdsBuf.bindVertexAttrib(*myContext, aTexCrdLoc);
 
-        myContext->core20fwd->glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+            myContext->core20fwd->glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
-        myFrTCrdsBuf.unBindVertexAttrib(*myContext, aTexCrdLoc);
-        myFrVertsBuf.unBindVertexAttrib(*myContext, aVertexLoc);
-    aProgram->unuse(*myContext);
+            myFrTCrdsBuf.unBindVertexAttrib(*myContext, aTexCrdLoc);
+            myFrVertsBuf.unBindVertexAttrib(*myContext, aVertexLoc);
+        aProgram->unuse(*myContext);
+    }
     myFrBuffer->unbindTexture(*myContext);
     myContext->stglResetScissorRect();
 
@@ -1257,19 +1294,25 @@ void StOutDistorted::stglDraw() {
     myContext->stglSetScissorRect(aViewPortR, false);
 
     myFrBuffer->bindTexture(*myContext);
-    if(aProgram == myProgramBarrel.access()) {
-        myProgramBarrel->setLensCenter(*myContext, StGLVec2((0.5f - aLensDisp) * aDX, 0.5f * aDY));
-    }
-    aProgram->use(*myContext);
-    myFrVertsBuf.bindVertexAttrib(*myContext, aVertexLoc);
-    myFrTCrdsBuf.bindVertexAttrib(*myContext, aTexCrdLoc);
+    if(toUseMesh) {
+        myProgramMesh->use(*myContext);
+        myDistMesh[1]->draw(*myContext, *myProgramMesh);
+        myProgramMesh->unuse(*myContext);
+    } else {
+        if(aProgram == myProgramBarrel.access()) {
+            myProgramBarrel->setLensCenter(*myContext, aLensCenterR);
+        }
+        aProgram->use(*myContext);
+        myFrVertsBuf.bindVertexAttrib(*myContext, aVertexLoc);
+        myFrTCrdsBuf.bindVertexAttrib(*myContext, aTexCrdLoc);
 
-    myContext->core20fwd->glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        myContext->core20fwd->glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
-    myFrTCrdsBuf.unBindVertexAttrib(*myContext, aTexCrdLoc);
-    myFrVertsBuf.unBindVertexAttrib(*myContext, aVertexLoc);
+        myFrTCrdsBuf.unBindVertexAttrib(*myContext, aTexCrdLoc);
+        myFrVertsBuf.unBindVertexAttrib(*myContext, aVertexLoc);
 
-    aProgram->unuse(*myContext);
+        aProgram->unuse(*myContext);
+    }
     myFrBuffer->unbindTexture(*myContext);
     myContext->stglResetScissorRect();
 
@@ -18,6 +18,8 @@
 
 class StSettings;
 class StProgramBarrel;
+class StProgramBarrelMesh;
+class StDistortMesh;
 class StProgramFlat;
 class StGLFrameBuffer;
 class StGLTexture;
@@ -254,6 +256,7 @@ class StOutDistorted : public StWindow {
 
         StHandle<StEnumParam>      Layout;   //!< pair layout
         StHandle<StBoolParamNamed> MonoClone;//!< display mono in stereo
+        StHandle<StBoolParamNamed> DistortMesh; //!< apply HMD distortion using precomputed mesh instead of per-fragment evaluation
 
     } params;
 
@@ -274,6 +277,8 @@ class StOutDistorted : public StWindow {
     StHandle<StGLTexture>     myCursor;          //!< cursor texture - we can not use normal cursor due to distortions
     StHandle<StProgramFlat>   myProgramFlat;
     StHandle<StProgramBarrel> myProgramBarrel;
+    StHandle<StProgramBarrelMesh> myProgramMesh; //!< program drawing precomputed distortion mesh
+    StHandle<StDistortMesh>   myDistMesh[2];     //!< precomputed distortion meshes for left and right eyes
     StFPSControl              myFPSControl;
     StGLVertexBuffer          myFrVertsBuf;      //!< buffers to draw simple fullsreen quad
     StGLVertexBuffer          myFrTCrdsBuf;
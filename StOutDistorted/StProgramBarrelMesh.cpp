@@ -0,0 +1,70 @@
+/**
+ * StOutDistorted, class providing stereoscopic output in anamorph side by side format using StCore toolkit.
+ * Copyright © 2017 Kirill Gavrilov <kirill@sview.ru>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file license-boost.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#include "StProgramBarrelMesh.h"
+
+#include <StGLCore/StGLCore20.h>
+#include <StGL/StGLContext.h>
+
+StProgramBarrelMesh::StProgramBarrelMesh()
+: StGLMeshProgram("StProgramBarrelMesh") {}
+
+bool StProgramBarrelMesh::init(StGLContext& theCtx) {
+    const char VERTEX_SHADER[] =
+       "attribute vec4 vVertex;\n"
+       "attribute vec2 vTexCoord;\n"
+       "attribute vec4 vColor;\n"
+       "varying vec2 fTCrdRed;\n"
+       "varying vec2 fTCrdGreen;\n"
+       "varying vec2 fTCrdBlue;\n"
+       "void main(void) {\n"
+       "  fTCrdRed   = vColor.xy;\n"
+       "  fTCrdGreen = vTexCoord;\n"
+       "  fTCrdBlue  = vColor.zw;\n"
+       "  gl_Position = vVertex;\n"
+       "}\n";
+
+    const char FRAGMENT_SHADER[] =
+       "uniform sampler2D texR, texL;\n"
+       "varying vec2 fTCrdRed;\n"
+       "varying vec2 fTCrdGreen;\n"
+       "varying vec2 fTCrdBlue;\n"
+       "\n"
+       "void main(void) {\n"
+       "  if(any(bvec2(clamp(fTCrdBlue, vec2(0.0, 0.0), vec2(1.0, 1.0)) - fTCrdBlue))) {\n"
+       "    gl_FragColor = vec4(0.0, 0.0, 0.0, 1.0);\n"
+       "    return;\n"
+       "  }\n"
+       "\n"
+       "  gl_FragColor = vec4(texture2D(texR, fTCrdRed  ).r,\n"
+       "                      texture2D(texR, fTCrdGreen).g,\n"
+       "                      texture2D(texR, fTCrdBlue ).b, 1.0);\n"
+       "}\n";
+
+    StGLVertexShader aVertexShader(StGLProgram::getTitle());
+    StGLAutoRelease aTmp1(theCtx, aVertexShader);
+    aVertexShader.init(theCtx, VERTEX_SHADER);
+
+    StGLFragmentShader aFragmentShader(StGLProgram::getTitle());
+    StGLAutoRelease aTmp2(theCtx, aFragmentShader);
+    aFragmentShader.init(theCtx, FRAGMENT_SHADER);
+    if(!StGLProgram::create(theCtx)
+       .attachShader(theCtx, aVertexShader)
+       .attachShader(theCtx, aFragmentShader)
+       .link(theCtx)) {
+        return false;
+    }
+
+    atrVVertexLoc = StGLProgram::getAttribLocation(theCtx, "vVertex");
+    atrVTCoordLoc = StGLProgram::getAttribLocation(theCtx, "vTexCoord");
+    atrVColorsLoc = StGLProgram::getAttribLocation(theCtx, "vColor");
+    return atrVVertexLoc.isValid()
+        && atrVTCoordLoc.isValid()
+        && atrVColorsLoc.isValid();
+}
@@ -0,0 +1,36 @@
+/**
+ * StOutDistorted, class providing stereoscopic output in anamorph side by side format using StCore toolkit.
+ * Copyright © 2017 Kirill Gavrilov <kirill@sview.ru>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file license-boost.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#ifndef __StProgramBarrelMesh_h_
+#define __StProgramBarrelMesh_h_
+
+#include <StGLMesh/StGLMesh.h>
+
+/**
+ * GLSL program drawing precomputed distortion mesh (StDistortMesh).
+ * Unlike StProgramBarrel, fragment shader just samples the texture
+ * using per-vertex texture coordinates for each color channel.
+ */
+class StProgramBarrelMesh : public StGLMeshProgram {
+
+        public:
+
+    /**
+     * Empty constructor.
+     */
+    ST_LOCAL StProgramBarrelMesh();
+
+    /**
+     * Initialize the program.
+     */
+    ST_LOCAL virtual bool init(StGLContext& theCtx) ST_ATTR_OVERRIDE;
+
+};
+
+#endif // __StProgramBarrelMesh_h_
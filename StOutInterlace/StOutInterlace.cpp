@@ -642,15 +642,30 @@ bool StOutInterlace::create() {
                                        .attachShader(*myContext, aShaderChessRev)
                                        .link(*myContext);
 
-    // discard mask texture
+    // discard mask texture - 2x2 pattern repeated across viewport;
+    // mask coordinates are computed per-vertex to avoid dependency on gl_FragCoord precision
+    StGLVertexShader aVertShaderMask(myGlProgramMask->getTitle());
     StGLFragmentShader aShaderMask(myGlProgramMask->getTitle());
     StGLAutoRelease aTmp8(*myContext, aShaderMask);
-    if(!aShaderMask.init(*myContext,
+    StGLAutoRelease aTmp8v(*myContext, aVertShaderMask);
+    if(!aVertShaderMask.init(*myContext,
+                             "uniform vec2 uMaskScale;\n"
+                             "attribute vec4 vVertex;\n"
+                             "attribute vec2 vTexCoord;\n"
+                             "varying vec2 fTexCoord;\n"
+                             "varying vec2 fMaskCoord;\n"
+                             "void main(void) {\n"
+                             "  fTexCoord  = vTexCoord;\n"
+                             "  fMaskCoord = (vVertex.xy * 0.5 + 0.5) * uMaskScale;\n"
+                             "  gl_Position = vVertex;\n"
+                             "}\n")
+    || !aShaderMask.init(*myContext,
                          "uniform sampler2D uTexture;\n"
                          "uniform sampler2D uMaskTexture;\n"
                          "varying vec2 fTexCoord;\n"
+                         "varying vec2 fMaskCoord;\n"
                          "void main(void) {\n"
-                         "  float aMask = texture2D(uMaskTexture, fTexCoord).a;\n"
+                         "  float aMask = texture2D(uMaskTexture, fMaskCoord).a;\n"
                          "  if(aMask < 0.5) { discard; }\n"
                          "  gl_FragColor = texture2D(uTexture, fTexCoord);\n"
                          "}\n")) {
@@ -659,9 +674,10 @@ bool StOutInterlace::create() {
         return true;
     }
     myGlProgramMask->create(*myContext)
-                   .attachShader(*myContext, aVertexShader)
+                   .attachShader(*myContext, aVertShaderMask)
                    .attachShader(*myContext, aShaderMask)
                    .link(*myContext);
+    myMaskScaleLoc = myGlProgramMask->getUniformLocation(*myContext, "uMaskScale");
 
 #if !defined(__ANDROID__)
     const StString aShadersRoot = StString("shaders" ST_FILE_SPLITTER) + ST_OUT_PLUGIN_NAME + SYS_FS_SPLITTER;
@@ -776,25 +792,25 @@ void StOutInterlace::processEvents() {
 }
 
 bool StOutInterlace::initTextureMask(int  theDevice,
-                                     bool theToReverse,
-                                     int  theSizeX,
-                                     int  theSizeY) {
-    if(myTextureMask->getSizeX() == theSizeX
-    && myTextureMask->getSizeY() == theSizeY
+                                     bool theToReverse) {
+    if(myTextureMask->isValid()
     && myTexMaskDevice   == theDevice
     && myTexMaskReversed == theToReverse) {
         return true;
     }
 
+    // pattern is repeated by texture sampler, thus 2x2 image is enough
+    const int aSizeX = 2;
+    const int aSizeY = 2;
     StImagePlane anImage;
-    if(!anImage.initTrash(StImagePlane::ImgGray, theSizeX, theSizeY)) {
+    if(!anImage.initTrash(StImagePlane::ImgGray, aSizeX, aSizeY)) {
         myMsgQueue->pushError(stCString("Interlace output - critical error:\nNot enough memory for mask image!"));
         myIsBroken = true;
         return false;
     }
 
-    for(int aRowIter = 0; aRowIter < theSizeY; ++aRowIter) {
-        for(int aColIter = 0; aColIter < theSizeX; ++aColIter) {
+    for(int aRowIter = 0; aRowIter < aSizeY; ++aRowIter) {
+        for(int aColIter = 0; aColIter < aSizeX; ++aColIter) {
             stUByte_t* aPixel = anImage.changeData(aRowIter, aColIter);
             switch(theDevice) {
                 case DEVICE_ROW_INTERLACED:
@@ -832,12 +848,18 @@ bool StOutInterlace::initTextureMask(int  theDevice,
         }
     }
 
+    myTextureMask->setMinMagFilter(*myContext, GL_NEAREST);
     if(!myTextureMask->init(*myContext, anImage)) {
-        myMsgQueue->pushError(stCString("Interlace output - critical error:\nMask texture resize failed!"));
+        myMsgQueue->pushError(stCString("Interlace output - critical error:\nMask texture initialization failed!"));
         myIsBroken = true;
         return false;
     }
 
+    myTextureMask->bind(*myContext);
+    myContext->core20fwd->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    myContext->core20fwd->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    myTextureMask->unbind(*myContext);
+
     myTexMaskDevice   = theDevice;
     myTexMaskReversed = theToReverse;
     return true;
@@ -1013,7 +1035,7 @@ void StOutInterlace::stglDraw() {
     // initialize mask texture
     const bool toUseTexMask = params.ToUseMask->getValue();
     if(toUseTexMask) {
-        if(!initTextureMask(aDevice, isPixelReverse, myFrmBuffer->getSizeX(), myFrmBuffer->getSizeY())) {
+        if(!initTextureMask(aDevice, isPixelReverse)) {
             return;
         }
     } else {
@@ -1050,6 +1072,10 @@ void StOutInterlace::stglDraw() {
                                             ? myGlProgramsRev[aDevice]
                                             : myGlPrograms[aDevice]);
     aProgram->use(*myContext);
+    if(toUseTexMask) {
+        // one mask texel per pixel
+        myContext->core20fwd->glUniform2f(myMaskScaleLoc, GLfloat(aVPort.width()) * 0.5f, GLfloat(aVPort.height()) * 0.5f);
+    }
     myQuadVertBuf.bindVertexAttrib(*myContext, ST_VATTRIB_VERTEX);
     myQuadTexCoordBuf.bindVertexAttrib(*myContext, ST_VATTRIB_TCOORD);
 
@@ -141,11 +141,11 @@ class StOutInterlace : public StWindow {
 
     /**
      * Initialize texture mask.
+     * The mask defines 2x2 pattern repeated across the viewport,
+     * thus it is independent from window size.
      */
     ST_LOCAL bool initTextureMask(int  theDevice,
-                                  bool theToReverse,
-                                  int  theSizeX,
-                                  int  theSizeY);
+                                  bool theToReverse);
 
     /**
      * Release GL resources before window closing.
@@ -212,7 +212,8 @@ class StOutInterlace : public StWindow {
     StHandle<StProgramFB>     myGlProgramsRev[DEVICE_NB]; //!< GLSL programs with reversed left/right condition
 
     StHandle<StProgramFB>     myGlProgramMask;            //!< universal GLSL program which uses mask texture
-    StHandle<StGLTexture>     myTextureMask;              //!< texture holding mask for discarding pixels
+    StHandle<StGLTexture>     myTextureMask;              //!< texture holding 2x2 mask pattern for discarding pixels
+    StGLVarLocation           myMaskScaleLoc;             //!< location of uniform scaling mask texture coordinates to viewport size
     int                       myTexMaskDevice;            //!< texture mask device
     bool                      myTexMaskReversed;          //!< texture mask is initialized in reversed state
 
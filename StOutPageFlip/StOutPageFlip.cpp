@@ -17,6 +17,7 @@
 #include <StGL/StGLEnums.h>
 #include <StGL/StGLContext.h>
 #include <StGL/StGLArbFbo.h>
+#include <StGL/StGLAsyncReadback.h>
 #include <StGLMesh/StGLTextureQuad.h>
 #include <StGLCore/StGLCore20.h>
 #include <StGLStereo/StGLStereoFrameBuffer.h>
@@ -37,8 +38,7 @@ namespace {
 }
 
 StOutPageFlip::StOutDirect3D::StOutDirect3D()
-: GlIoBuff(0),
-  ActivateStep(0),
+: ActivateStep(0),
   IsActive(false),
   ToUsePBO(true) {
     //
@@ -725,10 +725,11 @@ void StOutPageFlip::dxRelease() {
         myOutD3d.WglDxBuffer.nullify();
     }
 
-    if(myOutD3d.GlIoBuff != 0) {
-        myContext->core20fwd->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-        myContext->core20fwd->glDeleteBuffers(1, &myOutD3d.GlIoBuff);
-        myOutD3d.GlIoBuff = 0;
+    for(int aViewIter = 0; aViewIter < 2; ++aViewIter) {
+        if(!myOutD3d.Readback[aViewIter].isNull()) {
+            myOutD3d.Readback[aViewIter]->release(*myContext);
+            myOutD3d.Readback[aViewIter].nullify();
+        }
     }
 #endif
 }
@@ -830,10 +831,11 @@ void StOutPageFlip::dxDisactivate() {
             myOutD3d.GlBuffer->release(*myContext);
             myOutD3d.GlBuffer.nullify();
         }
-        if(myOutD3d.GlIoBuff != 0) {
-            myContext->core20fwd->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-            myContext->core20fwd->glDeleteBuffers(1, &myOutD3d.GlIoBuff);
-            myOutD3d.GlIoBuff = 0;
+        for(int aViewIter = 0; aViewIter < 2; ++aViewIter) {
+            if(!myOutD3d.Readback[aViewIter].isNull()) {
+                myOutD3d.Readback[aViewIter]->release(*myContext);
+                myOutD3d.Readback[aViewIter].nullify();
+            }
         }
     }
 #endif
@@ -950,39 +952,63 @@ void StOutPageFlip::processEvents() {
 
 void StOutPageFlip::dxDraw(unsigned int view) {
 #ifdef _WIN32
-    if(myOutD3d.ToUsePBO) {
-        // use PBO to get some speed up
-        // PBO macro (see spec for details)
-        #define BUFFER_OFFSET(i) ((char *)NULL + (i))
-        if(myOutD3d.GlIoBuff == 0) {
-            myContext->core20fwd->glGenBuffers(1, &myOutD3d.GlIoBuff);
-            myContext->core20fwd->glBindBuffer(GL_PIXEL_PACK_BUFFER, myOutD3d.GlIoBuff);
-            myContext->core20fwd->glBufferData(GL_PIXEL_PACK_BUFFER, myOutD3d.GlBuffer->getSizeX() * myOutD3d.GlBuffer->getSizeY() * 4, NULL, GL_STREAM_READ);
+    const size_t aViewIndex = view == ST_DRAW_LEFT ? 0 : 1;
+    if(myOutD3d.ToUsePBO
+    && myOutD3d.Readback[aViewIndex].isNull()
+    && StGLAsyncReadback::isSupported(*myContext)) {
+        myOutD3d.Readback[aViewIndex] = new StGLAsyncReadback(2);
+    }
+
+    if(myOutD3d.ToUsePBO
+    && !myOutD3d.Readback[aViewIndex].isNull()) {
+        // initiate asynchronous transfer into PBO, so that it overlaps rendering of the next frame
+        const GLsizei aSizeX = myOutD3d.GlBuffer->getSizeX();
+        const GLsizei aSizeY = myOutD3d.GlBuffer->getSizeY();
+        if(!myOutD3d.GlBuffer->readPixelsAsync(*myContext, *myOutD3d.Readback[aViewIndex], GL_BGRA, GL_UNSIGNED_BYTE)) {
+            ST_DEBUG_LOG_AT("PBO readback has failed, fallback to synchronous read");
+            for(int aViewIter = 0; aViewIter < 2; ++aViewIter) {
+                if(!myOutD3d.Readback[aViewIter].isNull()) {
+                    myOutD3d.Readback[aViewIter]->release(*myContext);
+                    myOutD3d.Readback[aViewIter].nullify();
+                }
+            }
+            myOutD3d.ToUsePBO = false;
+            if(view == ST_DRAW_LEFT) {
+                // synchronous path locks buffers on left view and unlocks them on right one
+                dxDraw(view);
+            }
+            return;
         }
 
-        myContext->core20fwd->glReadBuffer(GL_COLOR_ATTACHMENT0);
-        myContext->core20fwd->glBindBuffer(GL_PIXEL_PACK_BUFFER, myOutD3d.GlIoBuff);
-        myContext->core20fwd->glReadPixels(0, 0, myOutD3d.GlBuffer->getSizeX(), myOutD3d.GlBuffer->getSizeY(), GL_BGRA, GL_UNSIGNED_BYTE, BUFFER_OFFSET(0));
-        GLubyte* ioMemBRGA = (GLubyte* )myContext->core20fwd->glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
-        if(ioMemBRGA == NULL) {
-            ST_DEBUG_LOG_AT("PBO buffer is sucks!");
+        // present previous frame once both views of the current one have been requested;
+        // this gives one frame of latency but avoids waiting for the transfer just initiated
+        StHandle<StGLAsyncReadback>& aReadL = myOutD3d.Readback[0];
+        StHandle<StGLAsyncReadback>& aReadR = myOutD3d.Readback[1];
+        if(view == ST_DRAW_LEFT
+        || aReadL.isNull()
+        || !aReadL->isFull()
+        || !aReadR->isFull()) {
+            return;
         }
 
-        if(view == ST_DRAW_LEFT) {
+        const size_t   aFrameSize = size_t(aSizeX) * size_t(aSizeY) * 4;
+        const GLubyte* aDataL = aReadL->getOldestSizeX() == aSizeX && aReadL->getOldestSizeY() == aSizeY ? aReadL->mapOldest(*myContext) : NULL;
+        const GLubyte* aDataR = aReadR->getOldestSizeX() == aSizeX && aReadR->getOldestSizeY() == aSizeY ? aReadR->mapOldest(*myContext) : NULL;
+        if(aDataL != NULL
+        && aDataR != NULL) {
             myOutD3d.DxWindow->lockLRBuffers();
             myOutD3d.DxWindow->allocateBuffers();
             if(myOutD3d.DxWindow->getBuffLeft() != NULL) {
-                stMemCpy(myOutD3d.DxWindow->getBuffLeft(),  ioMemBRGA, myOutD3d.GlBuffer->getSizeX() * myOutD3d.GlBuffer->getSizeY() * 4);
+                stMemCpy(myOutD3d.DxWindow->getBuffLeft(),  aDataL, aFrameSize);
             }
-        } else {
             if(myOutD3d.DxWindow->getBuffRight() != NULL) {
-                stMemCpy(myOutD3d.DxWindow->getBuffRight(), ioMemBRGA, myOutD3d.GlBuffer->getSizeX() * myOutD3d.GlBuffer->getSizeY() * 4);
+                stMemCpy(myOutD3d.DxWindow->getBuffRight(), aDataR, aFrameSize);
             }
             myOutD3d.DxWindow->unlockLRBuffers();
             myOutD3d.DxWindow->update();
         }
-        myContext->core20fwd->glUnmapBuffer(GL_PIXEL_PACK_BUFFER); // release memory, i.e. give control back to the driver
-        myContext->core20fwd->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        aReadL->unmapOldest(*myContext);
+        aReadR->unmapOldest(*myContext);
     } else {
         // simple read
         if(view == ST_DRAW_LEFT) {
@@ -1012,6 +1038,10 @@ bool StOutPageFlip::isStereoFullscreenOnly() const {
 #endif
 }
 
+bool StOutPageFlip::toDrawContinuously() const {
+    return StWindow::isStereoOutput();
+}
+
 void StOutPageFlip::stglDraw() {
     myFPSControl.setTargetFPS(StWindow::getTargetFps());
 
@@ -24,6 +24,7 @@ class StSettings;
 class StWindow;
 class StVuzixSDK;
 class StGLFrameBuffer;
+class StGLAsyncReadback;
 class StGLTextureQuad;
 class StDXNVWindow;
 
@@ -136,6 +137,11 @@ class StOutPageFlip : public StWindow {
      */
     ST_CPPEXPORT virtual bool isStereoFullscreenOnly() const ST_ATTR_OVERRIDE;
 
+    /**
+     * Shutter glasses and HMD should be driven continuously within stereo output.
+     */
+    ST_CPPEXPORT virtual bool toDrawContinuously() const ST_ATTR_OVERRIDE;
+
         protected:
 
     ST_LOCAL void setupDevice();
@@ -236,10 +242,10 @@ class StOutPageFlip : public StWindow {
         StHandle<StThread>          DxThread;
         StHandle<StGLDXFrameBuffer> WglDxBuffer;
     #endif
-        GLuint GlIoBuff;
-        int    ActivateStep;
-        bool   IsActive;
-        bool   ToUsePBO;
+        StHandle<StGLAsyncReadback> Readback[2]; //!< asynchronous readback of left and right views
+        int                         ActivateStep;
+        bool                        IsActive;
+        bool                        ToUsePBO;
 
         ST_LOCAL StOutDirect3D();
         ST_LOCAL ~StOutDirect3D();
@@ -1,5 +1,5 @@
 /**
- * Copyright © 2011-2015 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2011-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -51,6 +51,8 @@ int StAVImage::getAVPixelFormat(const StImage& theImage) {
             size_t aDelimY = (theImage.getPlane(1).getSizeY() > 0) ? (aPlane0.getSizeY() / theImage.getPlane(1).getSizeY()) : 1;
             if(theImage.getPlane(1).getFormat() == StImagePlane::ImgUV) {
                 return stAV::PIX_FMT::NV12;
+            } else if(theImage.getPlane(1).getFormat() == StImagePlane::ImgUV16) {
+                return stAV::PIX_FMT::P016;
             } else if(aDelimX == 1 && aDelimY == 1) {
                 switch(theImage.getColorScale()) {
                     case StImage::ImgScale_Mpeg:
@@ -61,6 +63,8 @@ int StAVImage::getAVPixelFormat(const StImage& theImage) {
                     case StImage::ImgScale_Jpeg9:  return stAV::PIX_FMT::YUV444P9;
                     case StImage::ImgScale_Mpeg10:
                     case StImage::ImgScale_Jpeg10: return stAV::PIX_FMT::YUV444P10;
+                    case StImage::ImgScale_Mpeg12:
+                    case StImage::ImgScale_Jpeg12: return stAV::PIX_FMT::YUV444P12;
                     case StImage::ImgScale_Full:
                     default:
                         return aPlane0.getFormat() == StImagePlane::ImgGray16
@@ -77,6 +81,8 @@ int StAVImage::getAVPixelFormat(const StImage& theImage) {
                     case StImage::ImgScale_Jpeg9:  return stAV::PIX_FMT::YUV420P9;
                     case StImage::ImgScale_Mpeg10:
                     case StImage::ImgScale_Jpeg10: return stAV::PIX_FMT::YUV420P10;
+                    case StImage::ImgScale_Mpeg12:
+                    case StImage::ImgScale_Jpeg12: return stAV::PIX_FMT::YUV420P12;
                     case StImage::ImgScale_Full:
                     default:
                         return aPlane0.getFormat() == StImagePlane::ImgGray16
@@ -93,6 +99,8 @@ int StAVImage::getAVPixelFormat(const StImage& theImage) {
                     case StImage::ImgScale_Jpeg9:  return stAV::PIX_FMT::YUV422P9;
                     case StImage::ImgScale_Mpeg10:
                     case StImage::ImgScale_Jpeg10: return stAV::PIX_FMT::YUV422P10;
+                    case StImage::ImgScale_Mpeg12:
+                    case StImage::ImgScale_Jpeg12: return stAV::PIX_FMT::YUV422P12;
                     case StImage::ImgScale_Full:
                     default:
                         return aPlane0.getFormat() == StImagePlane::ImgGray16
@@ -340,7 +348,7 @@ bool StAVImage::loadExtra(const StString& theFilePath,
                 return false;
             }
         } else {
-            if(!aRawFile.readFile()) {
+            if(!aRawFile.mapFile()) {
                 setState("StAVImage, could not read the file");
                 close();
                 return false;
@@ -481,6 +489,9 @@ bool StAVImage::loadExtra(const StString& theFilePath,
         } else if(aDimsYUV.bitsPerComp == 10) {
             aPlaneFrmt = StImagePlane::ImgGray16;
             setColorScale(aDimsYUV.isFullScale ? StImage::ImgScale_Jpeg10 : StImage::ImgScale_Mpeg10);
+        } else if(aDimsYUV.bitsPerComp == 12) {
+            aPlaneFrmt = StImagePlane::ImgGray16;
+            setColorScale(aDimsYUV.isFullScale ? StImage::ImgScale_Jpeg12 : StImage::ImgScale_Mpeg12);
         } else if(aDimsYUV.bitsPerComp == 16) {
             aPlaneFrmt = StImagePlane::ImgGray16;
         }
@@ -535,6 +546,32 @@ bool StAVImage::loadExtra(const StString& theFilePath,
 bool StAVImage::save(const StString& theFilePath,
                      ImageType       theImageType,
                      StFormat        theSrcFormat) {
+    StJpegParser aRawFile(theFilePath);
+    if(!encode(aRawFile, theImageType, theSrcFormat)) {
+        return false;
+    }
+
+    if(!aRawFile.openFile(StRawFile::WRITE)) {
+        setState("Can not open the file for writing");
+        return false;
+    }
+
+    // store current content
+    aRawFile.writeFile();
+    // and finally close the file handle
+    aRawFile.closeFile();
+
+    // set debug information
+    StString aDummy, aFileName;
+    StFileNode::getFolderAndFile(theFilePath, aDummy, aFileName);
+    setState(StString("AVCodec library, saved image '") + aFileName + "' " + getDescription());
+
+    return true;
+}
+
+bool StAVImage::encode(StJpegParser& theBuffer,
+                       ImageType     theImageType,
+                       StFormat      theSrcFormat) {
     close();
     setState();
     if(isNull()) {
@@ -674,20 +711,13 @@ bool StAVImage::save(const StString& theFilePath,
     }
 #endif
 
-    StJpegParser aRawFile(theFilePath);
-    if(!aRawFile.openFile(StRawFile::WRITE)) {
-        setState("Can not open the file for writing");
-        close();
-        return false;
-    }
-
     // allocate the buffer, large enough (stupid formula copied from ffmpeg.c)
     int aBuffSize = int(getSizeX() * getSizeY() * 10);
-    aRawFile.initBuffer(aBuffSize);
+    theBuffer.initBuffer(aBuffSize);
 
     // encode the image
     StAVPacket aPacket;
-    aPacket.getAVpkt()->data = (uint8_t* )aRawFile.changeBuffer();
+    aPacket.getAVpkt()->data = (uint8_t* )theBuffer.changeBuffer();
     aPacket.getAVpkt()->size = aBuffSize;
 #if(LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(54, 2, 100))
     int isGotPacket = 0;
@@ -703,31 +733,20 @@ bool StAVImage::save(const StString& theFilePath,
         close();
         return false;
     }
-    aRawFile.setDataSize((size_t )anEncSize);
+    theBuffer.setDataSize((size_t )anEncSize);
 
     // save metadata when possible
     if(theImageType == ST_TYPE_JPEG
     || theImageType == ST_TYPE_JPS) {
-        if(aRawFile.parse()) {
+        if(theBuffer.parse()) {
             if(theSrcFormat != StFormat_AUTO) {
-                aRawFile.setupJps(theSrcFormat);
+                theBuffer.setupJps(theSrcFormat);
             }
         } else {
             ST_ERROR_LOG("AVCodec library, created JPEG can not be parsed!");
         }
     }
 
-    // store current content
-    aRawFile.writeFile();
-    // and finally close the file handle
-    aRawFile.closeFile();
-
     close();
-
-    // set debug information
-    StString aDummy, aFileName;
-    StFileNode::getFolderAndFile(theFilePath, aDummy, aFileName);
-    setState(StString("AVCodec library, saved image '") + aFileName + "' " + getDescription());
-
     return true;
 }
@@ -1,5 +1,5 @@
 /**
- * Copyright © 2009-2013 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2009-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -43,6 +43,7 @@ void StAVPacket::avInitPacket() {
 StAVPacket::StAVPacket()
 : myStParams(),
   myDurationSec(0.0),
+  myDataCapacity(0),
   myType(DATA_PACKET),
   myIsOwn(false) {
     avInitPacket();
@@ -52,6 +53,7 @@ StAVPacket::StAVPacket(const StHandle<StStereoParams>& theStParams,
                        const int theType)
 : myStParams(theStParams),
   myDurationSec(0.0),
+  myDataCapacity(0),
   myType(theType),
   myIsOwn(false) {
     avInitPacket();
@@ -60,6 +62,8 @@ StAVPacket::StAVPacket(const StHandle<StStereoParams>& theStParams,
 StAVPacket::StAVPacket(const StAVPacket& theCopy)
 : myStParams(theCopy.myStParams),
   myDurationSec(theCopy.myDurationSec),
+  myStamps(theCopy.myStamps),
+  myDataCapacity(0),
   myType(theCopy.myType),
   myIsOwn(false) {
     avInitPacket();
@@ -90,16 +94,90 @@ void StAVPacket::free() {
         avInitPacket();
     #endif
     }
-    myIsOwn = false;
+    myIsOwn        = false;
+    myDataCapacity = 0;
 }
 
-void StAVPacket::setAVpkt(const AVPacket& theCopy) {
-    // free old data
+void StAVPacket::recycle() {
+    myStParams.nullify();
+    myDurationSec = 0.0;
+    myType        = DATA_PACKET;
+    if(!myIsOwn) {
+        free();
+    }
+}
+
+void StAVPacket::copyFrom(const StAVPacket& theCopy) {
+    if(this == &theCopy) {
+        return;
+    }
+
+    myStParams    = theCopy.myStParams;
+    myDurationSec = theCopy.myDurationSec;
+    myStamps      = theCopy.myStamps;
+    myType        = theCopy.myType;
+    if(myType == DATA_PACKET) {
+        setAVpkt(theCopy.myPacket);
+    } else {
+        free();
+    }
+}
+
+void StAVPacket::moveFrom(StAVPacket& theOther) {
+    if(this == &theOther) {
+        return;
+    }
+
+    myStParams    = theOther.myStParams;
+    myDurationSec = theOther.myDurationSec;
+    myStamps      = theOther.myStamps;
+    myType        = theOther.myType;
+#if(LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(55, 0, 0))
+    const bool isOwned = theOther.myIsOwn || theOther.myPacket.buf != NULL;
+#else
+    const bool isOwned = theOther.myIsOwn || theOther.myPacket.destruct != NULL;
+#endif
+    if(!isOwned) {
+        // data belongs to demuxer and might be overridden by next read
+        if(myType == DATA_PACKET) {
+            setAVpkt(theOther.myPacket);
+        } else {
+            free();
+        }
+        theOther.free();
+        return;
+    }
+
     free();
+    myPacket       = theOther.myPacket;
+    myIsOwn        = theOther.myIsOwn;
+    myDataCapacity = theOther.myDataCapacity;
+    theOther.avInitPacket();
+    theOther.myIsOwn        = false;
+    theOther.myDataCapacity = 0;
+}
+
+void StAVPacket::setAVpkt(const AVPacket& theCopy) {
     if(theCopy.data == NULL) {
+        free();
         return;
     }
 
+    // keep own data buffer if it is large enough
+    const size_t aDataSize = size_t(theCopy.size) + FF_INPUT_BUFFER_PADDING_SIZE;
+    uint8_t*     aDataBuf  = NULL;
+    size_t       aDataCap  = 0;
+    if(myIsOwn
+    && myPacket.data != NULL
+    && myDataCapacity >= aDataSize) {
+        aDataBuf = myPacket.data;
+        aDataCap = myDataCapacity;
+        myPacket.data = NULL;
+    }
+
+    // free old data
+    free();
+
     // copy values
     myIsOwn  = true;
     myPacket = theCopy;
@@ -108,7 +186,12 @@ void StAVPacket::setAVpkt(const AVPacket& theCopy) {
 #endif
 
     // now copy data with special padding space
-    myPacket.data = stMemAllocAligned<uint8_t*>((theCopy.size + FF_INPUT_BUFFER_PADDING_SIZE), 16); // data must be aligned to 16 bytes for SSE!
+    if(aDataBuf == NULL) {
+        aDataBuf = stMemAllocAligned<uint8_t*>(aDataSize, 16); // data must be aligned to 16 bytes for SSE!
+        aDataCap = aDataSize;
+    }
+    myPacket.data  = aDataBuf;
+    myDataCapacity = aDataCap;
     stMemCpy (myPacket.data, theCopy.data, theCopy.size);
     stMemZero(myPacket.data + (ptrdiff_t )theCopy.size, FF_INPUT_BUFFER_PADDING_SIZE);
 
@@ -0,0 +1,370 @@
+/**
+ * Copyright © 2017 Kirill Gavrilov <kirill@sview.ru>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file license-boost.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#include <StAV/StAVScaler.h>
+
+#include <StThreads/StCondition.h>
+#include <StThreads/StThread.h>
+#include <StStrings/StLogger.h>
+
+#include <cstdlib>
+
+extern "C" {
+#if(LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(50, 8, 0))
+    #include <libavutil/pixdesc.h>
+#endif
+};
+
+/**
+ * Horizontal band of the frame converted by dedicated thread.
+ */
+class StAVScalerSlice {
+
+        public:
+
+    SwsContext*        Context;         //!< swscale context for this band
+    int                FromRow;         //!< first row of the band
+    int                NbRows;          //!< number of rows in the band
+    int                RowsAbove;       //!< number of overlapping rows converted above the band
+    int                RowsBelow;       //!< number of overlapping rows converted below the band
+    const uint8_t*     SrcData[4];      //!< source planes shifted to the band (including overlapping rows)
+    int                SrcLineSize[4];  //!< source line sizes
+    uint8_t*           DstData[4];      //!< destination planes shifted to the band
+    int                DstLineSize[4];  //!< destination line sizes
+    int                DstShifts[4];    //!< vertical subsampling of destination planes
+    uint8_t*           TmpData[4];      //!< temporary planes for the band with overlapping rows
+    int                TmpLineSize[4];  //!< temporary planes line sizes
+    uint8_t*           TmpBuffer;       //!< buffer for temporary planes
+    size_t             TmpBufferSize;   //!< size of temporary buffer
+    StHandle<StThread> Thread;          //!< worker thread (NULL for the band converted by caller thread)
+    StCondition        EventStart;      //!< event to start conversion
+    StCondition        EventDone;       //!< event indicating finished conversion
+    volatile bool      ToQuit;          //!< flag to stop the thread
+
+        public:
+
+    StAVScalerSlice()
+    : Context(NULL),
+      FromRow(0),
+      NbRows(0),
+      RowsAbove(0),
+      RowsBelow(0),
+      TmpBuffer(NULL),
+      TmpBufferSize(0),
+      EventStart(false),
+      EventDone(true),
+      ToQuit(false) {
+        for(int aPlaneIter = 0; aPlaneIter < 4; ++aPlaneIter) {
+            SrcData    [aPlaneIter] = NULL;
+            SrcLineSize[aPlaneIter] = 0;
+            DstData    [aPlaneIter] = NULL;
+            DstLineSize[aPlaneIter] = 0;
+            DstShifts  [aPlaneIter] = 0;
+            TmpData    [aPlaneIter] = NULL;
+            TmpLineSize[aPlaneIter] = 0;
+        }
+    }
+
+    ~StAVScalerSlice() {
+        if(!Thread.isNull()) {
+            ToQuit = true;
+            EventStart.set();
+            Thread->wait();
+            Thread.nullify();
+        }
+        if(Context != NULL) {
+            sws_freeContext(Context);
+        }
+        stMemFreeAligned(TmpBuffer);
+    }
+
+    /**
+     * @return true if band is converted with overlapping rows
+     */
+    bool hasOverlap() const {
+        return RowsAbove != 0
+            || RowsBelow != 0;
+    }
+
+    /**
+     * Setup temporary planes for the band with overlapping rows.
+     */
+    void initTmpPlanes() {
+        const int aNbRowsExt = RowsAbove + NbRows + RowsBelow;
+        size_t aSize = 0;
+        for(int aPlaneIter = 0; aPlaneIter < 4; ++aPlaneIter) {
+            TmpLineSize[aPlaneIter] = std::abs(DstLineSize[aPlaneIter]);
+            if(DstData[aPlaneIter] != NULL) {
+                aSize += size_t(TmpLineSize[aPlaneIter]) * size_t(((aNbRowsExt - 1) >> DstShifts[aPlaneIter]) + 1);
+            }
+        }
+        if(aSize > TmpBufferSize) {
+            stMemFreeAligned(TmpBuffer);
+            TmpBuffer     = stMemAllocAligned<uint8_t*>(aSize, 32);
+            TmpBufferSize = TmpBuffer != NULL ? aSize : 0;
+        }
+
+        size_t anOffset = 0;
+        for(int aPlaneIter = 0; aPlaneIter < 4; ++aPlaneIter) {
+            TmpData[aPlaneIter] = NULL;
+            if(DstData[aPlaneIter] != NULL
+            && TmpBuffer != NULL) {
+                TmpData[aPlaneIter] = TmpBuffer + anOffset;
+                anOffset += size_t(TmpLineSize[aPlaneIter]) * size_t(((aNbRowsExt - 1) >> DstShifts[aPlaneIter]) + 1);
+            }
+        }
+    }
+
+    void convert() {
+        if(!hasOverlap()) {
+            sws_scale(Context,
+                      SrcData, SrcLineSize,
+                      0, NbRows,
+                      DstData, DstLineSize);
+            return;
+        } else if(TmpBuffer == NULL) {
+            return;
+        }
+
+        // convert the band together with overlapping rows, so that vertical chroma interpolation
+        // does not clamp at band edges, and then crop overlapping rows
+        sws_scale(Context,
+                  SrcData, SrcLineSize,
+                  0, RowsAbove + NbRows + RowsBelow,
+                  TmpData, TmpLineSize);
+        for(int aPlaneIter = 0; aPlaneIter < 4; ++aPlaneIter) {
+            if(DstData[aPlaneIter] == NULL) {
+                continue;
+            }
+
+            const int    aShift    = DstShifts[aPlaneIter];
+            const int    aRowFrom  = FromRow >> aShift;
+            const int    aRowTo    = ((FromRow + NbRows - 1) >> aShift) + 1;
+            const uint8_t* aTmpRow = TmpData[aPlaneIter] + ptrdiff_t(RowsAbove >> aShift) * TmpLineSize[aPlaneIter];
+            uint8_t*       aDstRow = DstData[aPlaneIter];
+            for(int aRowIter = aRowFrom; aRowIter < aRowTo; ++aRowIter) {
+                stMemCpy(aDstRow, aTmpRow, TmpLineSize[aPlaneIter]);
+                aTmpRow += TmpLineSize[aPlaneIter];
+                aDstRow += DstLineSize[aPlaneIter];
+            }
+        }
+    }
+
+    void threadLoop() {
+        for(;;) {
+            EventStart.wait();
+            EventStart.reset();
+            if(ToQuit) {
+                return;
+            }
+
+            convert();
+            EventDone.set();
+        }
+    }
+
+    static SV_THREAD_FUNCTION threadFunction(void* theSlice) {
+        ((StAVScalerSlice* )theSlice)->threadLoop();
+        return SV_THREAD_RETURN 0;
+    }
+
+};
+
+namespace {
+
+    /**
+     * Band height should be divisible by chroma subsampling.
+     */
+    static const int THE_SLICE_ALIGN    = 16;
+
+    /**
+     * Minimal band height to make threading worth it.
+     */
+    static const int THE_SLICE_MIN_ROWS = 64;
+
+    /**
+     * Number of overlapping rows converted above and below the band
+     * for formats with vertically subsampled planes.
+     * Should be divisible by chroma subsampling and cover bicubic filter support of chroma planes.
+     */
+    static const int THE_SLICE_OVERLAP  = 16;
+
+    /**
+     * Fill in vertical subsampling of each plane.
+     * @return false if frame can not be split into bands (e.g. paletted format)
+     */
+    static bool planeShifts(const AVPixelFormat theFormat,
+                            int                 theShifts[4]) {
+        for(int aPlaneIter = 0; aPlaneIter < 4; ++aPlaneIter) {
+            theShifts[aPlaneIter] = 0;
+        }
+    #if(LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(52, 0, 0)) && defined(AV_PIX_FMT_FLAG_PAL)
+        const AVPixFmtDescriptor* aDesc = av_pix_fmt_desc_get(theFormat);
+        if(aDesc == NULL
+        || (aDesc->flags & (AV_PIX_FMT_FLAG_PAL | AV_PIX_FMT_FLAG_HWACCEL | AV_PIX_FMT_FLAG_BITSTREAM)) != 0) {
+            return false;
+        }
+    #ifdef AV_PIX_FMT_FLAG_PSEUDOPAL
+        if((aDesc->flags & AV_PIX_FMT_FLAG_PSEUDOPAL) != 0) {
+            return false;
+        }
+    #endif
+        if((aDesc->flags & AV_PIX_FMT_FLAG_RGB) == 0) {
+            for(int aCompIter = 1; aCompIter < 3 && aCompIter < aDesc->nb_components; ++aCompIter) {
+                theShifts[aDesc->comp[aCompIter].plane] = aDesc->log2_chroma_h;
+            }
+        }
+        return true;
+    #else
+        (void )theFormat;
+        return false;
+    #endif
+    }
+
+}
+
+StAVScaler::StAVScaler()
+: mySrcFormat(stAV::PIX_FMT::NONE),
+  myDstFormat(stAV::PIX_FMT::NONE),
+  mySizeX(0),
+  mySizeY(0),
+  myNbThreads(0) {
+    for(int aPlaneIter = 0; aPlaneIter < 4; ++aPlaneIter) {
+        mySrcShifts[aPlaneIter] = 0;
+        myDstShifts[aPlaneIter] = 0;
+    }
+}
+
+StAVScaler::~StAVScaler() {
+    release();
+}
+
+void StAVScaler::release() {
+    mySlices.clear();
+    mySrcFormat = stAV::PIX_FMT::NONE;
+    myDstFormat = stAV::PIX_FMT::NONE;
+    mySizeX     = 0;
+    mySizeY     = 0;
+    myNbThreads = 0;
+}
+
+bool StAVScaler::init(const AVPixelFormat theSrcFormat,
+                      const AVPixelFormat theDstFormat,
+                      const int           theSizeX,
+                      const int           theSizeY,
+                      const int           theNbThreads) {
+    if(isValid()
+    && mySrcFormat == theSrcFormat
+    && myDstFormat == theDstFormat
+    && mySizeX     == theSizeX
+    && mySizeY     == theSizeY
+    && myNbThreads == theNbThreads) {
+        return true;
+    }
+
+    release();
+    if(theSizeX <= 0
+    || theSizeY <= 0) {
+        return false;
+    }
+
+    int aNbSlices = theNbThreads > 0 ? theNbThreads : StThread::countLogicalProcessors();
+    aNbSlices = stMin(aNbSlices, theSizeY / THE_SLICE_MIN_ROWS);
+    if(!planeShifts(theSrcFormat, mySrcShifts)
+    || !planeShifts(theDstFormat, myDstShifts)) {
+        aNbSlices = 1;
+    }
+    aNbSlices = stMax(aNbSlices, 1);
+
+    int aSliceRows = theSizeY;
+    int anOverlap  = 0;
+    if(aNbSlices > 1) {
+        aSliceRows = theSizeY / aNbSlices;
+        aSliceRows = ((aSliceRows + THE_SLICE_ALIGN - 1) / THE_SLICE_ALIGN) * THE_SLICE_ALIGN;
+
+        // each band context treats band edges as frame edges, so that vertical chroma interpolation
+        // would clamp at band edges and produce visible seams - convert a few overlapping rows around the band
+        for(int aPlaneIter = 0; aPlaneIter < 4; ++aPlaneIter) {
+            if(mySrcShifts[aPlaneIter] != 0
+            || myDstShifts[aPlaneIter] != 0) {
+                anOverlap = THE_SLICE_OVERLAP;
+                break;
+            }
+        }
+    }
+
+    for(int aFromRow = 0; aFromRow < theSizeY; aFromRow += aSliceRows) {
+        StHandle<StAVScalerSlice> aSlice = new StAVScalerSlice();
+        aSlice->FromRow   = aFromRow;
+        aSlice->NbRows    = stMin(aSliceRows, theSizeY - aFromRow);
+        aSlice->RowsAbove = stMin(anOverlap, aFromRow);
+        aSlice->RowsBelow = stMin(anOverlap, theSizeY - aFromRow - aSlice->NbRows);
+        for(int aPlaneIter = 0; aPlaneIter < 4; ++aPlaneIter) {
+            aSlice->DstShifts[aPlaneIter] = myDstShifts[aPlaneIter];
+        }
+        const int aNbRowsExt = aSlice->RowsAbove + aSlice->NbRows + aSlice->RowsBelow;
+        aSlice->Context = sws_getContext(theSizeX, aNbRowsExt, theSrcFormat, // source
+                                         theSizeX, aNbRowsExt, theDstFormat, // destination
+                                         SWS_BICUBIC, NULL, NULL, NULL);
+        if(aSlice->Context == NULL) {
+            release();
+            return false;
+        }
+
+        // the first band is converted by caller thread
+        if(!mySlices.empty()) {
+            aSlice->Thread = new StThread(StAVScalerSlice::threadFunction, (void* )aSlice.access(), "StAVScaler");
+        }
+        mySlices.push_back(aSlice);
+    }
+
+    mySrcFormat = theSrcFormat;
+    myDstFormat = theDstFormat;
+    mySizeX     = theSizeX;
+    mySizeY     = theSizeY;
+    myNbThreads = theNbThreads;
+    if(mySlices.size() > 1) {
+        ST_DEBUG_LOG("StAVScaler, conversion is split into " + mySlices.size() + " bands of " + aSliceRows + " rows");
+    }
+    return true;
+}
+
+void StAVScaler::convert(const uint8_t* const theSrcData[],
+                         const int            theSrcLineSize[],
+                         uint8_t* const       theDstData[],
+                         const int            theDstLineSize[]) {
+    for(size_t aSliceIter = 0; aSliceIter < mySlices.size(); ++aSliceIter) {
+        StAVScalerSlice* aSlice = mySlices[aSliceIter].access();
+        for(int aPlaneIter = 0; aPlaneIter < 4; ++aPlaneIter) {
+            aSlice->SrcLineSize[aPlaneIter] = theSrcLineSize[aPlaneIter];
+            aSlice->DstLineSize[aPlaneIter] = theDstLineSize[aPlaneIter];
+            aSlice->SrcData[aPlaneIter] = theSrcData[aPlaneIter] != NULL
+                                        ? theSrcData[aPlaneIter] + ptrdiff_t((aSlice->FromRow - aSlice->RowsAbove) >> mySrcShifts[aPlaneIter]) * theSrcLineSize[aPlaneIter]
+                                        : NULL;
+            aSlice->DstData[aPlaneIter] = theDstData[aPlaneIter] != NULL
+                                        ? theDstData[aPlaneIter] + ptrdiff_t(aSlice->FromRow >> myDstShifts[aPlaneIter]) * theDstLineSize[aPlaneIter]
+                                        : NULL;
+        }
+        if(aSlice->hasOverlap()) {
+            aSlice->initTmpPlanes();
+        }
+        if(!aSlice->Thread.isNull()) {
+            aSlice->EventDone.reset();
+            aSlice->EventStart.set();
+        }
+    }
+
+    if(mySlices.empty()) {
+        return;
+    }
+
+    mySlices.front()->convert();
+    for(size_t aSliceIter = 1; aSliceIter < mySlices.size(); ++aSliceIter) {
+        mySlices[aSliceIter]->EventDone.wait();
+    }
+}
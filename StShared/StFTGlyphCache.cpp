@@ -0,0 +1,365 @@
+/**
+ * Copyright © 2017 Kirill Gavrilov <kirill@sview.ru>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file license-boost.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#include <StFT/StFTGlyphCache.h>
+
+#include <StFile/StFileNode.h>
+#include <StFile/StRawFile.h>
+#include <StStrings/StLogger.h>
+#include <StThreads/StTimer.h>
+
+#include <vector>
+
+namespace {
+
+    static const char     THE_CACHE_MAGIC[4] = { 'S', 'V', 'G', 'C' };
+    static const uint32_t THE_CACHE_VERSION  = 1;
+
+    /**
+     * Symbol ranges rasterized in advance.
+     */
+    struct StGlyphRange {
+        stUtf32_t First;
+        stUtf32_t Last;
+    };
+
+    static const StGlyphRange THE_WESTERN_RANGES[] = {
+        { 0x0020, 0x007E }, // Basic Latin
+        { 0x00A0, 0x00FF }, // Latin-1 Supplement
+        { 0x0400, 0x045F }, // Cyrillic
+        { 0x2010, 0x2026 }, // General Punctuation (dashes, quotes, ellipsis)
+    };
+
+    static const StGlyphRange THE_CJK_RANGES[] = {
+        { 0x3000, 0x303F }, // CJK Symbols and Punctuation
+        { 0x3040, 0x30FF }, // Hiragana and Katakana
+        { 0xFF01, 0xFF5E }, // Fullwidth ASCII variants
+    };
+
+    static const StGlyphRange THE_KOREAN_RANGES[] = {
+        { 0x3131, 0x318E }, // Hangul Compatibility Jamo
+    };
+
+    /**
+     * Header of persisted cache.
+     */
+    struct StGlyphCacheHeader {
+        char     Magic[4];
+        uint32_t Version;
+        uint64_t FontHash;
+        uint32_t PointSize;
+        uint32_t Resolution;
+        uint64_t NbGlyphs;
+    };
+
+    /**
+     * Glyph record of persisted cache, followed by SizeX * SizeY bytes of bitmap.
+     */
+    struct StGlyphCacheEntry {
+        uint32_t UChar;
+        uint32_t Style;
+        uint32_t SizeX;
+        uint32_t SizeY;
+        uint32_t IsTopDown;
+        float    Left;
+        float    Top;
+        float    Right;
+        float    Bottom;
+        uint32_t Reserved;
+    };
+
+    /**
+     * FNV-1a hash of the string.
+     */
+    static uint64_t hashString(const StString& theString,
+                               uint64_t        theHash = 14695981039346656037ULL) {
+        const char* aStr = theString.toCString();
+        for(size_t anIter = 0; anIter < theString.getSize(); ++anIter) {
+            theHash ^= uint64_t((unsigned char )aStr[anIter]);
+            theHash *= 1099511628211ULL;
+        }
+        return theHash;
+    }
+
+}
+
+StFTGlyphCache::StFTGlyphCache(const StHandle<StFTFont>& theFont,
+                               const unsigned int        thePointSize,
+                               const unsigned int        theResolution,
+                               const StString&           theCacheFolder)
+: myFontHash(14695981039346656037ULL),
+  myPointSize(thePointSize),
+  myResolution(theResolution),
+  myHasCJK(false),
+  myHasKorean(false),
+  myIsModified(false),
+  myToQuit(false) {
+    if(theFont.isNull()) {
+        return;
+    }
+
+    myHasCJK    = theFont->hasCJK();
+    myHasKorean = theFont->hasKorean();
+    for(size_t aStyleIt = 0; aStyleIt < StFTFont::StylesNB; ++aStyleIt) {
+        myFontPaths[aStyleIt] = theFont->getFilePath((StFTFont::Style )aStyleIt);
+        myFontHash = hashString(myFontPaths[aStyleIt] + "\n", myFontHash);
+    }
+    // number of glyphs is used as cheap check that the font file has not been replaced
+    myFontHash = hashString(theFont->getFamilyName() + "\n" + theFont->getGlyphsNumber(), myFontHash);
+    if(theCacheFolder.isEmpty()) {
+        return;
+    }
+
+    char aBuffer[64];
+    stsprintf(aBuffer, 64, "%08x%08x_%u_%u.glyphs",
+              (unsigned int )(myFontHash >> 32), (unsigned int )(myFontHash & 0xFFFFFFFF),
+              myPointSize, myResolution);
+    myCachePath = theCacheFolder + aBuffer;
+    load();
+}
+
+StFTGlyphCache::~StFTGlyphCache() {
+    if(!myThread.isNull()) {
+        myToQuit = true;
+        myThread->wait();
+        myThread.nullify();
+    }
+    save();
+}
+
+size_t StFTGlyphCache::getNbGlyphs() const {
+    StMutexAuto aLock(myMutex);
+    size_t aNbGlyphs = 0;
+    for(size_t aStyleIt = 0; aStyleIt < StFTFont::StylesNB; ++aStyleIt) {
+        aNbGlyphs += myGlyphs[aStyleIt].size();
+    }
+    return aNbGlyphs;
+}
+
+bool StFTGlyphCache::find(const StFTFont::Style theStyle,
+                          const stUtf32_t       theUChar,
+                          StImagePlane&         theImage,
+                          StRect<float>&        theRect) const {
+    if(theStyle < StFTFont::Style_Regular
+    || theStyle >= StFTFont::StylesNB) {
+        return false;
+    }
+
+    StMutexAuto aLock(myMutex);
+    std::map<stUtf32_t, Glyph>::const_iterator aGlyphIter = myGlyphs[theStyle].find(theUChar);
+    if(aGlyphIter == myGlyphs[theStyle].end()) {
+        return false;
+    }
+
+    // glyphs are never removed from the map, so that wrapped data remains valid
+    theRect = aGlyphIter->second.Rect;
+    return theImage.initWrapper(*aGlyphIter->second.Image);
+}
+
+void StFTGlyphCache::add(const StFTFont::Style theStyle,
+                         const stUtf32_t       theUChar,
+                         const StImagePlane&   theImage,
+                         const StRect<float>&  theRect) {
+    if(theStyle < StFTFont::Style_Regular
+    || theStyle >= StFTFont::StylesNB
+    || theImage.isNull()
+    || theImage.getFormat() != StImagePlane::ImgGray) {
+        return;
+    }
+
+    StHandle<StImagePlane> aCopy = new StImagePlane();
+    if(!aCopy->initCopy(theImage, true)) {
+        return;
+    }
+    aCopy->setTopDown(theImage.isTopDown());
+
+    StMutexAuto aLock(myMutex);
+    Glyph& aGlyph = myGlyphs[theStyle][theUChar];
+    if(!aGlyph.Image.isNull()) {
+        return;
+    }
+    aGlyph.Image = aCopy;
+    aGlyph.Rect  = theRect;
+    myIsModified = true;
+}
+
+void StFTGlyphCache::prewarm() {
+    if(!myThread.isNull()
+    || !StFileNode::isFileExists(myFontPaths[StFTFont::Style_Regular])) {
+        return;
+    }
+
+    myToQuit = false;
+    myThread = new StThread(prewarmThread, (void* )this, "StFTGlyphCache");
+}
+
+SV_THREAD_FUNCTION StFTGlyphCache::prewarmThread(void* theCache) {
+    ((StFTGlyphCache* )theCache)->prewarmLoop();
+    return SV_THREAD_RETURN 0;
+}
+
+void StFTGlyphCache::prewarmLoop() {
+    // FreeType objects are not thread-safe - use dedicated library instance
+    StHandle<StFTLibrary> aLib  = new StFTLibrary();
+    StHandle<StFTFont>    aFont = new StFTFont(aLib);
+    for(size_t aStyleIt = 0; aStyleIt < StFTFont::StylesNB; ++aStyleIt) {
+        if(!myFontPaths[aStyleIt].isEmpty()) {
+            aFont->load(myFontPaths[aStyleIt], (StFTFont::Style )aStyleIt);
+        }
+    }
+    if(!aFont->init(myPointSize, myResolution)) {
+        return;
+    }
+
+    std::vector<StGlyphRange> aRanges(THE_WESTERN_RANGES, THE_WESTERN_RANGES + sizeof(THE_WESTERN_RANGES) / sizeof(StGlyphRange));
+    if(myHasCJK) {
+        aRanges.insert(aRanges.end(), THE_CJK_RANGES, THE_CJK_RANGES + sizeof(THE_CJK_RANGES) / sizeof(StGlyphRange));
+    }
+    if(myHasKorean) {
+        aRanges.insert(aRanges.end(), THE_KOREAN_RANGES, THE_KOREAN_RANGES + sizeof(THE_KOREAN_RANGES) / sizeof(StGlyphRange));
+    }
+
+    StTimer aTimer(true);
+    size_t aNbRendered = 0;
+    StImagePlane  anImage;
+    StRect<float> aRect;
+    for(size_t aStyleIt = 0; aStyleIt < StFTFont::StylesNB && !myToQuit; ++aStyleIt) {
+        const StFTFont::Style aStyle = (StFTFont::Style )aStyleIt;
+        if(myFontPaths[aStyleIt].isEmpty()
+        || !aFont->setActiveStyle(aStyle)) {
+            continue;
+        }
+
+        for(size_t aRangeIter = 0; aRangeIter < aRanges.size() && !myToQuit; ++aRangeIter) {
+            for(stUtf32_t aUChar = aRanges[aRangeIter].First; aUChar <= aRanges[aRangeIter].Last && !myToQuit; ++aUChar) {
+                if(find(aStyle, aUChar, anImage, aRect)
+                || !aFont->renderGlyph(aUChar)) {
+                    continue;
+                }
+
+                aFont->getGlyphRect(aRect);
+                add(aStyle, aUChar, aFont->getGlyphImage(), aRect);
+                ++aNbRendered;
+            }
+        }
+    }
+    ST_DEBUG_LOG(StString("StFTGlyphCache, ") + aNbRendered + " glyphs of '" + aFont->getFamilyName()
+               + "' pre-warmed within " + aTimer.getElapsedTimeInSec() + " seconds");
+}
+
+bool StFTGlyphCache::load() {
+    StRawFile aFile(myCachePath);
+    if(!aFile.readFile()
+    ||  aFile.getSize() < sizeof(StGlyphCacheHeader)) {
+        return false;
+    }
+
+    const StGlyphCacheHeader* aHeader = (const StGlyphCacheHeader* )aFile.getBuffer();
+    if(!stAreEqual(aHeader->Magic, THE_CACHE_MAGIC, sizeof(THE_CACHE_MAGIC))
+    || aHeader->Version    != THE_CACHE_VERSION
+    || aHeader->FontHash   != myFontHash
+    || aHeader->PointSize  != myPointSize
+    || aHeader->Resolution != myResolution) {
+        ST_DEBUG_LOG(StString("StFTGlyphCache, outdated cache '") + aFile.getPath() + "' is ignored");
+        return false;
+    }
+
+    StMutexAuto aLock(myMutex);
+    const size_t aFileSize = aFile.getSize();
+    size_t anOffset = sizeof(StGlyphCacheHeader);
+    for(uint64_t aGlyphIter = 0; aGlyphIter < aHeader->NbGlyphs; ++aGlyphIter) {
+        if(anOffset + sizeof(StGlyphCacheEntry) > aFileSize) {
+            break;
+        }
+
+        const StGlyphCacheEntry* anEntry = (const StGlyphCacheEntry* )(aFile.getBuffer() + anOffset);
+        const size_t aDataSize = size_t(anEntry->SizeX) * size_t(anEntry->SizeY);
+        anOffset += sizeof(StGlyphCacheEntry);
+        if(anOffset + aDataSize > aFileSize) {
+            break;
+        }
+
+        StHandle<StImagePlane> anImage = new StImagePlane();
+        if(anEntry->Style >= StFTFont::StylesNB
+        || !anImage->initTrash(StImagePlane::ImgGray, anEntry->SizeX, anEntry->SizeY)) {
+            anOffset += aDataSize;
+            continue;
+        }
+        stMemCpy(anImage->changeData(), aFile.getBuffer() + anOffset, aDataSize);
+        anImage->setTopDown(anEntry->IsTopDown != 0);
+        anOffset += aDataSize;
+
+        Glyph& aGlyph = myGlyphs[anEntry->Style][anEntry->UChar];
+        aGlyph.Image = anImage;
+        aGlyph.Rect.left()   = anEntry->Left;
+        aGlyph.Rect.top()    = anEntry->Top;
+        aGlyph.Rect.right()  = anEntry->Right;
+        aGlyph.Rect.bottom() = anEntry->Bottom;
+    }
+    myIsModified = false;
+    return true;
+}
+
+bool StFTGlyphCache::save() {
+    StMutexAuto aLock(myMutex);
+    if(!myIsModified
+    || myCachePath.isEmpty()) {
+        return false;
+    }
+
+    size_t aNbGlyphs = 0;
+    size_t aSize     = sizeof(StGlyphCacheHeader);
+    for(size_t aStyleIt = 0; aStyleIt < StFTFont::StylesNB; ++aStyleIt) {
+        for(std::map<stUtf32_t, Glyph>::const_iterator aGlyphIter = myGlyphs[aStyleIt].begin();
+            aGlyphIter != myGlyphs[aStyleIt].end(); ++aGlyphIter) {
+            aSize += sizeof(StGlyphCacheEntry) + aGlyphIter->second.Image->getSizeX() * aGlyphIter->second.Image->getSizeY();
+            ++aNbGlyphs;
+        }
+    }
+
+    StRawFile aFile(myCachePath);
+    aFile.initBuffer(aSize);
+    StGlyphCacheHeader* aHeader = (StGlyphCacheHeader* )aFile.changeBuffer();
+    stMemZero(aHeader, sizeof(StGlyphCacheHeader));
+    stMemCpy(aHeader->Magic, THE_CACHE_MAGIC, sizeof(THE_CACHE_MAGIC));
+    aHeader->Version    = THE_CACHE_VERSION;
+    aHeader->FontHash   = myFontHash;
+    aHeader->PointSize  = myPointSize;
+    aHeader->Resolution = myResolution;
+    aHeader->NbGlyphs   = aNbGlyphs;
+
+    size_t anOffset = sizeof(StGlyphCacheHeader);
+    for(size_t aStyleIt = 0; aStyleIt < StFTFont::StylesNB; ++aStyleIt) {
+        for(std::map<stUtf32_t, Glyph>::const_iterator aGlyphIter = myGlyphs[aStyleIt].begin();
+            aGlyphIter != myGlyphs[aStyleIt].end(); ++aGlyphIter) {
+            const StImagePlane& anImage = *aGlyphIter->second.Image;
+            StGlyphCacheEntry* anEntry = (StGlyphCacheEntry* )(aFile.changeBuffer() + anOffset);
+            stMemZero(anEntry, sizeof(StGlyphCacheEntry));
+            anEntry->UChar     = aGlyphIter->first;
+            anEntry->Style     = uint32_t(aStyleIt);
+            anEntry->SizeX     = uint32_t(anImage.getSizeX());
+            anEntry->SizeY     = uint32_t(anImage.getSizeY());
+            anEntry->IsTopDown = anImage.isTopDown() ? 1 : 0;
+            anEntry->Left      = aGlyphIter->second.Rect.left();
+            anEntry->Top       = aGlyphIter->second.Rect.top();
+            anEntry->Right     = aGlyphIter->second.Rect.right();
+            anEntry->Bottom    = aGlyphIter->second.Rect.bottom();
+            anOffset += sizeof(StGlyphCacheEntry);
+
+            // images are stored compact (initCopy() with theIsCompact flag)
+            const size_t aDataSize = anImage.getSizeX() * anImage.getSizeY();
+            stMemCpy(aFile.changeBuffer() + anOffset, anImage.getData(), aDataSize);
+            anOffset += aDataSize;
+        }
+    }
+    if(!aFile.saveFile()) {
+        return false;
+    }
+    myIsModified = false;
+    return true;
+}
@@ -0,0 +1,211 @@
+/**
+ * Copyright © 2017 Kirill Gavrilov <kirill@sview.ru>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file license-boost.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#include <StGL/StGLAsyncReadback.h>
+
+#include <StGLCore/StGLCore20.h>
+#include <StGL/StGLContext.h>
+
+#include <StStrings/StLogger.h>
+#include <stAssert.h>
+
+#if !defined(GL_ES_VERSION_2_0)
+namespace {
+
+    /**
+     * @return pixel size in bytes for specified format and data type, 0 if unknown
+     */
+    static size_t getPixelSize(const GLenum theFormat,
+                               const GLenum theType) {
+        size_t aNbComps = 0;
+        switch(theFormat) {
+            case GL_ALPHA:
+            case GL_RED:
+            case GL_DEPTH_COMPONENT: aNbComps = 1; break;
+            case GL_RG:              aNbComps = 2; break;
+            case GL_RGB:
+            case GL_BGR:             aNbComps = 3; break;
+            case GL_RGBA:
+            case GL_BGRA:            aNbComps = 4; break;
+            default: return 0;
+        }
+
+        switch(theType) {
+            case GL_UNSIGNED_BYTE:  return aNbComps;
+            case GL_UNSIGNED_SHORT: return aNbComps * 2;
+            case GL_FLOAT:          return aNbComps * 4;
+            default:                return 0;
+        }
+    }
+
+}
+#endif
+
+bool StGLAsyncReadback::isSupported(const StGLContext& theCtx) {
+#if defined(GL_ES_VERSION_2_0)
+    (void )theCtx;
+    return false;
+#else
+    return theCtx.arbPbo;
+#endif
+}
+
+StGLAsyncReadback::StGLAsyncReadback(const size_t theNbBuffers)
+: mySlots(theNbBuffers > 0 ? theNbBuffers : 1),
+  myOldest(0),
+  myNbPending(0) {
+    for(size_t aSlotIter = 0; aSlotIter < mySlots.size(); ++aSlotIter) {
+        mySlots[aSlotIter].Buffer = new StGLPixelBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+}
+
+StGLAsyncReadback::~StGLAsyncReadback() {
+    for(size_t aSlotIter = 0; aSlotIter < mySlots.size(); ++aSlotIter) {
+        ST_ASSERT(!mySlots[aSlotIter].Buffer->isValid()
+               &&  mySlots[aSlotIter].Fence == NULL, "~StGLAsyncReadback() with unreleased GL resources");
+    }
+}
+
+void StGLAsyncReadback::releaseFence(StGLContext& theCtx,
+                                     Slot&        theSlot) {
+#if !defined(GL_ES_VERSION_2_0)
+    if(theSlot.Fence != NULL) {
+        theCtx.extAll->glDeleteSync((GLsync )theSlot.Fence);
+    }
+#else
+    (void )theCtx;
+#endif
+    theSlot.Fence = NULL;
+}
+
+void StGLAsyncReadback::release(StGLContext& theCtx) {
+    for(size_t aSlotIter = 0; aSlotIter < mySlots.size(); ++aSlotIter) {
+        Slot& aSlot = mySlots[aSlotIter];
+        releaseFence(theCtx, aSlot);
+        aSlot.Buffer->release(theCtx);
+        aSlot.SizeX    = 0;
+        aSlot.SizeY    = 0;
+        aSlot.RowBytes = 0;
+    }
+    myOldest    = 0;
+    myNbPending = 0;
+}
+
+void StGLAsyncReadback::discard(StGLContext& theCtx) {
+    while(myNbPending != 0) {
+        unmapOldest(theCtx);
+    }
+}
+
+bool StGLAsyncReadback::readPixels(StGLContext&  theCtx,
+                                   const GLint   theLeft,
+                                   const GLint   theBottom,
+                                   const GLsizei theSizeX,
+                                   const GLsizei theSizeY,
+                                   const GLenum  theFormat,
+                                   const GLenum  theType) {
+#if defined(GL_ES_VERSION_2_0)
+    (void )theCtx;
+    (void )theLeft;
+    (void )theBottom;
+    (void )theSizeX;
+    (void )theSizeY;
+    (void )theFormat;
+    (void )theType;
+    return false;
+#else
+    const size_t aPixelSize = getPixelSize(theFormat, theType);
+    if(!isSupported(theCtx)
+    || aPixelSize == 0
+    || theSizeX < 1
+    || theSizeY < 1) {
+        return false;
+    }
+
+    if(isFull()) {
+        // the consumer is too slow - drop the oldest frame
+        unmapOldest(theCtx);
+    }
+
+    // rows are aligned to 4 bytes with default GL_PACK_ALIGNMENT
+    const size_t aRowBytes  = ((size_t(theSizeX) * aPixelSize + 3) / 4) * 4;
+    const size_t aSizeBytes = aRowBytes * size_t(theSizeY);
+    Slot& aSlot = mySlots[(myOldest + myNbPending) % mySlots.size()];
+    if(aSlot.Buffer->getSizeBytes() != aSizeBytes
+    && !aSlot.Buffer->init(theCtx, aSizeBytes)) {
+        ST_DEBUG_LOG("StGLAsyncReadback, failed to allocate buffer of " + aSizeBytes + " bytes");
+        return false;
+    }
+
+    aSlot.Buffer->bind(theCtx);
+    theCtx.core20fwd->glReadPixels(theLeft, theBottom, theSizeX, theSizeY, theFormat, theType, NULL);
+    aSlot.Buffer->unbind(theCtx);
+
+    releaseFence(theCtx, aSlot);
+    if(theCtx.arbSync) {
+        aSlot.Fence = theCtx.extAll->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        // submit the fence, so that polling by isOldestReady() would not wait forever
+        theCtx.core20fwd->glFlush();
+    }
+    aSlot.SizeX    = theSizeX;
+    aSlot.SizeY    = theSizeY;
+    aSlot.RowBytes = aRowBytes;
+    ++myNbPending;
+    return true;
+#endif
+}
+
+bool StGLAsyncReadback::isOldestReady(StGLContext& theCtx) {
+    if(myNbPending == 0) {
+        return false;
+    }
+
+#if !defined(GL_ES_VERSION_2_0)
+    Slot& aSlot = mySlots[myOldest];
+    if(aSlot.Fence != NULL) {
+        const GLenum aRes = theCtx.extAll->glClientWaitSync((GLsync )aSlot.Fence, 0, 0);
+        return aRes == GL_ALREADY_SIGNALED
+            || aRes == GL_CONDITION_SATISFIED;
+    }
+#else
+    (void )theCtx;
+#endif
+    // no way to check - assume that previous frame is ready
+    return true;
+}
+
+const GLubyte* StGLAsyncReadback::mapOldest(StGLContext& theCtx) {
+    if(myNbPending == 0) {
+        return NULL;
+    }
+
+    Slot& aSlot = mySlots[myOldest];
+#if !defined(GL_ES_VERSION_2_0)
+    if(aSlot.Fence != NULL) {
+        // wait for the transfer completion, with 1 second as a safety limit
+        const GLenum aRes = theCtx.extAll->glClientWaitSync((GLsync )aSlot.Fence, GL_SYNC_FLUSH_COMMANDS_BIT, GLuint64(1000000000));
+        if(aRes == GL_WAIT_FAILED) {
+            ST_DEBUG_LOG("StGLAsyncReadback, fence wait has failed");
+        }
+        releaseFence(theCtx, aSlot);
+    }
+#endif
+    return aSlot.Buffer->map(theCtx);
+}
+
+void StGLAsyncReadback::unmapOldest(StGLContext& theCtx) {
+    if(myNbPending == 0) {
+        return;
+    }
+
+    Slot& aSlot = mySlots[myOldest];
+    aSlot.Buffer->unmap(theCtx);
+    releaseFence(theCtx, aSlot);
+    myOldest = (myOldest + 1) % mySlots.size();
+    --myNbPending;
+}
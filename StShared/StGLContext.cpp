@@ -1,5 +1,5 @@
 /**
- * Copyright © 2012-2016 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2012-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -52,6 +52,8 @@ StGLContext::StGLContext(const StHandle<StResourceManager>& theResMgr)
   arbNPTW(false),
   arbTexRG(false),
   arbTexClear(false),
+  arbPbo(false),
+  arbSync(false),
 #if defined(GL_ES_VERSION_2_0)
   hasUnpack(false),
   hasHighp(false),
@@ -105,6 +107,8 @@ StGLContext::StGLContext(const bool theToInitialize)
   arbNPTW(false),
   arbTexRG(false),
   arbTexClear(false),
+  arbPbo(false),
+  arbSync(false),
 #if defined(GL_ES_VERSION_2_0)
   hasUnpack(false),
   hasHighp(false),
@@ -1034,6 +1038,10 @@ bool StGLContext::stglInit() {
          && STGL_READ_FUNC(glMapBufferRange)
          && STGL_READ_FUNC(glFlushMappedBufferRange);
 
+    // pixel buffer objects (added to OpenGL 2.1 core) are useful only with glMapBufferRange()
+    arbPbo = (isGlGreaterEqual(2, 1) || stglCheckExtension("GL_ARB_pixel_buffer_object"))
+          && hasMapBufferRange;
+
     // load OpenGL 3.0 new functions
     has30 = isGlGreaterEqual(3, 0)
          && hasFBO
@@ -1148,6 +1156,7 @@ bool StGLContext::stglInit() {
          && STGL_READ_FUNC(glWaitSync)
          && STGL_READ_FUNC(glGetInteger64v)
          && STGL_READ_FUNC(glGetSynciv);
+    arbSync = hasSync;
 
     // load GL_ARB_texture_multisample (added to OpenGL 3.2 core)
     const bool hasTextureMultisample = (isGlGreaterEqual(3, 2) || stglCheckExtension("GL_ARB_texture_multisample"))
@@ -1,5 +1,5 @@
 /**
- * Copyright © 2012-2014 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2012-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -65,6 +65,11 @@ bool StGLFontEntry::stglInit(StGLContext&       theCtx,
                              const unsigned int theResolution,
                              const bool         theToCreateTexture) {
     release(theCtx);
+    if(!myGlyphCache.isNull()
+    && (myGlyphCache->getPointSize()  != thePointSize
+     || myGlyphCache->getResolution() != theResolution)) {
+        myGlyphCache.nullify();
+    }
     if(!myFont->init(thePointSize, theResolution)) {
         return false;
     }
@@ -158,9 +163,21 @@ bool StGLFontEntry::setActiveStyle(const StFTFont::Style theStyle) {
 bool StGLFontEntry::renderGlyph(StGLContext&    theCtx,
                                 const stUtf32_t theChar,
                                 const bool      theToForce) {
-    if(!myFont->renderGlyph(theChar)) {
-        if(!theToForce
-        || !myFont->renderGlyphNotdef()) {
+    StImagePlane  aCachedImg;
+    StRect<float> aGlyphRect;
+    const StFTFont::Style aStyle = myFont->getActiveStyle();
+    const bool isCached = !myGlyphCache.isNull()
+                        && myGlyphCache->find(aStyle, theChar, aCachedImg, aGlyphRect);
+    if(!isCached) {
+        if(myFont->renderGlyph(theChar)) {
+            myFont->getGlyphRect(aGlyphRect);
+            if(!myGlyphCache.isNull()) {
+                myGlyphCache->add(aStyle, theChar, myFont->getGlyphImage(), aGlyphRect);
+            }
+        } else if(theToForce
+               && myFont->renderGlyphNotdef()) {
+            myFont->getGlyphRect(aGlyphRect);
+        } else {
             return false;
         }
     }
@@ -172,7 +189,7 @@ bool StGLFontEntry::renderGlyph(StGLContext&    theCtx,
 
     StHandle<StGLTexture>& aTexture = myTextures[myTextures.size() - 1];
 
-    const StImagePlane& anImg = myFont->getGlyphImage();
+    const StImagePlane& anImg = isCached ? aCachedImg : myFont->getGlyphImage();
     const size_t aTileId = myLastTileId + 1;
     myLastTilePx.left()  = myLastTilePx.right() + 3;
     myLastTilePx.right() = myLastTilePx.left() + (int )anImg.getSizeX();
@@ -209,7 +226,7 @@ bool StGLFontEntry::renderGlyph(StGLContext&    theCtx,
     aTile.uv.top()    = GLfloat(myLastTilePx.top())                    / GLfloat(aTexture->getSizeY());
     aTile.uv.bottom() = GLfloat(myLastTilePx.top() + anImg.getSizeY()) / GLfloat(aTexture->getSizeY());
     aTile.texture     = aTexture->getTextureId();
-    myFont->getGlyphRect(aTile.px);
+    aTile.px          = aGlyphRect;
 
     myLastTileId = aTileId;
     myTiles.add(aTile);
@@ -1,5 +1,5 @@
 /**
- * Copyright © 2013-2015 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2013-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -38,6 +38,12 @@ void StGLFontManager::release(StGLContext& theCtx) {
     }
     myFonts.clear();
     myFontTypes.clear();
+
+    // glyph caches hold no GL resources and are kept for re-initialization
+    for(std::map< StGLFontKey, StHandle<StFTGlyphCache> >::iterator anIter = myGlyphCaches.begin();
+        anIter != myGlyphCaches.end(); ++anIter) {
+        anIter->second->save();
+    }
 }
 
 void StGLFontManager::setResolution(const unsigned int theResolution) {
@@ -73,6 +79,7 @@ StHandle<StGLFontEntry> StGLFontManager::findCreate(const StString& theName,
     aFontFt->load(aFont.BoldItalic, StFTFont::Style_BoldItalic);
     aFontFt->init(theSize, myResolution);
     aFontGl = new StGLFontEntry(aFontFt);
+    aFontGl->setGlyphCache(findCreateGlyphCache(aFontFt, theSize));
     return aFontGl;
 }
 
@@ -91,6 +98,7 @@ StHandle<StGLFontEntry> StGLFontManager::findCreateFallback(unsigned int theSize
                           StFTFont::Style_Regular);
     aFontFt->init(theSize, myResolution);
     aFontGl = new StGLFontEntry(aFontFt);
+    aFontGl->setGlyphCache(findCreateGlyphCache(aFontFt, theSize));
     return aFontGl;
 }
 
@@ -113,3 +121,19 @@ const StHandle<StGLFont>& StGLFontManager::findCreate(const StFTFont::Typeface t
     }
     return aFont;
 }
+
+StHandle<StFTGlyphCache> StGLFontManager::findCreateGlyphCache(const StHandle<StFTFont>& theFont,
+                                                               unsigned int              theSize) {
+    if(theFont.isNull()
+    || !theFont->isValid()) {
+        return StHandle<StFTGlyphCache>();
+    }
+
+    StHandle<StFTGlyphCache>& aCache = myGlyphCaches[StGLFontKey(theFont->getFilePath(StFTFont::Style_Regular), theSize)];
+    if(aCache.isNull()
+    || aCache->getResolution() != myResolution) {
+        aCache = new StFTGlyphCache(theFont, theSize, myResolution, myCacheFolder);
+        aCache->prewarm();
+    }
+    return aCache;
+}
@@ -1,5 +1,5 @@
 /**
- * Copyright © 2009-2013 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2009-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -10,6 +10,7 @@
 
 #include <StGLCore/StGLCore11Fwd.h>
 #include <StGL/StGLArbFbo.h>
+#include <StGL/StGLAsyncReadback.h>
 #include <StGL/StGLContext.h>
 
 #include <StStrings/StLogger.h>
@@ -50,6 +51,21 @@ void StGLFrameBuffer::bindBuffer(StGLContext& theCtx) {
     theCtx.stglBindFramebuffer(myGLFBufferId);
 }
 
+bool StGLFrameBuffer::readPixelsAsync(StGLContext&       theCtx,
+                                      StGLAsyncReadback& theReadback,
+                                      const GLenum       theFormat,
+                                      const GLenum       theType) {
+    if(!isValidFrameBuffer()) {
+        return false;
+    }
+
+    const GLuint aReadPrev = theCtx.stglFramebufferRead();
+    theCtx.stglBindFramebufferRead(myGLFBufferId);
+    const bool isOk = theReadback.readPixels(theCtx, 0, 0, myViewPortX, myViewPortY, theFormat, theType);
+    theCtx.stglBindFramebufferRead(aReadPrev);
+    return isOk;
+}
+
 void StGLFrameBuffer::unbindBufferGlobal(StGLContext& theCtx) {
     theCtx.stglBindFramebuffer(NO_FRAMEBUFFER);
 }
@@ -0,0 +1,120 @@
+/**
+ * Copyright © 2017 Kirill Gavrilov <kirill@sview.ru>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file license-boost.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#include <StGL/StGLPixelBuffer.h>
+
+#include <StGLCore/StGLCore20.h>
+#include <StGL/StGLContext.h>
+
+#include <StStrings/StLogger.h>
+#include <stAssert.h>
+
+StGLPixelBuffer::StGLPixelBuffer(const GLenum theTarget)
+: myTarget(theTarget),
+  myBufferId(0),
+  mySizeBytes(0),
+  myMappedData(NULL) {
+    //
+}
+
+StGLPixelBuffer::~StGLPixelBuffer() {
+    ST_ASSERT(!isValid(), "~StGLPixelBuffer() with unreleased GL resources");
+}
+
+void StGLPixelBuffer::release(StGLContext& theCtx) {
+    if(!isValid()) {
+        return;
+    }
+
+    if(isMapped()) {
+        unmap(theCtx);
+    }
+    theCtx.core20fwd->glDeleteBuffers(1, &myBufferId);
+    myBufferId  = 0;
+    mySizeBytes = 0;
+}
+
+bool StGLPixelBuffer::init(StGLContext& theCtx,
+                           const size_t theSizeBytes) {
+#if defined(GL_ES_VERSION_2_0)
+    (void )theCtx;
+    (void )theSizeBytes;
+    return false;
+#else
+    if(!theCtx.arbPbo
+    ||  theCtx.core20fwd == NULL
+    ||  theSizeBytes == 0) {
+        return false;
+    }
+
+    if(isMapped()) {
+        unmap(theCtx);
+    }
+    if(!isValid()) {
+        theCtx.core20fwd->glGenBuffers(1, &myBufferId);
+        if(!isValid()) {
+            return false;
+        }
+    }
+
+    bind(theCtx);
+    theCtx.core20fwd->glBufferData(myTarget, GLsizeiptr(theSizeBytes), NULL,
+                                   myTarget == GL_PIXEL_PACK_BUFFER ? GL_STREAM_READ : GL_STREAM_DRAW);
+    unbind(theCtx);
+    mySizeBytes = theSizeBytes;
+    return true;
+#endif
+}
+
+void StGLPixelBuffer::bind(StGLContext& theCtx) const {
+    if(isValid()) {
+        theCtx.core20fwd->glBindBuffer(myTarget, myBufferId);
+    }
+}
+
+void StGLPixelBuffer::unbind(StGLContext& theCtx) const {
+    if(isValid()) {
+        theCtx.core20fwd->glBindBuffer(myTarget, 0);
+    }
+}
+
+GLubyte* StGLPixelBuffer::map(StGLContext& theCtx) {
+#if defined(GL_ES_VERSION_2_0)
+    (void )theCtx;
+    return NULL;
+#else
+    if(!isValid()) {
+        return NULL;
+    } else if(isMapped()) {
+        return myMappedData;
+    }
+
+    const GLbitfield anAccess = myTarget == GL_PIXEL_PACK_BUFFER
+                              ? GL_MAP_READ_BIT
+                              : (GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    bind(theCtx);
+    myMappedData = (GLubyte* )theCtx.extAll->glMapBufferRange(myTarget, 0, GLsizeiptr(mySizeBytes), anAccess);
+    unbind(theCtx);
+    if(myMappedData == NULL) {
+        ST_DEBUG_LOG("StGLPixelBuffer, failed to map buffer of " + mySizeBytes + " bytes");
+    }
+    return myMappedData;
+#endif
+}
+
+bool StGLPixelBuffer::unmap(StGLContext& theCtx) {
+    if(!isMapped()) {
+        return true;
+    }
+
+    myMappedData = NULL;
+    bind(theCtx);
+    const bool isOk = theCtx.core20fwd->glUnmapBuffer(myTarget) == GL_TRUE;
+    unbind(theCtx);
+    return isOk;
+}
@@ -10,6 +10,8 @@
 
 #include <StGL/StGLVertexBuffer.h>
 
+#include <algorithm>
+
 /**
  * Auxiliary function to translate rectangles by the vector.
  */
@@ -59,6 +61,7 @@ StGLTextFormatter::StGLTextFormatter()
   myRectsNb(0),
   myLineSpacing(0.0f),
   myAscender(0.0f),
+  myIsFormatted(false),
   //
   myLinesNb(0),
   myRectLineStart(0),
@@ -67,7 +70,10 @@ StGLTextFormatter::StGLTextFormatter()
   myAlignWidth(0.0f),
   myTextWidth(0.0f),
   myLineLeft(0.0f),
-  myMoveVec(0.0f, 0.0f) {
+  myMoveVec(0.0f, 0.0f),
+  //
+  myLastFont(NULL),
+  myLastStyle(StFTFont::Style_Regular) {
     //
 }
 
@@ -83,7 +89,18 @@ void StGLTextFormatter::reset() {
     myPen.x() = myPen.y() = 0.0f;
     myRectsNb  = 0;
     myLineSpacing = myAscender = 0.0f;
-    myRects.clear(); /// TODO - clear without setting each rectangle to default value
+    myRectsRaw.clear();
+    myRects.clear();
+
+    myLastText.clear();
+    myLastFont = NULL;
+    myCharPens.clear();
+    myCharRects.clear();
+
+    // texture ids might be reused by re-initialized font
+    myLastTextures.clear();
+    myLastVerts.clear();
+    myLastTCrds.clear();
 }
 
 /**
@@ -100,37 +117,33 @@ inline StGLVec2& floor(StGLVec2& theVec) {
 void StGLTextFormatter::getResult(std::vector<GLuint>&                               theTextures,
                                   std::vector< StHandle <std::vector <StGLVec2> > >& theVertsPerTexture,
                                   std::vector< StHandle <std::vector <StGLVec2> > >& theTCrdsPerTexture) const {
-    StGLVec2 aVec(0.0f, 0.0f);
-    theTextures.clear();
     theVertsPerTexture.clear();
     theTCrdsPerTexture.clear();
+    fillResult(theTextures, theVertsPerTexture, theTCrdsPerTexture);
+}
 
-    std::vector<size_t> aNbRectPerTexture;
+void StGLTextFormatter::fillResult(std::vector<GLuint>&                               theTextures,
+                                   std::vector< StHandle <std::vector <StGLVec2> > >& theVertsPerTexture,
+                                   std::vector< StHandle <std::vector <StGLVec2> > >& theTCrdsPerTexture) const {
+    StGLVec2 aVec(0.0f, 0.0f);
+    theTextures.clear();
     for(size_t aRectIter = 0; aRectIter < myRectsNb; ++aRectIter) {
         const GLuint aTexture = myRects[aRectIter].texture;
-
-        size_t aListId = 0;
-        for(aListId = 0; aListId < theTextures.size(); ++aListId) {
-            if(theTextures[aListId] == aTexture) {
-                break;
-            }
-        }
-        if(aListId >= theTextures.size()) {
+        if(std::find(theTextures.begin(), theTextures.end(), aTexture) == theTextures.end()) {
             theTextures.push_back(aTexture);
-            theVertsPerTexture.push_back(new std::vector<StGLVec2>());
-            theTCrdsPerTexture.push_back(new std::vector<StGLVec2>());
-            aNbRectPerTexture.push_back(0);
         }
-
-        ++aNbRectPerTexture[aListId];
     }
 
+    // arrays allocated by previous call are cleared without releasing memory
+    theVertsPerTexture.resize(theTextures.size());
+    theTCrdsPerTexture.resize(theTextures.size());
     for(size_t aTexIter = 0; aTexIter < theTextures.size(); ++aTexIter) {
-        const size_t aNbTexTris = aNbRectPerTexture[aTexIter] * 6;
-        std::vector<StGLVec2>& aVerts = *theVertsPerTexture[aTexIter];
-        std::vector<StGLVec2>& aTCrds = *theTCrdsPerTexture[aTexIter];
-        aVerts.reserve(aNbTexTris);
-        aTCrds.reserve(aNbTexTris);
+        if(theVertsPerTexture[aTexIter].isNull()) {
+            theVertsPerTexture[aTexIter] = new std::vector<StGLVec2>();
+            theTCrdsPerTexture[aTexIter] = new std::vector<StGLVec2>();
+        }
+        theVertsPerTexture[aTexIter]->clear();
+        theTCrdsPerTexture[aTexIter]->clear();
     }
 
     for(size_t aRectIter = 0; aRectIter < myRectsNb; ++aRectIter) {
@@ -169,11 +182,15 @@ void StGLTextFormatter::getResult(std::vector<GLuint>&
 void StGLTextFormatter::getResult(StGLContext&                                theCtx,
                                   std::vector<GLuint>&                        theTextures,
                                   StArrayList< StHandle <StGLVertexBuffer> >& theVertsPerTexture,
-                                  StArrayList< StHandle <StGLVertexBuffer> >& theTCrdsPerTexture) const {
-    std::vector< StHandle < std::vector<StGLVec2> > > aVertsPerTexture;
-    std::vector< StHandle < std::vector<StGLVec2> > > aTCrdsPerTexture;
-    getResult(theTextures, aVertsPerTexture, aTCrdsPerTexture);
-
+                                  StArrayList< StHandle <StGLVertexBuffer> >& theTCrdsPerTexture) {
+    myLastTextures.swap(theTextures);
+    fillResult(theTextures, myNewVerts, myNewTCrds);
+
+    // partial update is allowed only for the same textures in the same order
+    const bool isSameTextures = !myLastTextures.empty()
+                             && theTextures == myLastTextures
+                             && theVertsPerTexture.size() == theTextures.size()
+                             && myLastVerts.size()        == theTextures.size();
     if(theVertsPerTexture.size() != theTextures.size()) {
         for(size_t aTextureIter = 0; aTextureIter < theVertsPerTexture.size(); ++aTextureIter) {
             theVertsPerTexture[aTextureIter]->release(theCtx);
@@ -193,11 +210,50 @@ void StGLTextFormatter::getResult(StGLContext&                                th
     }
 
     for(size_t aTextureIter = 0; aTextureIter < theTextures.size(); ++aTextureIter) {
-        const std::vector<StGLVec2>& aVerts = *aVertsPerTexture[aTextureIter];
-        const std::vector<StGLVec2>& aTCrds = *aTCrdsPerTexture[aTextureIter];
-        theVertsPerTexture[aTextureIter]->init(theCtx, aVerts);
-        theTCrdsPerTexture[aTextureIter]->init(theCtx, aTCrds);
+        const std::vector<StGLVec2>& aVerts = *myNewVerts[aTextureIter];
+        const std::vector<StGLVec2>& aTCrds = *myNewTCrds[aTextureIter];
+        StGLVertexBuffer& aVertsVbo = *theVertsPerTexture[aTextureIter];
+        StGLVertexBuffer& aTCrdsVbo = *theTCrdsPerTexture[aTextureIter];
+        if(!isSameTextures
+        || aVerts.empty()
+        || myLastVerts[aTextureIter]->size() != aVerts.size()
+        || aVertsVbo.getElemsCount() != GLsizeiptr(aVerts.size())
+        || aTCrdsVbo.getElemsCount() != GLsizeiptr(aTCrds.size())) {
+            aVertsVbo.init(theCtx, aVerts);
+            aTCrdsVbo.init(theCtx, aTCrds);
+            continue;
+        }
+
+        // the number of glyphs is unchanged - upload only the modified range
+        const std::vector<StGLVec2>& aLastVerts = *myLastVerts[aTextureIter];
+        const std::vector<StGLVec2>& aLastTCrds = *myLastTCrds[aTextureIter];
+        size_t aFirst = 0;
+        size_t aLast  = aVerts.size();
+        while(aFirst < aLast
+           && aVerts[aFirst] == aLastVerts[aFirst]
+           && aTCrds[aFirst] == aLastTCrds[aFirst]) {
+            ++aFirst;
+        }
+        while(aLast > aFirst
+           && aVerts[aLast - 1] == aLastVerts[aLast - 1]
+           && aTCrds[aLast - 1] == aLastTCrds[aLast - 1]) {
+            --aLast;
+        }
+        if(aFirst == aLast) {
+            continue;
+        }
+
+        aVertsVbo.bind(theCtx);
+        aVertsVbo.setSubData(theCtx, GLsizeiptr(aFirst), GLsizeiptr(aLast - aFirst), aVerts[aFirst].getData());
+        aVertsVbo.unbind(theCtx);
+        aTCrdsVbo.bind(theCtx);
+        aTCrdsVbo.setSubData(theCtx, GLsizeiptr(aFirst), GLsizeiptr(aLast - aFirst), aTCrds[aFirst].getData());
+        aTCrdsVbo.unbind(theCtx);
     }
+
+    // keep uploaded arrays for comparison on next call
+    myLastVerts.swap(myNewVerts);
+    myLastTCrds.swap(myNewTCrds);
 }
 
 void StGLTextFormatter::append(StGLContext&    theCtx,
@@ -218,6 +274,7 @@ void StGLTextFormatter::append(StGLContext&          theCtx,
         return;
     }
 
+    myIsFormatted = false;
     theFont.setActiveStyle(theStyle);
     myAscender    = stMax(myAscender,    theFont.getFont()->getAscender());
     myLineSpacing = stMax(myLineSpacing, theFont.getFont()->getLineSpacing());
@@ -230,6 +287,9 @@ void StGLTextFormatter::append(StGLContext&          theCtx,
     // first pass - render all symbols using associated font on single ZERO baseline
     StGLTile aTile;
     for(StUtf8Iter anIter = theString.iterator(); *anIter != 0 && anIter.getIndex() < theString.Length;) {
+        myCharPens .push_back(myPen);
+        myCharRects.push_back(myRectsNb);
+
         const stUtf32_t aCharThis =   *anIter;
         const stUtf32_t aCharNext = *++anIter;
 
@@ -246,12 +306,69 @@ void StGLTextFormatter::append(StGLContext&          theCtx,
         theFont.renderGlyph(theCtx,
                             aCharThis, aCharNext,
                             aTile, myPen);
-        myRects.push_back(aTile);
+        myRectsRaw.push_back(aTile);
 
         ++myRectsNb;
     }
 }
 
+void StGLTextFormatter::update(StGLContext&    theCtx,
+                               const StString& theString,
+                               StGLFont&       theFont) {
+    myIsFormatted = false;
+
+    // glyphs positions are tracked per symbol only for plain text
+    const bool isPlainText = myParser == Parser_PlainText
+                         || (!theString .isContains(stUtf32_t('<'))
+                          && !myLastText.isContains(stUtf32_t('<')));
+    const bool isSameFont  = myLastFont  == &theFont
+                          && myLastStyle == myDefStyle
+                          && !theFont.getFont().isNull()
+                          && theFont.getFont()->getLineSpacing() == myLineSpacing;
+
+    // find the common prefix
+    const stUtf8_t* aRestartPtr = theString.String;
+    size_t aNbSame = 0;
+    if(isPlainText
+    && isSameFont
+    && myCharPens.size() == myLastText.getLength()) {
+        StUtf8Iter aNewIter  = theString.iterator();
+        StUtf8Iter aLastIter = myLastText.iterator();
+        for(; *aNewIter != 0 && *aNewIter == *aLastIter; ++aNewIter, ++aLastIter) {
+            aRestartPtr = aNewIter.getBufferHere();
+            ++aNbSame;
+        }
+        if(*aNewIter  == 0
+        && *aLastIter == 0) {
+            return; // text is unchanged
+        }
+    }
+
+    if(aNbSame < 2) {
+        reset();
+        myLastText  = theString;
+        myLastFont  = &theFont;
+        myLastStyle = myDefStyle;
+        append(theCtx, theString, theFont);
+        return;
+    }
+
+    // the last common symbol is rendered again since its advance depends on kerning with the next symbol
+    const size_t aRestart = aNbSame - 1;
+    myRectsNb = myCharRects[aRestart];
+    myPen     = myCharPens [aRestart];
+    myRectsRaw .resize(myRectsNb);
+    myCharRects.resize(aRestart);
+    myCharPens .resize(aRestart);
+    myString   = theString.subString(0, aRestart);
+    myLastText = theString;
+
+    const StCString aSubString = stStringExtConstr(aRestartPtr,
+                                                   theString.Size   - size_t(aRestartPtr - theString.String),
+                                                   theString.Length - aRestart);
+    append(theCtx, aSubString, myDefStyle, theFont);
+}
+
 enum CtrlTag {
     CtrlTag_UNKNOWN,
     CtrlTag_Italic,
@@ -402,6 +519,7 @@ void StGLTextFormatter::format(const GLfloat theWidth,
     }
 
     myIsFormatted = true;
+    myRects.assign(myRectsRaw.begin(), myRectsRaw.begin() + myRectsNb);
     myLinesNb = myRectLineStart = myRectWordStart = 0;
     myLineLeft   = 0.0f;
     myBndTop     = 0.0f;
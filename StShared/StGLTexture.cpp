@@ -1,5 +1,5 @@
 /**
- * Copyright © 2009-2015 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2009-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -125,6 +125,14 @@ bool StGLTexture::getInternalFormat(const StGLContext&  theCtx,
             //theInternalFormat = GL_RG8;   // OpenGL3+ hardware
             theInternalFormat = GL_LUMINANCE_ALPHA;
             return true;
+        case StImagePlane::ImgUV16:
+        #if defined(GL_ES_VERSION_2_0)
+            theInternalFormat = GL_LUMINANCE_ALPHA;
+        #else
+            //theInternalFormat = GL_RG16;            // OpenGL3+ hardware
+            theInternalFormat = GL_LUMINANCE16_ALPHA16; // backward compatibility
+        #endif
+            return true;
         default:
             return false;
     }
@@ -160,6 +168,12 @@ bool StGLTexture::getDataFormat(const StGLContext&  theCtx,
             theDataType = GL_UNSIGNED_BYTE;
             return true;
         }
+        case StImagePlane::ImgUV16: {
+            //thePixelFormat = GL_RG;
+            thePixelFormat = GL_LUMINANCE_ALPHA;
+            theDataType = GL_UNSIGNED_SHORT;
+            return true;
+        }
         case StImagePlane::ImgRGB: {
             thePixelFormat = GL_RGB;
             theDataType = GL_UNSIGNED_BYTE;
@@ -593,12 +607,25 @@ bool StGLTexture::init(StGLContext&        theCtx,
     return fill(theCtx, theData);
 }
 
+/**
+ * Return pointer to the row data or offset within bound unpack buffer.
+ */
+inline const GLvoid* getUnpackData(const StImagePlane& theData,
+                                   const size_t        theRow,
+                                   const GLubyte*      theUnpackBase) {
+    const GLubyte* aData = theData.getData(theRow, 0);
+    return theUnpackBase == NULL
+         ? (const GLvoid* )aData
+         : (const GLvoid* )(aData - theUnpackBase);
+}
+
 bool StGLTexture::fillPatch(StGLContext&        theCtx,
                             const StImagePlane& theData,
                             GLenum              theTarget,
                             const GLsizei       theRowFrom,
                             const GLsizei       theRowTo,
-                            const GLsizei       theBatchRows) {
+                            const GLsizei       theBatchRows,
+                            const GLubyte*      theUnpackBase) {
     if(theTarget == 0) {
         theTarget = myTarget;
     }
@@ -664,7 +691,7 @@ bool StGLTexture::fillPatch(StGLContext&        theCtx,
                                               aPatchWidth, aNbRows,
                                               aPixelFormat,     // format of the pixel data
                                               aDataType,        // data type of the pixel data
-                                              theData.getData(aRow, 0));
+                                              getUnpackData(theData, aRow, theUnpackBase));
         }
 
         if(theCtx.hasUnpack) {
@@ -683,7 +710,7 @@ bool StGLTexture::fillPatch(StGLContext&        theCtx,
                                               aPatchWidth, 1,   // the (width, height) of the texture sub-image
                                               aPixelFormat,     // format of the pixel data
                                               aDataType,        // data type of the pixel data
-                                              theData.getData(aRow, 0));
+                                              getUnpackData(theData, aRow, theUnpackBase));
         }
     }
 
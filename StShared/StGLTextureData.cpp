@@ -9,13 +9,17 @@
 #include <StGLStereo/StGLTextureData.h>
 #include <StStrings/StLogger.h>
 
-#include <StGLCore/StGLCore11.h>
+#include <StGLCore/StGLCore20.h>
+#include <StGL/StGLContext.h>
 
 StGLTextureData::StGLTextureData()
 : myPrev(NULL),
   myNext(NULL),
   myDataPtr(NULL),
   myDataSizeBytes(0),
+  myUnpackBuffer(GL_PIXEL_UNPACK_BUFFER),
+  myUnpackBase(NULL),
+  myUnpackSizeHint(0),
   myStParams(),
   myPts(0.0),
   mySrcFormat(StFormat_AUTO),
@@ -33,6 +37,9 @@ void StGLTextureData::reset() {
     myDataPair.nullify();
     myDataL.nullify();
     myDataR.nullify();
+    myUnpackL.nullify();
+    myUnpackR.nullify();
+    myUnpackBase = NULL;
     if(myDataPtr != NULL) {
         stMemFreeAligned(myDataPtr);
         myDataPtr = NULL;
@@ -185,10 +192,13 @@ static GLubyte* readFromRowInterlace(const StImagePlane& theSrc,
     return &theDataPtr[2 * theDataL.getSizeBytes()];
 }
 
-static GLubyte* readFromTiled4X(const StImagePlane& theDataSrc,
-                                GLubyte*            theDataOutPtr,
-                                StImagePlane&       theDataOutL,
-                                StImagePlane&       theDataOutR) {
+/**
+ * Assemble Right view from 3 tiles of 720p-in-1080p frame.
+ * Left view is a plain rectangle in top-left corner - it can be either wrapped or copied.
+ */
+static GLubyte* readFromTiled4XRight(const StImagePlane& theDataSrc,
+                                     GLubyte*            theDataOutPtr,
+                                     StImagePlane&       theDataOutR) {
     if(theDataSrc.isNull()) {
         return theDataOutPtr;
     }
@@ -198,33 +208,20 @@ static GLubyte* readFromTiled4X(const StImagePlane& theDataSrc,
     const size_t aDataSizeXHalf = aDataSizeX / 2;
 
     const size_t anOutRowBytes = getEvenNumber(aDataSizeX * theDataSrc.getSizePixelBytes());
-    theDataOutL.initWrapper(theDataSrc.getFormat(), theDataOutPtr,
+    theDataOutR.initWrapper(theDataSrc.getFormat(), theDataOutPtr,
                             aDataSizeX, aDataSizeY,
                             anOutRowBytes);
-    theDataOutR.initWrapper(theDataSrc.getFormat(), &theDataOutPtr[theDataOutL.getSizeBytes()],
-                            theDataOutL.getSizeX(), theDataOutL.getSizeY(),
-                            anOutRowBytes);
 
-    size_t aCopyRows     = stMin(theDataOutL.getSizeY(), aDataSizeY);
-    size_t aCopyRowBytes = stMin(theDataOutL.getSizeX(), aDataSizeX) * theDataOutL.getSizePixelBytes();
+    size_t aCopyRows     = theDataOutR.getSizeY();
+    size_t aCopyRowBytes = aDataSizeXHalf * theDataOutR.getSizePixelBytes();
 
     // check if data is upside-down
     size_t aRowSrcTop = theDataSrc.isTopDown() ? 0 : (theDataSrc.getSizeY() - 1);
-
-    // copy Left view (1 big tile at top-left corner)
     const size_t aRowInc = theDataSrc.isTopDown() ? 1 : size_t(-1);
-    size_t aRowTo  = 0;
-    size_t aRowSrc = aRowSrcTop;
-    for(; aRowTo < aCopyRows; ++aRowTo, aRowSrc += aRowInc) {
-        stMemCpy(theDataOutL.changeData(aRowTo, 0),
-                 theDataSrc.getData(aRowSrc, 0),
-                 aCopyRowBytes);
-    }
 
     // copy Right view (first half-width tile at top-right
-    aCopyRowBytes = (aDataSizeX / 2) * theDataOutL.getSizePixelBytes();
-    aRowTo  = 0;
-    aRowSrc = aRowSrcTop;
+    size_t aRowTo  = 0;
+    size_t aRowSrc = aRowSrcTop;
     for(; aRowTo < aCopyRows; ++aRowTo, aRowSrc += aRowInc) {
         stMemCpy(theDataOutR.changeData(aRowTo, 0),
                  theDataSrc.getData(aRowSrc, aDataSizeX),
@@ -252,7 +249,39 @@ static GLubyte* readFromTiled4X(const StImagePlane& theDataSrc,
                  aCopyRowBytes);
     }
 
-    return &theDataOutPtr[2 * theDataOutL.getSizeBytes()];
+    return &theDataOutPtr[theDataOutR.getSizeBytes()];
+}
+
+static GLubyte* readFromTiled4X(const StImagePlane& theDataSrc,
+                                GLubyte*            theDataOutPtr,
+                                StImagePlane&       theDataOutL,
+                                StImagePlane&       theDataOutR) {
+    if(theDataSrc.isNull()) {
+        return theDataOutPtr;
+    }
+
+    const size_t aDataSizeX = (theDataSrc.getSizeX() / 3) * 2;
+    const size_t aDataSizeY = (theDataSrc.getSizeY() / 3) * 2;
+
+    const size_t anOutRowBytes = getEvenNumber(aDataSizeX * theDataSrc.getSizePixelBytes());
+    theDataOutL.initWrapper(theDataSrc.getFormat(), theDataOutPtr,
+                            aDataSizeX, aDataSizeY,
+                            anOutRowBytes);
+
+    const size_t aCopyRows     = theDataOutL.getSizeY();
+    const size_t aCopyRowBytes = aDataSizeX * theDataOutL.getSizePixelBytes();
+
+    // copy Left view (1 big tile at top-left corner)
+    const size_t aRowInc = theDataSrc.isTopDown() ? 1 : size_t(-1);
+    size_t aRowTo  = 0;
+    size_t aRowSrc = theDataSrc.isTopDown() ? 0 : (theDataSrc.getSizeY() - 1);
+    for(; aRowTo < aCopyRows; ++aRowTo, aRowSrc += aRowInc) {
+        stMemCpy(theDataOutL.changeData(aRowTo, 0),
+                 theDataSrc.getData(aRowSrc, 0),
+                 aCopyRowBytes);
+    }
+
+    return readFromTiled4XRight(theDataSrc, &theDataOutPtr[theDataOutL.getSizeBytes()], theDataOutR);
 }
 
 static GLubyte* readFromMono(const StImagePlane& theSrc,
@@ -362,6 +391,9 @@ void StGLTextureData::updateData(const StGLDeviceCaps&           theDeviceCaps,
 
     // reset fill texture state
     myFillRows = myFillFromRow = 0;
+    myUnpackL.nullify();
+    myUnpackR.nullify();
+    myUnpackBase = NULL;
 
     if(canCopyReference(theDataL)
     && canCopyReference(theDataR)) {
@@ -463,8 +495,37 @@ void StGLTextureData::updateData(const StGLDeviceCaps&           theDeviceCaps,
                 }
                 break;
             }
-            case StFormat_Columns:
             case StFormat_Tiled4x: {
+                if(!theDeviceCaps.hasUnpack) {
+                    // slow copying to GPU memory
+                    toCopy = true;
+                    break;
+                }
+
+                // Left view is a plain rectangle within source frame - wrap it,
+                // only Right view should be assembled from 3 tiles
+                myDataPair.nullify();
+                myDataL.nullify();
+                myDataR.nullify();
+                reAllocate(computeBufferSize(theDataL));
+                copyProps(theDataL, theDataR);
+                myDataPair.initReference(theDataL);
+                GLubyte* aDataDispl = myDataPtr;
+                for(size_t aPlaneId = 0; aPlaneId < 4; ++aPlaneId) {
+                    const StImagePlane& aFromPlane = myDataPair.getPlane(aPlaneId);
+                    if(aFromPlane.isNull()) {
+                        continue;
+                    }
+                    myDataL.changePlane(aPlaneId).initWrapper(aFromPlane.getFormat(),
+                                                              aFromPlane.accessData(0, 0),
+                                                              (aFromPlane.getSizeX() / 3) * 2,
+                                                              (aFromPlane.getSizeY() / 3) * 2,
+                                                              aFromPlane.getSizeRowBytes());
+                    aDataDispl = readFromTiled4XRight(aFromPlane, aDataDispl, myDataR.changePlane(aPlaneId));
+                }
+                break;
+            }
+            case StFormat_Columns: {
                 toCopy = true;
                 break;
             }
@@ -496,6 +557,7 @@ void StGLTextureData::updateData(const StGLDeviceCaps&           theDeviceCaps,
 
         if(!toCopy) {
             validateCubemap(theCubemap);
+            fillUnpackBuffer();
             return;
         }
     }
@@ -588,6 +650,49 @@ void StGLTextureData::updateData(const StGLDeviceCaps&           theDeviceCaps,
     validateCubemap(theCubemap);
 }
 
+bool StGLTextureData::stglMapUnpackBuffer(StGLContext& theCtx,
+                                          const size_t theSizeBytes) {
+    if(myUnpackBuffer.isMapped()) {
+        return true;
+    } else if(theSizeBytes == 0) {
+        return false;
+    }
+
+    if(myUnpackBuffer.getSizeBytes() != theSizeBytes) {
+        if(!myUnpackBuffer.init(theCtx, theSizeBytes)) {
+            myUnpackBuffer.release(theCtx);
+            return false;
+        }
+    }
+    return myUnpackBuffer.map(theCtx) != NULL;
+}
+
+void StGLTextureData::stglReleaseUnpackBuffer(StGLContext& theCtx) {
+    myUnpackL.nullify();
+    myUnpackR.nullify();
+    myUnpackBase = NULL;
+    myUnpackBuffer.release(theCtx);
+}
+
+void StGLTextureData::fillUnpackBuffer() {
+    myUnpackSizeHint = computeBufferSize(myDataL) + computeBufferSize(myDataR);
+    GLubyte* aDataPtr = myUnpackBuffer.getMappedData();
+    if(aDataPtr == NULL
+    || myUnpackBuffer.getSizeBytes() < myUnpackSizeHint) {
+        return;
+    }
+
+    // copying is performed within data thread,
+    // so that GL thread will only initiate DMA transfer from buffer object
+    myUnpackBase = aDataPtr;
+    for(size_t aPlaneId = 0; aPlaneId < 4; ++aPlaneId) {
+        aDataPtr = readFromMono(myDataL.getPlane(aPlaneId), aDataPtr, myUnpackL.changePlane(aPlaneId));
+    }
+    for(size_t aPlaneId = 0; aPlaneId < 4; ++aPlaneId) {
+        aDataPtr = readFromMono(myDataR.getPlane(aPlaneId), aDataPtr, myUnpackR.changePlane(aPlaneId));
+    }
+}
+
 void StGLTextureData::validateCubemap(const StCubemap theCubemap) {
     if(theCubemap != StCubemap_Packed) {
         myCubemapFormat = StCubemap_OFF;
@@ -618,13 +723,15 @@ void StGLTextureData::validateCubemap(const StCubemap theCubemap) {
 
 void StGLTextureData::fillTexture(StGLContext&        theCtx,
                                   StGLFrameTexture&   theFrameTexture,
-                                  const StImagePlane& theData) {
+                                  const StImagePlane& theData,
+                                  const GLubyte*      theUnpackBase) {
     if(!theFrameTexture.isValid() || theData.isNull()) {
         return;
     }
 
+    const GLsizei aBatchRows = theUnpackBase != NULL ? 0 : 128;
     if(myCubemapFormat != StCubemap_Packed) {
-        theFrameTexture.fillPatch(theCtx, theData, GL_TEXTURE_2D, myFillFromRow, myFillFromRow + myFillRows);
+        theFrameTexture.fillPatch(theCtx, theData, GL_TEXTURE_2D, myFillFromRow, myFillFromRow + myFillRows, aBatchRows, theUnpackBase);
         return;
     }
 
@@ -654,7 +761,7 @@ void StGLTextureData::fillTexture(StGLContext&        theCtx,
             ST_DEBUG_LOG("StGLTextureData::fillTexture(). wrapping failure");
             continue;
         }
-        theFrameTexture.fillPatch(theCtx, aPlane, aTargets[aTargetIter], myFillFromRow, myFillFromRow + myFillRows);
+        theFrameTexture.fillPatch(theCtx, aPlane, aTargets[aTargetIter], myFillFromRow, myFillFromRow + myFillRows, aBatchRows, theUnpackBase);
     }
 }
 
@@ -735,6 +842,14 @@ bool StGLTextureData::fillTexture(StGLContext&     theCtx,
 
     // setup rows count to be filled per fillTexture()
     if(myFillRows == 0 || myFillFromRow == 0) {
+        if(myUnpackBase != NULL
+        && !myUnpackBuffer.unmap(theCtx)) {
+            // buffer content has been lost - fallback to client memory
+            myUnpackL.nullify();
+            myUnpackR.nullify();
+            myUnpackBase = NULL;
+        }
+
         // prepare textures for new data
         prepareTextures(theCtx, myDataL, myCubemapFormat, theQTexture.getBack(StGLQuadTexture::LEFT_TEXTURE));
         prepareTextures(theCtx, myDataR, myCubemapFormat, theQTexture.getBack(StGLQuadTexture::RIGHT_TEXTURE));
@@ -752,6 +867,10 @@ bool StGLTextureData::fillTexture(StGLContext&     theCtx,
             maxRows    = stMax(maxRows, stMin(GLsizei(myDataR.getSizeY()), theQTexture.getBack(StGLQuadTexture::RIGHT_TEXTURE).getSizeY()));
             iterations = maxRows / UPDATED_ROWS_MAX + 1;
         }
+        if(myUnpackBase != NULL) {
+            // transfer from buffer object is asynchronous - no need to split it
+            iterations = 1;
+        }
         myFillRows = maxRows / iterations;
         myFillFromRow = 0;
     }
@@ -761,20 +880,31 @@ bool StGLTextureData::fillTexture(StGLContext&     theCtx,
         return true;
     }
 
+    const bool     toUseUnpack = myUnpackBase != NULL;
+    const StImage& aDataL      = toUseUnpack ? myUnpackL : myDataL;
+    const StImage& aDataR      = toUseUnpack ? myUnpackR : myDataR;
+    if(toUseUnpack) {
+        myUnpackBuffer.bind(theCtx);
+    }
     if(theQTexture.getBack(StGLQuadTexture::LEFT_TEXTURE).isValid()) {
         for(size_t aPlaneId = 0; aPlaneId < 4; ++aPlaneId) {
             fillTexture(theCtx,
                         theQTexture.getBack(StGLQuadTexture::LEFT_TEXTURE).getPlane(aPlaneId),
-                        myDataL.getPlane(aPlaneId));
+                        aDataL.getPlane(aPlaneId),
+                        myUnpackBase);
         }
     }
     if(theQTexture.getBack(StGLQuadTexture::RIGHT_TEXTURE).isValid()) {
         for(size_t aPlaneId = 0; aPlaneId < 4; ++aPlaneId) {
             fillTexture(theCtx,
                         theQTexture.getBack(StGLQuadTexture::RIGHT_TEXTURE).getPlane(aPlaneId),
-                        myDataR.getPlane(aPlaneId));
+                        aDataR.getPlane(aPlaneId),
+                        myUnpackBase);
         }
     }
+    if(toUseUnpack) {
+        myUnpackBuffer.unbind(theCtx);
+    }
     theQTexture.getBack(StGLQuadTexture::LEFT_TEXTURE).unbind(theCtx);
 
     myFillFromRow += myFillRows;
@@ -790,6 +920,11 @@ bool StGLTextureData::fillTexture(StGLContext&     theCtx,
         if(!myStParams.isNull()) {
             myStParams->StereoFormat = mySrcFormat;
         }
+
+        // unmapped memory should not be accessed anymore
+        myUnpackL.nullify();
+        myUnpackR.nullify();
+        myUnpackBase = NULL;
         return true;
     } else {
         return false;
@@ -1,5 +1,5 @@
 /**
- * Copyright © 2009-2016 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2009-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -9,17 +9,26 @@
 #include <StGLStereo/StGLTextureQueue.h>
 
 #include <StGL/StGLContext.h>
+#include <StThreads/StThread.h>
 
 StGLTextureQueue::StGLTextureQueue(const size_t theQueueSizeMax)
 : myDataFront(NULL),
-  myDataSnap(NULL),
   myDataBack(NULL),
-  myQueueSize(0),
+  myDataSnap(NULL),
+  myDataSnapUsed(NULL),
+  myPushCounter(0),
+  myPopCounter(0),
+  myFrontSeq(0),
+  myDropCounter(0),
+  myClearCounter(0),
+  myClearCounterGL(0),
+  myShotCounter(0),
+  myShotCounterCopy(0),
   myQueueSizeMax(theQueueSizeMax),
+  myUnpackSizeHint(0),
   mySwapFBCount(0),
   myCurrSrcFormat(StFormat_Mono),
   myCurrPts(0.0),
-  myNewShotEvent(false),
   myIsInUpdTexture(false),
   myIsReadyToSwap(false),
   myToCompress(false),
@@ -38,13 +47,47 @@ StGLTextureQueue::StGLTextureQueue(const size_t theQueueSizeMax)
 }
 
 StGLTextureQueue::~StGLTextureQueue() {
-    for(size_t anIter = 0; anIter < myQueueSizeMax; ++anIter) {
-        StGLTextureData* aRemItem = myDataFront;
-        myDataFront = myDataFront->getNext();
+    StGLTextureData* anIter = myDataFront;
+    for(size_t anIterId = 0; anIterId < myQueueSizeMax; ++anIterId) {
+        StGLTextureData* aRemItem = anIter;
+        anIter = anIter->getNext();
         delete aRemItem;
     }
 }
 
+void StGLTextureQueue::release(StGLContext& theCtx) {
+    StGLTextureData* anIter = myDataFront;
+    for(size_t anIterId = 0; anIterId < myQueueSizeMax; ++anIterId, anIter = anIter->getNext()) {
+        anIter->stglReleaseUnpackBuffer(theCtx);
+    }
+    myUnpackSizeHint = 0;
+    myQTexture.release(theCtx);
+}
+
+void StGLTextureQueue::stglMapUnpackBuffers(StGLContext& theCtx) {
+    const size_t anUnpackSizeHint = myUnpackSizeHint;
+    if(!theCtx.arbPbo
+    ||  myToCompress
+    ||  anUnpackSizeHint == 0) {
+        return;
+    }
+
+    // items in range [front, front + queued) are owned by queue, all others can be filled by next push();
+    // the item displayed just before front is skipped - its buffer might be still used by transfer.
+    // Mapping item concurrently filled by push() is harmless - it will just not use the mapped buffer
+    const size_t aQueued = size_t(uint32_t(myPushCounter - myPopCounter));
+    StGLTextureData* anIter = myDataFront;
+    for(size_t anIterId = 0; anIterId < aQueued; ++anIterId) {
+        anIter = anIter->getNext();
+    }
+    for(size_t anIterId = aQueued + 1; anIterId < myQueueSizeMax; ++anIterId, anIter = anIter->getNext()) {
+        if(!anIter->hasMappedUnpackBuffer()
+        && !anIter->stglMapUnpackBuffer(theCtx, anUnpackSizeHint)) {
+            break;
+        }
+    }
+}
+
 void StGLTextureQueue::setCompressMemory(const bool theToCompress) {
     myToCompress = theToCompress;
 }
@@ -55,13 +98,20 @@ bool StGLTextureQueue::push(const StImage&     theSrcDataLeft,
                             const StHandle<StStereoParams>& theStParams,
                             const StFormat     theSrcFormat,
                             const StCubemap    theSrcCubemap,
-                            const double       theSrcPTS) {
+                            const double       theSrcPTS,
+                            const StFrameStamps* theSrcStamps) {
     if(isFull()) {
         return false;
     }
 
-    myMutexPush.lock();
-    myDataBack = isEmpty() ? myDataFront : myDataBack->getNext();
+    // retire the snapshot pointer to the free item before checking the hazard,
+    // so that getSnapshot() could not start copying it after the check
+    StAtomicOp::CompareAndSwapPtr(myDataSnap, myDataBack, (StGLTextureData* )NULL);
+    StAtomicOp::Barrier();
+    if(myDataSnapUsed == myDataBack) {
+        // the item is being copied by getSnapshot()
+        return false;
+    }
 
     myDataBack->updateData(myDeviceCaps,
                            theSrcDataLeft,
@@ -70,54 +120,154 @@ bool StGLTextureQueue::push(const StImage&     theSrcDataLeft,
                            theSrcFormat,
                            theSrcCubemap,
                            theSrcPTS);
-    myMutexSrcFormat.lock();
-        myCurrSrcFormat = myDataBack->getSourceFormat();
-    myMutexSrcFormat.unlock();
-
-    myMutexSize.lock();
-        ++myQueueSize;
-    myMutexSize.unlock();
-    myMutexPush.unlock();
+    if(theSrcStamps != NULL) {
+        myDataBack->changeStamps() = *theSrcStamps;
+    } else {
+        myDataBack->changeStamps().reset();
+    }
+    myDataBack->changeStamps().Pushed = StFrameStamps::now();
+    if(myDataBack->getUnpackSizeHint() > myUnpackSizeHint) {
+        myUnpackSizeHint = myDataBack->getUnpackSizeHint();
+    }
+    myCurrSrcFormat = myDataBack->getSourceFormat();
+    myDataBack = myDataBack->getNext();
+
+    // publish the frame
+    StAtomicOp::Barrier();
+    myPushCounter = myPushCounter + 1;
     return true;
 }
 
+bool StGLTextureQueue::popPTSNext(double& thePts) const {
+    for(unsigned int aSpinIter = 0;; ++aSpinIter) {
+        if(aSpinIter >= 64) {
+            // GL thread might be preempted in the middle of modification
+            StThread::yield();
+        }
+
+        const uint32_t aFrontSeq = myFrontSeq;
+        if((aFrontSeq & 1) != 0) {
+            // front is being modified by GL thread right now
+            continue;
+        }
+
+        StAtomicOp::Barrier();
+        StGLTextureData* aFront     = myDataFront;
+        const uint32_t   aPopCount  = myPopCounter;
+        const uint32_t   aPushCount = myPushCounter;
+        const uint32_t   aDropCount = myDropCounter;
+        uint32_t aFirst = aPopCount;
+        if(int32_t(aDropCount - aFirst) > 0) {
+            aFirst = aDropCount;
+        }
+        if(int32_t(aPushCount - aFirst) <= 0) {
+            return false;
+        }
+
+        // make sure front data is valid
+        StAtomicOp::Barrier();
+        for(uint32_t anIter = aPopCount; anIter != aFirst; ++anIter) {
+            aFront = aFront->getNext();
+        }
+        const double aPts = aFront->getPTS();
+
+        // front might be popped by GL thread in the meantime
+        StAtomicOp::Barrier();
+        if(myFrontSeq == aFrontSeq) {
+            thePts = aPts;
+            return true;
+        }
+    }
+}
+
+bool StGLTextureQueue::stglSwapFB(const size_t theLimit) {
+    for(;;) {
+        const int32_t aCount = mySwapFBCount;
+        if(theLimit != 0 && size_t(aCount) >= theLimit) {
+            return false;
+        }
+        if(StAtomicOp::CompareAndSwap(mySwapFBCount, aCount, aCount + 1)) {
+            return true;
+        }
+    }
+}
+
 int StGLTextureQueue::swapFBOnReady(StGLContext& theCtx) {
     if(!myIsReadyToSwap) {
         return SWAPONREADY_NOTHING;
     }
 
-    mySwapFBMutex.lock();
-    if(mySwapFBCount != 0) {
-        myIsReadyToSwap = false;
-        --mySwapFBCount;
-        mySwapFBMutex.unlock();
+    for(;;) {
+        const int32_t aCount = mySwapFBCount;
+        if(aCount <= 0) {
+            return SWAPONREADY_WAITLIM;
+        }
+        if(StAtomicOp::CompareAndSwap(mySwapFBCount, aCount, aCount - 1)) {
+            break;
+        }
+    }
+
+    myIsReadyToSwap = false;
+    myQTexture.swapFB();
+    if(myToCompress) {
+        myQTexture.getBack(StGLQuadTexture::LEFT_TEXTURE ).release(theCtx);
+        myQTexture.getBack(StGLQuadTexture::RIGHT_TEXTURE).release(theCtx);
+    }
 
-        myQTexture.swapFB();
-        if(myToCompress) {
-            myQTexture.getBack(StGLQuadTexture::LEFT_TEXTURE ).release(theCtx);
-            myQTexture.getBack(StGLQuadTexture::RIGHT_TEXTURE).release(theCtx);
+    ++myFPSMeter;
+    if(myStampsBack.Pushed > 0.0) {
+        myStampsBack.Shown = StFrameStamps::now();
+        myLatency.addFrame(myStampsBack);
+        myStampsBack.reset();
+    }
+    return SWAPONREADY_SWAPPED;
+}
+
+void StGLTextureQueue::skipDropped() {
+    const uint32_t aClearCount = myClearCounter;
+    if(aClearCount != myClearCounterGL) {
+        myClearCounterGL = aClearCount;
+        StGLTextureData* aSnap = myDataSnap;
+        if(aSnap != NULL) {
+            aSnap->resetStParams();
         }
+        myDataSnap      = NULL;
+        myIsReadyToSwap = false; // invalidate currently uploaded image in back buffer
+        myStampsBack.reset();
+        myIsInUpdTexture = false;
+    }
 
-        myMeterMutex.lock();
-            ++myFPSMeter;
-        myMeterMutex.unlock();
-        return SWAPONREADY_SWAPPED;
-    } else {
-        mySwapFBMutex.unlock();
-        return SWAPONREADY_WAITLIM;
+    const uint32_t aDropCount = myDropCounter;
+    uint32_t       aPopCount  = myPopCounter;
+    if(int32_t(aDropCount - aPopCount) <= 0) {
+        return;
     }
+
+    // decrease StStereoSource counters
+    StGLTextureData* aFront = myDataFront;
+    for(; aPopCount != aDropCount; ++aPopCount) {
+        aFront->resetStParams();
+        aFront = aFront->getNext();
+    }
+    StAtomicOp::Increment(myFrontSeq);
+    myDataFront  = aFront;
+    myPopCounter = aPopCount;
+    StAtomicOp::Increment(myFrontSeq);
+
+    // empty texture update sequence
+    myIsInUpdTexture = false;
 }
 
 // this function called ONLY from plugin thread
 bool StGLTextureQueue::stglUpdateStTextures(StGLContext& theCtx) {
+    skipDropped();
+
     int aSwapState = swapFBOnReady(theCtx);
     if(aSwapState == SWAPONREADY_WAITLIM) {
         return false;
     }
 
-    if(!myMutexPop.tryLock()) {
-        return aSwapState == SWAPONREADY_SWAPPED;
-    }
+    stglMapUnpackBuffers(theCtx);
 
     // do we already in update cycle?
     if(!myIsInUpdTexture) {
@@ -132,26 +282,39 @@ bool StGLTextureQueue::stglUpdateStTextures(StGLContext& theCtx) {
 
     // still nothing to update? so return
     if(!myIsInUpdTexture) {
-        myMutexPop.unlock();
         return aSwapState == SWAPONREADY_SWAPPED;
     }
 
+    StAtomicOp::Barrier();
+    StGLTextureData* aFront = myDataFront;
+    if(aFront->getStamps().UploadStart <= 0.0) {
+        aFront->changeStamps().UploadStart = StFrameStamps::now();
+    }
     if(!theCtx.isBound()
-    || myDataFront->fillTexture(theCtx, myQTexture)) {
-        myIsReadyToSwap = true;
-        myMutexSize.lock();
-            myCurrPts   = myDataFront->getPTS();
-            myDataSnap  = myDataFront; myNewShotEvent.set();
-            if(myToCompress) {
-                myDataFront->reset();
-            }
-            myDataFront = myDataFront->getNext();
-            ST_ASSERT(myQueueSize != 0, "StGLTextureQueue::stglUpdateStTextures() - critical error!");
-            --myQueueSize;
-        myMutexSize.unlock();
+    || aFront->fillTexture(theCtx, myQTexture)) {
+        const uint32_t aPopCount = myPopCounter;
+        StAtomicOp::Barrier();
+        const bool isDropped = int32_t(myDropCounter - aPopCount) > 0;
+        if(!isDropped) {
+            // frame might be dropped by clear() while uploading
+            myIsReadyToSwap = true;
+            myCurrPts = aFront->getPTS();
+            myStampsBack = aFront->getStamps();
+            myStampsBack.Uploaded = StFrameStamps::now();
+        }
+        if(myToCompress) {
+            aFront->reset();
+        }
+        myDataSnap  = aFront;
+        StAtomicOp::Increment(myFrontSeq);
+        myDataFront  = aFront->getNext();
+        myPopCounter = aPopCount + 1;
+        StAtomicOp::Increment(myFrontSeq);
+        if(!isDropped) {
+            myShotCounter = myShotCounter + 1;
+        }
         myIsInUpdTexture = false;
     }
-    myMutexPop.unlock();
 
     // try early swap
     const bool isAlreadySwapped = (aSwapState == SWAPONREADY_SWAPPED);
@@ -160,71 +323,72 @@ bool StGLTextureQueue::stglUpdateStTextures(StGLContext& theCtx) {
 }
 
 void StGLTextureQueue::clear() {
-    myMutexPop.lock();
-    myMutexPush.lock();
-    myMutexSize.lock();
-    mySwapFBMutex.lock();
-        // decrease StStereoSource counters
-        StGLTextureData* anIterFront = myDataFront;
-        for(size_t i = 0; i < myQueueSize; ++i, anIterFront = anIterFront->getNext()) {
-            anIterFront->resetStParams();
-        }
-        // reset queue
-        myQueueSize     = 0;
-        myDataBack      = myDataFront;
-        if(myDataSnap != NULL) {
-            myDataSnap->resetStParams();
+    // request GL thread skipping all pushed frames
+    for(;;) {
+        const uint32_t aDropCount = myDropCounter;
+        const uint32_t aPushCount = myPushCounter;
+        if(int32_t(aPushCount - aDropCount) <= 0
+        || StAtomicOp::CompareAndSwap(myDropCounter, aDropCount, aPushCount)) {
+            break;
         }
-        myDataSnap      = NULL;
-        mySwapFBCount   = 0;
-        myIsReadyToSwap = false; // invalidate currently uploaded image in back buffer
-        // empty texture update sequence
-        myIsInUpdTexture = false;
-    mySwapFBMutex.unlock();
-    myMutexSize.unlock();
-    myMutexPush.unlock();
-    myMutexPop.unlock();
+    }
+    StAtomicOp::Increment(myClearCounter);
+
+    for(;;) {
+        const int32_t aCount = mySwapFBCount;
+        if(StAtomicOp::CompareAndSwap(mySwapFBCount, aCount, 0)) {
+            break;
+        }
+    }
 }
 
 void StGLTextureQueue::drop(const size_t theCount) {
-    myMutexPop.lock();
-    myMutexPush.lock();
-    myMutexSize.lock();
-        if(myQueueSize < 2) {
+    for(;;) {
+        const uint32_t aDropCount = myDropCounter;
+        const uint32_t aPushCount = myPushCounter;
+        uint32_t aFirst = myPopCounter;
+        if(int32_t(aDropCount - aFirst) > 0) {
+            aFirst = aDropCount;
+        }
+        const size_t aQueueSize = int32_t(aPushCount - aFirst) > 0 ? size_t(aPushCount - aFirst) : 0;
+        if(aQueueSize < 2) {
             // to small queue
-            myMutexSize.unlock();
-            myMutexPush.unlock();
-            myMutexPop.unlock();
             return;
         }
-        size_t decr = (theCount < myQueueSize) ? theCount : (myQueueSize - 1);
 
-        // decrease StStereoSource counters
-        for(size_t i = 0; i < decr; ++i, myDataFront = myDataFront->getNext()) {
-            myDataFront->resetStParams();
+        const size_t aDecr = (theCount < aQueueSize) ? theCount : (aQueueSize - 1);
+        if(StAtomicOp::CompareAndSwap(myDropCounter, aDropCount, aFirst + uint32_t(aDecr))) {
+            return;
         }
-        // reset queue
-        myQueueSize -= decr;
-        // empty texture update sequence
-        myIsInUpdTexture = false;
-    myMutexSize.unlock();
-    myMutexPush.unlock();
-    myMutexPop.unlock();
+    }
 }
 
 int StGLTextureQueue::getSnapshot(StImage* theOutDataLeft,
                                   StImage* theOutDataRight,
                                   bool     theToForce) {
-    if(!myNewShotEvent.check() && !theToForce) {
+    StMutexAuto aLock(myMutexSnap);
+    const uint32_t aShotCount = myShotCounter;
+    if(aShotCount == myShotCounterCopy && !theToForce) {
         return SNAPSHOT_NO_NEW;
     }
-    myMutexPop.lock();
-    if(myDataSnap == NULL) {
-        myMutexPop.unlock();
+
+    // mark the item as used, so that push() would not override it while copying
+    StGLTextureData* aSnap = NULL;
+    for(;;) {
+        aSnap = myDataSnap;
+        myDataSnapUsed = aSnap;
+        StAtomicOp::Barrier();
+        if(myDataSnap == aSnap) {
+            break;
+        }
+    }
+    if(aSnap == NULL) {
         return SNAPSHOT_NO_NEW;
     }
-    myDataSnap->getCopy(theOutDataLeft, theOutDataRight);
-    myNewShotEvent.reset();
-    myMutexPop.unlock();
+
+    aSnap->getCopy(theOutDataLeft, theOutDataRight);
+    StAtomicOp::Barrier();
+    myDataSnapUsed = NULL;
+    myShotCounterCopy = aShotCount;
     return SNAPSHOT_SUCCESS;
 }
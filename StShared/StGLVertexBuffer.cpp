@@ -1,5 +1,5 @@
 /**
- * Copyright © 2010-2015 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2010-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -127,6 +127,23 @@ void StGLVertexBuffer::setData(StGLContext&   theCtx,
     myDataType = GL_FLOAT;
 }
 
+void StGLVertexBuffer::setSubData(StGLContext&   theCtx,
+                                  GLsizeiptr     theElemFrom,
+                                  GLsizeiptr     theElemsCount,
+                                  const GLfloat* theData) {
+    if(!isValid()
+    || myDataType != GL_FLOAT
+    || theElemFrom < 0
+    || theElemFrom + theElemsCount > myElemsCount) {
+        return;
+    }
+
+    theCtx.core20fwd->glBufferSubData(getTarget(),
+                                      theElemFrom   * myElemSize * sizeof(GLfloat),
+                                      theElemsCount * myElemSize * sizeof(GLfloat),
+                                      theData);
+}
+
 void StGLVertexBuffer::setData(StGLContext&   theCtx,
                                GLsizeiptr     theElemSize,
                                GLsizeiptr     theElemsCount,
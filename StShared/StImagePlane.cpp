@@ -1,5 +1,5 @@
 /**
- * Copyright © 2010-2015 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2010-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -26,6 +26,7 @@ StString StImagePlane::formatImgFormat(ImgFormat theImgFormat) {
         case ImgRGBAF:   return "ImgRGBAF";
         case ImgBGRAF:   return "ImgBGRAF";
         case ImgUV:      return "ImgUV";
+        case ImgUV16:    return "ImgUV16";
         case ImgUNKNOWN:
         default:         return "ImgUNKNOWN";
     }
@@ -86,6 +87,9 @@ void StImagePlane::setFormat(StImagePlane::ImgFormat thePixelFormat) {
         case ImgUV:
             mySizeBPP = 2;
             break;
+        case ImgUV16:
+            mySizeBPP = 4;
+            break;
         case ImgGray:
         default:
             mySizeBPP = 1;
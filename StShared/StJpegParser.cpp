@@ -1,5 +1,5 @@
 /**
- * Copyright © 2011-2015 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2011-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -166,7 +166,10 @@ bool StJpegParser::readFile(const StCString& theFilePath,
                             const int        theOpenedFd,
                             const size_t     theReadMax) {
     reset();
-    if(!StRawFile::readFile(theFilePath, theOpenedFd, theReadMax)) {
+    const bool isRead = theReadMax == 0
+                      ? mapFile(theFilePath, theOpenedFd)
+                      : StRawFile::readFile(theFilePath, theOpenedFd, theReadMax);
+    if(!isRead) {
         return false;
     }
 
@@ -465,13 +468,12 @@ bool StJpegParser::insertSection(const uint8_t   theMarker,
     const size_t aDiff    = size_t(theSectLen) + 2; // 2 bytes for marker
     const size_t aNewSize = myLength + aDiff;
     if(aNewSize > myBuffSize) {
-        myBuffSize = aNewSize + 256;
-        stUByte_t* aNewData = stMemAllocAligned<stUByte_t*>(myBuffSize);
+        const size_t aNewBuffSize = aNewSize + 256;
+        stUByte_t* aNewData = stMemAllocAligned<stUByte_t*>(aNewBuffSize);
         if(aNewData == NULL) {
             return false;
         }
         stMemCpy(aNewData, myBuffer, myLength);
-        stMemFreeAligned(myBuffer);
 
         // update pointers of image(s) data
         for(StHandle<StJpegParser::Image> anImg = myImages;
@@ -490,7 +492,9 @@ bool StJpegParser::insertSection(const uint8_t   theMarker,
             }
         }
 
-        myBuffer = aNewData;
+        freeBuffer(); // might be memory-mapped file
+        myBuffer   = aNewData;
+        myBuffSize = aNewBuffSize;
     }
     myLength = aNewSize;
 
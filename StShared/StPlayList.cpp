@@ -1,5 +1,5 @@
 /**
- * Copyright © 2009-2015 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2009-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -532,6 +532,34 @@ bool StPlayList::getCurrentFile(StHandle<StFileNode>&     theFileNode,
     return true;
 }
 
+bool StPlayList::getNeighbourFile(const int             theOffset,
+                                  StHandle<StFileNode>& theFileNode) {
+    theFileNode.nullify();
+    StMutexAuto anAutoLock(myMutex);
+    if(myCurrent == NULL
+    || theOffset == 0
+    || (myIsShuffle && myItemsCount >= 3)) {
+        return false;
+    }
+
+    StPlayItem* anItem = myCurrent;
+    for(int anIter = theOffset > 0 ? theOffset : -theOffset; anIter > 0 && anItem != NULL; --anIter) {
+        anItem = theOffset > 0 ? anItem->getNext() : anItem->getPrev();
+        if(anItem == NULL
+        && myIsLoopFlag) {
+            anItem = theOffset > 0 ? myFirst : myLast;
+        }
+    }
+    if(anItem == NULL
+    || anItem == myCurrent
+    || anItem->getFileNode() == NULL) {
+        return false;
+    }
+
+    theFileNode = anItem->getFileNode()->detach();
+    return true;
+}
+
 void StPlayList::addToNode(const StHandle<StFileNode>& theFileNode,
                            const StString&             thePathToAdd) {
     StString aPath = theFileNode->getPath();
@@ -775,6 +803,36 @@ void StPlayList::getSubList(StArrayList<StString>& theList,
     }
 }
 
+void StPlayList::getSubList(StArrayList<StString>& theList,
+                            StArrayList<StString>& thePaths,
+                            const size_t           theStart,
+                            const size_t           theEnd) const {
+    theList.clear();
+    thePaths.clear();
+    StMutexAuto anAutoLock(myMutex);
+
+    size_t anIter = 0;
+    StPlayItem* anItem = myFirst;
+    for(; anItem != NULL; anItem = anItem->getNext(), ++anIter) {
+        if(anIter == theStart) {
+            break;
+        }
+    }
+
+    if(anIter != theStart) {
+        return;
+    }
+
+    for(; anItem != NULL; anItem = anItem->getNext(), ++anIter) {
+        if(anIter == theEnd) {
+            break;
+        }
+
+        theList .add(anItem->getTitle());
+        thePaths.add(anItem->getPath());
+    }
+}
+
 namespace {
     ST_LOCAL bool stAreSameRecent(const StFileNode& theA,
                                   const StFileNode& theB) {
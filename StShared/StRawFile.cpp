@@ -1,5 +1,5 @@
 /**
- * Copyright © 2009-2014 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2009-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -16,6 +16,14 @@
 #include <fstream>
 #include <limits>
 
+#if !defined(_WIN32)
+    #include <fcntl.h>
+    #include <stdlib.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
 #if defined(_WIN32)
     #define ftell64(a)     _ftelli64(a)
     #define fseek64(a,b,c) _fseeki64(a,b,c)
@@ -28,6 +36,16 @@
     #undef max
 #endif
 
+namespace {
+
+    /**
+     * Zero bytes which should be readable after the end of the mapped file,
+     * as decoders might read input by machine words (see AV_INPUT_BUFFER_PADDING_SIZE).
+     */
+    static const size_t THE_MAP_PADDING = 64;
+
+}
+
 int StRawFile::avInterruptCallback(void* thePtr) {
     StRawFile* aRawFile = reinterpret_cast<StRawFile*>(thePtr);
     return aRawFile != NULL
@@ -42,7 +60,10 @@ StRawFile::StRawFile(const StCString& theFilePath,
   myFileHandle(NULL),
   myBuffer(NULL),
   myBuffSize(0),
-  myLength(0) {
+  myLength(0),
+  myMappedSize(0),
+  myMappedDev(0),
+  myMappedIno(0) {
     //
 }
 
@@ -61,11 +82,18 @@ bool StRawFile::openFile(StRawFile::ReadWrite theFlags,
         setSubPath(theFilePath);
     }
 
+    const char* aMode = "rb";
+    if(theFlags == StRawFile::WRITE) {
+        aMode = "wb";
+    } else if(theFlags == StRawFile::APPEND) {
+        aMode = "ab";
+    }
+
     if(theOpenedFd != -1) {
     #ifdef _WIN32
-        myFileHandle = ::_fdopen(theOpenedFd, (theFlags == StRawFile::WRITE) ?  "wb" :  "rb");
+        myFileHandle = ::_fdopen(theOpenedFd, aMode);
     #else
-        myFileHandle =  ::fdopen(theOpenedFd, (theFlags == StRawFile::WRITE) ?  "wb" :  "rb");
+        myFileHandle =  ::fdopen(theOpenedFd, aMode);
     #endif
         return myFileHandle != NULL;
     }
@@ -74,13 +102,19 @@ bool StRawFile::openFile(StRawFile::ReadWrite theFlags,
 #if(LIBAVFORMAT_VERSION_INT >= AV_VERSION_INT(53, 21, 0))
     if(StFileNode::isRemoteProtocolPath(aFilePath)
     && stAV::init()) {
+        if(theFlags == StRawFile::APPEND) {
+            // AVIO_FLAG_WRITE overwrites remote file
+            ST_ERROR_LOG("StRawFile, appending to remote file (" + aFilePath + ") is not supported");
+            return false;
+        }
+
         AVIOInterruptCB anInterruptCB;
         stMemZero(&anInterruptCB, sizeof(anInterruptCB));
         anInterruptCB.callback = &StRawFile::avInterruptCallback;
         anInterruptCB.opaque   = this;
         const int aResult = avio_open2(&myContextIO,
                                        aFilePath.toCString(),
-                                       (theFlags == StRawFile::WRITE) ? AVIO_FLAG_WRITE : AVIO_FLAG_READ,
+                                       (theFlags != StRawFile::READ) ? AVIO_FLAG_WRITE : AVIO_FLAG_READ,
                                        &anInterruptCB,
                                        NULL);
         if(aResult < 0) {
@@ -94,9 +128,15 @@ bool StRawFile::openFile(StRawFile::ReadWrite theFlags,
 #ifdef _WIN32
     StStringUtfWide aPathWide;
     aPathWide.fromUnicode(aFilePath);
-    myFileHandle = _wfopen(aPathWide.toCString(), (theFlags == StRawFile::WRITE) ? L"wb" : L"rb");
+    const wchar_t* aModeWide = L"rb";
+    if(theFlags == StRawFile::WRITE) {
+        aModeWide = L"wb";
+    } else if(theFlags == StRawFile::APPEND) {
+        aModeWide = L"ab";
+    }
+    myFileHandle = _wfopen(aPathWide.toCString(), aModeWide);
 #else
-    myFileHandle =   fopen(aFilePath.toCString(), (theFlags == StRawFile::WRITE) ?  "wb" :  "rb");
+    myFileHandle =   fopen(aFilePath.toCString(), aMode);
 #endif
 
     return myFileHandle != NULL;
@@ -114,7 +154,8 @@ void StRawFile::closeFile() {
 }
 
 void StRawFile::initBuffer(size_t theDataSize) {
-    if(myBuffSize >= theDataSize) {
+    if(myBuffSize >= theDataSize
+    && !isMapped()) {
         myBuffSize = theDataSize;
         return;
     }
@@ -125,6 +166,17 @@ void StRawFile::initBuffer(size_t theDataSize) {
 }
 
 void StRawFile::freeBuffer() {
+#if !defined(_WIN32)
+    if(isMapped()) {
+        ::munmap(myBuffer, myMappedSize);
+        myBuffer     = NULL;
+        myBuffSize   = 0;
+        myMappedSize = 0;
+        myMappedDev  = 0;
+        myMappedIno  = 0;
+        return;
+    }
+#endif
     stMemFreeAligned(myBuffer);
     myBuffer = NULL;
     myBuffSize = 0;
@@ -266,15 +318,120 @@ bool StRawFile::readFile(const StCString& theFilePath,
     return true;
 }
 
+bool StRawFile::mapFile(const StCString& theFilePath,
+                        const int        theOpenedFd) {
+#if defined(_WIN32)
+    return StRawFile::readFile(theFilePath, theOpenedFd);
+#else
+    freeBuffer();
+    closeFile();
+    if(!theFilePath.isEmpty()) {
+        setSubPath(theFilePath);
+    }
+
+    const StString aFilePath = getPath();
+    if(theOpenedFd == -1
+    && StFileNode::isRemoteProtocolPath(aFilePath)) {
+        return StRawFile::readFile(stCString(""));
+    }
+
+    const int aFd = theOpenedFd != -1 ? theOpenedFd : ::open(aFilePath.toCString(), O_RDONLY);
+    if(aFd == -1) {
+        return false;
+    }
+
+    // bytes after the end of file within the last page are filled by zeros
+    struct stat aStat;
+    const long aPageSize = ::sysconf(_SC_PAGESIZE);
+    void*      aData     = MAP_FAILED;
+    if(::fstat(aFd, &aStat) == 0
+    && S_ISREG(aStat.st_mode)
+    && aStat.st_size > 0
+    && aPageSize > 0
+    && uint64_t(aStat.st_size) <= uint64_t(std::numeric_limits<ptrdiff_t>::max())) {
+        const size_t aTail = size_t(aStat.st_size % aPageSize);
+        if(aTail != 0
+        && size_t(aPageSize) - aTail >= THE_MAP_PADDING) {
+            aData = ::mmap(NULL, size_t(aStat.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, aFd, 0);
+        }
+    }
+
+    if(aData == MAP_FAILED) {
+        // fallback to reading into the heap buffer
+        if(theOpenedFd != -1) {
+            ::lseek(aFd, 0, SEEK_SET);
+            return StRawFile::readFile(stCString(""), aFd);
+        }
+        ::close(aFd);
+        return StRawFile::readFile(stCString(""));
+    }
+    ::close(aFd);
+
+#ifdef MADV_SEQUENTIAL
+    ::madvise(aData, size_t(aStat.st_size), MADV_SEQUENTIAL);
+#endif
+    myBuffer     = (stUByte_t* )aData;
+    myBuffSize   = size_t(aStat.st_size);
+    myMappedSize = myBuffSize;
+    myMappedDev  = uint64_t(aStat.st_dev);
+    myMappedIno  = uint64_t(aStat.st_ino);
+    return true;
+#endif
+}
+
 bool StRawFile::saveFile(const StCString& theFilePath,
                          const int        theOpenedFd) {
-    if(!openFile(StRawFile::WRITE, theFilePath, theOpenedFd)) {
+    if(!theFilePath.isEmpty()) {
+        setSubPath(theFilePath);
+    }
+
+    const StString aFilePath = getPath();
+    StString aTargetPath;
+#if !defined(_WIN32)
+    // the buffer might be a view of the file being overwritten, so that truncating it would invalidate the view;
+    // write into temporary file and replace the original one afterwards
+    struct stat aStat;
+    if(isMapped()
+    && theOpenedFd == -1
+    && ::stat(aFilePath.toCString(), &aStat) == 0
+    && uint64_t(aStat.st_dev) == myMappedDev
+    && uint64_t(aStat.st_ino) == myMappedIno) {
+        // replace the file itself rather than the symbolic link pointing to it
+        char* aRealPath = ::realpath(aFilePath.toCString(), NULL);
+        if(aRealPath == NULL) {
+            return false;
+        }
+        aTargetPath = aRealPath;
+        ::free(aRealPath);
+    }
+#endif
+
+    const bool toReplace = !aTargetPath.isEmpty();
+    if(!openFile(StRawFile::WRITE, toReplace ? StCString(aTargetPath + ".tmp") : stCString(""), theOpenedFd)) {
         return false;
     }
 
     const size_t aSize = (myLength != 0) ? myLength : myBuffSize;
     bool isSuccess = writeFile() == aSize;
     closeFile();
+#if !defined(_WIN32)
+    if(toReplace) {
+        const StString aTmpPath = getPath();
+        setSubPath(aFilePath);
+        if(isSuccess) {
+            // preserve access mode and (when permitted) ownership of the original file
+            isSuccess = ::chmod(aTmpPath.toCString(), aStat.st_mode & 07777) == 0;
+            if(::chown(aTmpPath.toCString(), aStat.st_uid, aStat.st_gid) != 0) {
+                ST_DEBUG_LOG("StRawFile, unable to preserve ownership of '" + aFilePath + "'");
+            }
+        }
+        if(!isSuccess
+        || ::rename(aTmpPath.toCString(), aTargetPath.toCString()) != 0) {
+            StFileNode::removeFile(aTmpPath);
+            return false;
+        }
+    }
+#endif
     return isSuccess;
 }
 
@@ -0,0 +1,579 @@
+/**
+ * Copyright © 2017 Kirill Gavrilov <kirill@sview.ru>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file license-boost.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#include <StImage/StThumbnailCache.h>
+
+#include <StAV/StAVImage.h>
+#include <StFile/StFileNode.h>
+#include <StFile/StRawFile.h>
+#include <StImage/StJpegParser.h>
+#include <StStrings/StLogger.h>
+#include <StThreads/StTimer.h>
+
+#include <algorithm>
+
+namespace {
+
+    static const char     THE_DB_MAGIC[4]   = { 'S', 'V', 'T', 'H' };
+    static const uint32_t THE_DB_VERSION    = 1;
+    static const uint32_t THE_RECORD_MAGIC  = 0x52485453; // "STHR"
+    static const size_t   THE_QUEUE_MAX     = 256;
+    static const size_t   THE_READY_MAX     = 512;
+    static const size_t   THE_DB_SIZE_MAX   = 256 * 1024 * 1024;
+    static const size_t   THE_DB_DEAD_MIN   = 1024 * 1024;
+    static const size_t   THE_DATA_PADDING  = 64;
+
+    /**
+     * Header of the thumbnails database.
+     */
+    struct StThumbDbHeader {
+        char     Magic[4];
+        uint32_t Version;
+        uint32_t ThumbSize;
+        uint32_t Reserved;
+    };
+
+    /**
+     * Thumbnail record, followed by NULL-terminated UTF-8 path, JPEG data and zero padding to 8 bytes.
+     */
+    struct StThumbDbRecord {
+        uint32_t Magic;
+        uint32_t PathSize;
+        uint32_t DataSize;
+        uint32_t Reserved;
+        uint64_t FileSize;
+        int64_t  ModTime;
+        uint64_t Hash;
+    };
+
+    /**
+     * FNV-1a hash of the data.
+     */
+    static uint64_t hashBytes(const stUByte_t* theData,
+                              const size_t     theSize,
+                              uint64_t         theHash = 14695981039346656037ULL) {
+        for(size_t anIter = 0; anIter < theSize; ++anIter) {
+            theHash ^= uint64_t(theData[anIter]);
+            theHash *= 1099511628211ULL;
+        }
+        return theHash;
+    }
+
+    /**
+     * @return size of the record including padding
+     */
+    inline size_t getRecordSize(const StThumbDbRecord& theRecord) {
+        return (sizeof(StThumbDbRecord) + size_t(theRecord.PathSize) + size_t(theRecord.DataSize) + 7) & ~size_t(7);
+    }
+
+    /**
+     * Read the record header and validate its structure.
+     * The header is copied, since records written by concurrent process might be unaligned.
+     */
+    static bool readRecord(const StRawFile& theFile,
+                           const size_t     theOffset,
+                           StThumbDbRecord& theRecord) {
+        const size_t aFileSize = theFile.getSize();
+        if(theOffset + sizeof(StThumbDbRecord) > aFileSize) {
+            return false;
+        }
+
+        stMemCpy(&theRecord, theFile.getBuffer() + theOffset, sizeof(StThumbDbRecord));
+        if(theRecord.Magic    != THE_RECORD_MAGIC
+        || theRecord.PathSize == 0
+        || theOffset + getRecordSize(theRecord) > aFileSize) {
+            return false;
+        }
+        return theFile.getBuffer()[theOffset + sizeof(StThumbDbRecord) + theRecord.PathSize - 1] == '\0';
+    }
+
+    /**
+     * @return true if record content matches the hash
+     */
+    static bool checkRecord(const StRawFile&       theFile,
+                            const size_t           theOffset,
+                            const StThumbDbRecord& theRecord) {
+        const stUByte_t* aData = theFile.getBuffer() + theOffset + sizeof(StThumbDbRecord);
+        return hashBytes(aData, size_t(theRecord.PathSize) + size_t(theRecord.DataSize)) == theRecord.Hash;
+    }
+
+}
+
+SV_THREAD_FUNCTION StThumbnailCache::workerThread(void* theCache) {
+    StThumbnailCache* aCache = (StThumbnailCache* )theCache;
+    aCache->workerLoop();
+    return SV_THREAD_RETURN 0;
+}
+
+StThumbnailCache::StThumbnailCache(const StString& theCacheFolder,
+                                   const int       theNbThreads)
+: myEvent(false),
+  myDbSize(0),
+  myIsDbLoaded(false),
+  myNbProcessed(0),
+  myToQuit(false) {
+    if(!theCacheFolder.isEmpty()) {
+        myDbPath = theCacheFolder + "thumbnails.db";
+    }
+
+    // decoding is IO-bound in large part, but leave the cores to the main rendering and video playback
+    const int aNbThreads = theNbThreads > 0
+                         ? theNbThreads
+                         : stMax(stMin(StThread::countLogicalProcessors() / 2, 4), 1);
+    for(int aThreadIter = 0; aThreadIter < aNbThreads; ++aThreadIter) {
+        myThreads.push_back(new StThread(workerThread, (void* )this, "StThumbnailCache"));
+    }
+}
+
+StThumbnailCache::~StThumbnailCache() {
+    myToQuit = true;
+    myEvent.set();
+    for(size_t aThreadIter = 0; aThreadIter < myThreads.size(); ++aThreadIter) {
+        myThreads[aThreadIter]->wait();
+    }
+    myThreads.clear();
+}
+
+bool StThumbnailCache::find(const StString&    thePath,
+                            StHandle<StImage>& theImage) {
+    theImage.nullify();
+    if(StImageFile::guessImageType(thePath, StMIME()) == StImageFile::ST_TYPE_NONE) {
+        // not an image file
+        return true;
+    }
+
+    StMutexAuto aLock(myMutex);
+    std::map<StString, ReadyEntry>::iterator aReady = myReady.find(thePath);
+    if(aReady != myReady.end()) {
+        myReadyLru.splice(myReadyLru.begin(), myReadyLru, aReady->second.LruIter);
+        theImage = aReady->second.Image;
+        return true;
+    } else if(myInProgress.find(thePath) != myInProgress.end()) {
+        return false;
+    }
+
+    // the most recent request goes first, the oldest requests are dropped
+    std::deque<StString>::iterator aQueued = std::find(myQueue.begin(), myQueue.end(), thePath);
+    if(aQueued != myQueue.end()) {
+        myQueue.erase(aQueued);
+    }
+    myQueue.push_front(thePath);
+    if(myQueue.size() > THE_QUEUE_MAX) {
+        myQueue.pop_back();
+    }
+    myEvent.set();
+    return false;
+}
+
+bool StThumbnailCache::hasPendingRequests() const {
+    StMutexAuto aLock(myMutex);
+    return !myQueue.empty()
+        || !myInProgress.empty();
+}
+
+size_t StThumbnailCache::getNbEntries() const {
+    StMutexAuto aLock(myDbMutex);
+    return myDbIndex.size();
+}
+
+bool StThumbnailCache::mapDb() {
+    if(myDbFile.isNull()) {
+        myDbFile = new StRawFile(myDbPath);
+    }
+    if(!myDbFile->mapFile()) {
+        myDbFile.nullify();
+        return false;
+    }
+    return true;
+}
+
+void StThumbnailCache::loadDb() {
+    myIsDbLoaded = true;
+    myDbIndex.clear();
+    myDbSize = 0;
+    if(myDbPath.isEmpty()) {
+        return;
+    }
+
+    StTimer aTimer(true);
+    bool isValid = mapDb()
+                && myDbFile->getSize() >= sizeof(StThumbDbHeader);
+    if(isValid) {
+        const StThumbDbHeader* aHeader = (const StThumbDbHeader* )myDbFile->getBuffer();
+        isValid = stAreEqual(aHeader->Magic, THE_DB_MAGIC, sizeof(THE_DB_MAGIC))
+               && aHeader->Version   == THE_DB_VERSION
+               && aHeader->ThumbSize == THE_THUMB_SIZE;
+    }
+    if(!isValid) {
+        // create new database
+        myDbFile.nullify();
+        StRawFile aFile(myDbPath);
+        aFile.initBuffer(sizeof(StThumbDbHeader));
+        StThumbDbHeader* aHeader = (StThumbDbHeader* )aFile.changeBuffer();
+        stMemZero(aHeader, sizeof(StThumbDbHeader));
+        stMemCpy(aHeader->Magic, THE_DB_MAGIC, sizeof(THE_DB_MAGIC));
+        aHeader->Version   = THE_DB_VERSION;
+        aHeader->ThumbSize = THE_THUMB_SIZE;
+        if(!aFile.saveFile()) {
+            ST_ERROR_LOG(StString("StThumbnailCache, unable to create database '") + myDbPath + "'");
+            myDbPath.clear();
+            return;
+        }
+        myDbSize = sizeof(StThumbDbHeader);
+        return;
+    }
+
+    // the last record for the same path overrides previous ones
+    const size_t aFileSize = myDbFile->getSize();
+    size_t anOffset   = sizeof(StThumbDbHeader);
+    size_t aLiveSize  = 0;
+    bool   isBroken   = false;
+    while(anOffset < aFileSize) {
+        StThumbDbRecord aRecord;
+        if(!readRecord(*myDbFile, anOffset, aRecord)) {
+            isBroken = true;
+            break;
+        }
+
+        const StString aPath((const char* )myDbFile->getBuffer() + anOffset + sizeof(StThumbDbRecord));
+        const size_t   aRecSize = getRecordSize(aRecord);
+        DbEntry& anEntry = myDbIndex[aPath];
+        aLiveSize -= anEntry.RecSize;
+        anEntry.FileSize = aRecord.FileSize;
+        anEntry.ModTime  = aRecord.ModTime;
+        anEntry.Offset   = anOffset;
+        anEntry.DataSize = aRecord.DataSize;
+        anEntry.RecSize  = aRecSize;
+        aLiveSize += aRecSize;
+        anOffset  += aRecSize;
+    }
+    myDbSize = anOffset;
+
+    const size_t aDeadSize = myDbSize - sizeof(StThumbDbHeader) - aLiveSize;
+    if(myDbSize > THE_DB_SIZE_MAX) {
+        compactDb(THE_DB_SIZE_MAX / 2);
+    } else if(isBroken
+          || (aDeadSize > aLiveSize && aDeadSize > THE_DB_DEAD_MIN)) {
+        compactDb(THE_DB_SIZE_MAX);
+    }
+    ST_DEBUG_LOG(StString("StThumbnailCache, ") + myDbIndex.size() + " thumbnails loaded within "
+               + aTimer.getElapsedTimeInMilliSec() + " ms");
+}
+
+void StThumbnailCache::compactDb(const size_t theSizeLimit) {
+    // keep the most recent records
+    std::vector< std::pair<size_t, StString> > aRecords;
+    aRecords.reserve(myDbIndex.size());
+    for(std::map<StString, DbEntry>::const_iterator anIter = myDbIndex.begin(); anIter != myDbIndex.end(); ++anIter) {
+        aRecords.push_back(std::make_pair(anIter->second.Offset, anIter->first));
+    }
+    std::sort(aRecords.begin(), aRecords.end());
+
+    // skip corrupted records
+    std::vector<size_t> aKept;
+    size_t aNewSize = sizeof(StThumbDbHeader);
+    for(size_t aRecIter = aRecords.size(); aRecIter > 0; --aRecIter) {
+        const DbEntry& anEntry = myDbIndex[aRecords[aRecIter - 1].second];
+        if(aNewSize + anEntry.RecSize > theSizeLimit) {
+            break;
+        }
+
+        StThumbDbRecord aRecord;
+        if(readRecord (*myDbFile, anEntry.Offset, aRecord)
+        && checkRecord(*myDbFile, anEntry.Offset, aRecord)) {
+            aKept.push_back(aRecIter - 1);
+            aNewSize += anEntry.RecSize;
+        }
+    }
+
+    const StString aTmpPath = myDbPath + ".tmp";
+    StRawFile aFile(aTmpPath);
+    aFile.initBuffer(aNewSize);
+    stMemCpy(aFile.changeBuffer(), myDbFile->getBuffer(), sizeof(StThumbDbHeader));
+    std::map<StString, DbEntry> anIndex;
+    size_t anOffset = sizeof(StThumbDbHeader);
+    for(size_t aKeptIter = aKept.size(); aKeptIter > 0; --aKeptIter) {
+        const StString& aPath   = aRecords[aKept[aKeptIter - 1]].second;
+        const DbEntry&  anEntry = myDbIndex[aPath];
+        stMemCpy(aFile.changeBuffer() + anOffset, myDbFile->getBuffer() + anEntry.Offset, anEntry.RecSize);
+        DbEntry& aNewEntry = anIndex[aPath];
+        aNewEntry = anEntry;
+        aNewEntry.Offset = anOffset;
+        anOffset += anEntry.RecSize;
+    }
+    myDbFile.nullify();
+    if(!aFile.saveFile()) {
+        ST_ERROR_LOG(StString("StThumbnailCache, unable to write database '") + aTmpPath + "'");
+        mapDb();
+        return;
+    }
+
+    if(!StFileNode::moveFile(aTmpPath, myDbPath)) {
+        // target should be removed first on some systems
+        StFileNode::removeFile(myDbPath);
+        if(!StFileNode::moveFile(aTmpPath, myDbPath)) {
+            ST_ERROR_LOG(StString("StThumbnailCache, unable to replace database '") + myDbPath + "'");
+            StFileNode::removeFile(aTmpPath);
+            myDbIndex.clear();
+            myDbPath.clear();
+            return;
+        }
+    }
+
+    ST_DEBUG_LOG(StString("StThumbnailCache, database compacted from ") + myDbSize + " to " + anOffset + " bytes");
+    myDbIndex.swap(anIndex);
+    myDbSize = anOffset;
+    mapDb();
+}
+
+bool StThumbnailCache::findDb(const StString&         thePath,
+                              const uint64_t          theFileSize,
+                              const int64_t           theModTime,
+                              bool&                   theIsValid,
+                              std::vector<stUByte_t>& theData) {
+    theIsValid = false;
+    theData.clear();
+
+    StMutexAuto aLock(myDbMutex);
+    if(!myIsDbLoaded) {
+        loadDb();
+    }
+
+    std::map<StString, DbEntry>::const_iterator anIter = myDbIndex.find(thePath);
+    if(anIter == myDbIndex.end()
+    || anIter->second.FileSize != theFileSize
+    || anIter->second.ModTime  != theModTime) {
+        return false;
+    }
+
+    const DbEntry& anEntry = anIter->second;
+    if(myDbFile.isNull()
+    || anEntry.Offset + anEntry.RecSize > myDbFile->getSize()) {
+        // record has been appended after mapping
+        if(!mapDb()) {
+            return false;
+        }
+    }
+
+    // record might be overridden by concurrent process,
+    // and offset computed by appendDb() might point to a record of another file
+    StThumbDbRecord aRecord;
+    if(!readRecord(*myDbFile, anEntry.Offset, aRecord)
+    ||  aRecord.FileSize != theFileSize
+    ||  aRecord.ModTime  != theModTime
+    ||  aRecord.PathSize != uint32_t(thePath.getSize() + 1)
+    || !checkRecord(*myDbFile, anEntry.Offset, aRecord)) {
+        return false;
+    }
+
+    const stUByte_t* aPath = myDbFile->getBuffer() + anEntry.Offset + sizeof(StThumbDbRecord);
+    if(aPath[thePath.getSize()] != 0
+    || ::memcmp(aPath, thePath.toCString(), thePath.getSize()) != 0) {
+        return false;
+    }
+
+    theIsValid = aRecord.DataSize != 0;
+    if(theIsValid) {
+        const stUByte_t* aData = myDbFile->getBuffer() + anEntry.Offset + sizeof(StThumbDbRecord) + aRecord.PathSize;
+        theData.assign(aData, aData + aRecord.DataSize);
+    }
+    return true;
+}
+
+void StThumbnailCache::appendDb(const StString&  thePath,
+                                const uint64_t   theFileSize,
+                                const int64_t    theModTime,
+                                const stUByte_t* theData,
+                                const size_t     theDataSize) {
+    StThumbDbRecord aRecord;
+    stMemZero(&aRecord, sizeof(StThumbDbRecord));
+    aRecord.Magic    = THE_RECORD_MAGIC;
+    aRecord.PathSize = uint32_t(thePath.getSize() + 1);
+    aRecord.DataSize = uint32_t(theDataSize);
+    aRecord.FileSize = theFileSize;
+    aRecord.ModTime  = theModTime;
+
+    // prepare the whole record to write it by single call
+    const size_t aRecSize = getRecordSize(aRecord);
+    StRawFile aFile;
+    aFile.initBuffer(aRecSize);
+    stMemZero(aFile.changeBuffer(), aRecSize);
+    stUByte_t* aPathData = aFile.changeBuffer() + sizeof(StThumbDbRecord);
+    stMemCpy(aPathData, thePath.toCString(), thePath.getSize());
+    if(theDataSize != 0) {
+        stMemCpy(aPathData + aRecord.PathSize, theData, theDataSize);
+    }
+    aRecord.Hash = hashBytes(aPathData, size_t(aRecord.PathSize) + theDataSize);
+    stMemCpy(aFile.changeBuffer(), &aRecord, sizeof(StThumbDbRecord));
+
+    StMutexAuto aLock(myDbMutex);
+    if(!myIsDbLoaded) {
+        loadDb();
+    }
+    if(myDbPath.isEmpty()) {
+        return;
+    }
+
+    // the database might be extended by concurrent process
+    uint64_t aDbSize = 0;
+    int64_t  aDbTime = 0;
+    if(!StFileNode::getFileStat(myDbPath, aDbSize, aDbTime)
+    ||  aDbSize < sizeof(StThumbDbHeader)
+    ||  aDbSize + aRecSize > THE_DB_SIZE_MAX) {
+        return;
+    }
+
+    if(!aFile.openFile(StRawFile::APPEND, myDbPath)) {
+        return;
+    }
+    const size_t aNbWritten = aFile.writeFile();
+    aFile.closeFile();
+    if(aNbWritten != aRecSize) {
+        return;
+    }
+
+    DbEntry& anEntry = myDbIndex[thePath];
+    anEntry.FileSize = theFileSize;
+    anEntry.ModTime  = theModTime;
+    anEntry.Offset   = size_t(aDbSize);
+    anEntry.DataSize = theDataSize;
+    anEntry.RecSize  = aRecSize;
+    myDbSize = size_t(aDbSize) + aRecSize;
+}
+
+bool StThumbnailCache::generate(const StString&         thePath,
+                                std::vector<stUByte_t>& theData) {
+    theData.clear();
+    const StImageFile::ImageType anImgType = StImageFile::guessImageType(thePath, StMIME());
+    StAVImage anImageFile;
+    if(anImgType == StImageFile::ST_TYPE_NONE
+    || !anImageFile.loadExtra(thePath, anImgType, NULL, 0, false)
+    ||  anImageFile.isNull()) {
+        return false;
+    }
+
+    // downscale keeping aspect ratio, pixels of thumbnail are square
+    const double aRatio = double(anImageFile.getSizeX()) * double(anImageFile.getPixelRatio()) / double(anImageFile.getSizeY());
+    size_t aSizeX = THE_THUMB_SIZE;
+    size_t aSizeY = THE_THUMB_SIZE;
+    if(aRatio >= 1.0) {
+        aSizeY = stMax(size_t(double(THE_THUMB_SIZE) / aRatio + 0.5), size_t(2));
+    } else {
+        aSizeX = stMax(size_t(double(THE_THUMB_SIZE) * aRatio + 0.5), size_t(2));
+    }
+
+    StAVImage aThumb;
+    if(anImageFile.getSizeX() > aSizeX
+    || anImageFile.getSizeY() > aSizeY) {
+        StImage aScaled;
+        if(!aScaled.initTrashLimited(anImageFile, aSizeX, aSizeY)
+        || !StAVImage::resize(anImageFile, aScaled)
+        || !aThumb.initCopy(aScaled, false)) {
+            return false;
+        }
+    } else if(!aThumb.initCopy(anImageFile, false)) {
+        return false;
+    }
+    aThumb.setPixelRatio(1.0f);
+    anImageFile.close();
+
+    StJpegParser anEncoded;
+    if(!aThumb.encode(anEncoded, StImageFile::ST_TYPE_JPEG)
+    ||  anEncoded.getDataSize() == 0) {
+        ST_DEBUG_LOG(StString("StThumbnailCache, unable to encode thumbnail for '") + thePath + "': " + aThumb.getState());
+        return false;
+    }
+    theData.assign(anEncoded.getBuffer(), anEncoded.getBuffer() + anEncoded.getDataSize());
+    return true;
+}
+
+StHandle<StImage> StThumbnailCache::decode(const StString&               thePath,
+                                           const std::vector<stUByte_t>& theData) {
+    if(theData.empty()) {
+        return StHandle<StImage>();
+    }
+
+    // decoder might read input by machine words, so that the buffer should be padded
+    std::vector<stUByte_t> aBuffer(theData.size() + THE_DATA_PADDING, 0);
+    stMemCpy(&aBuffer.front(), &theData.front(), theData.size());
+
+    StAVImage anImageFile;
+    StHandle<StImage> anImage = new StImage();
+    if(!anImageFile.loadExtra(thePath, StImageFile::ST_TYPE_JPEG, &aBuffer.front(), int(theData.size()), true)
+    || !anImage->initCopy(anImageFile, false)) {
+        return StHandle<StImage>();
+    }
+    return anImage;
+}
+
+void StThumbnailCache::addReady(const StString&          thePath,
+                                const StHandle<StImage>& theImage) {
+    StMutexAuto aLock(myMutex);
+    myInProgress.erase(thePath);
+    std::map<StString, ReadyEntry>::iterator aReady = myReady.find(thePath);
+    if(aReady != myReady.end()) {
+        aReady->second.Image = theImage;
+        myReadyLru.splice(myReadyLru.begin(), myReadyLru, aReady->second.LruIter);
+    } else {
+        myReadyLru.push_front(thePath);
+        ReadyEntry& anEntry = myReady[thePath];
+        anEntry.Image   = theImage;
+        anEntry.LruIter = myReadyLru.begin();
+    }
+
+    while(myReadyLru.size() > THE_READY_MAX) {
+        myReady.erase(myReadyLru.back());
+        myReadyLru.pop_back();
+    }
+    ++myNbProcessed;
+}
+
+void StThumbnailCache::workerLoop() {
+    std::vector<stUByte_t> aData;
+    for(;;) {
+        myEvent.wait();
+        for(;;) {
+            if(myToQuit) {
+                return;
+            }
+
+            StString aPath;
+            {
+                StMutexAuto aLock(myMutex);
+                if(myQueue.empty()) {
+                    // reset within the lock, so that new request would not be missed
+                    myEvent.reset();
+                    if(myToQuit) {
+                        return;
+                    }
+                    break;
+                }
+                aPath = myQueue.front();
+                myQueue.pop_front();
+                myInProgress.insert(aPath);
+            }
+
+            StHandle<StImage> anImage;
+            uint64_t aFileSize = 0;
+            int64_t  aModTime  = 0;
+            if(StFileNode::getFileStat(aPath, aFileSize, aModTime)) {
+                bool isValid = false;
+                if(!findDb(aPath, aFileSize, aModTime, isValid, aData)) {
+                    isValid = generate(aPath, aData);
+                    appendDb(aPath, aFileSize, aModTime,
+                             isValid ? &aData.front() : NULL,
+                             isValid ? aData.size()   : 0);
+                }
+                if(isValid) {
+                    anImage = decode(aPath, aData);
+                }
+            }
+            addReady(aPath, anImage);
+        }
+    }
+}
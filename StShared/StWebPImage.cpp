@@ -1,5 +1,5 @@
 /**
- * Copyright © 2012 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2012-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -178,7 +178,7 @@ bool StWebPImage::loadExtra(const StString& theFilePath,
     // read file
     StRawFile aRawFile(theFilePath);
     if(theDataPtr == NULL || theDataSize == 0) {
-        if(!aRawFile.readFile()) {
+        if(!aRawFile.mapFile()) {
             setState("StWebPImage, could not read the file");
             close();
             return false;
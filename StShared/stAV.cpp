@@ -1,5 +1,5 @@
 /**
- * Copyright © 2011-2016 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2011-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -113,12 +113,17 @@ const AVPixelFormat stAV::PIX_FMT::YUV410P    = ST_AV_GETPIXFMT("yuv410p");
 const AVPixelFormat stAV::PIX_FMT::YUV411P    = ST_AV_GETPIXFMT("yuv411p");
 const AVPixelFormat stAV::PIX_FMT::YUV440P    = ST_AV_GETPIXFMT("yuv440p");
 const AVPixelFormat stAV::PIX_FMT::NV12       = ST_AV_GETPIXFMT("nv12");
+const AVPixelFormat stAV::PIX_FMT::P010       = ST_AV_GETPIXFMT("p010");
+const AVPixelFormat stAV::PIX_FMT::P016       = ST_AV_GETPIXFMT("p016");
 const AVPixelFormat stAV::PIX_FMT::YUV420P9   = ST_AV_GETPIXFMT("yuv420p9");
 const AVPixelFormat stAV::PIX_FMT::YUV422P9   = ST_AV_GETPIXFMT("yuv422p9");
 const AVPixelFormat stAV::PIX_FMT::YUV444P9   = ST_AV_GETPIXFMT("yuv444p9");
 const AVPixelFormat stAV::PIX_FMT::YUV420P10  = ST_AV_GETPIXFMT("yuv420p10");
 const AVPixelFormat stAV::PIX_FMT::YUV422P10  = ST_AV_GETPIXFMT("yuv422p10");
 const AVPixelFormat stAV::PIX_FMT::YUV444P10  = ST_AV_GETPIXFMT("yuv444p10");
+const AVPixelFormat stAV::PIX_FMT::YUV420P12  = ST_AV_GETPIXFMT("yuv420p12");
+const AVPixelFormat stAV::PIX_FMT::YUV422P12  = ST_AV_GETPIXFMT("yuv422p12");
+const AVPixelFormat stAV::PIX_FMT::YUV444P12  = ST_AV_GETPIXFMT("yuv444p12");
 const AVPixelFormat stAV::PIX_FMT::YUV420P16  = ST_AV_GETPIXFMT("yuv420p16");
 const AVPixelFormat stAV::PIX_FMT::YUV422P16  = ST_AV_GETPIXFMT("yuv422p16");
 const AVPixelFormat stAV::PIX_FMT::YUV444P16  = ST_AV_GETPIXFMT("yuv444p16");
@@ -182,6 +187,12 @@ StCString stAV::PIX_FMT::getString(const AVPixelFormat theFrmt) {
         return stCString("yuv422p10");
     } else if(theFrmt == stAV::PIX_FMT::YUV444P10) {
         return stCString("yuv444p10");
+    } else if(theFrmt == stAV::PIX_FMT::YUV420P12) {
+        return stCString("yuv420p12");
+    } else if(theFrmt == stAV::PIX_FMT::YUV422P12) {
+        return stCString("yuv422p12");
+    } else if(theFrmt == stAV::PIX_FMT::YUV444P12) {
+        return stCString("yuv444p12");
     } else if(theFrmt == stAV::PIX_FMT::YUV420P16) {
         return stCString("yuv420p16");
     } else if(theFrmt == stAV::PIX_FMT::YUV422P16) {
@@ -214,6 +225,10 @@ StCString stAV::PIX_FMT::getString(const AVPixelFormat theFrmt) {
         return stCString("bgra64");
     } else if(theFrmt == stAV::PIX_FMT::NV12) {
         return stCString("nv12");
+    } else if(theFrmt == stAV::PIX_FMT::P010) {
+        return stCString("p010");
+    } else if(theFrmt == stAV::PIX_FMT::P016) {
+        return stCString("p016");
     } else if(theFrmt == stAV::PIX_FMT::XYZ12) {
         return stCString("xyz12");
     } else if(theFrmt == stAV::PIX_FMT::DXVA2_VLD) {
@@ -316,6 +331,9 @@ bool stAV::isFormatYUVPlanar(const AVCodecContext* theCtx) {
         || theCtx->pix_fmt == stAV::PIX_FMT::YUV420P10
         || theCtx->pix_fmt == stAV::PIX_FMT::YUV422P10
         || theCtx->pix_fmt == stAV::PIX_FMT::YUV444P10
+        || theCtx->pix_fmt == stAV::PIX_FMT::YUV420P12
+        || theCtx->pix_fmt == stAV::PIX_FMT::YUV422P12
+        || theCtx->pix_fmt == stAV::PIX_FMT::YUV444P12
         || theCtx->pix_fmt == stAV::PIX_FMT::YUV420P16
         || theCtx->pix_fmt == stAV::PIX_FMT::YUV422P16
         || theCtx->pix_fmt == stAV::PIX_FMT::YUV444P16;
@@ -331,6 +349,7 @@ bool stAV::isFormatYUVPlanar(const AVPixelFormat thePixFmt,
            || thePixFmt == stAV::PIX_FMT::YUVJ420P
            || thePixFmt == stAV::PIX_FMT::YUV420P9
            || thePixFmt == stAV::PIX_FMT::YUV420P10
+           || thePixFmt == stAV::PIX_FMT::YUV420P12
            || thePixFmt == stAV::PIX_FMT::YUV420P16) {
         theDims.widthY  = theWidth;
         theDims.heightY = theHeight;
@@ -341,6 +360,7 @@ bool stAV::isFormatYUVPlanar(const AVPixelFormat thePixFmt,
            || thePixFmt == stAV::PIX_FMT::YUVJ422P
            || thePixFmt == stAV::PIX_FMT::YUV422P9
            || thePixFmt == stAV::PIX_FMT::YUV422P10
+           || thePixFmt == stAV::PIX_FMT::YUV422P12
            || thePixFmt == stAV::PIX_FMT::YUV422P16) {
         theDims.widthY  = theWidth;
         theDims.heightY = theDims.heightU = theDims.heightV = theHeight;
@@ -350,6 +370,7 @@ bool stAV::isFormatYUVPlanar(const AVPixelFormat thePixFmt,
            || thePixFmt == stAV::PIX_FMT::YUVJ444P
            || thePixFmt == stAV::PIX_FMT::YUV444P9
            || thePixFmt == stAV::PIX_FMT::YUV444P10
+           || thePixFmt == stAV::PIX_FMT::YUV444P12
            || thePixFmt == stAV::PIX_FMT::YUV444P16) {
         theDims.widthY  = theDims.widthU  = theDims.widthV  = theWidth;
         theDims.heightY = theDims.heightU = theDims.heightV = theHeight;
@@ -383,6 +404,10 @@ bool stAV::isFormatYUVPlanar(const AVPixelFormat thePixFmt,
            || thePixFmt == stAV::PIX_FMT::YUV422P10
            || thePixFmt == stAV::PIX_FMT::YUV444P10) {
         theDims.bitsPerComp = 10;
+    } else if(thePixFmt == stAV::PIX_FMT::YUV420P12
+           || thePixFmt == stAV::PIX_FMT::YUV422P12
+           || thePixFmt == stAV::PIX_FMT::YUV444P12) {
+        theDims.bitsPerComp = 12;
     } else if(thePixFmt == stAV::PIX_FMT::YUV420P16
            || thePixFmt == stAV::PIX_FMT::YUV422P16
            || thePixFmt == stAV::PIX_FMT::YUV444P16) {
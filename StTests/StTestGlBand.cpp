@@ -1,5 +1,5 @@
 /**
- * Copyright © 2011-2013 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2011-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * StTests program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -20,6 +20,8 @@
 
 #include <StCore/StWindow.h>
 
+#include <StGL/StGLAsyncReadback.h>
+#include <StGL/StGLFrameBuffer.h>
 #include <StGL/StGLTexture.h>
 #include <StGL/StGLContext.h>
 #include <StGLCore/StGLCore20.h>
@@ -34,6 +36,44 @@ namespace {
     static const size_t TEST_ITERATIONS   = 100;
     static const double TEST_ITERATIONS_F = 100.0;
 
+    /**
+     * Colors of the left and right halves of frames rendered by readback test.
+     */
+    static const GLubyte TEST_READBACK_COLORS[3][2][4] = {
+        { { 255,   0,   0, 255 }, {   0, 255,   0, 255 } },
+        { {   0,   0, 255, 255 }, { 255, 255,   0, 255 } },
+        { { 255, 255, 255, 255 }, {   0,   0,   0, 255 } },
+    };
+
+    /**
+     * Check that the frame read back by StGLAsyncReadback has expected colors.
+     */
+    static bool checkReadbackFrame(const GLubyte* theData,
+                                   const size_t   theRowBytes,
+                                   const GLsizei  theSizeX,
+                                   const GLsizei  theSizeY,
+                                   const size_t   theFrameIter) {
+        if(theData == NULL) {
+            return false;
+        }
+
+        for(GLsizei aRowIter = 0; aRowIter < theSizeY; ++aRowIter) {
+            const GLubyte* aRow = theData + size_t(aRowIter) * theRowBytes;
+            for(GLsizei aColIter = 0; aColIter < theSizeX; ++aColIter) {
+                const GLubyte* aColor = TEST_READBACK_COLORS[theFrameIter][aColIter < theSizeX / 2 ? 0 : 1];
+                const GLubyte* aPixel = aRow + size_t(aColIter) * 4;
+                if(aPixel[0] != aColor[0]
+                || aPixel[1] != aColor[1]
+                || aPixel[2] != aColor[2]) {
+                    st::cout << stostream_text("  unexpected pixel (") << aColIter << stostream_text(", ") << aRowIter
+                             << stostream_text(") in frame #") << theFrameIter << stostream_text("\n");
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
 };
 
 void StTestGlBand::testTextureFill(StGLContext&  theCtx,
@@ -132,6 +172,71 @@ void StTestGlBand::testFrameCopyRAM(const GLsizei theFrameSizeX,
     st::cout << stostream_text("  fill FPS:  \t") << (TEST_ITERATIONS_F / aTimeAllSec)  << stostream_text("\n");
 }
 
+bool StTestGlBand::testFboReadback(StGLContext&  theCtx,
+                                   const GLsizei theFrameSizeX,
+                                   const GLsizei theFrameSizeY) {
+    st::cout << stostream_text("Asynchronous FBO readback ") << theFrameSizeX << stostream_text(" x ") << theFrameSizeY << stostream_text("\n");
+    if(!StGLAsyncReadback::isSupported(theCtx)) {
+        st::cout << stostream_text("  skipped, PBO is not supported\n");
+        return true;
+    }
+
+    StGLFrameBuffer aFbo;
+    if(!aFbo.init(theCtx, GL_RGBA8, theFrameSizeX, theFrameSizeY, false)) {
+        st::cout << stostream_text("  FAILED to create FBO\n");
+        aFbo.release(theCtx);
+        return false;
+    }
+
+    StGLAsyncReadback aReadback(2);
+    const GLsizei aHalfX  = theFrameSizeX / 2;
+    size_t        aNbRead = 0;
+    bool          isOk    = true;
+    aFbo.setupViewPort(theCtx);
+    for(size_t aFrameIter = 0; aFrameIter < 3 && isOk; ++aFrameIter) {
+        // render the frame into offscreen buffer - left and right halves with different colors
+        const GLubyte* aColorL = TEST_READBACK_COLORS[aFrameIter][0];
+        const GLubyte* aColorR = TEST_READBACK_COLORS[aFrameIter][1];
+        aFbo.bindBuffer(theCtx);
+        theCtx.core11fwd->glClearColor(aColorL[0] / 255.0f, aColorL[1] / 255.0f, aColorL[2] / 255.0f, 1.0f);
+        theCtx.core11fwd->glClear(GL_COLOR_BUFFER_BIT);
+        theCtx.core11fwd->glEnable(GL_SCISSOR_TEST);
+        theCtx.core11fwd->glScissor(aHalfX, 0, theFrameSizeX - aHalfX, theFrameSizeY);
+        theCtx.core11fwd->glClearColor(aColorR[0] / 255.0f, aColorR[1] / 255.0f, aColorR[2] / 255.0f, 1.0f);
+        theCtx.core11fwd->glClear(GL_COLOR_BUFFER_BIT);
+        theCtx.core11fwd->glDisable(GL_SCISSOR_TEST);
+        aFbo.unbindBuffer(theCtx);
+
+        if(!aFbo.readPixelsAsync(theCtx, aReadback, GL_RGBA, GL_UNSIGNED_BYTE)) {
+            st::cout << stostream_text("  FAILED to initiate readback\n");
+            isOk = false;
+            break;
+        }
+
+        // retrieve the previous frame only when the ring is full, as application would do
+        if(aReadback.isFull()) {
+            isOk = aReadback.getOldestSizeX() == theFrameSizeX
+                && aReadback.getOldestSizeY() == theFrameSizeY
+                && checkReadbackFrame(aReadback.mapOldest(theCtx), aReadback.getOldestRowBytes(), theFrameSizeX, theFrameSizeY, aNbRead);
+            aReadback.unmapOldest(theCtx);
+            ++aNbRead;
+        }
+    }
+
+    // retrieve remaining frames
+    while(isOk && aReadback.getNbPending() != 0) {
+        isOk = checkReadbackFrame(aReadback.mapOldest(theCtx), aReadback.getOldestRowBytes(), theFrameSizeX, theFrameSizeY, aNbRead);
+        aReadback.unmapOldest(theCtx);
+        ++aNbRead;
+    }
+    isOk = isOk && aNbRead == 3;
+    st::cout << (isOk ? stostream_text("  passed\n") : stostream_text("  FAILED\n"));
+
+    aReadback.release(theCtx);
+    aFbo.release(theCtx);
+    return isOk;
+}
+
 void StTestGlBand::perform() {
     // create the window
     StHandle<StWindow> aWin = new StWindow();
@@ -154,6 +259,7 @@ void StTestGlBand::perform() {
     testTextureFill(aCtx, aFrameSizeX, aFrameSizeY);
     testTextureRead(aCtx, aFrameSizeX, aFrameSizeY);
     testFrameCopyRAM(aFrameSizeX, aFrameSizeY);
+    testFboReadback(aCtx, 640, 480);
 
     // close the window
     aWin.nullify();
@@ -1,5 +1,5 @@
 /**
- * Copyright © 2011-2012 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2011-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * StTests program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -45,6 +45,15 @@ class ST_LOCAL StTestGlBand : public StTest {
     void testFrameCopyRAM(const GLsizei theFrameSizeX,
                           const GLsizei theFrameSizeY);
 
+    /**
+     * Render into offscreen FBO and read it back through StGLAsyncReadback ring,
+     * checking that frames are retrieved in order with expected pixels.
+     * @return true if test has passed
+     */
+    bool testFboReadback(StGLContext&  theCtx,
+                         const GLsizei theFrameSizeX,
+                         const GLsizei theFrameSizeY);
+
 };
 
 #endif // __StTestGlBand_h_
@@ -0,0 +1,344 @@
+/**
+ * Copyright © 2017 Kirill Gavrilov <kirill@sview.ru>
+ *
+ * StTests program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * StTests program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "StTestVideoBench.h"
+
+#include <StAV/StAVPacket.h>
+#include <StCore/StWindow.h>
+#include <StFile/StRawFile.h>
+#include <StGL/StGLContext.h>
+#include <StGLCore/StGLCore20.h>
+#include <StStrings/stConsole.h>
+#include <StThreads/StThread.h>
+
+#include <algorithm>
+
+namespace {
+
+    /**
+     * Size of texture queue, the same as used by movie player.
+     */
+    static const size_t THE_QUEUE_SIZE = 16;
+
+    /**
+     * Escape string for JSON output.
+     */
+    static StString jsonString(const StString& theString) {
+        return StString('\"')
+             + theString.replace(stCString("\\"), stCString("\\\\"))
+                        .replace(stCString("\""), stCString("\\\""))
+             + '\"';
+    }
+
+}
+
+StTestVideoBench::StTestVideoBench(const StString& theFile,
+                                   const StString& theJsonPath,
+                                   const size_t    theFramesMax,
+                                   const bool      theToUseGl)
+: myFilePath(theFile),
+  myJsonPath(theJsonPath),
+  myFramesMax(theFramesMax),
+  myToUseGl(theToUseGl),
+  mySizeX(0),
+  mySizeY(0) {
+    //
+}
+
+const char* StTestVideoBench::stageName(const Stage theStage) {
+    switch(theStage) {
+        case Stage_Demux:   return "demux";
+        case Stage_Decode:  return "decode";
+        case Stage_Convert: return "convert";
+        case Stage_Split:   return "split";
+        case Stage_Upload:  return "upload";
+        case StageNb:       break;
+    }
+    return "";
+}
+
+double StTestVideoBench::percentile(const std::vector<double>& theSorted,
+                                    const double               thePercent) {
+    if(theSorted.empty()) {
+        return 0.0;
+    }
+
+    // nearest rank
+    const size_t anIndex = size_t(thePercent * double(theSorted.size() - 1) + 0.5);
+    return theSorted[stMin(anIndex, theSorted.size() - 1)];
+}
+
+bool StTestVideoBench::prepareFrame(const AVCodecContext* theCodecCtx) {
+    AVPixelFormat aPixFmt = stAV::PIX_FMT::NONE;
+    myFrame.getImageInfo(theCodecCtx, mySizeX, mySizeY, aPixFmt);
+    myPixFmt = stAV::PIX_FMT::getString(aPixFmt);
+    myDataAdp.nullify();
+    myDataAdp.setColorScale(StImage::ImgScale_Full);
+
+    stAV::dimYUV aDimsYUV;
+    if(aPixFmt == stAV::PIX_FMT::RGB24) {
+        myDataAdp.setColorModel(StImage::ImgColor_RGB);
+        return myDataAdp.changePlane(0).initWrapper(StImagePlane::ImgRGB, myFrame.getPlane(0),
+                                                    size_t(mySizeX), size_t(mySizeY), myFrame.getLineSize(0));
+    } else if(stAV::isFormatYUVPlanar(aPixFmt, mySizeX, mySizeY, aDimsYUV)) {
+        const StImagePlane::ImgFormat aPlaneFrmt = aDimsYUV.bitsPerComp > 8
+                                                 ? StImagePlane::ImgGray16
+                                                 : StImagePlane::ImgGray;
+        myDataAdp.setColorModel(StImage::ImgColor_YUV);
+        myDataAdp.setColorScale(StImage::ImgScale_Mpeg);
+        return myDataAdp.changePlane(0).initWrapper(aPlaneFrmt, myFrame.getPlane(0),
+                                                    size_t(aDimsYUV.widthY), size_t(aDimsYUV.heightY), myFrame.getLineSize(0))
+            && myDataAdp.changePlane(1).initWrapper(aPlaneFrmt, myFrame.getPlane(1),
+                                                    size_t(aDimsYUV.widthU), size_t(aDimsYUV.heightU), myFrame.getLineSize(1))
+            && myDataAdp.changePlane(2).initWrapper(aPlaneFrmt, myFrame.getPlane(2),
+                                                    size_t(aDimsYUV.widthV), size_t(aDimsYUV.heightV), myFrame.getLineSize(2));
+    } else if(aPixFmt == stAV::PIX_FMT::NV12
+           || aPixFmt == stAV::PIX_FMT::P010
+           || aPixFmt == stAV::PIX_FMT::P016) {
+        const bool isWide = aPixFmt != stAV::PIX_FMT::NV12;
+        myDataAdp.setColorModel(StImage::ImgColor_YUV);
+        myDataAdp.setColorScale(StImage::ImgScale_NvMpeg);
+        return myDataAdp.changePlane(0).initWrapper(isWide ? StImagePlane::ImgGray16 : StImagePlane::ImgGray, myFrame.getPlane(0),
+                                                    size_t(mySizeX), size_t(mySizeY), myFrame.getLineSize(0))
+            && myDataAdp.changePlane(1).initWrapper(isWide ? StImagePlane::ImgUV16 : StImagePlane::ImgUV, myFrame.getPlane(1),
+                                                    size_t(mySizeX / 2), size_t(mySizeY / 2), myFrame.getLineSize(1));
+    }
+
+    // software conversion into RGB
+    if(!myToRgb.init(aPixFmt, stAV::PIX_FMT::RGB24, mySizeX, mySizeY)) {
+        return false;
+    }
+    if(myDataRGB.getSizeX() != size_t(mySizeX)
+    || myDataRGB.getSizeY() != size_t(mySizeY)) {
+        if(!myDataRGB.initTrash(StImagePlane::ImgRGB, size_t(mySizeX), size_t(mySizeY))) {
+            return false;
+        }
+    }
+
+    uint8_t* aDstData[4]     = { myDataRGB.changeData(), NULL, NULL, NULL };
+    int      aDstLineSize[4] = { (int )myDataRGB.getSizeRowBytes(), 0, 0, 0 };
+    myToRgb.convert(myFrame.Frame->data, myFrame.Frame->linesize, aDstData, aDstLineSize);
+    myDataAdp.setColorModel(StImage::ImgColor_RGB);
+    return myDataAdp.changePlane(0).initWrapper(StImagePlane::ImgRGB, myDataRGB.changeData(),
+                                                size_t(mySizeX), size_t(mySizeY), myDataRGB.getSizeRowBytes());
+}
+
+void StTestVideoBench::processFile(StGLContext& theCtx) {
+    AVFormatContext* aFormatCtx = NULL;
+    if(avformat_open_input(&aFormatCtx, myFilePath.toCString(), NULL, NULL) != 0) {
+        st::cout << stostream_text("  file can not be opened.\n");
+        return;
+    }
+    if(avformat_find_stream_info(aFormatCtx, NULL) < 0) {
+        st::cout << stostream_text("  stream info can not be retrieved.\n");
+        avformat_close_input(&aFormatCtx);
+        return;
+    }
+
+    int aStreamId = -1;
+    for(unsigned int aStreamIter = 0; aStreamIter < aFormatCtx->nb_streams; ++aStreamIter) {
+        const AVStream* aStream = aFormatCtx->streams[aStreamIter];
+        if(stAV::getCodecType(aStream) == AVMEDIA_TYPE_VIDEO
+        && !stAV::isAttachedPicture(aStream)) {
+            aStreamId = int(aStreamIter);
+            break;
+        }
+    }
+    if(aStreamId < 0) {
+        st::cout << stostream_text("  file has no video streams.\n");
+        avformat_close_input(&aFormatCtx);
+        return;
+    }
+
+    AVCodecContext* aCodecCtx = stAV::getCodecCtx(aFormatCtx->streams[aStreamId]);
+    AVCodec*        aCodec    = avcodec_find_decoder(aCodecCtx->codec_id);
+    aCodecCtx->thread_count   = StThread::countLogicalProcessors();
+    if(aCodec == NULL
+    || avcodec_open2(aCodecCtx, aCodec, NULL) < 0) {
+        st::cout << stostream_text("  video decoder can not be opened.\n");
+        avformat_close_input(&aFormatCtx);
+        return;
+    }
+
+    StAVPacket aPacket;
+    StImage    anEmpty;
+    StTimer    aStageTimer;
+    double     aDemuxMSec  = 0.0;
+    double     aDecodeMSec = 0.0;
+    size_t     aNbFrames   = 0;
+    bool       isEof       = false;
+    myTimer.restart();
+    while(myFramesMax == 0 || aNbFrames < myFramesMax) {
+        if(!isEof) {
+            aStageTimer.restart();
+            isEof = av_read_frame(aFormatCtx, aPacket.getAVpkt()) < 0;
+            aDemuxMSec += aStageTimer.getElapsedTimeInMilliSec();
+            if(isEof) {
+                aPacket.free(); // empty packet flushes the decoder
+            } else if(aPacket.getStreamId() != aStreamId) {
+                aPacket.free();
+                continue;
+            }
+        }
+
+        int isFrameFinished = 0;
+        aStageTimer.restart();
+        avcodec_decode_video2(aCodecCtx, myFrame.Frame, &isFrameFinished, aPacket.getAVpkt());
+        aDecodeMSec += aStageTimer.getElapsedTimeInMilliSec();
+        aPacket.free();
+        if(isFrameFinished == 0) {
+            if(isEof) {
+                break;
+            }
+            continue;
+        }
+
+        aStageTimer.restart();
+        const bool isPrepared = prepareFrame(aCodecCtx);
+        const double aConvertMSec = aStageTimer.getElapsedTimeInMilliSec();
+        if(!isPrepared) {
+            st::cout << stostream_text("  frame with unsupported pixel format '") << myPixFmt << stostream_text("' skipped.\n");
+            continue;
+        }
+
+        aStageTimer.restart();
+        if(!myQueue->push(myDataAdp, anEmpty, myParams, StFormat_Mono, StCubemap_OFF, double(aNbFrames))) {
+            st::cout << stostream_text("  texture queue is unexpectedly full.\n");
+            break;
+        }
+        const double aSplitMSec = aStageTimer.getElapsedTimeInMilliSec();
+
+        // large frames might be uploaded within several calls
+        aStageTimer.restart();
+        myQueue->stglSwapFB(0);
+        for(size_t anIter = 0; !myQueue->isEmpty() && anIter < 1024; ++anIter) {
+            myQueue->stglUpdateStTextures(theCtx);
+        }
+        if(theCtx.isBound()) {
+            theCtx.core20fwd->glFinish();
+        }
+        const double anUploadMSec = aStageTimer.getElapsedTimeInMilliSec();
+
+        myStages[Stage_Demux]  .push_back(aDemuxMSec);
+        myStages[Stage_Decode] .push_back(aDecodeMSec);
+        myStages[Stage_Convert].push_back(aConvertMSec);
+        myStages[Stage_Split]  .push_back(aSplitMSec);
+        myStages[Stage_Upload] .push_back(anUploadMSec);
+        aDemuxMSec  = 0.0;
+        aDecodeMSec = 0.0;
+        ++aNbFrames;
+    }
+    const double aTotalSec = myTimer.getElapsedTimeInSec();
+
+    avcodec_close(aCodecCtx);
+    avformat_close_input(&aFormatCtx);
+    report(aTotalSec);
+}
+
+void StTestVideoBench::report(const double theTotalSec) {
+    const size_t aNbFrames = myStages[Stage_Demux].size();
+    const double aFps      = theTotalSec > 0.0 ? double(aNbFrames) / theTotalSec : 0.0;
+    st::cout << stostream_text("  frames:    \t") << aNbFrames << stostream_text(" (") << mySizeX << stostream_text("x") << mySizeY
+             << stostream_text(" ") << myPixFmt << stostream_text(")\n");
+    st::cout << stostream_text("  throughput:\t") << aFps << stostream_text(" FPS\n");
+    st::cout << stostream_text("  stage      \tmean\tp50\tp90\tp99\tmax (msec)\n");
+
+    StString aJson = StString("{\n")
+                   + "  \"file\": "    + jsonString(myFilePath) + ",\n"
+                   + "  \"gl\": "      + (myToUseGl ? "true" : "false") + ",\n"
+                   + "  \"width\": "   + mySizeX + ",\n"
+                   + "  \"height\": "  + mySizeY + ",\n"
+                   + "  \"pixfmt\": "  + jsonString(myPixFmt) + ",\n"
+                   + "  \"frames\": "  + aNbFrames + ",\n"
+                   + "  \"seconds\": " + theTotalSec + ",\n"
+                   + "  \"fps\": "     + aFps + ",\n"
+                   + "  \"stages\": {\n";
+    for(int aStageIter = 0; aStageIter < StageNb; ++aStageIter) {
+        std::vector<double> aSorted = myStages[aStageIter];
+        std::sort(aSorted.begin(), aSorted.end());
+        double aMean = 0.0;
+        for(size_t anIter = 0; anIter < aSorted.size(); ++anIter) {
+            aMean += aSorted[anIter];
+        }
+        aMean = !aSorted.empty() ? aMean / double(aSorted.size()) : 0.0;
+        const double aP50 = percentile(aSorted, 0.50);
+        const double aP90 = percentile(aSorted, 0.90);
+        const double aP99 = percentile(aSorted, 0.99);
+        const double aMax = !aSorted.empty() ? aSorted.back() : 0.0;
+
+        st::cout << stostream_text("  ") << stageName(Stage(aStageIter)) << stostream_text("    \t")
+                 << aMean << stostream_text("\t") << aP50 << stostream_text("\t")
+                 << aP90  << stostream_text("\t") << aP99 << stostream_text("\t")
+                 << aMax  << stostream_text("\n");
+        aJson = aJson + "    \"" + stageName(Stage(aStageIter)) + "\": { "
+              + "\"mean\": " + aMean + ", "
+              + "\"p50\": "  + aP50  + ", "
+              + "\"p90\": "  + aP90  + ", "
+              + "\"p99\": "  + aP99  + ", "
+              + "\"max\": "  + aMax  + " }"
+              + (aStageIter + 1 < StageNb ? ",\n" : "\n");
+    }
+    aJson += "  }\n}\n";
+
+    if(myJsonPath.isEmpty()) {
+        st::cout << aJson;
+        return;
+    }
+
+    StRawFile aFile(myJsonPath);
+    if(!aFile.openFile(StRawFile::WRITE)
+    ||  aFile.write(aJson) != aJson.getSize()) {
+        st::cout << stostream_text("  report can not be saved to '") << myJsonPath << stostream_text("'\n");
+        return;
+    }
+    aFile.closeFile();
+    st::cout << stostream_text("  report saved to '") << myJsonPath << stostream_text("'\n");
+}
+
+void StTestVideoBench::perform() {
+    st::cout << stostream_text("Video pipeline throughput test\n");
+    st::cout << stostream_text("  file:   \t'") << myFilePath << stostream_text("'\n");
+    if(!stAV::init()) {
+        st::cout << stostream_text("  FFmpeg library is unavailable! Skipped.\n");
+        return;
+    }
+
+    myQueue  = new StGLTextureQueue(THE_QUEUE_SIZE);
+    myParams = new StStereoParams();
+    if(!myToUseGl) {
+        // unbound context - texture queue skips upload
+        StGLContext aCtx(false);
+        processFile(aCtx);
+        myQueue.nullify();
+        return;
+    }
+
+    StHandle<StWindow> aWin = new StWindow();
+    aWin->setPlacement(StRectI_t(256, 768, 256, 768));
+    aWin->setTitle("sView - Tests");
+    aWin->create();
+    aWin->stglMakeCurrent();
+    {
+        StGLContext aCtx(true);
+        myQueue->setDeviceCaps(aCtx.getDeviceCaps());
+        processFile(aCtx);
+        myQueue->release(aCtx);
+    }
+    myQueue.nullify();
+    aWin.nullify();
+}
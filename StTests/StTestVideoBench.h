@@ -0,0 +1,120 @@
+/**
+ * Copyright © 2017 Kirill Gavrilov <kirill@sview.ru>
+ *
+ * StTests program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * StTests program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __StTestVideoBench_h_
+#define __StTestVideoBench_h_
+
+#include "StTest.h"
+
+#include <StAV/StAVFrame.h>
+#include <StAV/StAVScaler.h>
+#include <StGL/StParams.h>
+#include <StGLStereo/StGLTextureQueue.h>
+#include <StImage/StImage.h>
+
+#include <vector>
+
+class StGLContext;
+
+/**
+ * Measures throughput of video playback pipeline stages:
+ * demuxing, decoding, color conversion, splitting into texture queue and upload into GL textures.
+ * Frames are processed within single thread without A/V synchronization (as in benchmark mode of the movie player),
+ * so that numbers are repeatable between runs.
+ */
+class ST_LOCAL StTestVideoBench : public StTest {
+
+        public:
+
+    /**
+     * Pipeline stages.
+     */
+    enum Stage {
+        Stage_Demux = 0, //!< av_read_frame()
+        Stage_Decode,    //!< avcodec_decode_video2()
+        Stage_Convert,   //!< pixel format conversion (swscale) for formats not supported by GLSL programs
+        Stage_Split,     //!< copying frame into StGLTextureQueue (split into views)
+        Stage_Upload,    //!< texture upload by StGLTextureQueue
+        StageNb
+    };
+
+        public:
+
+    /**
+     * Main constructor.
+     * @param theFile     video file to decode
+     * @param theJsonPath path to the file to store results in JSON format (optional)
+     * @param theFramesMax maximum number of frames to process, 0 means whole file
+     * @param theToUseGl  create window with GL context to measure upload, or use unbound context stand-in
+     */
+    StTestVideoBench(const StString& theFile,
+                     const StString& theJsonPath,
+                     const size_t    theFramesMax,
+                     const bool      theToUseGl);
+
+    virtual void perform() ST_ATTR_OVERRIDE;
+
+        private:
+
+    /**
+     * Process all frames.
+     */
+    void processFile(StGLContext& theCtx);
+
+    /**
+     * Wrap decoded frame into image planes, converting into RGB if needed.
+     * @return false if frame has been skipped
+     */
+    bool prepareFrame(const AVCodecContext* theCodecCtx);
+
+    /**
+     * Print results and store them into JSON file.
+     */
+    void report(const double theTotalSec);
+
+    /**
+     * @return stage name
+     */
+    static const char* stageName(const Stage theStage);
+
+    /**
+     * @return percentile (within 0..1 range) of sorted values
+     */
+    static double percentile(const std::vector<double>& theSorted,
+                             const double               thePercent);
+
+        private:
+
+    StString                   myFilePath;   //!< video file
+    StString                   myJsonPath;   //!< path to JSON report
+    size_t                     myFramesMax;  //!< frames limit
+    bool                       myToUseGl;    //!< measure upload into real GL context
+    StHandle<StGLTextureQueue> myQueue;      //!< texture queue
+    StHandle<StStereoParams>   myParams;     //!< stereo parameters for pushed frames
+    StAVFrame                  myFrame;      //!< decoded frame
+    StAVScaler                 myToRgb;      //!< color converter
+    StImagePlane               myDataRGB;    //!< converted frame
+    StImage                    myDataAdp;    //!< frame wrapper passed to the texture queue
+    std::vector<double>        myStages[StageNb]; //!< per-frame time of each stage in milliseconds
+    StString                   myPixFmt;     //!< decoded pixel format
+    int                        mySizeX;      //!< frame width
+    int                        mySizeY;      //!< frame height
+
+};
+
+#endif // __StTestVideoBench_h_
@@ -1,5 +1,5 @@
 /**
- * Copyright © 2011-2015 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2011-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * StTests program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -20,11 +20,14 @@
 #include <StThreads/StProcess.h>
 #include <StFile/StFolder.h>
 
+#include <cstdlib>
+
 #include "StTestMutex.h"
 #include "StTestGlBand.h"
 #include "StTestEmbed.h"
 #include "StTestImageLib.h"
 #include "StTestGlStress.h"
+#include "StTestVideoBench.h"
 
 int main(int , char** ) { // force console output
 #if defined(_WIN32)
@@ -54,6 +57,7 @@ int main(int , char** ) { // force console output
     const StString ST_TEST_GLHANG  = "glhang";
     const StString ST_TEST_EMBED   = "embed";
     const StString ST_TEST_IMAGE   = "image";
+    const StString ST_TEST_VIDEO   = "video";
     const StString ST_TEST_ALL     = "all";
     size_t aFound = 0;
     for(size_t anArgId = 0; anArgId < anArgs.size(); ++anArgId) {
@@ -88,6 +92,35 @@ int main(int , char** ) { // force console output
             StTestImageLib anImage(anArgs[anArgId]);
             anImage.perform();
             ++aFound;
+        } else if(aParam == ST_TEST_VIDEO) {
+            // video pipeline throughput test
+            if(++anArgId >= anArgs.size()) {
+                st::cout << stostream_text("Broken syntax - video file awaited!\n");
+                break;
+            }
+
+            const StString aFilePath = anArgs[anArgId];
+            StString aJsonPath;
+            size_t   aFramesMax = 0;
+            bool     toUseGl    = true;
+            for(; anArgId + 1 < anArgs.size(); ++anArgId) {
+                const StString& anOption = anArgs[anArgId + 1];
+                if(anOption == "nogl") {
+                    toUseGl = false;
+                } else if(anOption == "json"
+                       && anArgId + 2 < anArgs.size()) {
+                    aJsonPath = anArgs[++anArgId + 1];
+                } else if(anOption == "frames"
+                       && anArgId + 2 < anArgs.size()) {
+                    aFramesMax = size_t(stMax(std::atoi(anArgs[++anArgId + 1].toCString()), 0));
+                } else {
+                    break;
+                }
+            }
+
+            StTestVideoBench aVideo(aFilePath, aJsonPath, aFramesMax, toUseGl);
+            aVideo.perform();
+            ++aFound;
         } else if(aParam == ST_TEST_ALL) {
             // mutex speed test
             StTestMutex aMutices;
@@ -114,7 +147,8 @@ int main(int , char** ) { // force console output
                  << stostream_text("  glband - gl <-> cpu trasfer speed test\n")
                  << stostream_text("  glhang - gl stress test\n")
                  << stostream_text("  embed  - test window embedding\n")
-                 << stostream_text("  image fileName - test image libraries\n");
+                 << stostream_text("  image fileName - test image libraries\n")
+                 << stostream_text("  video fileName [nogl] [frames N] [json outFile] - video pipeline throughput test\n");
     }
 
     st::cout << stostream_text("Press any key to exit...") << st::SYS_PAUSE_EMPTY;
@@ -1,5 +1,5 @@
 /**
- * Copyright © 2011-2015 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2011-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -16,6 +16,7 @@ struct AVInputFormat;
 struct AVFormatContext;
 struct AVCodecContext;
 struct AVCodec;
+class  StJpegParser;
 
 // define StHandle template specialization
 class StAVImage;
@@ -79,6 +80,17 @@ class StAVImage : public StImageFile {
                                    ImageType       theImageType,
                                    StFormat        theSrcFormat = StFormat_AUTO);
 
+    /**
+     * Encode image into the memory buffer.
+     * @param theBuffer    output buffer, data size is set to the length of encoded image
+     * @param theImageType image type
+     * @param theSrcFormat stereo format - might be stored as metadata
+     * @return true on success
+     */
+    ST_CPPEXPORT bool encode(StJpegParser& theBuffer,
+                             ImageType     theImageType,
+                             StFormat      theSrcFormat = StFormat_AUTO);
+
         private:
 
     ST_LOCAL static int getAVPixelFormat(const StImage& theImage);
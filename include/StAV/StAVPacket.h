@@ -1,5 +1,5 @@
 /**
- * Copyright © 2009-2013 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2009-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -12,6 +12,7 @@
 #include <StAV/stAV.h>
 
 #include <StGL/StParams.h>
+#include <StThreads/StLatencyMeter.h>
 
 /**
  * This is just a wrapper to AVPacket structure
@@ -55,6 +56,26 @@ class StAVPacket {
      */
     ST_CPPEXPORT void free();
 
+    /**
+     * Prepare packet for reuse.
+     * Releases reference-counted data and stereo parameters,
+     * but keeps own data buffer so that next setAVpkt() could fill it without reallocation.
+     */
+    ST_CPPEXPORT void recycle();
+
+    /**
+     * Copy packet with content.
+     * Already allocated data buffer is reused when it is large enough.
+     */
+    ST_CPPEXPORT void copyFrom(const StAVPacket& theCopy);
+
+    /**
+     * Take ownership of packet content without copying.
+     * The source packet is left empty.
+     * Falls back to copying when source data is not owned by the packet (not reference-counted).
+     */
+    ST_CPPEXPORT void moveFrom(StAVPacket& theOther);
+
     inline AVPacket* getAVpkt() {
         return &myPacket;
     }
@@ -109,6 +130,20 @@ class StAVPacket {
         myDurationSec = theDurationSec;
     }
 
+    /**
+     * @return timestamps of pipeline hand-offs
+     */
+    ST_LOCAL const StFrameStamps& getStamps() const {
+        return myStamps;
+    }
+
+    /**
+     * @return timestamps of pipeline hand-offs for modification
+     */
+    ST_LOCAL StFrameStamps& changeStamps() {
+        return myStamps;
+    }
+
     inline int getStreamId() const {
         return myPacket.stream_index;
     }
@@ -156,6 +191,8 @@ class StAVPacket {
     AVPacket                 myPacket;
     StHandle<StStereoParams> myStParams;
     double                   myDurationSec;
+    StFrameStamps            myStamps;       //!< timestamps of pipeline hand-offs
+    size_t                   myDataCapacity; //!< size of own data buffer, including padding
     int                      myType;
     bool                     myIsOwn;
 
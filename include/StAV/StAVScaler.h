@@ -0,0 +1,99 @@
+/**
+ * Copyright © 2017 Kirill Gavrilov <kirill@sview.ru>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file license-boost.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#ifndef __StAVScaler_h_
+#define __StAVScaler_h_
+
+#include <StAV/stAV.h>
+#include <StTemplates/StHandle.h>
+
+#include <vector>
+
+class StAVScalerSlice;
+
+/**
+ * Software pixel format converter (swscale) without resizing.
+ * The frame is split into horizontal bands converted in parallel,
+ * each by dedicated worker thread with own SwsContext.
+ */
+class StAVScaler {
+
+        public:
+
+    /**
+     * Empty constructor.
+     */
+    ST_CPPEXPORT StAVScaler();
+
+    /**
+     * Destructor.
+     */
+    ST_CPPEXPORT ~StAVScaler();
+
+    /**
+     * Stop worker threads and release swscale contexts.
+     */
+    ST_CPPEXPORT void release();
+
+    /**
+     * @return true if scaler has been successfully initialized
+     */
+    ST_LOCAL bool isValid() const {
+        return !mySlices.empty();
+    }
+
+    /**
+     * @return number of horizontal bands (threads)
+     */
+    ST_LOCAL size_t getNbSlices() const {
+        return mySlices.size();
+    }
+
+    /**
+     * (Re)initialize converter, does nothing if parameters are not changed.
+     * @param theSrcFormat source pixel format
+     * @param theDstFormat destination pixel format
+     * @param theSizeX     frame width
+     * @param theSizeY     frame height
+     * @param theNbThreads number of threads to use, 0 means number of logical processors
+     * @return true on success
+     */
+    ST_CPPEXPORT bool init(const AVPixelFormat theSrcFormat,
+                           const AVPixelFormat theDstFormat,
+                           const int           theSizeX,
+                           const int           theSizeY,
+                           const int           theNbThreads = 0);
+
+    /**
+     * Convert the frame, wraps sws_scale().
+     * Should be called from single thread.
+     */
+    ST_CPPEXPORT void convert(const uint8_t* const theSrcData[],
+                              const int            theSrcLineSize[],
+                              uint8_t* const       theDstData[],
+                              const int            theDstLineSize[]);
+
+        private:
+
+    std::vector< StHandle<StAVScalerSlice> > mySlices; //!< horizontal bands
+    AVPixelFormat mySrcFormat;    //!< source pixel format
+    AVPixelFormat myDstFormat;    //!< destination pixel format
+    int           mySizeX;        //!< frame width
+    int           mySizeY;        //!< frame height
+    int           myNbThreads;    //!< requested number of threads
+    int           mySrcShifts[4]; //!< vertical subsampling of source planes
+    int           myDstShifts[4]; //!< vertical subsampling of destination planes
+
+        private: //! @name no copies
+
+    StAVScaler(const StAVScaler& theCopy);
+    const StAVScaler& operator=(const StAVScaler& theCopy);
+
+};
+
+#endif // __StAVScaler_h_
@@ -1,5 +1,5 @@
 /**
- * Copyright © 2011-2016 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2011-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -224,13 +224,18 @@ namespace stAV {
         ST_SHARED_CPPEXPORT AVPixelFormat YUV411P;   //!< planar YUV 4:1:1, 12bpp, (1 Cr & Cb sample per 4x1 Y samples)
         ST_SHARED_CPPEXPORT AVPixelFormat YUV440P;   //!< planar YUV 4:4:0 (1 Cr & Cb sample per 1x2 Y samples)
         ST_SHARED_CPPEXPORT AVPixelFormat NV12;      //!< YUV420, Y plane + interleaved UV plane oh half width and height
-        // wide planar YUV formats (9,10,14,16 bits stored in 16 bits)
+        ST_SHARED_CPPEXPORT AVPixelFormat P010;      //!< NV12 layout with 10 bits stored in high bits of 16 bits
+        ST_SHARED_CPPEXPORT AVPixelFormat P016;      //!< NV12 layout with 16 bits per component
+        // wide planar YUV formats (9,10,12,16 bits stored in 16 bits)
         ST_SHARED_CPPEXPORT AVPixelFormat YUV420P9;
         ST_SHARED_CPPEXPORT AVPixelFormat YUV422P9;
         ST_SHARED_CPPEXPORT AVPixelFormat YUV444P9;
         ST_SHARED_CPPEXPORT AVPixelFormat YUV420P10;
         ST_SHARED_CPPEXPORT AVPixelFormat YUV422P10;
         ST_SHARED_CPPEXPORT AVPixelFormat YUV444P10;
+        ST_SHARED_CPPEXPORT AVPixelFormat YUV420P12;
+        ST_SHARED_CPPEXPORT AVPixelFormat YUV422P12;
+        ST_SHARED_CPPEXPORT AVPixelFormat YUV444P12;
         ST_SHARED_CPPEXPORT AVPixelFormat YUV420P16;
         ST_SHARED_CPPEXPORT AVPixelFormat YUV422P16;
         ST_SHARED_CPPEXPORT AVPixelFormat YUV444P16;
@@ -173,6 +173,13 @@ class StApplication {
      */
     ST_CPPEXPORT virtual void beforeDraw();
 
+    /**
+     * Return true if nothing has been changed since previous frame,
+     * so that drawing and buffers swap could be skipped to reduce CPU and GPU load.
+     * Called after beforeDraw(); default implementation returns false.
+     */
+    ST_CPPEXPORT virtual bool toSkipFrame();
+
     /**
      * Rendering callback.
      */
@@ -310,6 +310,11 @@ class StWindow {
      */
     ST_CPPEXPORT bool isMouseMoved() const;
 
+    /**
+     * @return true if some event has been dispatched (or key is held) within previous processEvents().
+     */
+    ST_CPPEXPORT bool hasDispatchedEvents() const;
+
     /**
      * Resources manager.
      */
@@ -482,6 +487,12 @@ class StWindow {
      */
     ST_CPPEXPORT virtual bool toSwapEyesHW() const;
 
+    /**
+     * Return TRUE if renderer requires continuous redraws even when frame content is unchanged
+     * (e.g. software page-flipping), so that application should not skip idle frames.
+     */
+    ST_CPPEXPORT virtual bool toDrawContinuously() const;
+
     /**
      * Retrieve options list.
      */
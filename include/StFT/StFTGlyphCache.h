@@ -0,0 +1,139 @@
+/**
+ * Copyright © 2017 Kirill Gavrilov <kirill@sview.ru>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file license-boost.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#ifndef __StFTGlyphCache_h_
+#define __StFTGlyphCache_h_
+
+#include <StFT/StFTFont.h>
+#include <StThreads/StMutex.h>
+#include <StThreads/StThread.h>
+
+#include <map>
+
+/**
+ * Cache of rasterized glyphs for single font at fixed size and resolution.
+ * Glyph bitmaps and metrics are persisted to the file so that next launch
+ * uploads already rasterized glyphs instead of calling FreeType.
+ * The cache can be pre-warmed with commonly used symbols by background thread,
+ * which uses its own FreeType library and font instances.
+ */
+class StFTGlyphCache {
+
+        public:
+
+    /**
+     * Main constructor, loads persisted glyphs when available.
+     * @param theFont        initialized font to cache
+     * @param thePointSize   font size
+     * @param theResolution  font resolution
+     * @param theCacheFolder folder to persist glyphs, empty string disables persistence
+     */
+    ST_CPPEXPORT StFTGlyphCache(const StHandle<StFTFont>& theFont,
+                                const unsigned int        thePointSize,
+                                const unsigned int        theResolution,
+                                const StString&           theCacheFolder);
+
+    /**
+     * Destructor, stops pre-warming and saves modified cache.
+     */
+    ST_CPPEXPORT ~StFTGlyphCache();
+
+    /**
+     * @return font size
+     */
+    ST_LOCAL unsigned int getPointSize() const {
+        return myPointSize;
+    }
+
+    /**
+     * @return font resolution
+     */
+    ST_LOCAL unsigned int getResolution() const {
+        return myResolution;
+    }
+
+    /**
+     * @return number of cached glyphs
+     */
+    ST_CPPEXPORT size_t getNbGlyphs() const;
+
+    /**
+     * Start background rasterization of commonly used symbols.
+     * Does nothing if font has not been loaded from the file.
+     */
+    ST_CPPEXPORT void prewarm();
+
+    /**
+     * Find cached glyph.
+     * @param theStyle font style
+     * @param theUChar unicode symbol
+     * @param theImage wrapper over cached glyph bitmap, valid until cache destruction
+     * @param theRect  glyph rectangle as returned by StFTFont::getGlyphRect()
+     * @return true if glyph has been found
+     */
+    ST_CPPEXPORT bool find(const StFTFont::Style theStyle,
+                           const stUtf32_t       theUChar,
+                           StImagePlane&         theImage,
+                           StRect<float>&        theRect) const;
+
+    /**
+     * Put rasterized glyph into the cache (bitmap is copied).
+     */
+    ST_CPPEXPORT void add(const StFTFont::Style theStyle,
+                          const stUtf32_t       theUChar,
+                          const StImagePlane&   theImage,
+                          const StRect<float>&  theRect);
+
+    /**
+     * Save the cache if it has been modified after loading.
+     */
+    ST_CPPEXPORT bool save();
+
+        private:
+
+    /**
+     * Cached glyph.
+     */
+    struct Glyph {
+        StHandle<StImagePlane> Image; //!< glyph bitmap
+        StRect<float>          Rect;  //!< glyph rectangle
+    };
+
+    /**
+     * Load persisted cache.
+     */
+    ST_LOCAL bool load();
+
+    /**
+     * Pre-warm loop.
+     */
+    ST_LOCAL void prewarmLoop();
+
+    /**
+     * Thread function.
+     */
+    static SV_THREAD_FUNCTION prewarmThread(void* theCache);
+
+        private:
+
+    std::map<stUtf32_t, Glyph> myGlyphs[StFTFont::StylesNB]; //!< cached glyphs per style
+    StString           myFontPaths[StFTFont::StylesNB];      //!< font paths
+    StHandle<StThread> myThread;     //!< pre-warming thread
+    mutable StMutex    myMutex;      //!< lock for thread-safety
+    StString           myCachePath;  //!< path to the file storing the cache
+    uint64_t           myFontHash;   //!< hash of font paths used to validate persisted cache
+    unsigned int       myPointSize;  //!< font size
+    unsigned int       myResolution; //!< font resolution
+    bool               myHasCJK;     //!< font contains CJK symbols
+    bool               myHasKorean;  //!< font contains Korean symbols
+    volatile bool      myIsModified; //!< cache has been modified after loading
+    volatile bool      myToQuit;     //!< flag to stop pre-warming
+
+};
+
+#endif // __StFTGlyphCache_h_
@@ -1,5 +1,5 @@
 /**
- * Copyright © 2009-2014 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2009-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -24,6 +24,7 @@ class StRawFile : public StFileNode {
     typedef enum tagReadWrite {
         READ,
         WRITE,
+        APPEND, //!< write to the end of existing file (not supported for remote files)
     } ReadWrite;
 
         public:
@@ -72,6 +73,13 @@ class StRawFile : public StFileNode {
      */
     ST_CPPEXPORT void freeBuffer();
 
+    /**
+     * @return true if buffer is a memory-mapped view of the file
+     */
+    bool isMapped() const {
+        return myMappedSize != 0;
+    }
+
     /**
      * Returns true if file is opened.
      */
@@ -125,8 +133,27 @@ class StRawFile : public StFileNode {
                                        const int        theOpenedFd = -1,
                                        const size_t     theReadMax  = 0);
 
+    /**
+     * Map the file content into memory instead of reading it into the buffer.
+     * The view is private - buffer modifications are not written back to the file.
+     * Pages are loaded on first access, so that parsing of the file header might start before the whole file is resident.
+     * Beware that truncating the file by another process while it is mapped
+     * will raise SIGBUS on access to the pages beyond new end of file,
+     * hence the mapping should be used only for short-living buffers (e.g. while decoding the image).
+     * Falls back to readFile() for remote paths, on platforms without mmap()
+     * or when the file tail does not leave enough zero padding for decoders reading input by machine words.
+     * @param theFilePath the file path
+     * @param theOpenedFd when specified, already opened file descriptor will be used; passed descriptor will be automatically closed
+     * @return true if file was mapped or read
+     */
+    ST_CPPEXPORT bool mapFile(const StCString& theFilePath = stCString(""),
+                              const int        theOpenedFd = -1);
+
     /**
      * Write the buffer into the file.
+     * When the buffer is a mapped view of the same file, the data is written into temporary file
+     * which then replaces the original one (symbolic links are resolved and file mode is preserved,
+     * but hard links are not), because truncating the mapped file would invalidate the view.
      * @param theFilePath the file path
      * @param theOpenedFd when specified, already opened file descriptor will be used; passed descriptor will be automatically closed
      * @return true if file was stored
@@ -159,6 +186,9 @@ class StRawFile : public StFileNode {
     stUByte_t*   myBuffer;     //!< buffer with file content
     size_t       myBuffSize;   //!< buffer size
     size_t       myLength;     //!< data length
+    size_t       myMappedSize; //!< size of memory-mapped view (0 if buffer is allocated on heap)
+    uint64_t     myMappedDev;  //!< device  of the mapped file
+    uint64_t     myMappedIno;  //!< i-node of the mapped file
 
 };
 
@@ -0,0 +1,169 @@
+/**
+ * Copyright © 2017 Kirill Gavrilov <kirill@sview.ru>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file license-boost.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#ifndef __StGLAsyncReadback_h_
+#define __StGLAsyncReadback_h_
+
+#include <StGL/StGLPixelBuffer.h>
+#include <StTemplates/StHandle.h>
+
+#include <vector>
+
+/**
+ * Ring of pixel pack buffers for asynchronous readback of the framebuffer.
+ * readPixels() only initiates the transfer into the next free buffer,
+ * so that the GPU can continue rendering of the next frame
+ * while previously requested frames are being copied.
+ * The oldest requested frame should be retrieved by mapOldest() / unmapOldest() pair.
+ *
+ * Completion of each transfer is tracked by fence object (StGLContext::arbSync);
+ * without fences mapOldest() still works but might wait for the transfer.
+ * Requires StGLContext::arbPbo.
+ */
+class StGLAsyncReadback : public StGLResource {
+
+        public:
+
+    /**
+     * @return true if asynchronous readback is supported by the context
+     */
+    ST_CPPEXPORT static bool isSupported(const StGLContext& theCtx);
+
+        public:
+
+    /**
+     * Empty constructor.
+     * @param theNbBuffers number of buffers in the ring (number of frames in flight)
+     */
+    ST_CPPEXPORT StGLAsyncReadback(const size_t theNbBuffers = 2);
+
+    /**
+     * Destructor - should be called after release()!
+     */
+    ST_CPPEXPORT virtual ~StGLAsyncReadback();
+
+    /**
+     * Release GL resources.
+     */
+    ST_CPPEXPORT virtual void release(StGLContext& theCtx) ST_ATTR_OVERRIDE;
+
+    /**
+     * @return number of buffers in the ring
+     */
+    ST_LOCAL size_t getNbBuffers() const {
+        return mySlots.size();
+    }
+
+    /**
+     * @return number of requested but not yet retrieved frames
+     */
+    ST_LOCAL size_t getNbPending() const {
+        return myNbPending;
+    }
+
+    /**
+     * @return true if all buffers in the ring hold not yet retrieved frames
+     */
+    ST_LOCAL bool isFull() const {
+        return myNbPending >= mySlots.size();
+    }
+
+    /**
+     * Initiate asynchronous readback from currently bound read framebuffer.
+     * When the ring is full, the oldest pending frame is discarded.
+     * Rows are expected to be packed with default GL_PACK_ALIGNMENT (4).
+     * @param theCtx    current context
+     * @param theLeft   left   corner of the region
+     * @param theBottom bottom corner of the region
+     * @param theSizeX  region width
+     * @param theSizeY  region height
+     * @param theFormat pixel format (e.g. GL_RGBA or GL_BGRA)
+     * @param theType   pixel type   (e.g. GL_UNSIGNED_BYTE)
+     * @return true if transfer has been initiated
+     */
+    ST_CPPEXPORT bool readPixels(StGLContext&  theCtx,
+                                 const GLint   theLeft,
+                                 const GLint   theBottom,
+                                 const GLsizei theSizeX,
+                                 const GLsizei theSizeY,
+                                 const GLenum  theFormat,
+                                 const GLenum  theType);
+
+    /**
+     * @return true if the transfer of the oldest pending frame has been completed,
+     *         so that mapOldest() will not stall
+     */
+    ST_CPPEXPORT bool isOldestReady(StGLContext& theCtx);
+
+    /**
+     * Map the oldest pending frame for reading (waits for the transfer completion).
+     * @return pointer to pixel data or NULL if there are no pending frames
+     */
+    ST_CPPEXPORT const GLubyte* mapOldest(StGLContext& theCtx);
+
+    /**
+     * Unmap the oldest pending frame and return its buffer into the ring.
+     */
+    ST_CPPEXPORT void unmapOldest(StGLContext& theCtx);
+
+    /**
+     * Discard all pending frames.
+     */
+    ST_CPPEXPORT void discard(StGLContext& theCtx);
+
+    /**
+     * @return width of the oldest pending frame
+     */
+    ST_LOCAL GLsizei getOldestSizeX() const {
+        return myNbPending != 0 ? mySlots[myOldest].SizeX : 0;
+    }
+
+    /**
+     * @return height of the oldest pending frame
+     */
+    ST_LOCAL GLsizei getOldestSizeY() const {
+        return myNbPending != 0 ? mySlots[myOldest].SizeY : 0;
+    }
+
+    /**
+     * @return number of bytes in the row of the oldest pending frame
+     */
+    ST_LOCAL size_t getOldestRowBytes() const {
+        return myNbPending != 0 ? mySlots[myOldest].RowBytes : 0;
+    }
+
+        private:
+
+    /**
+     * Single buffer in the ring.
+     */
+    struct Slot {
+        StHandle<StGLPixelBuffer> Buffer;   //!< pixel pack buffer
+        void*                     Fence;    //!< GLsync object signaled on transfer completion
+        GLsizei                   SizeX;    //!< frame width
+        GLsizei                   SizeY;    //!< frame height
+        size_t                    RowBytes; //!< row size in bytes
+
+        Slot() : Fence(NULL), SizeX(0), SizeY(0), RowBytes(0) {}
+    };
+
+    /**
+     * Delete the fence of the slot.
+     */
+    ST_LOCAL void releaseFence(StGLContext& theCtx,
+                               Slot&        theSlot);
+
+        private:
+
+    std::vector<Slot> mySlots;     //!< ring of buffers
+    size_t            myOldest;    //!< index of the oldest pending frame
+    size_t            myNbPending; //!< number of pending frames
+
+};
+
+#endif // __StGLAsyncReadback_h_
@@ -1,5 +1,5 @@
 /**
- * Copyright © 2012-2016 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2012-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -160,6 +160,8 @@ class StGLContext {
     bool            arbNPTW;    //!< GL_ARB_texture_non_power_of_two
     bool            arbTexRG;   //!< GL_ARB_texture_rg
     bool            arbTexClear;//!< GL_ARB_clear_texture
+    bool            arbPbo;     //!< GL_ARB_pixel_buffer_object with glMapBufferRange() - asynchronous pixel transfers
+    bool            arbSync;    //!< GL_ARB_sync - fence objects
     bool            hasUnpack;  //!< GL_PACK_ROW_LENGTH / GL_UNPACK_ROW_LENGTH can be used - OpenGL ES 3.0+ or any desktop
     bool            hasHighp;   //!< highp in GLSL ES fragment shader is supported
     bool            hasTexRGBA8;//!< always available on desktop; on OpenGL ES - since 3.0 or as extension GL_OES_rgb8_rgba8
@@ -360,7 +362,7 @@ class StGLContext {
      * @return currently bound FBO for reading operations
      */
     inline GLuint stglFramebufferRead() const {
-        return myFramebufferDraw;
+        return myFramebufferRead;
     }
 
     /**
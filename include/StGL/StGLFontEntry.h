@@ -1,5 +1,5 @@
 /**
- * Copyright © 2012-2014 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2012-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -10,6 +10,7 @@
 #define __StGLFontEntry_h_
 
 #include <StFT/StFTFont.h>
+#include <StFT/StFTGlyphCache.h>
 #include <StGL/StGLTexture.h>
 #include <StGL/StGLFrameBuffer.h>
 #include <StGL/StGLVec.h>
@@ -70,6 +71,23 @@ class StGLFontEntry : public StGLResource {
         return myFont;
     }
 
+    /**
+     * @return cache of rasterized glyphs
+     */
+    ST_LOCAL const StHandle<StFTGlyphCache>& getGlyphCache() const {
+        return myGlyphCache;
+    }
+
+    /**
+     * Setup cache of rasterized glyphs, which should match font size and resolution.
+     * Glyphs found in the cache are uploaded to the texture without FreeType rasterization.
+     * The cache is detached by stglInit() changing font size or resolution,
+     * so that the new one should be retrieved from StGLFontManager::findCreateGlyphCache().
+     */
+    ST_LOCAL void setGlyphCache(const StHandle<StFTGlyphCache>& theCache) {
+        myGlyphCache = theCache;
+    }
+
     /**
      * @return active font style
      */
@@ -179,6 +197,7 @@ class StGLFontEntry : public StGLResource {
         protected:
 
     StHandle<StFTFont> myFont;                //!< FreeType font instance
+    StHandle<StFTGlyphCache> myGlyphCache;    //!< cache of rasterized glyphs
     GLfloat            myAscender;            //!< ascender     provided my FT font
     GLfloat            myLineSpacing;         //!< line spacing provided my FT font
     GLsizei            myTileSizeX;           //!< tile width
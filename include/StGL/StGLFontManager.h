@@ -1,5 +1,5 @@
 /**
- * Copyright © 2013-2015 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2013-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -11,6 +11,7 @@
 
 #include <StGL/StGLFont.h>
 #include <StFT/StFTFontRegistry.h>
+#include <StFT/StFTGlyphCache.h>
 
 #include <map>
 
@@ -99,6 +100,20 @@ class StGLFontManager : public StGLResource {
      */
     ST_CPPEXPORT StHandle<StGLFontEntry> findCreateFallback(unsigned int theSize);
 
+    /**
+     * Setup folder to persist rasterized glyphs, empty string disables persistence.
+     */
+    ST_LOCAL void setCacheFolder(const StString& theFolder) {
+        myCacheFolder = theFolder;
+    }
+
+    /**
+     * Find cache of rasterized glyphs for specified font and size, and create it if not already created.
+     * New cache is pre-warmed with commonly used symbols in background.
+     */
+    ST_CPPEXPORT StHandle<StFTGlyphCache> findCreateGlyphCache(const StHandle<StFTFont>& theFont,
+                                                               unsigned int              theSize);
+
     /**
      * @return handle to the FT library object
      */
@@ -114,6 +129,9 @@ class StGLFontManager : public StGLResource {
               StHandle<StGLFontEntry> > myFonts;      //!< fonts map
     std::map< StGLFontTypeKey,
               StHandle<StGLFont> >      myFontTypes;  //!< font typefaces map
+    std::map< StGLFontKey,
+              StHandle<StFTGlyphCache> > myGlyphCaches; //!< caches of rasterized glyphs
+    StString                            myCacheFolder; //!< folder to persist rasterized glyphs
     unsigned int                        myResolution; //!< fonts resolution
 
 };
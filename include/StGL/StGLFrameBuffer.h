@@ -1,5 +1,5 @@
 /**
- * Copyright © 2009-2013 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2009-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -12,6 +12,8 @@
 #include <StGL/StGLTexture.h>
 #include <StTemplates/StHandle.h>
 
+class StGLAsyncReadback;
+
 /**
  * Simple class represents Virtual (texture) stereo Frame buffer object.
  * This allow render to texture.
@@ -142,6 +144,22 @@ class StGLFrameBuffer : public StGLResource {
      */
     ST_CPPEXPORT static void unbindBufferGlobal(StGLContext& theCtx);
 
+    /**
+     * Initiate asynchronous readback of the viewport area of this FBO (e.g. for frame capture).
+     * The result should be retrieved later using StGLAsyncReadback::mapOldest(),
+     * preferably after next frame has been submitted to avoid pipeline stall.
+     * Previously bound read framebuffer is restored.
+     * @param theCtx      current context
+     * @param theReadback ring of pixel pack buffers
+     * @param theFormat   pixel format
+     * @param theType     pixel data type
+     * @return true if transfer has been initiated
+     */
+    ST_CPPEXPORT bool readPixelsAsync(StGLContext&       theCtx,
+                                      StGLAsyncReadback& theReadback,
+                                      const GLenum       theFormat,
+                                      const GLenum       theType);
+
     /**
      * Return color texture.
      */
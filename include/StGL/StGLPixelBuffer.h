@@ -0,0 +1,121 @@
+/**
+ * Copyright © 2017 Kirill Gavrilov <kirill@sview.ru>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file license-boost.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#ifndef __StGLPixelBuffer_h_
+#define __StGLPixelBuffer_h_
+
+#include <StGL/StGLResource.h>
+
+/**
+ * Pixel Buffer Object - GL buffer used as source (GL_PIXEL_UNPACK_BUFFER)
+ * or destination (GL_PIXEL_PACK_BUFFER) for asynchronous pixel transfers.
+ * Requires StGLContext::arbPbo.
+ *
+ * The mapped memory can be accessed from any thread,
+ * but mapping / unmapping should be performed only within GL thread.
+ */
+class StGLPixelBuffer : public StGLResource {
+
+        public:
+
+    /**
+     * Empty constructor.
+     * @param theTarget GL_PIXEL_UNPACK_BUFFER or GL_PIXEL_PACK_BUFFER
+     */
+    ST_CPPEXPORT StGLPixelBuffer(const GLenum theTarget);
+
+    /**
+     * Destructor - should be called after release()!
+     */
+    ST_CPPEXPORT virtual ~StGLPixelBuffer();
+
+    /**
+     * Release GL resource.
+     */
+    ST_CPPEXPORT virtual void release(StGLContext& theCtx) ST_ATTR_OVERRIDE;
+
+    /**
+     * @return true if this PBO has valid ID
+     */
+    ST_LOCAL bool isValid() const {
+        return myBufferId != 0;
+    }
+
+    /**
+     * @return buffer target
+     */
+    ST_LOCAL GLenum getTarget() const {
+        return myTarget;
+    }
+
+    /**
+     * @return allocated buffer size in bytes
+     */
+    ST_LOCAL size_t getSizeBytes() const {
+        return mySizeBytes;
+    }
+
+    /**
+     * @return pointer to mapped memory or NULL if buffer is not mapped
+     */
+    ST_LOCAL GLubyte* getMappedData() const {
+        return myMappedData;
+    }
+
+    /**
+     * @return true if buffer is currently mapped
+     */
+    ST_LOCAL bool isMapped() const {
+        return myMappedData != NULL;
+    }
+
+    /**
+     * Create the buffer (if not yet created) and (re)allocate its storage.
+     * Previous content is discarded (buffer orphaning), so that the driver
+     * would not wait for pending transfers using old storage.
+     * @param theCtx       current context
+     * @param theSizeBytes new buffer size
+     * @return true on success
+     */
+    ST_CPPEXPORT bool init(StGLContext& theCtx,
+                           const size_t theSizeBytes);
+
+    /**
+     * Bind this PBO to its target.
+     */
+    ST_CPPEXPORT void bind(StGLContext& theCtx) const;
+
+    /**
+     * Unbind any PBO from the target.
+     */
+    ST_CPPEXPORT void unbind(StGLContext& theCtx) const;
+
+    /**
+     * Map the whole buffer into client memory.
+     * Unpack buffer is mapped for writing with previous content invalidated,
+     * pack buffer is mapped for reading (this will wait for pending transfer!).
+     * @return pointer to mapped memory or NULL on failure
+     */
+    ST_CPPEXPORT GLubyte* map(StGLContext& theCtx);
+
+    /**
+     * Unmap the buffer.
+     * @return false if buffer content has been corrupted (e.g. due to screen mode change)
+     */
+    ST_CPPEXPORT bool unmap(StGLContext& theCtx);
+
+        private:
+
+    GLenum   myTarget;     //!< buffer target
+    GLuint   myBufferId;   //!< GL buffer ID
+    size_t   mySizeBytes;  //!< allocated size
+    GLubyte* myMappedData; //!< pointer to mapped memory
+
+};
+
+#endif // __StGLPixelBuffer_h_
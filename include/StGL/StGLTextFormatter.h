@@ -92,6 +92,8 @@ class StGLTextFormatter {
 
     /**
      * Reset current progress.
+     * Should be called after re-initialization of the font, since formatted glyphs refer to its textures;
+     * vertex buffers are then fully re-uploaded by next getResult() call.
      */
     ST_CPPEXPORT void reset();
 
@@ -110,6 +112,17 @@ class StGLTextFormatter {
                              const StFTFont::Style theStyle,
                              StGLFont&             theFont);
 
+    /**
+     * Replace previously appended text by the new one (same as reset() + append()),
+     * but reuse glyphs of the common prefix of previous and new text.
+     * Falls back to complete re-layout when font, style or line spacing have been changed,
+     * or when the text contains formatting tags.
+     * reset() should be called after font re-initialization to drop references to released textures.
+     */
+    ST_CPPEXPORT void update(StGLContext&    theCtx,
+                             const StString& theString,
+                             StGLFont&       theFont);
+
     /**
      * Process minimal set of formatting tags from HTML.
      */
@@ -119,7 +132,7 @@ class StGLTextFormatter {
 
     /**
      * Perform formatting on the buffered text.
-     * Should not be called more than once after initialization!
+     * Subsequent calls without modification of the text are ignored.
      */
     ST_CPPEXPORT void format(const GLfloat theWidth,
                              const GLfloat theHeight);
@@ -132,12 +145,14 @@ class StGLTextFormatter {
                                 std::vector< StHandle < std::vector<StGLVec2> > >& theTCrdsPerTexture) const;
 
     /**
-     * Retrieve formatting results.
+     * Retrieve formatting results into vertex buffers.
+     * Buffers are expected to be filled by previous call to this method,
+     * so that only modified range of each buffer is uploaded when the number of glyphs per texture is unchanged.
      */
     ST_CPPEXPORT void getResult(StGLContext&                                theCtx,
                                 std::vector<GLuint>&                        theTextures,
                                 StArrayList< StHandle <StGLVertexBuffer> >& theVertsPerTexture,
-                                StArrayList< StHandle <StGLVertexBuffer> >& theTCrdsPerTexture) const;
+                                StArrayList< StHandle <StGLVertexBuffer> >& theTCrdsPerTexture);
 
     /**
      * @return width of formatted text.
@@ -160,6 +175,20 @@ class StGLTextFormatter {
         return myTextWidth;
     }
 
+    /**
+     * @return vertices per texture uploaded by last call to getResult() into vertex buffers
+     */
+    inline const std::vector< StHandle < std::vector<StGLVec2> > >& getResultVertices() const {
+        return myLastVerts;
+    }
+
+    /**
+     * @return texture coordinates per texture uploaded by last call to getResult() into vertex buffers
+     */
+    inline const std::vector< StHandle < std::vector<StGLVec2> > >& getResultTexCoords() const {
+        return myLastTCrds;
+    }
+
     /**
      * @param bounding box.
      */
@@ -177,6 +206,13 @@ class StGLTextFormatter {
      */
     ST_CPPEXPORT void newLine(const size_t theLastRect);
 
+    /**
+     * Fill vertex arrays per texture, re-using already allocated arrays.
+     */
+    ST_LOCAL void fillResult(std::vector<GLuint>&                               theTextures,
+                             std::vector< StHandle < std::vector<StGLVec2> > >& theVertsPerTexture,
+                             std::vector< StHandle < std::vector<StGLVec2> > >& theTCrdsPerTexture) const;
+
         protected: //! @name configuration
 
     StAlignX              myAlignX;        //!< horizontal alignment style
@@ -188,6 +224,7 @@ class StGLTextFormatter {
 
     StString              myString;        //!< currently rendered text
     StGLVec2              myPen;           //!< current pen position
+    std::vector<StGLTile> myRectsRaw;      //!< glyphs rectangles on zero baseline (before formatting)
     std::vector<StGLTile> myRects;         //!< glyphs rectangles
     size_t                myRectsNb;       //!< rectangles number
     GLfloat               myLineSpacing;   //!< line spacing (computed as maximum of all fonts involved in text formatting)
@@ -206,6 +243,18 @@ class StGLTextFormatter {
     GLfloat               myBndTop;
     StGLVec2              myMoveVec;       //!< local variable
 
+        protected: //! @name state for incremental update
+    StString              myLastText;      //!< text passed to update()
+    const StGLFont*       myLastFont;      //!< font used by update()
+    StFTFont::Style       myLastStyle;     //!< default style used by update()
+    std::vector<StGLVec2> myCharPens;      //!< pen position before each symbol of plain text
+    std::vector<size_t>   myCharRects;     //!< number of rectangles before each symbol of plain text
+    std::vector<GLuint>   myLastTextures;  //!< textures of last uploaded vertex buffers
+    std::vector< StHandle < std::vector<StGLVec2> > > myLastVerts; //!< last uploaded vertices per texture
+    std::vector< StHandle < std::vector<StGLVec2> > > myLastTCrds; //!< last uploaded texture coordinates per texture
+    std::vector< StHandle < std::vector<StGLVec2> > > myNewVerts;  //!< vertices per texture being uploaded
+    std::vector< StHandle < std::vector<StGLVec2> > > myNewTCrds;  //!< texture coordinates per texture being uploaded
+
 };
 
 #endif // __StGLTextFormatter_h_
@@ -183,6 +183,9 @@ class StGLTexture : public StGLResource {
      *                     0 to copy in single batch
      *                     1 to copy row-by-row
      *                     N to copy in batches of specified number of rows
+     * @param theUnpackBase when not NULL, the image plane points into mapped memory of currently bound
+     *                      GL_PIXEL_UNPACK_BUFFER starting at this address (the buffer should be unmapped before this call);
+     *                      data is transferred from buffer object instead of client memory
      * @return true on success
      */
     ST_CPPEXPORT bool fillPatch(StGLContext&        theCtx,
@@ -190,7 +193,8 @@ class StGLTexture : public StGLResource {
                                 const GLenum        theTarget,
                                 const GLsizei       theRowFrom,
                                 const GLsizei       theRowTo,
-                                const GLsizei       theBatchRows = 128);
+                                const GLsizei       theBatchRows = 128,
+                                const GLubyte*      theUnpackBase = NULL);
 
     /**
      * @return GL texture ID.
@@ -1,5 +1,5 @@
 /**
- * Copyright © 2010-2015 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2010-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -92,6 +92,18 @@ class StGLVertexBuffer : public StGLResource {
                               GLsizeiptr     theElemsCount,
                               const GLubyte* theData);
 
+    /**
+     * Update sub-range of already allocated buffer of GL_FLOAT elements.
+     * VBO should be binded before call.
+     * @param theElemFrom   first element to update
+     * @param theElemsCount number of elements to update
+     * @param theData       data pointer to the first updated element
+     */
+    ST_CPPEXPORT void setSubData(StGLContext&   theCtx,
+                                 GLsizeiptr     theElemFrom,
+                                 GLsizeiptr     theElemsCount,
+                                 const GLfloat* theData);
+
     inline bool init(StGLContext&             theCtx,
                      const StArray<StGLVec2>& theArray) {
         return init(theCtx, 2, GLsizeiptr(theArray.size()), theArray.getFirst().getData());
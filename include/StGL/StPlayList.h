@@ -1,5 +1,5 @@
 /**
- * Copyright © 2009-2015 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2009-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -202,6 +202,17 @@ class StPlayList {
         return getCurrentFile(theFileNode, theParams, aPlsFile);
     }
 
+    /**
+     * Returns file node for the item next to the current one in list order,
+     * which can be used for decoding this item ahead of time.
+     * Items can not be predicted in shuffle mode.
+     * @param theOffset   offset from the current item, 1 for the next and -1 for the previous one
+     * @param theFileNode found file node
+     * @return true if item has been found
+     */
+    ST_CPPEXPORT bool getNeighbourFile(const int             theOffset,
+                                       StHandle<StFileNode>& theFileNode);
+
     ST_CPPEXPORT void addToNode(const StHandle<StFileNode>& theFileNode,
                                 const StString&             thePathToAdd);
 
@@ -323,6 +334,18 @@ class StPlayList {
                                  const size_t           theStart,
                                  const size_t           theEnd) const;
 
+    /**
+     * Fill lists with playlist items titles and file paths.
+     * @param theList  the list to fill with titles
+     * @param thePaths the list to fill with file paths
+     * @param theStart start index (inclusive) in playlist
+     * @param theEnd   end   index (exclusive) in playlist
+     */
+    ST_CPPEXPORT void getSubList(StArrayList<StString>& theList,
+                                 StArrayList<StString>& thePaths,
+                                 const size_t           theStart,
+                                 const size_t           theEnd) const;
+
         public: //! @name recently opened files list
 
     /**
@@ -1,5 +1,5 @@
 /**
- * Copyright © 2009-2016 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2009-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -12,6 +12,8 @@
 #include <StImage/StImage.h>
 #include <StGLStereo/StGLQuadTexture.h>
 #include <StGL/StGLDeviceCaps.h>
+#include <StGL/StGLPixelBuffer.h>
+#include <StThreads/StLatencyMeter.h>
 
 /**
  * This class represents stereo data for textures
@@ -68,6 +70,20 @@ class StGLTextureData {
         return myPts;
     }
 
+    /**
+     * @return timestamps of pipeline hand-offs
+     */
+    ST_LOCAL const StFrameStamps& getStamps() const {
+        return myStamps;
+    }
+
+    /**
+     * @return timestamps of pipeline hand-offs for modification
+     */
+    ST_LOCAL StFrameStamps& changeStamps() {
+        return myStamps;
+    }
+
     /**
      * @return format of source data
      */
@@ -154,6 +170,36 @@ class StGLTextureData {
      */
     ST_CPPEXPORT void reset();
 
+    /**
+     * @return true if pixel unpack buffer is mapped and ready to be filled by updateData()
+     */
+    ST_LOCAL bool hasMappedUnpackBuffer() const {
+        return myUnpackBuffer.isMapped();
+    }
+
+    /**
+     * @return size of pixel unpack buffer in bytes required to store the last frame passed to updateData()
+     */
+    ST_LOCAL size_t getUnpackSizeHint() const {
+        return myUnpackSizeHint;
+    }
+
+    /**
+     * Map pixel unpack buffer, so that next updateData() will copy frame into it
+     * and fillTexture() will just initiate asynchronous transfer from buffer object to the texture.
+     * Should be called from GL thread while this item is not used by data thread.
+     * @param theCtx       OpenGL context
+     * @param theSizeBytes buffer size
+     * @return true if buffer has been mapped
+     */
+    ST_CPPEXPORT bool stglMapUnpackBuffer(StGLContext& theCtx,
+                                          const size_t theSizeBytes);
+
+    /**
+     * Release pixel unpack buffer.
+     */
+    ST_CPPEXPORT void stglReleaseUnpackBuffer(StGLContext& theCtx);
+
         private:
 
     ST_LOCAL bool reAllocate(const size_t theSizeBytes);
@@ -171,7 +217,13 @@ class StGLTextureData {
      */
     ST_LOCAL void fillTexture(StGLContext&        theCtx,
                               StGLFrameTexture&   theFrameTexture,
-                              const StImagePlane& theData);
+                              const StImagePlane& theData,
+                              const GLubyte*      theUnpackBase);
+
+    /**
+     * Copy views into mapped pixel unpack buffer (if any).
+     */
+    ST_LOCAL void fillUnpackBuffer();
 
     ST_LOCAL void setupAttributes(StGLFrameTextures& stFrameTextures, const StImage& theImage);
 
@@ -186,8 +238,15 @@ class StGLTextureData {
     StImage                  myDataL;
     StImage                  myDataR;
 
+    StGLPixelBuffer          myUnpackBuffer;  //!< pixel unpack buffer for asynchronous transfer
+    StImage                  myUnpackL;       //!< left  view copied into mapped unpack buffer
+    StImage                  myUnpackR;       //!< right view copied into mapped unpack buffer
+    const GLubyte*           myUnpackBase;    //!< base address of mapped unpack buffer for myUnpackL and myUnpackR
+    size_t                   myUnpackSizeHint;//!< size of unpack buffer required for the last frame
+
     StHandle<StStereoParams> myStParams;
     double                   myPts;           //!< presentation timestamp
+    StFrameStamps            myStamps;        //!< timestamps of pipeline hand-offs
     StFormat                 mySrcFormat;
     StCubemap                myCubemapFormat;
 
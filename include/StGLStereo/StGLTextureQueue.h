@@ -1,5 +1,5 @@
 /**
- * Copyright © 2009-2016 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2009-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -9,8 +9,10 @@
 #ifndef __StGLTextureQueue_h_
 #define __StGLTextureQueue_h_
 
+#include <StThreads/StAtomicOp.h>
 #include <StThreads/StCondition.h>
 #include <StThreads/StFPSMeter.h>
+#include <StThreads/StLatencyMeter.h>
 #include <StThreads/StMutex.h>
 
 #include <StGL/StGLDeviceCaps.h>
@@ -26,6 +28,12 @@
  * Method stglUpdateStTextures() should be called each rendering call from GL thread to update textures.
  * Method push() should be used to fill in queue with new frames and stglSwapFB() to pop frame from queue
  * to display.
+ *
+ * The queue is a single-producer / single-consumer ring:
+ * only data thread advances push counter and only GL thread advances pop counter,
+ * so that push, pop and PTS queries do not lock.
+ * Methods clear() and drop() can be called from any thread - they just request
+ * skipping of queued frames, which is performed by GL thread.
  */
 class StGLTextureQueue {
 
@@ -41,13 +49,18 @@ class StGLTextureQueue {
      */
     ST_CPPEXPORT ~StGLTextureQueue();
 
+    /**
+     * Release GL resources (quad texture and pixel unpack buffers).
+     * Should be called from GL thread.
+     */
+    ST_CPPEXPORT void release(StGLContext& theCtx);
+
     /**
      * Set device capabilities.
+     * Should be called before data thread starts pushing frames.
      */
     ST_LOCAL void setDeviceCaps(const StGLDeviceCaps& theCaps) {
-        myMutexPush.lock();
         myDeviceCaps = theCaps;
-        myMutexPush.unlock();
     }
 
     /**
@@ -80,6 +93,7 @@ class StGLTextureQueue {
      * @param theSrcFormat    source data format
      * @param theSrcCubemap   format of cubemap
      * @param theSrcPTS       PTS (presentation timestamp)
+     * @param theSrcStamps    timestamps of previous pipeline hand-offs (optional)
      * @return true on success
      */
     ST_CPPEXPORT bool push(const StImage&     theSrcDataLeft,
@@ -87,17 +101,18 @@ class StGLTextureQueue {
                            const StHandle<StStereoParams>& theStParams,
                            const StFormat     theSrcFormat,
                            const StCubemap    theSrcCubemap,
-                           const double       theSrcPTS);
+                           const double       theSrcPTS,
+                           const StFrameStamps* theSrcStamps = NULL);
 
     /**
      * Retrieve queue statistics.
+     * Should be called from GL thread.
      */
     ST_LOCAL inline void getQueueInfo(int&    theQueued,
                                       int&    theQueueLen,
                                       double& theFps) {
-        myMeterMutex.lock();
         if(myHasStream) {
-            theQueued   = int(myQueueSize + 1);
+            theQueued   = int(getSize() + 1);
             theQueueLen = int(myQueueSizeMax);
             theFps      = myFPSMeter.getAverage();
         } else {
@@ -105,13 +120,19 @@ class StGLTextureQueue {
             theQueueLen = 0;
             theFps      = -1.0;
         }
-        const bool isUpdated = myFPSMeter.isUpdated();
-        myMeterMutex.unlock();
-        if(isUpdated) {
+        if(myFPSMeter.isUpdated()) {
             ST_DEBUG_LOG("Queue playback FPS " + theFps + ", buffers: " + theQueued + "/" + theQueueLen);
         }
     }
 
+    /**
+     * Return per-stage latency statistics of displayed frames.
+     * Can be accessed from any thread.
+     */
+    ST_LOCAL const StLatencyMeter& getLatencyMeter() const {
+        return myLatency;
+    }
+
     /**
      * Function called in loop from general GL draw loop
      * and do update quad texture data / state (display frame).
@@ -119,81 +140,67 @@ class StGLTextureQueue {
      */
     ST_CPPEXPORT bool stglUpdateStTextures(StGLContext& theCtx);
 
+    /**
+     * @return number of queued frames (frames requested to be dropped are not counted).
+     */
     ST_LOCAL size_t getSize() const {
-        myMutexSize.lock();
-            const size_t aResult = myQueueSize;
-        myMutexSize.unlock();
-        return aResult;
+        const uint32_t aPushCount = myPushCounter;
+        uint32_t       aPopCount  = myPopCounter;
+        const uint32_t aDropCount = myDropCounter;
+        if(int32_t(aDropCount - aPopCount) > 0) {
+            aPopCount = aDropCount;
+        }
+        return int32_t(aPushCount - aPopCount) > 0 ? size_t(aPushCount - aPopCount) : 0;
+    }
+
+    /**
+     * Should be called from GL thread.
+     * Connected stream state is intentionally ignored here - image loader keeps stream connected
+     * after successful load, while nothing changes until the next frame is pushed into the queue.
+     * @return true if queue holds frames to be uploaded or displayed,
+     *         so that next frame should be redrawn
+     */
+    ST_LOCAL bool hasPendingFrames() const {
+        return myIsInUpdTexture
+            || myIsReadyToSwap
+            || !isEmpty();
     }
 
     /**
      * @return true if queue is EMPTY.
      */
     ST_LOCAL bool isEmpty() const {
-        myMutexSize.lock();
-            const bool aResult = (myQueueSize == 0);
-        myMutexSize.unlock();
-        return aResult;
+        return getSize() == 0;
     }
 
     /**
+     * Notice that dropped frames still occupy the queue until GL thread skips them.
      * @return true if queue is FULL.
      */
     ST_LOCAL bool isFull() const {
-        myMutexSize.lock();
-            const bool aResult = ((myQueueSize + 1) == myQueueSizeMax);
-        myMutexSize.unlock();
-        return aResult;
+        return size_t(uint32_t(myPushCounter - myPopCounter)) + 1 >= myQueueSizeMax;
     }
 
     /**
      * @return presentation timestamp of currently shown frame (or -1 if none).
      */
     ST_LOCAL double getPTSCurr() const {
-        myMutexSize.lock();
-            const double aPts = (myHasStream || myQueueSize != 0)
-                              ? myCurrPts : -1.0;
-        myMutexSize.unlock();
-        return aPts;
+        return (myHasStream || !isEmpty())
+             ? myCurrPts : -1.0;
     }
 
     /**
      * @param thePts - next (front) stereo frame PTS (presentation timestamp);
      * @return false if next PTS not available.
      */
-    ST_LOCAL bool popPTSNext(double& thePts) {
-        bool aRes = false;
-        myMutexPop.lock();
-        myMutexPush.lock();
-        myMutexSize.lock();
-            // make sure front data is valid
-            if(myQueueSize < 1) {
-                aRes = false;
-            } else {
-                aRes = true;
-                thePts = myDataFront->getPTS();
-            }
-        myMutexSize.unlock();
-        myMutexPush.unlock();
-        myMutexPop.unlock();
-        return aRes;
-    }
+    ST_CPPEXPORT bool popPTSNext(double& thePts) const;
 
     /**
      * Send event to swap texture buffer Back->Front (increase swap counter).
      * @param theLimit - swap counter limit;
      * @return true if swap counter increased.
      */
-    ST_LOCAL bool stglSwapFB(const size_t theLimit) {
-        mySwapFBMutex.lock();
-        if(theLimit == 0 || mySwapFBCount < theLimit) {
-            ++mySwapFBCount;
-            mySwapFBMutex.unlock();
-            return true;
-        }
-        mySwapFBMutex.unlock();
-        return false;
-    }
+    ST_CPPEXPORT bool stglSwapFB(const size_t theLimit);
 
     /**
      * Release unused memory as fast as possible.
@@ -216,11 +223,8 @@ class StGLTextureQueue {
      * At this moment function used just for stereo/mono recognizing.
      */
     ST_LOCAL int getSrcFormat() {
-        myMutexSrcFormat.lock();
-            // TODO (Kirill Gavrilov#4#) source format should be defined like front PTS to prevent early changes
-            const int aSrcFrmt = myCurrSrcFormat;
-        myMutexSrcFormat.unlock();
-        return aSrcFrmt;
+        // TODO (Kirill Gavrilov#4#) source format should be defined like front PTS to prevent early changes
+        return myCurrSrcFormat;
     }
 
     enum {
@@ -244,32 +248,50 @@ class StGLTextureQueue {
 
     ST_CPPEXPORT int swapFBOnReady(StGLContext& theCtx);
 
+    /**
+     * Map pixel unpack buffers of free queue items,
+     * so that data thread would be able to copy next frames directly into them.
+     * Should be called from GL thread.
+     */
+    ST_LOCAL void stglMapUnpackBuffers(StGLContext& theCtx);
+
+    /**
+     * Skip frames requested to be dropped by clear() and drop().
+     * Should be called from GL thread.
+     */
+    ST_LOCAL void skipDropped();
+
         private:
 
-    StMutex          myMutexPop;
-    StGLTextureData* myDataFront;      //!< queue pointer
-    StGLTextureData* myDataSnap;       //!< snapshot pointer
-    StMutex          myMutexPush;
-    StGLTextureData* myDataBack;       //!< queue pointer
+    StGLTextureData* volatile myDataFront;    //!< queue front - next frame to display (modified only by GL thread)
+    StGLTextureData*          myDataBack;     //!< next free item to be filled by push() (modified only by data thread)
+    StGLTextureData* volatile myDataSnap;     //!< last displayed frame (set by GL thread, reset by push() before reusing the item)
+    StGLTextureData* volatile myDataSnapUsed; //!< frame being copied by getSnapshot() - should not be overridden by push()
+    StMutex                   myMutexSnap;    //!< serializes getSnapshot() calls
 
-    mutable StMutex  myMutexSize;
-    size_t           myQueueSize;
-    size_t           myQueueSizeMax;
+    volatile uint32_t myPushCounter;     //!< number of pushed frames (modified only by data thread)
+    volatile uint32_t myPopCounter;      //!< number of popped frames (modified only by GL thread)
+    volatile uint32_t myFrontSeq;        //!< odd while GL thread modifies myDataFront and myPopCounter
+    volatile uint32_t myDropCounter;     //!< frames with lesser number should be skipped
+    volatile uint32_t myClearCounter;    //!< number of clear() requests
+    uint32_t          myClearCounterGL;  //!< number of clear() requests processed by GL thread
+    volatile uint32_t myShotCounter;     //!< number of displayed frames
+    uint32_t          myShotCounterCopy; //!< displayed frame number at the moment of last snapshot
+    size_t            myQueueSizeMax;
+    volatile size_t   myUnpackSizeHint;  //!< pixel unpack buffer size required for the last pushed frame
 
-    StGLQuadTexture  myQTexture;       //!< quad stereo texture
+    StGLQuadTexture   myQTexture;        //!< quad stereo texture
 
-    StMutex          mySwapFBMutex;
-    size_t           mySwapFBCount;
+    volatile int32_t  mySwapFBCount;
 
-    StMutex          myMeterMutex;
-    StFPSMeter       myFPSMeter;
+    StFPSMeter        myFPSMeter;        //!< playback FPS meter (accessed only by GL thread)
+    StLatencyMeter    myLatency;         //!< per-stage latency of displayed frames
+    StFrameStamps     myStampsBack;      //!< timestamps of the frame uploaded into back buffer (accessed only by GL thread)
 
-    StMutex          myMutexSrcFormat;
-    int              myCurrSrcFormat;  //!< current source format
+    volatile int      myCurrSrcFormat;   //!< current source format
 
-    double           myCurrPts;
+    volatile double   myCurrPts;
 
-    StCondition      myNewShotEvent;
     bool             myIsInUpdTexture; //!< private bools for plugin thread
     bool             myIsReadyToSwap;
     bool             myToCompress;     //!< release unused memory as fast as possible
@@ -0,0 +1,147 @@
+/**
+ * StGLWidgets, small C++ toolkit for writing GUI using OpenGL.
+ * Copyright © 2017 Kirill Gavrilov <kirill@sview.ru>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file license-boost.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#ifndef __StGLDrawBatch_h_
+#define __StGLDrawBatch_h_
+
+#include <StGL/StGLVertexBuffer.h>
+#include <StGL/StGLVec.h>
+#include <StTemplates/StHandle.h>
+
+#include <vector>
+
+class StGLContext;
+class StGLMatrix;
+
+/**
+ * Collects solid and glyph quads of widgets into single dynamic vertex buffer
+ * to draw them with a handful of draw calls instead of one program switch and draw call per widget.
+ * Vertices are transformed on CPU into camera space, so that only projection matrix is shared.
+ * Consecutive quads using the same texture are merged into single draw call;
+ * solid quads do not sample the texture and thus are merged with any glyph run.
+ *
+ * Batching is scoped by begin()/end() pair (e.g. by StGLMenu),
+ * widgets which are not aware of batching should call flush() before drawing to preserve drawing order.
+ */
+class StGLDrawBatch {
+
+        public:
+
+    /**
+     * Empty constructor.
+     */
+    ST_CPPEXPORT StGLDrawBatch();
+
+    /**
+     * Destructor.
+     */
+    ST_CPPEXPORT ~StGLDrawBatch();
+
+    /**
+     * Release GL resources.
+     */
+    ST_CPPEXPORT void release(StGLContext& theCtx);
+
+    /**
+     * Initialize GL resources.
+     */
+    ST_CPPEXPORT bool init(StGLContext& theCtx);
+
+    /**
+     * Setup projection matrix.
+     */
+    ST_CPPEXPORT void setProjMat(StGLContext&      theCtx,
+                                 const StGLMatrix& theProjMat);
+
+    /**
+     * @return true if quads should be added to the batch instead of drawing them directly
+     */
+    ST_LOCAL bool isActive() const {
+        return myNbLayers > 0
+            && myIsValid;
+    }
+
+    /**
+     * Open batching scope; quads pending from outer scope are drawn first.
+     */
+    ST_CPPEXPORT void begin(StGLContext& theCtx);
+
+    /**
+     * Draw pending quads and close batching scope.
+     */
+    ST_CPPEXPORT void end(StGLContext& theCtx);
+
+    /**
+     * Draw pending quads.
+     */
+    ST_CPPEXPORT void flush(StGLContext& theCtx);
+
+    /**
+     * Add solid primitive.
+     * @param theStrip       vertices of triangle strip
+     * @param theNbVerts     number of vertices
+     * @param theColor       color (with opacity)
+     * @param theTranslation translation to camera space
+     */
+    ST_CPPEXPORT void addSolid(const StGLVec2*  theStrip,
+                               const size_t     theNbVerts,
+                               const StGLVec4&  theColor,
+                               const StGLVec3&  theTranslation);
+
+    /**
+     * Add glyphs from single texture.
+     * @param theTexture     texture in alpha format
+     * @param theVerts       vertices of triangles
+     * @param theTCrds       texture coordinates of triangles
+     * @param theColor       text color (with opacity)
+     * @param theTranslation translation to camera space
+     * @param theScale       scale factor applied to vertices before translation
+     */
+    ST_CPPEXPORT void addGlyphs(const GLuint                 theTexture,
+                                const std::vector<StGLVec2>& theVerts,
+                                const std::vector<StGLVec2>& theTCrds,
+                                const StGLVec4&              theColor,
+                                const StGLVec3&              theTranslation,
+                                const GLfloat                theScale);
+
+        private:
+
+    /**
+     * Consecutive range of triangles sharing the texture.
+     */
+    struct Command {
+        GLuint  Texture; //!< texture to bind, 0 for solid-only range
+        GLsizei First;   //!< first vertex
+        GLsizei Count;   //!< number of vertices
+    };
+
+    class Program;
+
+    /**
+     * Append vertices range to the last command or start new one.
+     */
+    ST_LOCAL void addCommand(const GLuint theTexture,
+                             const size_t theFirst);
+
+        private:
+
+    StHandle<Program>     myProgram;     //!< GLSL program
+    StGLVertexBuffer      myVertBuf;     //!< positions
+    StGLVertexBuffer      myTCrdBuf;     //!< texture coordinates, negative for solid primitives
+    StGLVertexBuffer      myColorBuf;    //!< colors
+    std::vector<StGLVec3> myVerts;       //!< pending positions
+    std::vector<StGLVec2> myTCrds;       //!< pending texture coordinates
+    std::vector<StGLVec4> myColors;      //!< pending colors
+    std::vector<Command>  myCommands;    //!< pending draw commands
+    int                   myNbLayers;    //!< number of opened batching scopes
+    bool                  myIsValid;     //!< program has been successfully initialized
+
+};
+
+#endif // __StGLDrawBatch_h_
@@ -1,6 +1,6 @@
 /**
  * StGLWidgets, small C++ toolkit for writing GUI using OpenGL.
- * Copyright © 2013-2015 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2013-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -12,6 +12,7 @@
 
 #include <StGLWidgets/StGLTextArea.h>
 #include <StGLWidgets/StGLMenuProgram.h>
+#include <StThreads/StLatencyMeter.h>
 
 /**
  * Widget for displaying diagnostic information
@@ -34,6 +35,12 @@ class StGLFpsLabel : public StGLTextArea {
     ST_LOCAL int&    changePlayQueued()      { return myPlayQueued; }
     ST_LOCAL int&    changePlayQueueLength() { return myPlayQueueLen; }
 
+    /**
+     * Set playback pipeline latency statistics to display (NULL to hide).
+     * The meter should remain valid while assigned to this widget.
+     */
+    ST_LOCAL void setLatencyMeter(const StLatencyMeter* theMeter) { myLatency = theMeter; }
+
         public:  //! @name Signals
 
     struct {
@@ -53,6 +60,7 @@ class StGLFpsLabel : public StGLTextArea {
     double       myPlayFps;      //!< video decoding FPS
     int          myPlayQueued;   //!< queued frames
     int          myPlayQueueLen; //!< queue length
+    const StLatencyMeter* myLatency; //!< playback pipeline latency statistics
     StTimer      myTimer;        //!< FPS timer
     unsigned int myCounter;      //!< frames counter
 
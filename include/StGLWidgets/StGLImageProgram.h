@@ -75,6 +75,8 @@ class StGLImageProgram : public StGLProgramMatrix<1, 5, StGLMeshProgram> {
         FragToRgb_FromYuv9Mpeg,
         FragToRgb_FromYuv10Full,
         FragToRgb_FromYuv10Mpeg,
+        FragToRgb_FromYuv12Full,
+        FragToRgb_FromYuv12Mpeg,
         FragToRgb_FromYuvNvFull,
         FragToRgb_FromYuvNvMpeg,
         FragToRgb_CUBEMAP,
@@ -1,6 +1,6 @@
 /**
  * StGLWidgets, small C++ toolkit for writing GUI using OpenGL.
- * Copyright © 2009-2016 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2009-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -215,6 +215,8 @@ class StGLMenu : public StGLWidget {
 
     StGLVertexBuffer           myVertexBuf;
     StGLVertexBuffer           myVertexBndBuf;
+    StArray<StGLVec2>          myVertices;      //!< background vertices for batched drawing
+    StArray<StGLVec2>          myVerticesBnd;   //!< bounds vertices for batched drawing
     StGLVec4                   myColorVec;
     int                        myOrient;
     int                        myItemHeight;
@@ -1,6 +1,6 @@
 /**
  * StGLWidgets, small C++ toolkit for writing GUI using OpenGL.
- * Copyright © 2009-2015 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2009-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -170,6 +170,7 @@ class StGLMenuItem : public StGLTextArea {
     StGLMenu*                  mySubMenu;        //!< child menu
     StGLIcon*                  myIcon;           //!< optional icon
     StGLVertexBuffer           myBackVertexBuf;  //!< background vertices
+    StArray<StGLVec2>          myBackVertices;   //!< background vertices for batched drawing
     StGLVec4                   myBackColor[3];   //!< background color per state
     Arrow                      myArrowIcon;      //!< draw arrow
     bool                       myIsItemSelected; //!< navigation selection flag
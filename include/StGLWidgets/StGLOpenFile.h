@@ -14,6 +14,7 @@
 #include <StGLWidgets/StGLRootWidget.h>
 #include <StFile/StMIMEList.h>
 
+class StFileNode;
 class StGLMenu;
 class StGLMenuItem;
 
@@ -70,6 +71,13 @@ class StGLOpenFile : public StGLMessageBox {
                                   const StGLVec4& theColor,
                                   const bool      theisFolder);
 
+    /**
+     * Assign thumbnail (or folder icon) to the item of the file list.
+     */
+    ST_CPPEXPORT void setItemThumbnail(StGLMenuItem*     theItem,
+                                       const StGLVec4&   theColor,
+                                       const StFileNode* theNode);
+
     /**
      * Handle hot-item click event - just remember item id.
      */
@@ -113,6 +121,7 @@ class StGLOpenFile : public StGLMessageBox {
     int                        myHotSizeX;
     int                        myMarginX;
     int                        myIconSizeX;
+    int                        myThumbSizeX;    //!< size of thumbnails within the file list
 
 };
 
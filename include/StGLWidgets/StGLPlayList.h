@@ -1,6 +1,6 @@
 /**
  * StGLWidgets, small C++ toolkit for writing GUI using OpenGL.
- * Copyright © 2013-2015 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2013-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -49,6 +49,21 @@ class StGLPlayList : public StGLWidget {
         return myFitMargins;
     }
 
+    /**
+     * Return true if file thumbnails are displayed next to item titles.
+     */
+    ST_LOCAL bool toShowThumbnails() const {
+        return myToShowThumbs;
+    }
+
+    /**
+     * Display file thumbnails next to item titles (false by default).
+     * Should be called before the widget initialization.
+     */
+    ST_LOCAL void setShowThumbnails(const bool theToShow) {
+        myToShowThumbs = theToShow;
+    }
+
         public:  //! @name Signals
 
     struct {
@@ -71,6 +86,8 @@ class StGLPlayList : public StGLWidget {
         protected:
 
     ST_LOCAL StGLMenuItem* addItem();
+    ST_LOCAL void setItemPath(StGLMenuItem*   theItem,
+                              const StString& thePath);
     ST_LOCAL void stglDrawScrollBar(unsigned int theView);
     ST_LOCAL bool stglInitMenu();
 
@@ -87,6 +104,7 @@ class StGLPlayList : public StGLWidget {
     int                  myItemsNb;      //!< number of items displayed on screen
     volatile bool        myToResetList;  //!< playlist has been reseted
     volatile bool        myToUpdateList; //!< playlist has been changed
+    bool                 myToShowThumbs; //!< display file thumbnails
 
     bool       myIsLeftClick; //!< flag to perform dragging - some item has been clicked (but not yet unclicked)
     StPointD_t myClickPntZo;  //!< remembered mouse click position
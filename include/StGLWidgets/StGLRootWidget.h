@@ -14,10 +14,12 @@
 #include <StGLWidgets/StGLWidget.h>
 #include <StGL/StGLFontManager.h>
 #include <StGL/StGLTexture.h>
+#include <StImage/StThumbnailCache.h>
 #include <StThreads/StResourceManager.h>
 
 template<> inline void StArray<StGLNamedTexture>::sort() {}
 typedef StArray<StGLNamedTexture> StGLTextureArray;
+class StGLDrawBatch;
 class StGLMenuProgram;
 class StGLMessageBox;
 class StGLTextProgram;
@@ -122,6 +124,11 @@ class StGLRootWidget : public StGLWidget {
      */
     ST_LOCAL StGLTextBorderProgram& getTextBorderProgram() { return *myTextBorderProgram; }
 
+    /**
+     * Get shared batch of widgets primitives.
+     */
+    ST_LOCAL StGLDrawBatch& getDrawBatch() { return *myDrawBatch; }
+
     /**
      * Return color of standard element.
      */
@@ -398,6 +405,18 @@ class StGLRootWidget : public StGLWidget {
         return myGlFontMgr;
     }
 
+    /**
+     * @return shared thumbnails cache, created on first call
+     */
+    ST_CPPEXPORT const StHandle<StThumbnailCache>& getThumbnails();
+
+    /**
+     * @return true if thumbnails cache has been already created
+     */
+    ST_LOCAL bool hasThumbnails() const {
+        return !myThumbnails.isNull();
+    }
+
     /**
      * Returns camera projection matrix within to-screen displacement
      * thus it can be used for vertices given in only 2D-coordinates.
@@ -425,6 +444,21 @@ class StGLRootWidget : public StGLWidget {
         return myCursorZo;
     }
 
+    /**
+     * Return true if some widget has been changed since last update,
+     * so that GUI should be redrawn.
+     */
+    ST_LOCAL bool isDirty() const {
+        return myIsDirty;
+    }
+
+    /**
+     * Mark GUI as changed, normally called by StGLWidget::invalidate().
+     */
+    ST_LOCAL void setDirty() {
+        myIsDirty = true;
+    }
+
     using StGLWidget::stglResize;
     ST_CPPEXPORT virtual void stglUpdate(const StPointD_t& theCursorZo,
                                          bool theIsPreciseInput) ST_ATTR_OVERRIDE;
@@ -493,6 +527,7 @@ class StGLRootWidget : public StGLWidget {
     StGLProjCamera            myProjCamera;    //!< projection camera
     StGLMatrix                myScrProjMat;    //!< projection matrix within translation to the screen
     StHandle<StGLFontManager> myGlFontMgr;     //!< shared font manager
+    StHandle<StThumbnailCache> myThumbnails;   //!< shared thumbnails cache
     StHandle<StGLContext>     myGlCtx;         //!< OpenGL context
     GLfloat                   myScrDispX;
     GLfloat                   myLensDist;
@@ -506,6 +541,7 @@ class StGLRootWidget : public StGLWidget {
     StHandle<StGLMenuProgram>  myMenuProgram;
     StHandle<StGLTextProgram>  myTextProgram;
     StHandle<StGLTextBorderProgram> myTextBorderProgram;
+    StHandle<StGLDrawBatch>    myDrawBatch;
 
     bool                      myIsMobile;      //!< flag indicating mobile device
     StMarginsI                myMarginsPx;     //!< active area margins in pixels
@@ -524,6 +560,7 @@ class StGLRootWidget : public StGLWidget {
     StGLMessageBox*           myModalDialog;   //!< active dialog
 
     bool                      myIsMenuPressed; //!< global flag to perform navigation in menu after first item clicked
+    bool                      myIsDirty;       //!< some widget has been changed since last update
 
         protected:
 
@@ -1,6 +1,6 @@
 /**
  * StGLWidgets, small C++ toolkit for writing GUI using OpenGL.
- * Copyright © 2009-2016 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2009-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -11,7 +11,10 @@
 #define __StGLSeekBar_h_
 
 #include <StGLWidgets/StGLWidget.h>
+#include <StGL/StGLTexture.h>
 #include <StGL/StGLVertexBuffer.h>
+#include <StImage/StThumbnailAtlas.h>
+#include <StThreads/StTimer.h>
 
 /**
  * Simple seeking bar widget.
@@ -44,6 +47,13 @@ class StGLSeekBar : public StGLWidget {
         myMoveTolerPx = theTolerPx;
     }
 
+    /**
+     * Set thumbnails to preview on hover, NULL to disable preview.
+     */
+    ST_LOCAL void setThumbnails(const StHandle<StThumbnailAtlas>& theThumbs) {
+        myThumbs = theThumbs;
+    }
+
     ST_CPPEXPORT virtual void stglResize() ST_ATTR_OVERRIDE;
     ST_CPPEXPORT virtual bool stglInit() ST_ATTR_OVERRIDE;
     ST_CPPEXPORT virtual void stglUpdate(const StPointD_t& theCursor,
@@ -76,6 +86,7 @@ class StGLSeekBar : public StGLWidget {
         private: //! @name private methods
 
     ST_LOCAL void stglUpdateVertices();
+    ST_LOCAL void stglDrawThumbnail();
     ST_LOCAL double getPointInEx(const StPointD_t& thePointZo) const;
 
         private:
@@ -90,6 +101,16 @@ class StGLSeekBar : public StGLWidget {
     int                   myClickPos;
     int                   myMoveTolerPx;
 
+    class StProgramThumb;
+    StHandle<StProgramThumb>   myThumbProgram;   //!< GLSL program for thumbnail preview
+    StHandle<StThumbnailAtlas> myThumbs;         //!< thumbnails to preview
+    StGLTexture                myThumbTexture;   //!< uploaded thumbnails atlas
+    StGLVertexBuffer           myThumbVertices;  //!< thumbnail preview vertices VBO
+    StGLVertexBuffer           myThumbTCoords;   //!< thumbnail preview texture coordinates VBO
+    StTimer                    myThumbTimer;     //!< timer to limit atlas re-uploading frequency
+    size_t                     myThumbRevision;  //!< revision of uploaded atlas
+    double                     myHoverPos;       //!< hovered position 0..1, or negative if not hovered
+
 };
 
 #endif // __StGLSeekBar_h_
@@ -18,6 +18,7 @@
 #include <StGLWidgets/StGLShare.h>
 #include <StGLWidgets/StGLWidget.h>
 
+class StGLDrawBatch;
 class StGLTextProgram;
 class StGLTextBorderProgram;
 
@@ -226,6 +227,14 @@ class StGLTextArea : public StGLWidget {
 
     ST_LOCAL void drawText(StGLContext& theCtx);
 
+    /**
+     * Add formatted text into the batch instead of drawing it directly.
+     */
+    ST_LOCAL void addTextToBatch(StGLDrawBatch&  theBatch,
+                                 const StGLVec3& theTranslation,
+                                 const GLfloat   theScale,
+                                 const StGLVec4& theColor);
+
     ST_LOCAL void recomputeBorder(StGLContext& theCtx);
 
     ST_LOCAL void computeTextWidthFake(const StString& theText,
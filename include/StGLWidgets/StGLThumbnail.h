@@ -0,0 +1,98 @@
+/**
+ * StGLWidgets, small C++ toolkit for writing GUI using OpenGL.
+ * Copyright © 2017 Kirill Gavrilov <kirill@sview.ru>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file license-boost.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#ifndef __StGLThumbnail_h_
+#define __StGLThumbnail_h_
+
+#include <StGLWidgets/StGLTextureButton.h>
+#include <StImage/StThumbnailCache.h>
+
+/**
+ * Icon displaying thumbnail of the file.
+ * The thumbnail is requested from StThumbnailCache only while the widget is within visible area of its parents,
+ * and the texture is released when the widget is scrolled out, so that long lists do not consume video memory.
+ * Fallback texture (generic file icon) is displayed until the thumbnail is ready or when file has no thumbnail.
+ */
+class StGLThumbnail : public StGLIcon {
+
+        public:
+
+    /**
+     * Main constructor.
+     * @param theParent parent widget
+     * @param theLeft   left position
+     * @param theTop    top position
+     * @param theCorner corner
+     * @param theSize   size of square area to fit the thumbnail in
+     */
+    ST_CPPEXPORT StGLThumbnail(StGLWidget*      theParent,
+                               const int        theLeft,
+                               const int        theTop,
+                               const StGLCorner theCorner,
+                               const int        theSize);
+
+    ST_CPPEXPORT virtual ~StGLThumbnail();
+
+    /**
+     * @return file path
+     */
+    ST_LOCAL const StString& getPath() const {
+        return myPath;
+    }
+
+    /**
+     * Set file path to display the thumbnail for.
+     */
+    ST_CPPEXPORT void setPath(const StString& thePath);
+
+    /**
+     * Define externally managed texture displayed when thumbnail is unavailable.
+     */
+    ST_CPPEXPORT void setFallbackTextures(const StHandle<StGLTextureArray>& theTextures);
+
+    ST_CPPEXPORT virtual bool stglInit() ST_ATTR_OVERRIDE;
+    ST_CPPEXPORT virtual void stglUpdate(const StPointD_t& theCursorZo,
+                                         bool theIsPreciseInput) ST_ATTR_OVERRIDE;
+
+        private:
+
+    /**
+     * @return true if widget is within visible area of all parents
+     */
+    ST_LOCAL bool isOnScreen();
+
+    /**
+     * Release the thumbnail texture and switch to fallback texture.
+     */
+    ST_LOCAL void releaseThumbnail();
+
+    /**
+     * Scale the thumbnail to fit widget area and upload it into the texture.
+     */
+    ST_LOCAL void uploadThumbnail(const StImage& theImage);
+
+    /**
+     * Switch between thumbnail and fallback textures, and center the image within widget area.
+     */
+    ST_LOCAL void updateFace();
+
+        private:
+
+    StHandle<StThumbnailCache> myCache;      //!< thumbnails source
+    StHandle<StGLTextureArray> myThumbTex;   //!< thumbnail texture
+    StHandle<StGLTextureArray> myFallback;   //!< fallback texture
+    StString                   myPath;       //!< file path
+    size_t                     myLastStamp;  //!< value of StThumbnailCache::getNbProcessed() on last request
+    int                        mySize;       //!< size of area to fit the thumbnail in
+    bool                       myIsReady;    //!< flag indicating that thumbnail has been processed
+    bool                       myIsInit;     //!< flag indicating that stglInit() has been called
+
+};
+
+#endif // __StGLThumbnail_h_
@@ -189,6 +189,7 @@ class StGLWidget {
     ST_LOCAL void setRectPx(const StRectI_t& theRectPx) {
         myIsResized = true;
         myRectPx = theRectPx;
+        invalidate();
     }
 
     /**
@@ -197,9 +198,17 @@ class StGLWidget {
      */
     ST_LOCAL StRectI_t& changeRectPx() {
         myIsResized = true;
+        invalidate();
         return myRectPx;
     }
 
+    /**
+     * Mark widget as changed, so that the whole GUI will be redrawn on next frame.
+     * Should be called on every state change affecting widget appearance,
+     * including animation in progress.
+     */
+    ST_CPPEXPORT void invalidate();
+
     /**
      * Return true if widget has been marked resized, but not yet updated.
      */
@@ -1,5 +1,5 @@
 /**
- * Copyright © 2010-2015 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2010-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -68,6 +68,8 @@ class StImage {
         ImgScale_Mpeg10,  //!< YUV 10 bits in 16 bits    Y   64..940;   U and V   64..960
         ImgScale_Jpeg9,   //!< 9  bits in 16 bits 0...511
         ImgScale_Jpeg10,  //!< 10 bits in 16 bits 0..1023
+        ImgScale_Mpeg12,  //!< YUV 12 bits in 16 bits    Y  256..3760;  U and V  256..3840
+        ImgScale_Jpeg12,  //!< 12 bits in 16 bits 0..4095
         ImgScale_NvFull,  //!< full range (use all bits)
         ImgScale_NvMpeg,  //!< YUV  8 bits per component Y   16..235;   U and V   16..240
     } ImgColorScale;
@@ -1,5 +1,5 @@
 /**
- * Copyright © 2010-2016 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2010-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -41,6 +41,7 @@ class StImagePlane {
         ImgRGBAF,       //!< 4 floats (16-bytes) RGBA image plane
         ImgBGRAF,       //!< same as RGBAF but with different components order
         ImgUV,          //!< 2 bytes packed UV image plane
+        ImgUV16,        //!< 4 bytes packed UV image plane (2x16 bits)
     } ImgFormat;
 
     ST_CPPEXPORT static StString formatImgFormat(ImgFormat theImgFormat);
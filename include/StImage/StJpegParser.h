@@ -1,5 +1,5 @@
 /**
- * Copyright © 2011-2015 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2011-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -117,6 +117,7 @@ class StJpegParser : public StRawFile {
 
     /**
      * Read the file content.
+     * The whole file is memory-mapped (when possible) instead of being copied into heap buffer.
      */
     ST_CPPEXPORT virtual bool readFile(const StCString& theFilePath,
                                        const int        theOpenedFd = -1,
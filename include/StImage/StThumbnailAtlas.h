@@ -0,0 +1,226 @@
+/**
+ * Copyright © 2017 Kirill Gavrilov <kirill@sview.ru>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file license-boost.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#ifndef __StThumbnailAtlas_h_
+#define __StThumbnailAtlas_h_
+
+#include "StImagePlane.h"
+
+#include <StThreads/StMutex.h>
+
+#include <vector>
+
+/**
+ * Fixed-size grid of equally sized RGB thumbnails packed into single image plane.
+ * Cell N holds thumbnail for N-th of getNbCells() equal time slots of the media,
+ * so that memory consumption is bounded by atlas dimensions regardless of media duration.
+ * Cells are filled by producer thread, while consumer (GL thread) uploads the whole plane
+ * each time the revision is changed.
+ */
+class StThumbnailAtlas {
+
+        public:
+
+    /**
+     * Empty constructor.
+     */
+    StThumbnailAtlas()
+    : myNbCellsX(0),
+      myNbCellsY(0),
+      myNbFilled(0),
+      myRevision(0) {}
+
+    /**
+     * Allocate atlas and mark all cells empty.
+     * @param theCellSizeX thumbnail width
+     * @param theCellSizeY thumbnail height
+     * @param theNbCellsX  number of columns
+     * @param theNbCellsY  number of rows
+     * @return false on allocation failure
+     */
+    bool init(const size_t theCellSizeX,
+              const size_t theCellSizeY,
+              const size_t theNbCellsX,
+              const size_t theNbCellsY) {
+        StMutexAuto aLock(myMutex);
+        myFilled.assign(theNbCellsX * theNbCellsY, false);
+        myNbCellsX = theNbCellsX;
+        myNbCellsY = theNbCellsY;
+        myNbFilled = 0;
+        ++myRevision;
+        if(!myPlane.initZero(StImagePlane::ImgRGB, theCellSizeX * theNbCellsX, theCellSizeY * theNbCellsY)) {
+            clearUnlocked();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Release memory.
+     */
+    void clear() {
+        StMutexAuto aLock(myMutex);
+        clearUnlocked();
+    }
+
+    /**
+     * @return number of cells (time slots)
+     */
+    size_t getNbCells() const {
+        StMutexAuto aLock(myMutex);
+        return myFilled.size();
+    }
+
+    /**
+     * @return number of filled cells
+     */
+    size_t getNbFilled() const {
+        StMutexAuto aLock(myMutex);
+        return myNbFilled;
+    }
+
+    /**
+     * @return counter incremented on each modification
+     */
+    size_t getRevision() const {
+        return myRevision;
+    }
+
+    /**
+     * @return cell width
+     */
+    size_t getCellSizeX() const {
+        return myNbCellsX != 0 ? myPlane.getSizeX() / myNbCellsX : 0;
+    }
+
+    /**
+     * @return cell height
+     */
+    size_t getCellSizeY() const {
+        return myNbCellsY != 0 ? myPlane.getSizeY() / myNbCellsY : 0;
+    }
+
+    /**
+     * @return number of columns
+     */
+    size_t getNbCellsX() const {
+        return myNbCellsX;
+    }
+
+    /**
+     * @return number of rows
+     */
+    size_t getNbCellsY() const {
+        return myNbCellsY;
+    }
+
+    /**
+     * Lock should be held while accessing atlas image.
+     */
+    StMutex& getMutex() const {
+        return myMutex;
+    }
+
+    /**
+     * @return atlas image, should be accessed within lock
+     */
+    const StImagePlane& getPlane() const {
+        return myPlane;
+    }
+
+    /**
+     * @return true if cell has been filled
+     */
+    bool isFilled(const size_t theCell) const {
+        StMutexAuto aLock(myMutex);
+        return theCell < myFilled.size()
+            && myFilled[theCell];
+    }
+
+    /**
+     * Copy thumbnail into the cell.
+     * @param theCell  cell index
+     * @param theThumb RGB image of cell dimensions (larger image is cropped)
+     * @return false if cell index is out of range or image format is unsupported
+     */
+    bool setCell(const size_t        theCell,
+                 const StImagePlane& theThumb) {
+        StMutexAuto aLock(myMutex);
+        if(theCell >= myFilled.size()
+        || theThumb.getFormat() != StImagePlane::ImgRGB) {
+            return false;
+        }
+
+        const size_t aCellSizeX = getCellSizeX();
+        const size_t aCellSizeY = getCellSizeY();
+        const size_t aCol0      = (theCell % myNbCellsX) * aCellSizeX;
+        const size_t aRow0      = (theCell / myNbCellsX) * aCellSizeY;
+        const size_t aRowBytes  = stMin(theThumb.getSizeX(), aCellSizeX) * myPlane.getSizePixelBytes();
+        const size_t aNbRows    = stMin(theThumb.getSizeY(), aCellSizeY);
+        for(size_t aRow = 0; aRow < aNbRows; ++aRow) {
+            stMemCpy(myPlane.changeData(aRow0 + aRow, aCol0), theThumb.getData(aRow, 0), aRowBytes);
+        }
+
+        if(!myFilled[theCell]) {
+            myFilled[theCell] = true;
+            ++myNbFilled;
+        }
+        ++myRevision;
+        return true;
+    }
+
+    /**
+     * Find filled cell nearest to specified position.
+     * @param theProgress position within 0..1 range
+     * @return cell index or -1 if atlas is empty
+     */
+    int findCell(const double theProgress) const {
+        StMutexAuto aLock(myMutex);
+        const int aNbCells = (int )myFilled.size();
+        if(myNbFilled == 0
+        || aNbCells   == 0) {
+            return -1;
+        }
+
+        const int aCell = stClamp(int(theProgress * double(aNbCells)), 0, aNbCells - 1);
+        for(int aDelta = 0; aDelta < aNbCells; ++aDelta) {
+            if(aCell - aDelta >= 0
+            && myFilled[aCell - aDelta]) {
+                return aCell - aDelta;
+            } else if(aCell + aDelta < aNbCells
+                   && myFilled[aCell + aDelta]) {
+                return aCell + aDelta;
+            }
+        }
+        return -1;
+    }
+
+        private:
+
+    void clearUnlocked() {
+        myPlane.nullify(StImagePlane::ImgRGB);
+        myFilled.clear();
+        myNbCellsX = 0;
+        myNbCellsY = 0;
+        myNbFilled = 0;
+        ++myRevision;
+    }
+
+        private:
+
+    StImagePlane      myPlane;    //!< atlas image
+    std::vector<bool> myFilled;   //!< filled cells
+    mutable StMutex   myMutex;    //!< lock for thread-safety
+    size_t            myNbCellsX; //!< number of columns
+    size_t            myNbCellsY; //!< number of rows
+    volatile size_t   myNbFilled; //!< number of filled cells
+    volatile size_t   myRevision; //!< modification counter
+
+};
+
+#endif // __StThumbnailAtlas_h_
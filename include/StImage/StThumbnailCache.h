@@ -0,0 +1,196 @@
+/**
+ * Copyright © 2017 Kirill Gavrilov <kirill@sview.ru>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file license-boost.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#ifndef __StThumbnailCache_h_
+#define __StThumbnailCache_h_
+
+#include <StImage/StImage.h>
+#include <StThreads/StCondition.h>
+#include <StThreads/StMutex.h>
+#include <StThreads/StThread.h>
+
+#include <deque>
+#include <list>
+#include <map>
+#include <set>
+#include <vector>
+
+class StRawFile;
+
+/**
+ * Service generating thumbnails of image files.
+ *
+ * Thumbnails are generated by the pool of background threads
+ * and stored as small JPEG images within the single database file,
+ * so that they are displayed instantly on the next launch.
+ * The database is an append-only sequence of records keyed by file path, size and modification time;
+ * it is memory-mapped on startup and compacted when outdated records take too much space.
+ *
+ * Decoded thumbnails are kept within small LRU cache in memory.
+ * Requests are processed in reversed order (the most recent first) and the queue is limited,
+ * so that scrolling through large folders does not delay thumbnails of currently visible items.
+ */
+class StThumbnailCache {
+
+        public:
+
+    /**
+     * Maximal dimension of generated thumbnail.
+     */
+    static const size_t THE_THUMB_SIZE = 128;
+
+        public:
+
+    /**
+     * Main constructor.
+     * @param theCacheFolder folder to store the database, empty string disables persistence
+     * @param theNbThreads   number of working threads, 0 means auto
+     */
+    ST_CPPEXPORT StThumbnailCache(const StString& theCacheFolder,
+                                  const int       theNbThreads = 0);
+
+    /**
+     * Destructor, stops working threads.
+     */
+    ST_CPPEXPORT ~StThumbnailCache();
+
+    /**
+     * Find decoded thumbnail; thumbnail generation is requested when it is not yet available.
+     * @param thePath  file path
+     * @param theImage decoded thumbnail in RGB(A) or gray format, NULL if file can not be decoded
+     * @return true if file has been processed
+     */
+    ST_CPPEXPORT bool find(const StString&    thePath,
+                           StHandle<StImage>& theImage);
+
+    /**
+     * @return counter of processed requests, which can be used to skip redundant find() calls
+     */
+    ST_LOCAL size_t getNbProcessed() const {
+        return myNbProcessed;
+    }
+
+    /**
+     * @return true if some requests are queued or being processed by working threads
+     */
+    ST_CPPEXPORT bool hasPendingRequests() const;
+
+    /**
+     * @return number of thumbnails in the database
+     */
+    ST_CPPEXPORT size_t getNbEntries() const;
+
+    /**
+     * Working thread loop, should not be called directly.
+     */
+    ST_LOCAL void workerLoop();
+
+        private:
+
+    /**
+     * Thumbnail record within the database.
+     */
+    struct DbEntry {
+        uint64_t FileSize; //!< size of the source file
+        int64_t  ModTime;  //!< modification time of the source file
+        size_t   Offset;   //!< offset to the record within the database file
+        size_t   DataSize; //!< size of the JPEG data, 0 if file can not be decoded
+        size_t   RecSize;  //!< size of the whole record
+    };
+
+    /**
+     * Decoded thumbnail.
+     */
+    struct ReadyEntry {
+        StHandle<StImage>            Image;   //!< decoded thumbnail, NULL if file can not be decoded
+        std::list<StString>::iterator LruIter; //!< position within LRU list
+    };
+
+    /**
+     * Load the database, compact it when necessary.
+     * Called lazily by working thread on first access (within locked mutex).
+     */
+    ST_LOCAL void loadDb();
+
+    /**
+     * Rewrite the database keeping only actual records (within locked mutex).
+     * @param theSizeLimit maximum size of the new database, the oldest records exceeding the limit are dropped
+     */
+    ST_LOCAL void compactDb(const size_t theSizeLimit);
+
+    /**
+     * Map the database file (within locked mutex).
+     */
+    ST_LOCAL bool mapDb();
+
+    /**
+     * Find JPEG data within the database and copy it.
+     * @param theIsValid flag indicating that the file has been decoded successfully
+     * @return true if actual record has been found
+     */
+    ST_LOCAL bool findDb(const StString&        thePath,
+                         const uint64_t         theFileSize,
+                         const int64_t          theModTime,
+                         bool&                  theIsValid,
+                         std::vector<stUByte_t>& theData);
+
+    /**
+     * Append new record to the database.
+     */
+    ST_LOCAL void appendDb(const StString&   thePath,
+                           const uint64_t    theFileSize,
+                           const int64_t     theModTime,
+                           const stUByte_t*  theData,
+                           const size_t      theDataSize);
+
+    /**
+     * Decode the source image and encode the thumbnail.
+     */
+    ST_LOCAL static bool generate(const StString&         thePath,
+                                  std::vector<stUByte_t>& theData);
+
+    /**
+     * Decode the thumbnail from JPEG data.
+     */
+    ST_LOCAL static StHandle<StImage> decode(const StString&               thePath,
+                                             const std::vector<stUByte_t>& theData);
+
+    /**
+     * Put decoded thumbnail into LRU cache.
+     */
+    ST_LOCAL void addReady(const StString&          thePath,
+                           const StHandle<StImage>& theImage);
+
+    /**
+     * Thread function.
+     */
+    static SV_THREAD_FUNCTION workerThread(void* theCache);
+
+        private:
+
+    std::vector< StHandle<StThread> > myThreads;  //!< working threads
+    StCondition                  myEvent;         //!< event to wake up working threads
+    mutable StMutex              myMutex;         //!< lock for the queue and LRU cache
+    std::deque<StString>         myQueue;         //!< requested paths, most recent first
+    std::set<StString>           myInProgress;    //!< paths being processed by working threads
+    std::map<StString, ReadyEntry> myReady;       //!< decoded thumbnails
+    std::list<StString>          myReadyLru;      //!< decoded thumbnails, most recently used first
+
+    mutable StMutex              myDbMutex;       //!< lock for the database
+    StString                     myDbPath;        //!< path to the database file
+    StHandle<StRawFile>          myDbFile;        //!< mapped database file
+    std::map<StString, DbEntry>  myDbIndex;       //!< index of the database records
+    size_t                       myDbSize;        //!< database file size
+    bool                         myIsDbLoaded;    //!< flag indicating that database has been loaded
+
+    volatile size_t              myNbProcessed;   //!< counter of processed requests
+    volatile bool                myToQuit;        //!< flag to stop working threads
+
+};
+
+#endif // __StThumbnailCache_h_
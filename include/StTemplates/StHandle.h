@@ -1,5 +1,5 @@
 /**
- * Copyright © 2010-2013 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2010-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -228,6 +228,14 @@ class StHandle {
         return myEntity == NULL;
     }
 
+    /**
+     * Check that this handle is the only owner of referred object.
+     */
+    inline bool isUnique() const {
+        return myEntity != NULL
+            && myEntity->myCounter.getValue() == 1;
+    }
+
     /**
      * Check for equality
      */
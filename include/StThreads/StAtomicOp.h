@@ -1,5 +1,5 @@
 /**
- * Copyright © 2011-2014 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2011-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -93,6 +93,78 @@ class StAtomicOp {
         return (uint32_t )Decrement((volatile int32_t& )theValue);
     }
 
+    /**
+     * Atomically replace the value with new one if it is equal to expected value.
+     * @param theValue    (volatile int32_t& ) - value to modify;
+     * @param theExpected (int32_t ) - expected current value;
+     * @param theNew      (int32_t ) - new value;
+     * @return true if value has been replaced.
+     */
+    static inline bool CompareAndSwap(volatile int32_t& theValue,
+                                      const int32_t     theExpected,
+                                      const int32_t     theNew) {
+    #ifdef __GCC_HAVE_SYNC_COMPARE_AND_SWAP_4
+        // g++ compiler
+        return __sync_bool_compare_and_swap(&theValue, theExpected, theNew);
+    #elif defined(_WIN32)
+        return InterlockedCompareExchange((volatile LONG* )&theValue, theNew, theExpected) == theExpected;
+    #elif defined(__APPLE__)
+        return OSAtomicCompareAndSwap32Barrier(theExpected, theNew, &theValue);
+    #elif defined(__GNUC__)
+        #error "Set -march=i486 or -march=armv7-a for gcc compiler"
+        return false;
+    #else
+        #error "Atomic operation doesn't implemented for current platform!"
+        return false;
+    #endif
+    }
+
+    /**
+     * Atomically replace the value with new one if it is equal to expected value.
+     */
+    static inline bool CompareAndSwap(volatile uint32_t& theValue,
+                                      const uint32_t     theExpected,
+                                      const uint32_t     theNew) {
+        return CompareAndSwap((volatile int32_t& )theValue, (int32_t )theExpected, (int32_t )theNew);
+    }
+
+    /**
+     * Atomically replace the pointer with new one if it is equal to expected value.
+     * @param theValue    pointer to modify
+     * @param theExpected expected current pointer
+     * @param theNew      new pointer
+     * @return true if pointer has been replaced
+     */
+    template<typename Type>
+    static inline bool CompareAndSwapPtr(Type* volatile& theValue,
+                                         Type*           theExpected,
+                                         Type*           theNew) {
+    #if defined(__GNUC__)
+        return __sync_bool_compare_and_swap(&theValue, theExpected, theNew);
+    #elif defined(_WIN32)
+        return InterlockedCompareExchangePointer((PVOID volatile* )&theValue, (PVOID )theNew, (PVOID )theExpected) == (PVOID )theExpected;
+    #else
+        #error "Atomic operation doesn't implemented for current platform!"
+        return false;
+    #endif
+    }
+
+    /**
+     * Full memory barrier - memory accesses are not reordered across this call
+     * neither by compiler nor by CPU.
+     */
+    static inline void Barrier() {
+    #ifdef __GCC_HAVE_SYNC_COMPARE_AND_SWAP_4
+        __sync_synchronize();
+    #elif defined(_WIN32)
+        MemoryBarrier();
+    #elif defined(__APPLE__)
+        OSMemoryBarrier();
+    #else
+        #error "Atomic operation doesn't implemented for current platform!"
+    #endif
+    }
+
     // int64_t, actually available on win32 too, but since WinNT 5.2 (Windows XP x64)
 #if (defined(_WIN64) || defined(__WIN64__))\
  || (defined(_LP64)  || defined(__LP64__))
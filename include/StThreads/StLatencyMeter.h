@@ -0,0 +1,206 @@
+/**
+ * Copyright © 2017 Kirill Gavrilov <kirill@sview.ru>
+ *
+ * Distributed under the Boost Software License, Version 1.0.
+ * See accompanying file license-boost.txt or copy at
+ * http://www.boost.org/LICENSE_1_0.txt
+ */
+
+#ifndef __StLatencyMeter_h_
+#define __StLatencyMeter_h_
+
+#include "StMutex.h"
+#include "StTimer.h"
+
+#include <StTemplates/StTemplates.h>
+
+/**
+ * Timestamps of single frame taken at hand-offs between playback pipeline stages.
+ * All values are in milli-seconds of monotonic clock (see StTimer::getMonotonicTimeInMilliSec()),
+ * zero value means that hand-off has not been stamped.
+ */
+struct StFrameStamps {
+
+    double Read;        //!< packet has been read from demuxer
+    double Queued;      //!< packet has been pushed into packets queue
+    double Dequeued;    //!< packet has been popped from packets queue by decoder
+    double Decoded;     //!< frame has been decoded
+    double Pushed;      //!< frame has been pushed into texture queue
+    double UploadStart; //!< texture upload has been started
+    double Uploaded;    //!< texture upload has been finished
+    double Shown;       //!< frame has been swapped to be displayed
+
+    /**
+     * Empty constructor.
+     */
+    StFrameStamps() {
+        reset();
+    }
+
+    /**
+     * Clear all timestamps.
+     */
+    void reset() {
+        Read        = 0.0;
+        Queued      = 0.0;
+        Dequeued    = 0.0;
+        Decoded     = 0.0;
+        Pushed      = 0.0;
+        UploadStart = 0.0;
+        Uploaded    = 0.0;
+        Shown       = 0.0;
+    }
+
+    /**
+     * @return current timestamp
+     */
+    static double now() {
+        return StTimer::getMonotonicTimeInMilliSec();
+    }
+
+};
+
+/**
+ * Per-stage latency statistics of playback pipeline.
+ * Latencies of last frames are kept within ring buffer,
+ * so that collecting them is cheap enough to be done all the time.
+ * Frames are added by single thread (GL thread), while statistics can be retrieved from any thread.
+ */
+class StLatencyMeter {
+
+        public:
+
+    /**
+     * Measured intervals between hand-offs.
+     */
+    enum Stage {
+        Stage_Demux = 0,    //!< Read     -> Queued,      pushing packet into packets queue
+        Stage_PacketQueue,  //!< Queued   -> Dequeued,    waiting within packets queue
+        Stage_Decode,       //!< Dequeued -> Decoded,     decoding
+        Stage_Prepare,      //!< Decoded  -> Pushed,      color conversion and waiting for free slot in texture queue
+        Stage_TextureQueue, //!< Pushed   -> UploadStart, waiting within texture queue
+        Stage_Upload,       //!< UploadStart -> Uploaded, texture upload
+        Stage_Present,      //!< Uploaded -> Shown,       waiting for presentation time
+        Stage_Total,        //!< Read     -> Shown,       whole pipeline
+        StageNb
+    };
+
+    /**
+     * Number of frames kept within ring buffer.
+     */
+    enum { RING_SIZE = 128 };
+
+    /**
+     * @return short stage name
+     */
+    static const char* getStageName(const Stage theStage) {
+        switch(theStage) {
+            case Stage_Demux:        return "demux";
+            case Stage_PacketQueue:  return "packetQueue";
+            case Stage_Decode:       return "decode";
+            case Stage_Prepare:      return "prepare";
+            case Stage_TextureQueue: return "textureQueue";
+            case Stage_Upload:       return "upload";
+            case Stage_Present:      return "present";
+            case Stage_Total:        return "total";
+            case StageNb:            break;
+        }
+        return "";
+    }
+
+        public:
+
+    /**
+     * Empty constructor.
+     */
+    StLatencyMeter() {
+        reset();
+    }
+
+    /**
+     * Clear collected statistics.
+     */
+    void reset() {
+        StMutexAuto aLock(myMutex);
+        for(int aStageIter = 0; aStageIter < StageNb; ++aStageIter) {
+            for(int aFrameIter = 0; aFrameIter < RING_SIZE; ++aFrameIter) {
+                myRing[aStageIter][aFrameIter] = 0.0;
+            }
+            myNbSamples[aStageIter] = 0;
+            myRingPos  [aStageIter] = 0;
+        }
+    }
+
+    /**
+     * Add latencies of displayed frame.
+     * Stages with missing timestamps are skipped.
+     */
+    void addFrame(const StFrameStamps& theStamps) {
+        StMutexAuto aLock(myMutex);
+        addSample(Stage_Demux,        theStamps.Read,        theStamps.Queued);
+        addSample(Stage_PacketQueue,  theStamps.Queued,      theStamps.Dequeued);
+        addSample(Stage_Decode,       theStamps.Dequeued,    theStamps.Decoded);
+        addSample(Stage_Prepare,      theStamps.Decoded,     theStamps.Pushed);
+        addSample(Stage_TextureQueue, theStamps.Pushed,      theStamps.UploadStart);
+        addSample(Stage_Upload,       theStamps.UploadStart, theStamps.Uploaded);
+        addSample(Stage_Present,      theStamps.Uploaded,    theStamps.Shown);
+        addSample(Stage_Total,        theStamps.Read,        theStamps.Shown);
+    }
+
+    /**
+     * Retrieve statistics of specified stage over the frames in ring buffer.
+     * @param theStage   stage to retrieve
+     * @param theAverage average latency in milli-seconds
+     * @param theMax     maximum latency in milli-seconds
+     * @return false if stage has no samples
+     */
+    bool getStats(const Stage theStage,
+                  double&     theAverage,
+                  double&     theMax) const {
+        theAverage = 0.0;
+        theMax     = 0.0;
+        StMutexAuto aLock(myMutex);
+        const int aNbSamples = myNbSamples[theStage];
+        if(aNbSamples == 0) {
+            return false;
+        }
+
+        for(int aFrameIter = 0; aFrameIter < aNbSamples; ++aFrameIter) {
+            const double aValue = myRing[theStage][aFrameIter];
+            theAverage += aValue;
+            theMax = stMax(theMax, aValue);
+        }
+        theAverage /= double(aNbSamples);
+        return true;
+    }
+
+        private:
+
+    /**
+     * Push new value into the ring buffer of specified stage.
+     */
+    void addSample(const Stage  theStage,
+                   const double theFrom,
+                   const double theTo) {
+        if(theFrom <= 0.0
+        || theTo   <  theFrom) {
+            return;
+        }
+
+        myRing[theStage][myRingPos[theStage]] = theTo - theFrom;
+        myRingPos[theStage] = (myRingPos[theStage] + 1) % RING_SIZE;
+        if(myNbSamples[theStage] < RING_SIZE) {
+            ++myNbSamples[theStage];
+        }
+    }
+
+        private:
+
+    double          myRing[StageNb][RING_SIZE]; //!< latencies of last frames in milli-seconds
+    int             myNbSamples[StageNb];       //!< number of filled values in ring buffer
+    int             myRingPos[StageNb];         //!< next position to write in ring buffer
+    mutable StMutex myMutex;                    //!< lock for thread-safety
+
+};
+
+#endif // __StLatencyMeter_h_
@@ -17,6 +17,7 @@
     extern "C" __declspec(dllimport) void __stdcall Sleep(unsigned long theMilliseconds);
 #else
     #include <pthread.h>
+    #include <sched.h>
     #include <unistd.h>
     #include <errno.h>
     #include <sys/time.h>
@@ -53,6 +54,18 @@ class StThread {
     #endif
     }
 
+    /**
+     * Give up the rest of time slice to other threads.
+     * Should be used within busy-wait loops.
+     */
+    static void yield() {
+    #ifdef _WIN32
+        Sleep(0);
+    #else
+        sched_yield();
+    #endif
+    }
+
     /**
      * Returns the logical processors count in system.
      * This number could be used to tune multithreading algorithms.
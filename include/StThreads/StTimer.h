@@ -1,5 +1,5 @@
 /**
- * Copyright © 2008-2014 Kirill Gavrilov <kirill@sview.ru>
+ * Copyright © 2008-2017 Kirill Gavrilov <kirill@sview.ru>
  *
  * Distributed under the Boost Software License, Version 1.0.
  * See accompanying file license-boost.txt or copy at
@@ -126,6 +126,24 @@ class StTimer {
         return myIsPaused ? 0.0 : timeFromStart();
     }
 
+    /**
+     * Return current value of monotonic clock, counted from undefined starting point.
+     * Can be used for comparing timestamps taken by different threads.
+     * @return clock value in milli-seconds
+     */
+    static double getMonotonicTimeInMilliSec() {
+        stTimeCounter_t aCounter;
+        fillCounter(aCounter);
+    #ifdef _WIN32
+        static const double INV_FREQ = winInvFrequency();
+        return double(aCounter.QuadPart) * INV_FREQ * 0.001;
+    #elif defined(ST_HAVE_MONOTONIC_CLOCK)
+        return double(aCounter.tv_sec) * 1000.0 + double(aCounter.tv_nsec) * 0.000001;
+    #else
+        return double(aCounter.tv_sec) * 1000.0 + double(aCounter.tv_usec) * 0.001;
+    #endif
+    }
+
         protected:
 
 #ifdef _WIN32